@@ -41,6 +41,9 @@ __BEGIN_DECLS
  * port Application Programming Interface (API).
  */
 
+//! Size of each read-ahead buffer in #hamlib_port_t
+#define HAMLIB_PORT_RXBUF_SIZE 512
+
 /**
  * \brief Port definition
  *
@@ -118,6 +121,13 @@ typedef struct hamlib_port {
     int fd_sync_error_read;     /*!< file descriptor for reading synchronous data error codes */
 #endif
     short timeout_retry;    /*!< number of retries to make in case of read timeout errors, some serial interfaces may require this, 0 to disable */
+    struct hamlib_port_rxbuf {
+        int head;           /*!< offset of the first unconsumed byte in data */
+        int len;            /*!< number of unconsumed bytes */
+        unsigned char data[HAMLIB_PORT_RXBUF_SIZE]; /*!< bytes received past the end of the last reply */
+    } rxbuf[2];             /*!< Hamlib internal read-ahead buffers, [0] for the device, [1] for the synchronous data pipe */
+    int64_t deadline_ns;    /*!< Hamlib internal, reads give up at this CLOCK_MONOTONIC time in ns, 0 for none */
+    int64_t next_write_us;  /*!< Hamlib internal, CLOCK_MONOTONIC time in us the next write may start at, 0 for now, reset on open */
 // Additions go right above this line
 } hamlib_port_t;
 
@@ -1196,6 +1196,25 @@ enum multicast_item_e {
     RIG_MULTICAST_SPECTRUM      // spectrum data will be included
 };
 
+/**
+ * \brief How the multicast publisher sends spectrum lines
+ * \sa the multicast_spectrum_format conf parameter
+ */
+enum multicast_spectrum_format_e {
+    RIG_MULTICAST_SPECTRUM_JSON,    /*!< In the JSON snapshot, data hex encoded */
+    RIG_MULTICAST_SPECTRUM_BINARY,  /*!< One binary packet per line, see src/spectrum_packet.h */
+};
+
+/**
+ * \brief Which memory channels rig_set_channel() writes
+ * \sa the mem_incremental conf parameter, rig_channel_hash()
+ */
+enum rig_mem_incremental_e {
+    RIG_MEM_INCREMENTAL_OFF,    /*!< All of them */
+    RIG_MEM_INCREMENTAL_ON,     /*!< Those that differ from their last known content */
+    RIG_MEM_INCREMENTAL_VERIFY, /*!< Same, and read each one back after writing it */
+};
+
 //! @cond Doxygen_Suppress
 #define RIG_PARM_FLOAT_LIST (RIG_PARM_BACKLIGHT|RIG_PARM_BAT|RIG_PARM_KEYLIGHT|RIG_PARM_BACKLIGHT)
 #define RIG_PARM_STRING_LIST (RIG_PARM_BANDSELECT|RIG_PARM_KEYERTYPE)
@@ -1817,6 +1836,28 @@ typedef int (* confval_cb_t)(RIG *,
                              rig_ptr_t);
 //! @endcond
 
+/**
+ * \brief Pipelined memory channel reads, see rig_get_chan_all_cb()
+ *
+ * A backend that reads a memory channel with a fixed number of
+ * commands, each with exactly one reply, describes them here.  The
+ * commands of consecutive channels are then sent without waiting for
+ * the replies, up to \a window of them at a time, and the replies are
+ * matched to the commands in the order they were sent.
+ */
+struct rig_mem_batch
+{
+    int cmds;           /*!< Commands per channel */
+    int window;         /*!< Commands in flight at most, what the rig's input buffer holds */
+    char terminator;    /*!< Last byte of every reply */
+    /*! Writes command \a cmd (0..cmds-1) of channel \a channel_num to \a buf, returns its length */
+    int (*encode)(RIG *rig, int channel_num, int cmd, char *buf, size_t len);
+    /*! Fills \a chan from the reply to command \a cmd, -RIG_ENAVAIL for an empty channel */
+    int (*decode)(RIG *rig, channel_t *chan, int cmd, const char *reply, size_t len);
+    int (*start)(RIG *rig);     /*!< Optional, called before the first command */
+    void (*finish)(RIG *rig);   /*!< Optional, called after the last reply */
+};
+
 /**
  * \brief Spectrum scope
  */
@@ -1878,6 +1919,41 @@ struct rig_spectrum_line
     unsigned char *spectrum_data; /*!< 8-bit spectrum data covering bandwidth of either the span_freq in center mode or from low edge to high edge in fixed mode. A higher value represents higher signal strength. */
 };
 
+/**
+ * \brief How rig_get_spectrum_history() combines recent spectrum lines
+ */
+enum rig_spectrum_history_e {
+    RIG_SPECTRUM_HISTORY_LAST = 0,  /*!< The newest line as it is */
+    RIG_SPECTRUM_HISTORY_AVERAGE,   /*!< Average of each bin */
+    RIG_SPECTRUM_HISTORY_MAX,       /*!< Peak hold, the highest value of each bin */
+    RIG_SPECTRUM_HISTORY_MIN,       /*!< The lowest value of each bin */
+};
+
+/** \brief rig_vfo_status.valid bits */
+#define RIG_VFO_STATUS_FREQ  (1 << 0) /*!< freq */
+#define RIG_VFO_STATUS_MODE  (1 << 1) /*!< mode */
+#define RIG_VFO_STATUS_WIDTH (1 << 2) /*!< width, as read from the rig */
+#define RIG_VFO_STATUS_PTT   (1 << 3) /*!< ptt */
+#define RIG_VFO_STATUS_SPLIT (1 << 4) /*!< split and tx_vfo */
+
+/**
+ * \brief Operating state of a VFO, see rig_get_status()
+ *
+ * A backend get_status() fills in what it can read in as few
+ * transactions as possible and sets the matching bits in \a valid.
+ */
+struct rig_vfo_status
+{
+    vfo_t vfo;          /*!< The VFO the values are for, never RIG_VFO_CURR */
+    freq_t freq;        /*!< Frequency */
+    rmode_t mode;       /*!< Mode */
+    pbwidth_t width;    /*!< Passband width */
+    ptt_t ptt;          /*!< PTT state */
+    split_t split;      /*!< Split state */
+    vfo_t tx_vfo;       /*!< TX VFO when split is on */
+    unsigned int valid; /*!< RIG_VFO_STATUS_* bits of the fields that are set */
+};
+
 /**
  * Config item for deferred processing
  *  (Funky names to avoid clash with perl keywords. Sheesh.)
@@ -2226,6 +2302,8 @@ struct rig_caps {
     int (*get_lock_mode)(RIG *rig, int *mode);
     short timeout_retry;    /*!< number of retries to make in case of read timeout errors, some serial interfaces may require this, 0 to use default value, -1 to disable */
     short morse_qsize;  /*!< max length of morse message rig can accept in one command */
+    int (*get_status)(RIG *rig, vfo_t vfo, struct rig_vfo_status *status); /*!< Read freq/mode/PTT/split of \a vfo in as few transactions as possible, see rig_get_status() */
+    const struct rig_mem_batch *mem_batch; /*!< Pipelined memory channel reads for rig_get_chan_all_cb(), NULL if not supported */
 //    int (*bandwidth2rig)(RIG  *rig, enum bandwidth_t bandwidth);
 //    enum bandwidth_t (*rig2bandwidth)(RIG  *rig, int rigbandwidth);
 };
@@ -2325,6 +2403,7 @@ enum rig_function_e {
     RIG_FUNCTION_PROCESS_ASYNC_FRAME,
     RIG_FUNCTION_GET_CONF2,
     RIG_FUNCTION_STOP_VOICE_MEM,
+    RIG_FUNCTION_GET_STATUS,
 };
 
 /**
@@ -2410,15 +2489,51 @@ typedef enum {
 #define HAMLIB_CACHE_ALWAYS (-1) /*!< value to set cache timeout to always use cache */
 
 typedef enum {
-    HAMLIB_CACHE_ALL, // to set all cache timeouts at once
+    HAMLIB_CACHE_ALL, // to set the VFO..WIDTH timeouts at once
     HAMLIB_CACHE_VFO,
     HAMLIB_CACHE_FREQ,
     HAMLIB_CACHE_MODE,
     HAMLIB_CACHE_PTT,
     HAMLIB_CACHE_SPLIT,
-    HAMLIB_CACHE_WIDTH
+    HAMLIB_CACHE_WIDTH,
+    HAMLIB_CACHE_LEVEL, // rig_get_level(), off (0 ms) by default
+    HAMLIB_CACHE_FUNC,  // rig_get_func(), off by default
+    HAMLIB_CACHE_PARM,  // rig_get_parm(), off by default
+    HAMLIB_CACHE_RIT,   // rig_get_rit(), off by default
+    HAMLIB_CACHE_XIT,   // rig_get_xit(), off by default
+    HAMLIB_CACHE_ANT    // rig_get_ant(), off by default
 } hamlib_cache_t;
 
+/**
+ * \brief Priority of a caller waiting for the rig, see rig_set_thread_prio()
+ *
+ * When several threads use one rig, the one with the best (lowest)
+ * priority gets the rig next; callers of the same priority are served in
+ * arrival order.
+ */
+typedef enum {
+    RIG_PRIO_PTT,   /*!< PTT and CW keying */
+    RIG_PRIO_SET,   /*!< setting the rig */
+    RIG_PRIO_GET,   /*!< interactive reads, the default */
+    RIG_PRIO_POLL,  /*!< background polling */
+    RIG_PRIO_COUNT
+} rig_prio_t;
+
+#define RIG_PRIO_HIST_BUCKETS 24
+
+/**
+ * \brief How long callers of one priority waited for the rig
+ *
+ * hist[0] counts waits under 1 us, hist[n] waits of 2^(n-1) up to 2^n us;
+ * the last bucket also counts anything longer.
+ */
+struct rig_prio_stats {
+    unsigned long count;    /*!< Number of waits */
+    unsigned long max_us;   /*!< Longest wait */
+    unsigned long total_us; /*!< Sum of all waits */
+    unsigned long hist[RIG_PRIO_HIST_BUCKETS];  /*!< log2 histogram of waits in us */
+};
+
 typedef enum {
     TWIDDLE_OFF,
     TWIDDLE_ON
@@ -3061,6 +3176,16 @@ rig_lookup_mem_caps(RIG *rig,
 extern HAMLIB_EXPORT(int)
 rig_mem_count(RIG *rig);
 
+extern HAMLIB_EXPORT(uint32_t)
+rig_channel_hash(RIG *rig,
+                 const channel_t *chan);
+extern HAMLIB_EXPORT(int)
+rig_load_chan_hashes(RIG *rig,
+                     const char *path);
+extern HAMLIB_EXPORT(int)
+rig_save_chan_hashes(RIG *rig,
+                     const char *path);
+
 HL_DEPRECATED
 extern HAMLIB_EXPORT(int)
 rig_set_trn(RIG *rig,
@@ -3104,6 +3229,23 @@ rig_set_spectrum_callback(RIG *,
                           spectrum_cb_t,
                           rig_ptr_t);
 
+extern HAMLIB_EXPORT(int)
+rig_get_spectrum_history(RIG *rig,
+                         int id,
+                         enum rig_spectrum_history_e op,
+                         int lines,
+                         int bins,
+                         struct rig_spectrum_line *line,
+                         unsigned char *data);
+
+extern HAMLIB_EXPORT(int)
+rig_hold_spectrum_line(RIG *rig,
+                       const struct rig_spectrum_line *line);
+
+extern HAMLIB_EXPORT(int)
+rig_release_spectrum_line(RIG *rig,
+                          const struct rig_spectrum_line *line);
+
 extern HAMLIB_EXPORT(int)
 rig_set_twiddle(RIG *rig,
                 int seconds);
@@ -3162,6 +3304,9 @@ rig_get_debug(enum rig_debug_level_e *debug_level);
 extern HAMLIB_EXPORT(void)
 rig_set_debug_time_stamp(int flag);
 
+extern HAMLIB_EXPORT(void)
+rig_set_debug_history_level(enum rig_debug_level_e debug_level);
+
 #define rig_set_debug_level(level) rig_set_debug(level)
 
 extern HAMLIB_EXPORT(int)
@@ -3184,11 +3329,18 @@ rig_debug(enum rig_debug_level_e debug_level,
 
 extern HAMLIB_EXPORT(void)add2debugmsgsave(const char *s);
 // this needs to be fairly big to avoid compiler warnings
+// debugmsgsave is deprecated, it is only filled in when rigerror() or
+// rig_get_debug_history() is called; use the latter's return value
+#if !defined(IN_HAMLIB)
+HL_DEPRECATED
+#endif
 extern HAMLIB_EXPORT_VAR(char) debugmsgsave[DEBUGMSGSAVE_SIZE];  // last debug msg
 extern HAMLIB_EXPORT_VAR(char) debugmsgsave2[DEBUGMSGSAVE_SIZE];  // last-1 debug msg
 // debugmsgsave3 is deprecated
 extern HAMLIB_EXPORT_VAR(char) debugmsgsave3[DEBUGMSGSAVE_SIZE];  // last-2 debug msg
-#define rig_debug_clear() { debugmsgsave[0] = debugmsgsave2[0] = debugmsgsave3[0] = 0; };
+extern HAMLIB_EXPORT(const char *) rig_get_debug_history(void);
+extern HAMLIB_EXPORT(void) rig_debug_history_clear(void);
+#define rig_debug_clear() { rig_debug_history_clear(); };
 
 // Measuring elapsed time -- local variable inside function when macro is used
 #define ELAPSED1 struct timespec __begin; elapsed_ms(&__begin, HAMLIB_ELAPSED_SET);
@@ -3237,6 +3389,13 @@ rig_probe_all(hamlib_port_t *p,
 extern HAMLIB_EXPORT(rig_model_t)
 rig_probe(hamlib_port_t *p);
 
+extern HAMLIB_EXPORT(int)
+rig_probe_ports(const char *const pathnames[],
+                int count,
+                int budget_ms,
+                rig_probe_func_t cfunc,
+                rig_ptr_t data);
+
 
 /* Misc calls */
 extern HAMLIB_EXPORT(const char *) rig_strrmode(rmode_t mode);
@@ -3255,6 +3414,7 @@ extern HAMLIB_EXPORT(const char *) rig_strscan(scan_t scan);
 extern HAMLIB_EXPORT(const char *) rig_strstatus(enum rig_status_e status);
 extern HAMLIB_EXPORT(const char *) rig_strmtype(chan_type_t mtype);
 extern HAMLIB_EXPORT(const char *) rig_strspectrummode(enum rig_spectrum_mode_e mode);
+extern HAMLIB_EXPORT(const char *) rig_strspectrumhistory(enum rig_spectrum_history_e op);
 extern HAMLIB_EXPORT(const char *) rig_strcommstatus(rig_comm_status_t vfo);
 
 extern HAMLIB_EXPORT(rmode_t) rig_parse_mode(const char *s);
@@ -3266,6 +3426,7 @@ extern HAMLIB_EXPORT(vfo_op_t) rig_parse_vfo_op(const char *s);
 extern HAMLIB_EXPORT(scan_t) rig_parse_scan(const char *s);
 extern HAMLIB_EXPORT(rptr_shift_t) rig_parse_rptr_shift(const char *s);
 extern HAMLIB_EXPORT(chan_type_t) rig_parse_mtype(const char *s);
+extern HAMLIB_EXPORT(int) rig_parse_spectrum_history(const char *s);
 
 extern HAMLIB_EXPORT(const char *) rig_license(void);
 extern HAMLIB_EXPORT(const char *) rig_version(void);
@@ -3276,8 +3437,12 @@ extern HAMLIB_EXPORT(void) rig_no_restore_ai(void);
 extern HAMLIB_EXPORT(int) rig_get_cache_timeout_ms(RIG *rig, hamlib_cache_t selection);
 extern HAMLIB_EXPORT(int) rig_set_cache_timeout_ms(RIG *rig, hamlib_cache_t selection, int ms);
 
+extern HAMLIB_EXPORT(void) rig_set_thread_prio(rig_prio_t prio);
+extern HAMLIB_EXPORT(int) rig_get_prio_stats(RIG *rig, rig_prio_t prio, struct rig_prio_stats *stats);
+
 extern HAMLIB_EXPORT(int) rig_set_vfo_opt(RIG *rig, int status);
 extern HAMLIB_EXPORT(int) rig_get_vfo_info(RIG *rig, vfo_t vfo, freq_t *freq, rmode_t *mode, pbwidth_t *width, split_t *split, int *satmode);
+extern HAMLIB_EXPORT(int) rig_get_status(RIG *rig, vfo_t vfo, struct rig_vfo_status *status);
 extern HAMLIB_EXPORT(int) rig_get_rig_info(RIG *rig, char *response, int max_response_len);
 extern HAMLIB_EXPORT(int) rig_get_cache(RIG *rig, vfo_t vfo, freq_t *freq, int * cache_ms_freq, rmode_t *mode, int *cache_ms_mode, pbwidth_t *width, int *cache_ms_width);
 extern HAMLIB_EXPORT(int) rig_get_cache_freq(RIG *rig, vfo_t vfo, freq_t *freq, int * cache_ms_freq);
@@ -48,6 +48,9 @@ __BEGIN_DECLS
  * Structures pointed to by rig_state and defined elsewhere
  */
 struct FIFO_RIG_s;  /* Defined in src/fifo.h */
+struct spectrum_history;    /* Defined in src/spectrum_history.h */
+struct spectrum_pool;       /* Defined in src/spectrum_pool.h */
+struct mem_hashes;          /* Defined in src/mem.c */
 
 /**
  * \brief Rig state containing live data and customized fields.
@@ -237,8 +240,13 @@ struct rig_state {
     struct timespec freq_event_elapsed;     /*!< Time struct used by various caches. */
     int freq_skip; /*!< allow frequency skip for gpredict RX/TX freq set */
     client_t client;        /*!< Client application of the library. */
-    pthread_mutex_t api_mutex;      /*!< Lock for any API entry. */
+    pthread_mutex_t api_mutex;      /*!< Recursive lock for applications, Hamlib itself serializes API entry with rig_lock(). */
     bool morse_busy;                /*!< Advisory to use cache when morse_handler is busy */
+    int multicast_spectrum_format;  /*!< enum multicast_spectrum_format_e */
+    struct spectrum_history *spectrum_history; /*!< Recent spectrum lines, see rig_get_spectrum_history() */
+    struct spectrum_pool *spectrum_pool;    /*!< Buffers spectrum lines are assembled and passed around in */
+    int mem_incremental;    /*!< enum rig_mem_incremental_e */
+    struct mem_hashes *mem_hashes;  /*!< Last known content of the memory channels, see rig_channel_hash() */
 // New rig_state items go before this line ============================================
 };
 
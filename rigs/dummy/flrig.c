@@ -1818,7 +1818,7 @@ static int flrig_get_mode(RIG *rig, vfo_t vfo, rmode_t *mode, pbwidth_t *width)
         {
             rig_debug(RIG_DEBUG_WARN, "%s: empty value, returning cached bandwidth\n",
                       __func__);
-            *width = CACHE(rig)->widthMainA;
+            *width = CACHE(rig)->slot[CACHE_SLOT_MAIN_A].width;
             RETURNFUNC(RIG_OK);
         }
 
@@ -1845,7 +1845,7 @@ static int flrig_get_mode(RIG *rig, vfo_t vfo, rmode_t *mode, pbwidth_t *width)
             {
                 rig_debug(RIG_DEBUG_WARN, "%s: empty value, returning cached bandwidth\n",
                           __func__);
-                *width = CACHE(rig)->widthMainA;
+                *width = CACHE(rig)->slot[CACHE_SLOT_MAIN_A].width;
                 RETURNFUNC(RIG_OK);
             }
 
@@ -412,14 +412,14 @@ static int pmr171_open(RIG *rig)
                          reply[freq_b_offset+3];
 
         // Update cache
-        CACHE(rig)->freqMainA = (freq_t)freq_a;
-        CACHE(rig)->freqMainB = (freq_t)freq_b;
+        CACHE(rig)->slot[CACHE_SLOT_MAIN_A].freq = (freq_t)freq_a;
+        CACHE(rig)->slot[CACHE_SLOT_MAIN_B].freq = (freq_t)freq_b;
 
         // Return requested VFO frequency
-        *freq = (vfo == RIG_VFO_A) ? CACHE(rig)->freqMainA : CACHE(rig)->freqMainB;
+        *freq = (vfo == RIG_VFO_A) ? CACHE(rig)->slot[CACHE_SLOT_MAIN_A].freq : CACHE(rig)->slot[CACHE_SLOT_MAIN_B].freq;
 
         rig_debug(RIG_DEBUG_VERBOSE, "%s: Successfully got VFOA=%.0f Hz, VFOB=%.0f Hz\n",
-                 __func__, CACHE(rig)->freqMainA, CACHE(rig)->freqMainB);
+                 __func__, CACHE(rig)->slot[CACHE_SLOT_MAIN_A].freq, CACHE(rig)->slot[CACHE_SLOT_MAIN_B].freq);
     }
     return RIG_OK;
  }
@@ -441,10 +441,10 @@ static int pmr171_open(RIG *rig)
             RETURN_CACHED_MODE(rig, vfo, mode, width, cachep, p);
         }
         // Update cache
-        cachep->modeMainA = guohe2rmode(reply[7], pmr171_modes);
-        cachep->modeMainB = guohe2rmode(reply[8], pmr171_modes);
+        cachep->slot[CACHE_SLOT_MAIN_A].mode = guohe2rmode(reply[7], pmr171_modes);
+        cachep->slot[CACHE_SLOT_MAIN_B].mode = guohe2rmode(reply[8], pmr171_modes);
         // Return requested mode
-        *mode = (vfo == RIG_VFO_A) ? cachep->modeMainA : cachep->modeMainB;
+        *mode = (vfo == RIG_VFO_A) ? cachep->slot[CACHE_SLOT_MAIN_A].mode : cachep->slot[CACHE_SLOT_MAIN_B].mode;
         *width = p->filterBW;
     }
     return RIG_OK;
@@ -571,13 +571,13 @@ static int pmr171_open(RIG *rig)
     /* Update frequency */
     if (vfo == RIG_VFO_B)
     {
-        to_be(&cmd[6], CACHE(rig)->freqMainA, 4);
+        to_be(&cmd[6], CACHE(rig)->slot[CACHE_SLOT_MAIN_A].freq, 4);
         to_be(&cmd[10], freq, 4);
     }
     else
     {
         to_be(&cmd[6], freq, 4);
-        to_be(&cmd[10], CACHE(rig)->freqMainB, 4);
+        to_be(&cmd[10], CACHE(rig)->slot[CACHE_SLOT_MAIN_B].freq, 4);
     }
  
      unsigned int crc = CRC16Check(&cmd[4], 10);
@@ -593,11 +593,11 @@ static int pmr171_open(RIG *rig)
          // Update cache with requested frequency even if response failed
          if (vfo == RIG_VFO_B)
          {
-             CACHE(rig)->freqMainB = freq;
+             CACHE(rig)->slot[CACHE_SLOT_MAIN_B].freq = freq;
          }
          else
          {
-             CACHE(rig)->freqMainA = freq;
+             CACHE(rig)->slot[CACHE_SLOT_MAIN_A].freq = freq;
          }
          return RIG_OK;
      }
@@ -605,11 +605,11 @@ static int pmr171_open(RIG *rig)
      // Update cache with requested frequency
      if (vfo == RIG_VFO_B)
      {
-         CACHE(rig)->freqMainB = freq;
+         CACHE(rig)->slot[CACHE_SLOT_MAIN_B].freq = freq;
      }
      else
      {
-         CACHE(rig)->freqMainA = freq;
+         CACHE(rig)->slot[CACHE_SLOT_MAIN_A].freq = freq;
      }
 
      return RIG_OK;
@@ -642,13 +642,13 @@ static int pmr171_open(RIG *rig)
 
      if (vfo == RIG_VFO_B)
      {
-         cmd[6] = rmode2guohe(CACHE(rig)->modeMainA, pmr171_modes);
+         cmd[6] = rmode2guohe(CACHE(rig)->slot[CACHE_SLOT_MAIN_A].mode, pmr171_modes);
          cmd[7] = i;
      }
      else
      {
          cmd[6] = i;
-         cmd[7] = rmode2guohe(CACHE(rig)->modeMainB, pmr171_modes);
+         cmd[7] = rmode2guohe(CACHE(rig)->slot[CACHE_SLOT_MAIN_B].mode, pmr171_modes);
      }
 
      int crc = CRC16Check(&cmd[4], 4);
@@ -662,11 +662,11 @@ static int pmr171_open(RIG *rig)
          // Update cache with requested mode even if response failed
          if (vfo == RIG_VFO_B)
          {
-             CACHE(rig)->modeMainB = mode;
+             CACHE(rig)->slot[CACHE_SLOT_MAIN_B].mode = mode;
          }
          else
          {
-             CACHE(rig)->modeMainA = mode;
+             CACHE(rig)->slot[CACHE_SLOT_MAIN_A].mode = mode;
          }
          return RIG_OK;
      }
@@ -677,18 +677,18 @@ static int pmr171_open(RIG *rig)
          // Update cache with requested mode even if validation failed
          if (vfo == RIG_VFO_B)
          {
-             CACHE(rig)->modeMainB = mode;
+             CACHE(rig)->slot[CACHE_SLOT_MAIN_B].mode = mode;
          }
          else
          {
-             CACHE(rig)->modeMainA = mode;
+             CACHE(rig)->slot[CACHE_SLOT_MAIN_A].mode = mode;
          }
          return RIG_OK;
      }
      
      // Update cache with response data
-     CACHE(rig)->modeMainA = guohe2rmode(reply[6], pmr171_modes);
-     CACHE(rig)->modeMainB = guohe2rmode(reply[7], pmr171_modes);
+     CACHE(rig)->slot[CACHE_SLOT_MAIN_A].mode = guohe2rmode(reply[6], pmr171_modes);
+     CACHE(rig)->slot[CACHE_SLOT_MAIN_B].mode = guohe2rmode(reply[7], pmr171_modes);
 
      return RIG_OK;
  }
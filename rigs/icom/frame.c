@@ -178,6 +178,9 @@ collision_retry:
         RETURNFUNC(retval);
     }
 
+    __atomic_add_fetch(&priv->civ_stats.frames_sent, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&priv->civ_stats.bytes_sent, frm_len, __ATOMIC_RELAXED);
+
     if (!priv_caps->serial_full_duplex && !priv->serial_USB_echo_off)
     {
 
@@ -345,6 +348,10 @@ again2:
         goto again2;
     }
 
+    __atomic_add_fetch(&priv->civ_stats.frames_received, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&priv->civ_stats.bytes_received, frm_len,
+                       __ATOMIC_RELAXED);
+
     // IC-PW2 was sending fe fe 94 aa 1c 03
     if (buf[3] == 0xaa || buf[2] == 0xaa)
     {
@@ -40,6 +40,7 @@
 #include "frame.h"
 #include "misc.h"
 #include "event.h"
+#include "spectrum_pool.h"
 #include "cache.h"
 
 // we automatically determine availability of the 1A 03 command
@@ -52,6 +53,7 @@ static int icom_get_spectrum_edge_frequency_range(RIG *rig, vfo_t vfo,
         int *range_id);
 static void icom_set_x25x26_ability(RIG *rig, int status);
 static int icom_get_vfo_number_x25x26(RIG *rig, vfo_t vfo);
+static void icom_civ_stats_str(RIG *rig, char *buf, int buf_len);
 
 const int cw_lookup [43][2] =
 {
@@ -394,6 +396,8 @@ struct icom_addr
 #define TOK_FILTER_USB TOKEN_BACKEND(6)
 #define TOK_FILTER_CW TOKEN_BACKEND(7)
 #define TOK_FILTER_FM TOKEN_BACKEND(8)
+#define TOK_TRANSCEIVE_RECONCILE TOKEN_BACKEND(9)
+#define TOK_CIV_STATS TOKEN_BACKEND(10)
 
 const struct confparams icom_cfg_params[] =
 {
@@ -432,6 +436,17 @@ const struct confparams icom_cfg_params[] =
         TOK_FILTER_FM, "filter_fm", "Filter to use FM", "Filter to use for FM/PKTFM when setting mode",
         "1", RIG_CONF_NUMERIC, {.n = {0, 3, 1}}
     },
+    {
+        TOK_TRANSCEIVE_RECONCILE, "transceive_reconcile", "Transceive reconcile",
+        "With async data, seconds to trust transceive freq/mode for the "
+        "selected VFO before polling the rig again, 0 to always poll",
+        "5", RIG_CONF_NUMERIC, {.n = {0, 3600, 1}}
+    },
+    {
+        TOK_CIV_STATS, "civ_stats", "CI-V statistics",
+        "Read only: transceive cache hits/misses and CI-V bus traffic",
+        "", RIG_CONF_STRING
+    },
     {RIG_CONF_END, NULL,}
 };
 
@@ -640,23 +655,18 @@ int icom_init(RIG *rig)
 
     for (int i = 0; caps->spectrum_scopes[i].name != NULL; i++)
     {
-        priv->spectrum_scope_cache[i].spectrum_data = NULL;
+        // lines are assembled in buffers from the spectrum pool
+        priv->spectrum_scope_cache[i].buffer = NULL;
 
-        if (priv_caps->spectrum_scope_caps.spectrum_line_length < 1)
+        if (priv_caps->spectrum_scope_caps.spectrum_line_length < 1
+                || priv_caps->spectrum_scope_caps.spectrum_line_length >
+                HAMLIB_MAX_SPECTRUM_DATA)
         {
-            rig_debug(RIG_DEBUG_ERR, "%s: no spectrum scope line length defined\n",
+            rig_debug(RIG_DEBUG_ERR, "%s: no valid spectrum scope line length defined\n",
                       __func__);
             RETURNFUNC(-RIG_ECONF);
         }
 
-        priv->spectrum_scope_cache[i].spectrum_data = calloc(1,
-                priv_caps->spectrum_scope_caps.spectrum_line_length);
-
-        if (!priv->spectrum_scope_cache[i].spectrum_data)
-        {
-            RETURNFUNC(-RIG_ENOMEM);
-        }
-
         priv->spectrum_scope_count++;
     }
 
@@ -674,6 +684,8 @@ int icom_init(RIG *rig)
     priv->x25cmdfails = 1;
     priv->x26cmdfails = 1;
     priv->x1cx03cmdfails = 0;
+    priv->transceive_reconcile_ms = 5000;
+    priv->transceive_vfo = RIG_VFO_NONE;
 
     // Reset 0x25/0x26 command detection for the rigs that may support it
     icom_set_x25x26_ability(rig, -1);
@@ -695,10 +707,10 @@ int icom_cleanup(RIG *rig)
 
     for (int i = 0; rig->caps->spectrum_scopes[i].name != NULL; i++)
     {
-        if (priv->spectrum_scope_cache[i].spectrum_data)
+        if (priv->spectrum_scope_cache[i].buffer)
         {
-            free(priv->spectrum_scope_cache[i].spectrum_data);
-            priv->spectrum_scope_cache[i].spectrum_data = NULL;
+            spectrum_buffer_unref(priv->spectrum_scope_cache[i].buffer);
+            priv->spectrum_scope_cache[i].buffer = NULL;
         }
     }
 
@@ -1063,6 +1075,11 @@ int icom_rig_open(RIG *rig)
     rp->retry = 0;
 
     priv->no_1a_03_cmd = ENUM_1A_03_UNK;
+    priv->transceive_vfo = RIG_VFO_NONE;
+    priv->transceive_seen = 0;
+    memset(priv->transceive_polled, 0, sizeof(priv->transceive_polled));
+    memset(&priv->civ_stats, 0, sizeof(priv->civ_stats));
+    elapsed_ms(&priv->civ_stats.start, HAMLIB_ELAPSED_SET);
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s: %s v%s\n", __func__, rig->caps->model_name,
               rig->caps->version);
@@ -1214,6 +1231,14 @@ int icom_rig_close(RIG *rig)
 
     ENTERFUNC;
 
+    if (rig_need_debug(RIG_DEBUG_VERBOSE))
+    {
+        char stats[128];
+
+        icom_civ_stats_str(rig, stats, sizeof(stats));
+        rig_debug(RIG_DEBUG_VERBOSE, "%s: CI-V stats: %s\n", __func__, stats);
+    }
+
     if (priv->poweron == 0) { RETURNFUNC(RIG_OK); } // nothing to do
 
     if (priv->poweron == 1 && rs->auto_power_off)
@@ -1641,6 +1666,112 @@ int icom_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
  * Assumes rig!=NULL, STATE(rig)->priv!=NULL, freq!=NULL, Main=VFOA, Sub=VFOB
  * Note: old rig may return less than 4/5 bytes for get_freq
  */
+/*
+ * Transceive-authoritative freq/mode.
+ *
+ * With async data on, the rig pushes a CI-V transceive frame whenever its
+ * frequency or mode changes, and icom_process_async_frame() puts it in the
+ * cache.  The frames don't say which VFO they are for: they follow the
+ * VFO selected on the rig.  So once we have selected a VFO ourselves
+ * (priv->transceive_vfo) and the rig has pushed an item since, gets for
+ * that VFO are answered from the cache.  Every transceive_reconcile_ms one
+ * get goes to the rig anyway, to catch frames we missed and VFO changes
+ * made on the front panel, which are not pushed.
+ *
+ * Returns 1 if the cache may answer, otherwise 0 and the caller polls.
+ */
+static int icom_transceive_fresh(RIG *rig, vfo_t vfo, int item)
+{
+    struct rig_state *rs = STATE(rig);
+    struct icom_priv_data *priv = (struct icom_priv_data *) rs->priv;
+    struct icom_civ_stats *stats = &priv->civ_stats;
+    int64_t *polled = &priv->transceive_polled[item ==
+                                               ICOM_TRANSCEIVE_FREQ ? 0 : 1];
+    int64_t last = __atomic_load_n(polled, __ATOMIC_RELAXED);
+    int64_t now;
+    vfo_t tc_vfo = __atomic_load_n(&priv->transceive_vfo, __ATOMIC_ACQUIRE);
+    int seen = __atomic_load_n(&priv->transceive_seen, __ATOMIC_ACQUIRE);
+
+    if (vfo == RIG_VFO_CURR) { vfo = rs->current_vfo; }
+
+    if (!rs->async_data_enabled || priv->transceive_reconcile_ms <= 0
+            || tc_vfo == RIG_VFO_NONE || vfo != tc_vfo || !(seen & item))
+    {
+        __atomic_add_fetch(&stats->cache_misses, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    now = rig_cache_now_ns();
+
+    if (last != 0
+            && now - last < (int64_t) priv->transceive_reconcile_ms * 1000000)
+    {
+        return 1;
+    }
+
+    // the thread that claims the poll goes to the rig, the others that
+    // raced it still have fresh enough transceive data
+    if (!__atomic_compare_exchange_n(polled, &last, now, 0, __ATOMIC_RELAXED,
+                                     __ATOMIC_RELAXED))
+    {
+        return 1;
+    }
+
+    rig_debug(RIG_DEBUG_TRACE, "%s: reconciling %s on %s\n", __func__,
+              item == ICOM_TRANSCEIVE_FREQ ? "freq" : "mode", rig_strvfo(vfo));
+    __atomic_add_fetch(&stats->cache_misses, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats->reconcile_polls, 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+/* The rig now has vfo selected, or RIG_VFO_NONE if we don't know */
+static void icom_transceive_select(RIG *rig, vfo_t vfo)
+{
+    struct icom_priv_data *priv = (struct icom_priv_data *) STATE(rig)->priv;
+
+    __atomic_store_n(&priv->transceive_seen, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&priv->transceive_vfo, vfo, __ATOMIC_RELEASE);
+    __atomic_store_n(&priv->transceive_polled[0], 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&priv->transceive_polled[1], 0, __ATOMIC_RELAXED);
+}
+
+/*
+ * Formats the CI-V counters for the civ_stats conf token.  Bus load is
+ * bytes on the wire at 10 bits per byte against the serial rate, so it
+ * is only shown for serial ports.
+ */
+static void icom_civ_stats_str(RIG *rig, char *buf, int buf_len)
+{
+    struct icom_priv_data *priv = (struct icom_priv_data *) STATE(rig)->priv;
+    struct icom_civ_stats *stats = &priv->civ_stats;
+    const hamlib_port_t *rp = RIGPORT(rig);
+    unsigned long hits = __atomic_load_n(&stats->cache_hits, __ATOMIC_RELAXED);
+    unsigned long misses = __atomic_load_n(&stats->cache_misses,
+                                           __ATOMIC_RELAXED);
+    unsigned long long bytes = __atomic_load_n(&stats->bytes_sent,
+                               __ATOMIC_RELAXED)
+                               + __atomic_load_n(&stats->bytes_received, __ATOMIC_RELAXED);
+    double secs = stats->start.tv_sec ? elapsed_ms(&stats->start,
+                  HAMLIB_ELAPSED_GET) / 1000.0 : 0;
+    char bus[16] = "n/a";
+
+    if (rp->type.rig == RIG_PORT_SERIAL && rp->parm.serial.rate > 0 && secs > 0)
+    {
+        SNPRINTF(bus, sizeof(bus), "%.1f%%",
+                 100.0 * bytes * 10 / (rp->parm.serial.rate * secs));
+    }
+
+    SNPRINTF(buf, buf_len,
+             "hits=%lu misses=%lu hit_rate=%.1f%% polls=%lu tx=%lu rx=%lu "
+             "async=%lu bytes=%llu bus=%s",
+             hits, misses, hits + misses ? 100.0 * hits / (hits + misses) : 0.0,
+             __atomic_load_n(&stats->reconcile_polls, __ATOMIC_RELAXED),
+             __atomic_load_n(&stats->frames_sent, __ATOMIC_RELAXED),
+             __atomic_load_n(&stats->frames_received, __ATOMIC_RELAXED),
+             __atomic_load_n(&stats->async_frames, __ATOMIC_RELAXED),
+             bytes, bus);
+}
+
 int icom_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
 {
     struct rig_state *rs = STATE(rig);
@@ -1661,6 +1792,20 @@ int icom_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
         icom_get_usb_echo_off(rig);
     }
 
+    if (icom_transceive_fresh(rig, vfo, ICOM_TRANSCEIVE_FREQ))
+    {
+        rmode_t mode;
+        pbwidth_t width;
+        int cache_ms_freq, cache_ms_mode, cache_ms_width;
+
+        if (rig_get_cache(rig, vfo, freq, &cache_ms_freq, &mode, &cache_ms_mode,
+                          &width, &cache_ms_width) == RIG_OK && *freq != 0)
+        {
+            __atomic_add_fetch(&priv->civ_stats.cache_hits, 1, __ATOMIC_RELAXED);
+            return RIG_OK;
+        }
+    }
+
     if (vfo == RIG_VFO_MEM && (priv->civ_731_mode || RIG_IS_IC706))
     {
         // Memory channels have always 5-byte frequency
@@ -2827,6 +2972,19 @@ int icom_get_mode(RIG *rig, vfo_t vfo, rmode_t *mode, pbwidth_t *width)
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called vfo=%s\n", __func__, rig_strvfo(vfo));
 
+    if (icom_transceive_fresh(rig, vfo, ICOM_TRANSCEIVE_MODE))
+    {
+        freq_t freq;
+        int cache_ms_freq, cache_ms_mode, cache_ms_width;
+
+        if (rig_get_cache(rig, vfo, &freq, &cache_ms_freq, mode, &cache_ms_mode,
+                          width, &cache_ms_width) == RIG_OK && *mode != RIG_MODE_NONE)
+        {
+            __atomic_add_fetch(&priv->civ_stats.cache_hits, 1, __ATOMIC_RELAXED);
+            RETURNFUNC2(RIG_OK);
+        }
+    }
+
     // Icom 0x26 command can only manipulate VFO A/B *or* VFO Main/Sub modes.
     // With (usually satellite-capable) rigs that have Main/Sub + A/B for each,
     // Sub receiver modes must be manipulated using non-targetable commands.
@@ -3031,6 +3189,9 @@ int icom_set_vfo(RIG *rig, vfo_t vfo)
         RETURNFUNC2(RIG_OK);
     }
 
+    // transceive frames can't be trusted until we know where they go
+    icom_transceive_select(rig, RIG_VFO_NONE);
+
     if (vfo == RIG_VFO_MAIN && VFO_HAS_A_B_ONLY)
     {
         vfo = RIG_VFO_A;
@@ -3114,7 +3275,7 @@ int icom_set_vfo(RIG *rig, vfo_t vfo)
     {
         rig_debug(RIG_DEBUG_TRACE, "%s: VFO changing from %s to %s\n", __func__,
                   rig_strvfo(rs->current_vfo), rig_strvfo(vfo));
-        cachep->freqCurr = 0; // reset current frequency so set_freq works 1st time
+        cachep->slot[CACHE_SLOT_CURR].freq = 0; // reset current frequency so set_freq works 1st time
     }
 
     rig_debug(RIG_DEBUG_TRACE, "%s: line#%d\n", __func__, __LINE__);
@@ -3321,6 +3482,7 @@ int icom_set_vfo(RIG *rig, vfo_t vfo)
     }
 
     rs->current_vfo = vfo;
+    icom_transceive_select(rig, vfo);
     rig_debug(RIG_DEBUG_TRACE, "%s: line#%d curr_vfo=%s\n", __func__, __LINE__,
               rig_strvfo(rs->current_vfo));
     RETURNFUNC2(RIG_OK);
@@ -4534,7 +4696,7 @@ int icom_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
                       val->f);
         }
 
-        if (RIG_IS_IC9700 && CACHE(rig)->freqMainA >= 1e9)
+        if (RIG_IS_IC9700 && CACHE(rig)->slot[CACHE_SLOT_MAIN_A].freq >= 1e9)
         {
             val->f /= 10;   // power scale is different for 10GHz
         }
@@ -5271,6 +5433,13 @@ int icom_set_conf(RIG *rig, hamlib_token_t token, const char *val)
 
         break;
 
+    case TOK_TRANSCEIVE_RECONCILE:
+        priv->transceive_reconcile_ms = atoi(val) * 1000;
+
+        if (priv->transceive_reconcile_ms < 0) { priv->transceive_reconcile_ms = 0; }
+
+        break;
+
     default:
         RETURNFUNC(-RIG_EINVAL);
     }
@@ -5304,6 +5473,14 @@ static int icom_get_conf2(RIG *rig, hamlib_token_t token, char *val, int val_len
     case TOK_NOXCHG: SNPRINTF(val, val_len, "%d", priv->no_xchg);
         break;
 
+    case TOK_TRANSCEIVE_RECONCILE:
+        SNPRINTF(val, val_len, "%d", priv->transceive_reconcile_ms / 1000);
+        break;
+
+    case TOK_CIV_STATS:
+        icom_civ_stats_str(rig, val, val_len);
+        break;
+
     default: RETURNFUNC(-RIG_EINVAL);
     }
 
@@ -9184,7 +9361,13 @@ static int icom_parse_spectrum_frame(RIG *rig, size_t length,
         spectrum_data_length_in_frame = length - 15;
         spectrum_data_start_in_frame = frame_data + 15;
 
-        memset(cache->spectrum_data, 0,
+        // a line cut short keeps its buffer, else the next one is taken
+        if (!cache->buffer && !(cache->buffer = spectrum_buffer_get(rig)))
+        {
+            RETURNFUNC(-RIG_ENOMEM);
+        }
+
+        memset(cache->buffer->data, 0,
                priv_caps->spectrum_scope_caps.spectrum_line_length);
 
         cache->spectrum_data_length = 0;
@@ -9203,6 +9386,12 @@ static int icom_parse_spectrum_frame(RIG *rig, size_t length,
         spectrum_data_start_in_frame = frame_data + 3;
     }
 
+    // the rest of a line whose start was missed
+    if (!cache->buffer)
+    {
+        RETURNFUNC(RIG_OK);
+    }
+
     if (spectrum_data_length_in_frame > 0)
     {
         int frame_length = priv_caps->spectrum_scope_caps.single_frame_data_length;
@@ -9219,30 +9408,33 @@ static int icom_parse_spectrum_frame(RIG *rig, size_t length,
             RETURNFUNC(-RIG_EPROTO);
         }
 
-        memcpy(cache->spectrum_data + offset, spectrum_data_start_in_frame,
+        memcpy(cache->buffer->data + offset, spectrum_data_start_in_frame,
                spectrum_data_length_in_frame);
         cache->spectrum_data_length = offset + spectrum_data_length_in_frame;
     }
 
     if (cache->spectrum_metadata_valid && division == max_division)
     {
-        struct rig_spectrum_line spectrum_line =
-        {
-            .id = spectrum_id,
-            .data_level_min = priv_caps->spectrum_scope_caps.data_level_min,
-            .data_level_max = priv_caps->spectrum_scope_caps.data_level_max,
-            .signal_strength_min = priv_caps->spectrum_scope_caps.signal_strength_min,
-            .signal_strength_max = priv_caps->spectrum_scope_caps.signal_strength_max,
-            .spectrum_mode = cache->spectrum_mode,
-            .center_freq = cache->spectrum_center_freq,
-            .span_freq = cache->spectrum_span_freq,
-            .low_edge_freq = cache->spectrum_low_edge_freq,
-            .high_edge_freq = cache->spectrum_high_edge_freq,
-            .spectrum_data_length = cache->spectrum_data_length,
-            .spectrum_data = cache->spectrum_data,
-        };
-
-        rig_fire_spectrum_event(rig, &spectrum_line);
+        struct rig_spectrum_line *spectrum_line = &cache->buffer->line;
+
+        spectrum_line->id = spectrum_id;
+        spectrum_line->data_level_min = priv_caps->spectrum_scope_caps.data_level_min;
+        spectrum_line->data_level_max = priv_caps->spectrum_scope_caps.data_level_max;
+        spectrum_line->signal_strength_min =
+            priv_caps->spectrum_scope_caps.signal_strength_min;
+        spectrum_line->signal_strength_max =
+            priv_caps->spectrum_scope_caps.signal_strength_max;
+        spectrum_line->spectrum_mode = cache->spectrum_mode;
+        spectrum_line->center_freq = cache->spectrum_center_freq;
+        spectrum_line->span_freq = cache->spectrum_span_freq;
+        spectrum_line->low_edge_freq = cache->spectrum_low_edge_freq;
+        spectrum_line->high_edge_freq = cache->spectrum_high_edge_freq;
+        spectrum_line->spectrum_data_length = cache->spectrum_data_length;
+
+        // consumers hold on to this one, the next line goes in a new buffer
+        rig_fire_spectrum_buffer(rig, cache->buffer);
+        spectrum_buffer_unref(cache->buffer);
+        cache->buffer = NULL;
 
         cache->spectrum_metadata_valid = 0;
     }
@@ -9275,6 +9467,10 @@ int icom_process_async_frame(RIG *rig, size_t frame_length,
 
     ENTERFUNC;
 
+    __atomic_add_fetch(&priv->civ_stats.async_frames, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&priv->civ_stats.bytes_received, frame_length,
+                       __ATOMIC_RELAXED);
+
     /*
      * the first 2 bytes must be 0xfe
      * the 3rd one 0x00 since this is transceive mode
@@ -9298,10 +9494,11 @@ int icom_process_async_frame(RIG *rig, size_t frame_length,
     case C_SND_FREQ:
     {
         // TODO: The freq length might be less than 4 or 5 bytes on older rigs!
-        // TODO: Disable cache timeout for frequency after first transceive packet once we figure out how to get active VFO reliably with transceive updates
-        // TODO: rig_set_cache_timeout_ms(rig, HAMLIB_CACHE_FREQ, HAMLIB_CACHE_ALWAYS);
         freq_t freq = (freq_t) from_bcd(frame + 5, (priv->civ_731_mode ? 4 : 5) * 2);
         rig_fire_freq_event(rig, RIG_VFO_CURR, freq);
+        // see icom_transceive_fresh()
+        __atomic_or_fetch(&priv->transceive_seen, ICOM_TRANSCEIVE_FREQ,
+                          __ATOMIC_RELEASE);
 
 #if 0
 
@@ -9318,10 +9515,10 @@ int icom_process_async_frame(RIG *rig, size_t frame_length,
     }
 
     case C_SND_MODE:
-        // TODO: Disable cache timeout for frequency after first transceive packet once we figure out how to get active VFO reliably with transceive updates
-        // TODO: rig_set_cache_timeout_ms(rig, HAMLIB_CACHE_MODE, HAMLIB_CACHE_ALWAYS);
         icom2rig_mode(rig, frame[5], frame[6], &mode, &width);
         rig_fire_mode_event(rig, RIG_VFO_CURR, mode, width);
+        __atomic_or_fetch(&priv->transceive_seen, ICOM_TRANSCEIVE_MODE,
+                          __ATOMIC_RELEASE);
 
         if (rs->use_cached_mode != 1)
         {
@@ -193,6 +193,8 @@ struct icom_spectrum_edge_frequency_range
     freq_t high_freq; /*!< The high edge frequency if the range in Hz */
 };
 
+struct spectrum_buffer;
+
 /**
  * \brief Cached Icom spectrum scope data.
  *
@@ -209,9 +211,31 @@ struct icom_spectrum_scope_cache
     freq_t spectrum_low_edge_freq; /*!< The low edge frequency of the current spectrum scope line being received */
     freq_t spectrum_high_edge_freq; /*!< The high edge frequency of the current spectrum scope line being received */
     size_t spectrum_data_length;     /*!< Number of bytes of 8-bit spectrum data in the data buffer. The amount of data may vary if the rig has multiple spectrum scopes, depending on the scope. */
-    unsigned char *spectrum_data; /*!< Dynamically allocated buffer for raw spectrum data */
+    struct spectrum_buffer *buffer; /*!< Pooled buffer the line is assembled in, NULL between lines */
+};
+
+/**
+ * \brief CI-V bus and transceive cache counters.
+ *
+ * Updated from both the transaction path and the async data thread, so
+ * always with __atomic builtins.  Reported by the "civ_stats" conf token.
+ */
+struct icom_civ_stats
+{
+    unsigned long frames_sent;      /*!< Command frames written */
+    unsigned long frames_received;  /*!< Reply frames read, excluding echo */
+    unsigned long async_frames;     /*!< Transceive and scope frames pushed by the rig */
+    unsigned long long bytes_sent;
+    unsigned long long bytes_received; /*!< Reply and pushed frame bytes */
+    unsigned long cache_hits;       /*!< Freq/mode gets answered from transceive data */
+    unsigned long cache_misses;     /*!< Freq/mode gets that went to the rig */
+    unsigned long reconcile_polls;  /*!< Misses that re-checked transceive data */
+    struct timespec start;          /*!< When counting started, at open */
 };
 
+#define ICOM_TRANSCEIVE_FREQ 0x01
+#define ICOM_TRANSCEIVE_MODE 0x02
+
 struct icom_priv_caps
 {
     unsigned char re_civ_addr;  /*!< The remote equipment's default CI-V address */
@@ -291,15 +315,15 @@ struct icom_priv_data
      */
     vfo_t rx_vfo_deprecated; /*!< @deprecated Use rig_state.rx_vfo */
     vfo_t tx_vfo_deprecated; /*!< @deprecated Use rig_state.tx_vfo */
-    freq_t curr_freq_deprecated; /*!< @deprecated Use rig_cache.freqCurr - Our current freq depending on which vfo is selected */
-    freq_t main_freq_deprecated; /*!< @deprecated Use rig_cache.freqMainA - Track last setting of main -- not being used yet */
-    freq_t sub_freq_deprecated;  /*!< @deprecated Use rig_cache.freqSubA - Track last setting of sub -- not being used yet */
-    freq_t maina_freq_deprecated; /*!< @deprecated Use rig_cache.freqMainA */
-    freq_t mainb_freq_deprecated; /*!< @deprecated Use rig_cache.freqMainB */
-    freq_t suba_freq_deprecated; /*!< @deprecated Use rig_cache.freqSubA */
-    freq_t subb_freq_deprecated; /*!< @deprecated Use rig_cache.freqSubB */
-    freq_t vfoa_freq_deprecated; /*!< @deprecated Use rig_cache.freqMainA - Track last setting of vfoa -- used to return last freq when ptt is asserted */
-    freq_t vfob_freq_deprecated; /*!< @deprecated Use rig_cache.freqMainB - Track last setting of vfob -- used to return last freq when ptt is asserted */
+    freq_t curr_freq_deprecated; /*!< @deprecated Use rig_cache.slot[CACHE_SLOT_CURR].freq - Our current freq depending on which vfo is selected */
+    freq_t main_freq_deprecated; /*!< @deprecated Use rig_cache.slot[CACHE_SLOT_MAIN_A].freq - Track last setting of main -- not being used yet */
+    freq_t sub_freq_deprecated;  /*!< @deprecated Use rig_cache.slot[CACHE_SLOT_SUB_A].freq - Track last setting of sub -- not being used yet */
+    freq_t maina_freq_deprecated; /*!< @deprecated Use rig_cache.slot[CACHE_SLOT_MAIN_A].freq */
+    freq_t mainb_freq_deprecated; /*!< @deprecated Use rig_cache.slot[CACHE_SLOT_MAIN_B].freq */
+    freq_t suba_freq_deprecated; /*!< @deprecated Use rig_cache.slot[CACHE_SLOT_SUB_A].freq */
+    freq_t subb_freq_deprecated; /*!< @deprecated Use rig_cache.slot[CACHE_SLOT_SUB_B].freq */
+    freq_t vfoa_freq_deprecated; /*!< @deprecated Use rig_cache.slot[CACHE_SLOT_MAIN_A].freq - Track last setting of vfoa -- used to return last freq when ptt is asserted */
+    freq_t vfob_freq_deprecated; /*!< @deprecated Use rig_cache.slot[CACHE_SLOT_MAIN_B].freq - Track last setting of vfob -- used to return last freq when ptt is asserted */
     int x25cmdfails; /*!< This will get set if the 0x25 command fails so we try just once */
     int x26cmdfails; /*!< This will get set if the 0x26 command fails so we try just once */
     int x1cx03cmdfails; /*!< This will get set if the 0x1c 0x03 command fails so we try just once */
@@ -308,7 +332,7 @@ struct icom_priv_data
     unsigned char datamode; /*!< Current datamode */
     int spectrum_scope_count; /*!< Number of spectrum scopes, calculated from caps */
     struct icom_spectrum_scope_cache spectrum_scope_cache[HAMLIB_MAX_SPECTRUM_SCOPES]; /*!< Cached Icom spectrum scope data used during reception of the data. The array index must match the scope ID. */
-    freq_t other_freq_deprecated; /*!< @deprecated Use rig_cache.freqOther - Our other freq depending on which vfo is selected */
+    freq_t other_freq_deprecated; /*!< @deprecated Use rig_cache.slot[CACHE_SLOT_OTHER].freq - Our other freq depending on which vfo is selected */
     int vfo_flag; // used to skip vfo check when frequencies are equal
     int dual_watch_main_sub; // 0=main, 1=sub
     int tone_enable;         /*!< Re-enable tone after freq change -- IC-705 bug with gpredict */
@@ -316,6 +340,11 @@ struct icom_priv_data
     int filter_usb;          /*!< Filter number to use for USB/LSB when setting mode */
     int filter_cw;           /*!< Filter number to use for CW/CWR when setting mode */
     int filter_fm;           /*!< Filter number to use for CW/CWR when setting mode */
+    int transceive_reconcile_ms; /*!< Max age of transceive freq/mode before it is polled again, 0 = always poll */
+    vfo_t transceive_vfo;    /*!< VFO we last selected on the rig, which transceive frames refer to, or RIG_VFO_NONE */
+    int transceive_seen;     /*!< ICOM_TRANSCEIVE_* items pushed by the rig since transceive_vfo was selected */
+    int64_t transceive_polled[2]; /*!< rig_cache_now_ns() of the last freq and mode poll of transceive_vfo, __atomic access */
+    struct icom_civ_stats civ_stats;
 };
 
 extern const struct ts_sc_list r8500_ts_sc_list[];
@@ -286,7 +286,7 @@ static int id5100_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
 {
     rig_debug(RIG_DEBUG_VERBOSE, "%s(%d): Sub/A vfo=%s\n", __func__, __LINE__,
               rig_strvfo(vfo));
-        *freq = CACHE(rig)->freqSubA;
+        *freq = CACHE(rig)->slot[CACHE_SLOT_SUB_A].freq;
         int cache_ms_freq, cache_ms_mode, cache_ms_width;
         pbwidth_t width;
         freq_t tfreq;
@@ -105,6 +105,8 @@ int elecraft_open(RIG *rig)
     rig_debug(RIG_DEBUG_VERBOSE, "%s called, rig version=%s\n", __func__,
               rig->caps->version);
 
+    kenwood_ai_open(rig);
+
     if (rs->auto_power_on && !priv->poweron)
     {
         rig_set_powerstat(rig, 1);
@@ -376,8 +378,8 @@ int elecraft_open(RIG *rig)
         /* get current AI state so it can be restored */
         priv->trn_state = -1;
         kenwood_get_trn(rig, &priv->trn_state);  /* ignore errors */
-        /* Currently we cannot cope with AI mode so turn it off in
-             case last client left it on */
+        /* Turn AI off in case last client left it on, it comes back on
+             later if we are running with async data */
         kenwood_set_trn(rig,
                         RIG_TRN_OFF); /* ignore status in case it's not supported */
     }
@@ -398,6 +400,8 @@ int elecraft_close(RIG *rig)
 {
     const struct kenwood_priv_data *priv = STATE(rig)->priv;
 
+    kenwood_ai_close(rig);
+
     if (priv->save_k2_ext_lvl >= 0)
     {
         int err;
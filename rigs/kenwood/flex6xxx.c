@@ -1344,7 +1344,7 @@ struct rig_caps f6k_caps =
     RIG_MODEL(RIG_MODEL_F6K),
     .model_name =       "6xxx",
     .mfg_name =     "FlexRadio",
-    .version =      "20240829.0",
+    .version =      "20240829.1",
     .copyright =        "LGPL",
     .status =       RIG_STATUS_STABLE,
     .rig_type =     RIG_TYPE_TRANSCEIVER,
@@ -1459,6 +1459,7 @@ struct rig_caps f6k_caps =
     .set_split_vfo =    kenwood_set_split_vfo,
     .get_split_vfo =    kenwood_get_split_vfo_if,
     .get_ptt =      kenwood_get_ptt,
+    .get_status =      kenwood_get_status,
     .set_ptt =      kenwood_set_ptt,
     // TODO copy over kenwood_[set|get]_level and modify to handle DSP filter values
     // correctly - use actual values instead of indices
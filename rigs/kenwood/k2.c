@@ -120,7 +120,7 @@ struct rig_caps k2_caps =
     RIG_MODEL(RIG_MODEL_K2),
     .model_name =       "K2",
     .mfg_name =     "Elecraft",
-    .version =      BACKEND_VER ".2",
+    .version =      BACKEND_VER ".3",
     .copyright =        "LGPL",
     .status =       RIG_STATUS_STABLE,
     .rig_type =     RIG_TYPE_TRANSCEIVER,
@@ -231,6 +231,7 @@ struct rig_caps k2_caps =
     .set_xit =      kenwood_set_xit,
     .get_xit =      kenwood_get_xit,
     .get_ptt =      kenwood_get_ptt,
+    .get_status =      kenwood_get_status,
     .set_ptt =      kenwood_set_ptt,
     .get_dcd =      kenwood_get_dcd,
     .set_func =     kenwood_set_func,
@@ -198,7 +198,7 @@ struct rig_caps k3_caps =
     RIG_MODEL(RIG_MODEL_K3),
     .model_name =       "K3",
     .mfg_name =     "Elecraft",
-    .version =      BACKEND_VER ".31",
+    .version =      BACKEND_VER ".32",
     .copyright =        "LGPL",
     .status =       RIG_STATUS_STABLE,
     .rig_type =     RIG_TYPE_TRANSCEIVER,
@@ -350,6 +350,10 @@ struct rig_caps k3_caps =
     .stop_voice_mem =   kenwood_stop_voice_mem,
     .power2mW =     k3_power2mW,
     .morse_qsize = 24,
+    .async_data_supported = 1,
+    .read_frame_direct =   kenwood_read_frame_direct,
+    .is_async_frame =   kenwood_is_async_frame,
+    .process_async_frame =   kenwood_process_async_frame,
     .hamlib_check_rig_caps = HAMLIB_CHECK_RIG_CAPS
 };
 
@@ -358,7 +362,7 @@ struct rig_caps k3s_caps =
     RIG_MODEL(RIG_MODEL_K3S),
     .model_name =       "K3S",
     .mfg_name =     "Elecraft",
-    .version =      BACKEND_VER ".25",
+    .version =      BACKEND_VER ".26",
     .copyright =        "LGPL",
     .status =       RIG_STATUS_STABLE,
     .rig_type =     RIG_TYPE_TRANSCEIVER,
@@ -512,6 +516,10 @@ struct rig_caps k3s_caps =
     .stop_voice_mem =   kenwood_stop_voice_mem,
     .power2mW =     k3_power2mW,
     .morse_qsize = 24,
+    .async_data_supported = 1,
+    .read_frame_direct =   kenwood_read_frame_direct,
+    .is_async_frame =   kenwood_is_async_frame,
+    .process_async_frame =   kenwood_process_async_frame,
     .hamlib_check_rig_caps = HAMLIB_CHECK_RIG_CAPS
 };
 
@@ -521,7 +529,7 @@ struct rig_caps k4_caps =
     RIG_MODEL(RIG_MODEL_K4),
     .model_name =       "K4",
     .mfg_name =     "Elecraft",
-    .version =      BACKEND_VER ".32",
+    .version =      BACKEND_VER ".33",
     .copyright =        "LGPL",
     .status =       RIG_STATUS_STABLE,
     .rig_type =     RIG_TYPE_TRANSCEIVER,
@@ -686,6 +694,10 @@ struct rig_caps k4_caps =
     .stop_voice_mem =   kenwood_stop_voice_mem,
     .power2mW =     k3_power2mW,
     .morse_qsize = 24,
+    .async_data_supported = 1,
+    .read_frame_direct =   kenwood_read_frame_direct,
+    .is_async_frame =   kenwood_is_async_frame,
+    .process_async_frame =   kenwood_process_async_frame,
     .hamlib_check_rig_caps = HAMLIB_CHECK_RIG_CAPS
 };
 
@@ -694,7 +706,7 @@ struct rig_caps kx3_caps =
     RIG_MODEL(RIG_MODEL_KX3),
     .model_name =       "KX3",
     .mfg_name =     "Elecraft",
-    .version =      BACKEND_VER ".22",
+    .version =      BACKEND_VER ".23",
     .copyright =        "LGPL",
     .status =       RIG_STATUS_STABLE,
     .rig_type =     RIG_TYPE_TRANSCEIVER,
@@ -845,6 +857,10 @@ struct rig_caps kx3_caps =
     .stop_voice_mem =   kenwood_stop_voice_mem,
     .power2mW =     k3_power2mW,
     .morse_qsize = 24,
+    .async_data_supported = 1,
+    .read_frame_direct =   kenwood_read_frame_direct,
+    .is_async_frame =   kenwood_is_async_frame,
+    .process_async_frame =   kenwood_process_async_frame,
     .hamlib_check_rig_caps = HAMLIB_CHECK_RIG_CAPS
 };
 
@@ -853,7 +869,7 @@ struct rig_caps kx2_caps =
     RIG_MODEL(RIG_MODEL_KX2),
     .model_name =       "KX2",
     .mfg_name =     "Elecraft",
-    .version =      BACKEND_VER ".21",
+    .version =      BACKEND_VER ".23",
     .copyright =        "LGPL",
     .status =       RIG_STATUS_STABLE,
     .rig_type =     RIG_TYPE_TRANSCEIVER,
@@ -979,6 +995,7 @@ struct rig_caps kx2_caps =
     .set_xit =      k3_set_xit,
     .get_xit =      kenwood_get_xit,
     .get_ptt =      kenwood_get_ptt,
+    .get_status =      kenwood_get_status,
     .set_ptt =      kenwood_set_ptt,
     .get_dcd =      kenwood_get_dcd,
     .set_func =     k3_set_func,
@@ -1000,6 +1017,10 @@ struct rig_caps kx2_caps =
     .wait_morse =       rig_wait_morse,
     .stop_morse =       k3_stop_morse,
     .power2mW =     k3_power2mW,
+    .async_data_supported = 1,
+    .read_frame_direct =   kenwood_read_frame_direct,
+    .is_async_frame =   kenwood_is_async_frame,
+    .process_async_frame =   kenwood_process_async_frame,
     .hamlib_check_rig_caps = HAMLIB_CHECK_RIG_CAPS
 };
 
@@ -191,6 +191,10 @@ struct kenwood_priv_data
     const char *voice_mem_start, *voice_mem_stop; // Commands to do the thing to do
     rmode_t last_mode_pc; // last mode memory for PC command
     int power_now, power_min, power_max;
+    int ai_pending;  /* turn AI on once the async data handler runs */
+    int ai_active;   /* rig pushes FA/FB/MD/IF/TX/RX, see kenwood_is_async_frame() */
+    int ai_reply;    /* 2 char prefix of the reply a transaction waits for, 0 if none */
+    int ai_data_submode; /* Elecraft DT sub-mode seen in AI mode, -1 if unknown */
 };
 
 
@@ -214,6 +218,14 @@ int kenwood_init(RIG *rig);
 int kenwood_cleanup(RIG *rig);
 int kenwood_open(RIG *rig);
 int kenwood_close(RIG *rig);
+int kenwood_read_frame_direct(RIG *rig, size_t buffer_length,
+                              const unsigned char *buffer);
+int kenwood_is_async_frame(RIG *rig, size_t frame_length,
+                           const unsigned char *frame);
+int kenwood_process_async_frame(RIG *rig, size_t frame_length,
+                                const unsigned char *frame);
+void kenwood_ai_open(RIG *rig);
+void kenwood_ai_close(RIG *rig);
 
 int kenwood_set_vfo(RIG *rig, vfo_t vfo);
 int kenwood_set_vfo_main_sub(RIG *rig, vfo_t vfo);
@@ -257,6 +269,7 @@ int kenwood_set_ant(RIG *rig, vfo_t vfo, ant_t ant, value_t option);
 int kenwood_set_ant_no_ack(RIG *rig, vfo_t vfo, ant_t ant, value_t option);
 int kenwood_get_ant(RIG *rig, vfo_t vfo, ant_t dummy, value_t *option, ant_t *ant_curr, ant_t *ant_tx, ant_t *ant_rx);
 int kenwood_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt);
+int kenwood_get_status(RIG *rig, vfo_t vfo, struct rig_vfo_status *status);
 int kenwood_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt);
 int kenwood_set_ptt_safe(RIG *rig, vfo_t vfo, ptt_t ptt);
 int kenwood_get_dcd(RIG *rig, vfo_t vfo, dcd_t *dcd);
@@ -265,6 +278,7 @@ int kenwood_set_mem(RIG *rig, vfo_t vfo, int ch);
 int kenwood_get_mem(RIG *rig, vfo_t vfo, int *ch);
 int kenwood_get_mem_if(RIG *rig, vfo_t vfo, int *ch);
 int kenwood_get_channel(RIG *rig, vfo_t vfo, channel_t *chan, int read_only);
+extern const struct rig_mem_batch kenwood_mem_batch;
 int kenwood_set_channel(RIG *rig, vfo_t vfo, const channel_t *chan);
 int kenwood_scan(RIG *rig, vfo_t vfo, scan_t scan, int ch);
 const char *kenwood_get_info(RIG *rig);
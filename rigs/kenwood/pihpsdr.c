@@ -100,7 +100,7 @@ struct rig_caps pihpsdr_caps =
     RIG_MODEL(RIG_MODEL_HPSDR),
     .model_name = "PiHPSDR",
     .mfg_name =  "OpenHPSDR",
-    .version =  BACKEND_VER ".2",
+    .version =  BACKEND_VER ".3",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_TRANSCEIVER,
@@ -287,6 +287,7 @@ struct rig_caps pihpsdr_caps =
     .set_ctcss_sql =  kenwood_set_ctcss_sql,
     .get_ctcss_sql =  kenwood_get_ctcss_sql,
     .get_ptt =  kenwood_get_ptt,
+    .get_status =  kenwood_get_status,
     .set_ptt =  kenwood_set_ptt,
     .get_dcd =  kenwood_get_dcd,
     .set_func =  kenwood_set_func,
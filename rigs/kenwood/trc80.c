@@ -65,7 +65,7 @@ struct rig_caps trc80_caps =
     RIG_MODEL(RIG_MODEL_TRC80),
     .model_name = "TRC-80",
     .mfg_name =  "Kenwood",
-    .version =  BACKEND_VER ".0",
+    .version =  BACKEND_VER ".1",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_TRANSCEIVER,
@@ -160,6 +160,7 @@ struct rig_caps trc80_caps =
     .set_mode =  kenwood_set_mode,
     .get_mode =  kenwood_get_mode,
     .get_ptt =  kenwood_get_ptt,
+    .get_status =  kenwood_get_status,
     .set_ptt =  kenwood_set_ptt,
     .get_dcd =  kenwood_get_dcd,
     .set_func =  kenwood_set_func,
@@ -169,6 +170,7 @@ struct rig_caps trc80_caps =
     .set_mem =  kenwood_set_mem,
     .get_mem =  kenwood_get_mem,
     .get_channel =  kenwood_get_channel,
+    .mem_batch = &kenwood_mem_batch,
     .scan =  kenwood_scan,
     .set_powerstat =  kenwood_set_powerstat,
     .get_powerstat =  kenwood_get_powerstat,
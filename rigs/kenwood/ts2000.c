@@ -1687,7 +1687,7 @@ struct rig_caps ts2000_caps =
     RIG_MODEL(RIG_MODEL_TS2000),
     .model_name = "TS-2000",
     .mfg_name =  "Kenwood",
-    .version =  BACKEND_VER ".2",
+    .version =  BACKEND_VER ".3",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_TRANSCEIVER,
@@ -1906,6 +1906,7 @@ struct rig_caps ts2000_caps =
     .set_ctcss_sql =  kenwood_set_ctcss_sql,
     .get_ctcss_sql =  kenwood_get_ctcss_sql,
     .get_ptt =  kenwood_get_ptt,
+    .get_status =  kenwood_get_status,
     .set_ptt =  kenwood_set_ptt,
     .get_dcd =  kenwood_get_dcd,
     .set_func =  ts2000_set_func,
@@ -1946,7 +1947,7 @@ struct rig_caps sdrconsole_caps =
     RIG_MODEL(RIG_MODEL_SDRCONSOLE),
     .model_name = "SDRConsole",
     .mfg_name =  "SDR Radio",
-    .version =  BACKEND_VER ".3",
+    .version =  BACKEND_VER ".4",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_TRANSCEIVER,
@@ -2165,6 +2166,7 @@ struct rig_caps sdrconsole_caps =
     //.set_ctcss_sql =  kenwood_set_ctcss_sql,
     //.get_ctcss_sql =  kenwood_get_ctcss_sql,
     .get_ptt =  kenwood_get_ptt,
+    .get_status =  kenwood_get_status,
     .set_ptt =  kenwood_set_ptt,
     //.get_dcd =  kenwood_get_dcd,
     //.set_func =  ts2000_set_func,
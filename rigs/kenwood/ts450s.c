@@ -122,7 +122,7 @@ struct rig_caps ts450s_caps =
     RIG_MODEL(RIG_MODEL_TS450S),
     .model_name = "TS-450S",
     .mfg_name   = "Kenwood",
-    .version    = BACKEND_VER ".0",
+    .version    = BACKEND_VER ".1",
     .copyright  = "LGPL",
     .status     = RIG_STATUS_STABLE,
     .rig_type   = RIG_TYPE_TRANSCEIVER,
@@ -245,6 +245,7 @@ struct rig_caps ts450s_caps =
     .set_split_vfo = kenwood_set_split_vfo,
     .get_split_vfo = kenwood_get_split_vfo_if,
     .get_ptt = kenwood_get_ptt,
+    .get_status = kenwood_get_status,
     .set_ptt = kenwood_set_ptt,
     .get_dcd = kenwood_get_dcd,
     .set_func = kenwood_set_func,
@@ -263,6 +264,7 @@ struct rig_caps ts450s_caps =
     .reset = kenwood_reset,
     .scan = kenwood_scan,
     .get_channel = kenwood_get_channel,
+    .mem_batch = &kenwood_mem_batch,
     .set_channel = kenwood_set_channel,
     .hamlib_check_rig_caps = HAMLIB_CHECK_RIG_CAPS
 };
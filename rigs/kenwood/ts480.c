@@ -1323,7 +1323,7 @@ struct rig_caps ts480_caps =
     RIG_MODEL(RIG_MODEL_TS480),
     .model_name = "TS-480",
     .mfg_name = "Kenwood",
-    .version = BACKEND_VER ".3",
+    .version = BACKEND_VER ".4",
     .copyright = "LGPL",
     .status = RIG_STATUS_STABLE,
     .rig_type = RIG_TYPE_TRANSCEIVER,
@@ -1500,6 +1500,7 @@ struct rig_caps ts480_caps =
     .set_split_vfo = kenwood_set_split_vfo,
     .get_split_vfo = kenwood_get_split_vfo_if,
     .get_ptt = kenwood_get_ptt,
+    .get_status = kenwood_get_status,
     .set_ptt = kenwood_set_ptt,
     .get_dcd = kenwood_get_dcd,
     .set_powerstat = kenwood_set_powerstat,
@@ -1538,7 +1539,7 @@ struct rig_caps trudx_caps =
     RIG_MODEL(RIG_MODEL_TRUSDX),
     .model_name = "(tr)uSDX",
     .mfg_name = "DL2MAN",
-    .version = BACKEND_VER ".1",
+    .version = BACKEND_VER ".2",
     .copyright = "LGPL",
     .status = RIG_STATUS_STABLE,
     .rig_type = RIG_TYPE_TRANSCEIVER,
@@ -1710,6 +1711,7 @@ struct rig_caps trudx_caps =
     .set_split_vfo = kenwood_set_split_vfo,
     .get_split_vfo = kenwood_get_split_vfo_if,
     .get_ptt = kenwood_get_ptt,
+    .get_status = kenwood_get_status,
     .set_ptt = kenwood_set_ptt,
     .get_dcd = kenwood_get_dcd,
     .set_powerstat = kenwood_set_powerstat,
@@ -1748,7 +1750,7 @@ struct rig_caps qrplabs_caps =
     RIG_MODEL(RIG_MODEL_QRPLABS),
     .model_name = "QCX/QDX",
     .mfg_name = "QRPLabs",
-    .version = BACKEND_VER ".4",
+    .version = BACKEND_VER ".5",
     .copyright = "LGPL",
     .status = RIG_STATUS_STABLE,
     .rig_type = RIG_TYPE_TRANSCEIVER,
@@ -1920,6 +1922,7 @@ struct rig_caps qrplabs_caps =
     .set_split_vfo = kenwood_set_split_vfo,
     .get_split_vfo = kenwood_get_split_vfo_if,
     .get_ptt = kenwood_get_ptt,
+    .get_status = kenwood_get_status,
     .set_ptt = kenwood_set_ptt,
     .get_dcd = kenwood_get_dcd,
     .get_info = kenwood_ts480_get_info,
@@ -1949,7 +1952,7 @@ struct rig_caps qrplabs_qmx_caps =
     RIG_MODEL(RIG_MODEL_QRPLABS_QMX),
     .model_name = "QMX",
     .mfg_name = "QRPLabs",
-    .version = BACKEND_VER ".2",
+    .version = BACKEND_VER ".3",
     .copyright = "LGPL",
     .status = RIG_STATUS_BETA,
     .rig_type = RIG_TYPE_TRANSCEIVER,
@@ -2000,6 +2003,7 @@ struct rig_caps qrplabs_qmx_caps =
     .set_split_vfo = kenwood_set_split_vfo,
     .get_split_vfo = kenwood_get_split_vfo_if,
     .get_ptt = kenwood_get_ptt,
+    .get_status = kenwood_get_status,
     .set_ptt = kenwood_set_ptt,
     .get_info = kenwood_ts480_get_info,
     .get_clock = qrplabs_get_clock,
@@ -2016,7 +2020,7 @@ struct rig_caps pt8000a_caps =
     RIG_MODEL(RIG_MODEL_PT8000A),
     .model_name = "PT-8000A",
     .mfg_name = "Hilberling",
-    .version = BACKEND_VER ".2",
+    .version = BACKEND_VER ".3",
     .copyright = "LGPL",
     .status = RIG_STATUS_STABLE,
     .rig_type = RIG_TYPE_TRANSCEIVER,
@@ -2169,6 +2173,7 @@ struct rig_caps pt8000a_caps =
     .set_split_vfo = kenwood_set_split_vfo,
     .get_split_vfo = kenwood_get_split_vfo_if,
     .get_ptt = kenwood_get_ptt,
+    .get_status = kenwood_get_status,
     .set_ptt = kenwood_set_ptt,
     .get_dcd = kenwood_get_dcd,
 //    .set_powerstat = kenwood_set_powerstat,
@@ -2198,7 +2203,7 @@ struct rig_caps sdruno_caps =
     RIG_MODEL(RIG_MODEL_SDRUNO),
     .model_name = "SDRUno",
     .mfg_name = "SDRPlay",
-    .version = BACKEND_VER ".3",
+    .version = BACKEND_VER ".4",
     .copyright = "LGPL",
     .status = RIG_STATUS_STABLE,
     .rig_type = RIG_TYPE_RECEIVER,
@@ -2325,6 +2330,7 @@ struct rig_caps sdruno_caps =
     .set_split_vfo = kenwood_set_split_vfo,
     .get_split_vfo = kenwood_get_split_vfo_if,
     .get_ptt = kenwood_get_ptt,
+    .get_status = kenwood_get_status,
     .set_ptt = kenwood_set_ptt,
     .get_dcd = kenwood_get_dcd,
     .set_powerstat = kenwood_set_powerstat,
@@ -2407,11 +2413,11 @@ static int malachite_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
     ENTERFUNC;
 
     rig_debug(RIG_DEBUG_TRACE, "%s: freqMainA=%g, freq=%g\n", __func__,
-              cachep->freqMainA, freq);
+              cachep->slot[CACHE_SLOT_MAIN_A].freq, freq);
 
-    if ((cachep->freqMainA < 400000000 && freq >= 400000000)
-            || (cachep->freqMainA >= 400000000 && freq < 400000000)
-            || cachep->freqMainA == 0)
+    if ((cachep->slot[CACHE_SLOT_MAIN_A].freq < 400000000 && freq >= 400000000)
+            || (cachep->slot[CACHE_SLOT_MAIN_A].freq >= 400000000 && freq < 400000000)
+            || cachep->slot[CACHE_SLOT_MAIN_A].freq == 0)
     {
         // Malachite has a bug where it takes two freq set to make it work
         // under band changes -- so we just do this all the time
@@ -52,7 +52,7 @@ struct rig_caps ts50s_caps =
     RIG_MODEL(RIG_MODEL_TS50),
     .model_name = "TS-50S",
     .mfg_name =  "Kenwood",
-    .version =  BACKEND_VER ".1",
+    .version =  BACKEND_VER ".2",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_MOBILE,
@@ -194,6 +194,7 @@ struct rig_caps ts50s_caps =
     .set_ctcss_tone =  kenwood_set_ctcss_tone,
     .get_ctcss_tone =  kenwood_get_ctcss_tone,
     .get_ptt =  kenwood_get_ptt,
+    .get_status =  kenwood_get_status,
     .set_ptt =  kenwood_set_ptt,
     .get_dcd =  kenwood_get_dcd,
     .set_func =  kenwood_set_func,
@@ -914,7 +914,7 @@ struct rig_caps ts570s_caps =
     RIG_MODEL(RIG_MODEL_TS570S),
     .model_name = "TS-570S",
     .mfg_name =  "Kenwood",
-    .version =  BACKEND_VER ".3",
+    .version =  BACKEND_VER ".4",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_TRANSCEIVER,
@@ -1064,6 +1064,7 @@ struct rig_caps ts570s_caps =
     .set_ctcss_tone =  kenwood_set_ctcss_tone,
     .get_ctcss_tone =  kenwood_get_ctcss_tone,
     .get_ptt =  kenwood_get_ptt,
+    .get_status =  kenwood_get_status,
     .set_ptt =  kenwood_set_ptt,
     .get_dcd =  kenwood_get_dcd,
     .set_func =  ts570_set_func,
@@ -1078,6 +1079,7 @@ struct rig_caps ts570s_caps =
     .set_mem =  kenwood_set_mem,
     .get_mem =  kenwood_get_mem,
     .get_channel = kenwood_get_channel,
+    .mem_batch = &kenwood_mem_batch,
     .set_channel = ts570_set_channel,
     .set_trn =  kenwood_set_trn,
     .get_trn =  kenwood_get_trn,
@@ -1100,7 +1102,7 @@ struct rig_caps ts570d_caps =
     RIG_MODEL(RIG_MODEL_TS570D),
     .model_name = "TS-570D",
     .mfg_name =  "Kenwood",
-    .version =  BACKEND_VER ".1",
+    .version =  BACKEND_VER ".2",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_TRANSCEIVER,
@@ -1257,6 +1259,7 @@ struct rig_caps ts570d_caps =
     .set_ctcss_tone =  kenwood_set_ctcss_tone,
     .get_ctcss_tone =  kenwood_get_ctcss_tone,
     .get_ptt =  kenwood_get_ptt,
+    .get_status =  kenwood_get_status,
     .set_ptt =  kenwood_set_ptt,
     .get_dcd =  kenwood_get_dcd,
     .set_func =  ts570_set_func,
@@ -1271,6 +1274,7 @@ struct rig_caps ts570d_caps =
     .set_mem =  kenwood_set_mem,
     .get_mem =  kenwood_get_mem,
     .get_channel = kenwood_get_channel,
+    .mem_batch = &kenwood_mem_batch,
     .set_channel = ts570_set_channel,
     .set_trn =  kenwood_set_trn,
     .get_trn =  kenwood_get_trn,
@@ -241,7 +241,7 @@ static int ts590_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
     if (!sf_fails)
     {
         SNPRINTF(cmd, sizeof(cmd), "SF%d%011.0f%c", vfo == RIG_VFO_A ? 0 : 1,
-                 vfo == RIG_VFO_A ? CACHE(rig)->freqMainA : CACHE(rig)->freqMainB,
+                 vfo == RIG_VFO_A ? CACHE(rig)->slot[CACHE_SLOT_MAIN_A].freq : CACHE(rig)->slot[CACHE_SLOT_MAIN_B].freq,
                  c);
         retval = kenwood_transaction(rig, cmd, NULL, 0);
     }
@@ -1716,7 +1716,7 @@ struct rig_caps ts590_caps =
     RIG_MODEL(RIG_MODEL_TS590S),
     .model_name = "TS-590S",
     .mfg_name = "Kenwood",
-    .version = BACKEND_VER ".18",
+    .version = BACKEND_VER ".19",
     .copyright = "LGPL",
     .status = RIG_STATUS_STABLE,
     .rig_type = RIG_TYPE_TRANSCEIVER,
@@ -1890,6 +1890,7 @@ struct rig_caps ts590_caps =
     .set_split_vfo = kenwood_set_split_vfo,
     .get_split_vfo = kenwood_get_split_vfo_if,
     .get_ptt = kenwood_get_ptt,
+    .get_status = kenwood_get_status,
     .set_ptt = kenwood_set_ptt,
     .get_dcd = kenwood_get_dcd,
     .set_powerstat = kenwood_set_powerstat,
@@ -1940,7 +1941,7 @@ struct rig_caps fx4_caps =
     RIG_MODEL(RIG_MODEL_FX4),
     .model_name = "FX4/C/CR/L",
     .mfg_name = "BG2FX",
-    .version = BACKEND_VER ".11",
+    .version = BACKEND_VER ".12",
     .copyright = "LGPL",
     .status = RIG_STATUS_STABLE,
     .rig_type = RIG_TYPE_TRANSCEIVER,
@@ -2104,6 +2105,7 @@ struct rig_caps fx4_caps =
     .set_split_vfo = kenwood_set_split_vfo,
     .get_split_vfo = kenwood_get_split_vfo_if,
     .get_ptt = kenwood_get_ptt,
+    .get_status = kenwood_get_status,
     .set_ptt = kenwood_set_ptt,
     .get_dcd = kenwood_get_dcd,
     .set_powerstat = kenwood_set_powerstat,
@@ -2151,7 +2153,7 @@ struct rig_caps ts590sg_caps =
     RIG_MODEL(RIG_MODEL_TS590SG),
     .model_name = "TS-590SG",
     .mfg_name = "Kenwood",
-    .version = BACKEND_VER ".12",
+    .version = BACKEND_VER ".13",
     .copyright = "LGPL",
     .status = RIG_STATUS_STABLE,
     .rig_type = RIG_TYPE_TRANSCEIVER,
@@ -2325,6 +2327,7 @@ struct rig_caps ts590sg_caps =
     .set_split_vfo = kenwood_set_split_vfo,
     .get_split_vfo = kenwood_get_split_vfo_if,
     .get_ptt = kenwood_get_ptt,
+    .get_status = kenwood_get_status,
     .set_ptt = kenwood_set_ptt,
     .get_dcd = kenwood_get_dcd,
     .set_powerstat = kenwood_set_powerstat,
@@ -69,7 +69,7 @@ struct rig_caps ts790_caps =
     RIG_MODEL(RIG_MODEL_TS790),
     .model_name = "TS-790",
     .mfg_name =  "Kenwood",
-    .version =  BACKEND_VER ".0",
+    .version =  BACKEND_VER ".1",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_TRANSCEIVER,
@@ -197,6 +197,7 @@ struct rig_caps ts790_caps =
     .set_ctcss_tone =  kenwood_set_ctcss_tone,
     .get_ctcss_tone =  kenwood_get_ctcss_tone,
     .get_ptt =  kenwood_get_ptt,
+    .get_status =  kenwood_get_status,
     .set_ptt =  kenwood_set_ptt,
     .get_dcd =  kenwood_get_dcd,
     .set_func =  kenwood_set_func,
@@ -209,6 +210,7 @@ struct rig_caps ts790_caps =
     .get_mem =  kenwood_get_mem,
     .set_channel = kenwood_set_channel,
     .get_channel = kenwood_get_channel,
+    .mem_batch = &kenwood_mem_batch,
     .set_trn =  kenwood_set_trn,
     .get_trn =  kenwood_get_trn,
     .get_info =  kenwood_get_info,
@@ -101,7 +101,7 @@ struct rig_caps ts850_caps =
     RIG_MODEL(RIG_MODEL_TS850),
     .model_name = "TS-850",
     .mfg_name =  "Kenwood",
-    .version =  BACKEND_VER ".0",
+    .version =  BACKEND_VER ".1",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_TRANSCEIVER,
@@ -239,6 +239,7 @@ struct rig_caps ts850_caps =
     .set_ctcss_tone = kenwood_set_ctcss_tone_tn,
     .get_ctcss_tone = kenwood_get_ctcss_tone,
     .get_ptt =  kenwood_get_ptt,
+    .get_status =  kenwood_get_status,
     .set_ptt =  kenwood_set_ptt_safe,
     .set_func = kenwood_set_func,
     .get_func = kenwood_get_func,
@@ -248,6 +249,7 @@ struct rig_caps ts850_caps =
     .set_mem =  kenwood_set_mem,
     .get_mem =  kenwood_get_mem_if,
     .get_channel = kenwood_get_channel,
+    .mem_batch = &kenwood_mem_batch,
     .set_channel = ts850_set_channel,
     .set_trn =  kenwood_set_trn,
     .hamlib_check_rig_caps = HAMLIB_CHECK_RIG_CAPS
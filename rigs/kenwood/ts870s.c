@@ -539,7 +539,7 @@ struct rig_caps ts870s_caps =
     RIG_MODEL(RIG_MODEL_TS870S),
     .model_name = "TS-870S",
     .mfg_name =  "Kenwood",
-    .version =  BACKEND_VER ".1",
+    .version =  BACKEND_VER ".2",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_TRANSCEIVER,
@@ -667,6 +667,7 @@ struct rig_caps ts870s_caps =
     .set_ctcss_tone =  kenwood_set_ctcss_tone,
     .get_ctcss_tone =  kenwood_get_ctcss_tone,
     .get_ptt =  kenwood_get_ptt,
+    .get_status =  kenwood_get_status,
     .set_ptt =  kenwood_set_ptt,
     .get_dcd =  kenwood_get_dcd,
     .set_func =  kenwood_set_func,
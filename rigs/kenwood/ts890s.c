@@ -538,7 +538,7 @@ struct rig_caps ts890s_caps =
     RIG_MODEL(RIG_MODEL_TS890S),
     .model_name = "TS-890S",
     .mfg_name = "Kenwood",
-    .version = BACKEND_VER ".16",
+    .version = BACKEND_VER ".18",
     .copyright = "LGPL",
     .status = RIG_STATUS_STABLE,
     .rig_type = RIG_TYPE_TRANSCEIVER,
@@ -659,6 +659,7 @@ struct rig_caps ts890s_caps =
     .priv = (void *)& ts890s_priv_caps,
     .rig_init = kenwood_init,
     .rig_open = kenwood_open,
+    .rig_close = kenwood_close,
     .rig_cleanup = kenwood_cleanup,
     .set_freq = kenwood_set_freq,
     .get_freq = kenwood_get_freq,
@@ -678,6 +679,7 @@ struct rig_caps ts890s_caps =
     .set_ctcss_sql = kenwood_set_ctcss_sql,
     .get_ctcss_sql = kenwood_get_ctcss_sql,
     .get_ptt = kenwood_get_ptt,
+    .get_status = kenwood_get_status,
     .set_ptt = kenwood_set_ptt,
     .get_dcd = kenwood_get_dcd,
     .set_powerstat = kenwood_set_powerstat,
@@ -722,5 +724,9 @@ struct rig_caps ts890s_caps =
     .get_clock = kenwood_get_clock,
     .set_clock = kenwood_set_clock,
     .morse_qsize = 24,
+    .async_data_supported = 1,
+    .read_frame_direct = kenwood_read_frame_direct,
+    .is_async_frame = kenwood_is_async_frame,
+    .process_async_frame = kenwood_process_async_frame,
     .hamlib_check_rig_caps = HAMLIB_CHECK_RIG_CAPS
 };
@@ -79,7 +79,7 @@ struct rig_caps ts940_caps =
     RIG_MODEL(RIG_MODEL_TS940),
     .model_name = "TS-940S",
     .mfg_name =  "Kenwood",
-    .version =  BACKEND_VER ".0",
+    .version =  BACKEND_VER ".1",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_TRANSCEIVER,
@@ -179,6 +179,7 @@ struct rig_caps ts940_caps =
     .get_split_vfo =  kenwood_get_split_vfo_if,
     .set_ptt =  kenwood_set_ptt,
     .get_ptt =  kenwood_get_ptt,
+    .get_status =  kenwood_get_status,
     .set_func =  kenwood_set_func,
     .vfo_op =  kenwood_vfo_op,
     .set_mem =  kenwood_set_mem,
@@ -187,6 +188,7 @@ struct rig_caps ts940_caps =
     .scan =  kenwood_scan,
     .set_channel = kenwood_set_channel,
     .get_channel = kenwood_get_channel,
+    .mem_batch = &kenwood_mem_batch,
     .hamlib_check_rig_caps = HAMLIB_CHECK_RIG_CAPS
 };
 
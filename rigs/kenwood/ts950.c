@@ -68,7 +68,7 @@ struct rig_caps ts950s_caps =
     RIG_MODEL(RIG_MODEL_TS950S),
     .model_name = "TS-950S",
     .mfg_name =  "Kenwood",
-    .version =  BACKEND_VER ".1",
+    .version =  BACKEND_VER ".2",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_TRANSCEIVER,
@@ -189,6 +189,7 @@ struct rig_caps ts950s_caps =
     .set_ctcss_tone =  kenwood_set_ctcss_tone,
     .get_ctcss_tone =  kenwood_get_ctcss_tone,
     .get_ptt =  kenwood_get_ptt,
+    .get_status =  kenwood_get_status,
     .set_ptt =  kenwood_set_ptt,
     .get_dcd =  kenwood_get_dcd,
     /* Things that the '950 doesn't do ...
@@ -215,7 +216,7 @@ struct rig_caps ts950sdx_caps =
     RIG_MODEL(RIG_MODEL_TS950SDX),
     .model_name = "TS-950SDX",
     .mfg_name =  "Kenwood",
-    .version =  BACKEND_VER ".1",
+    .version =  BACKEND_VER ".2",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_TRANSCEIVER,
@@ -335,6 +336,7 @@ struct rig_caps ts950sdx_caps =
     .set_ctcss_tone =  kenwood_set_ctcss_tone,
     .get_ctcss_tone =  kenwood_get_ctcss_tone,
     .get_ptt =  kenwood_get_ptt,
+    .get_status =  kenwood_get_status,
     .set_ptt =  kenwood_set_ptt,
     .get_dcd =  kenwood_get_dcd,
     /* Things that the '950 doesn't do ...
@@ -135,7 +135,7 @@ struct rig_caps ts990s_caps =
     RIG_MODEL(RIG_MODEL_TS990S),
     .model_name = "TS-990S",
     .mfg_name =  "Kenwood",
-    .version =  BACKEND_VER ".7",
+    .version =  BACKEND_VER ".8",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_TRANSCEIVER,
@@ -382,6 +382,10 @@ struct rig_caps ts990s_caps =
     .get_clock = kenwood_get_clock,
     .set_clock = kenwood_set_clock,
     .morse_qsize = 24,
+    .async_data_supported = 1,
+    .read_frame_direct = kenwood_read_frame_direct,
+    .is_async_frame = kenwood_is_async_frame,
+    .process_async_frame = kenwood_process_async_frame,
     .hamlib_check_rig_caps = HAMLIB_CHECK_RIG_CAPS
 };
 
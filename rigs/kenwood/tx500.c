@@ -127,7 +127,7 @@ struct rig_caps tx500_caps =
     RIG_MODEL(RIG_MODEL_LAB599_TX500),
     .model_name = "TX-500",
     .mfg_name =  "Lab599",
-    .version =  BACKEND_VER ".3",
+    .version =  BACKEND_VER ".4",
     .copyright =  "LGPL",
     .status =  RIG_STATUS_STABLE,
     .rig_type =  RIG_TYPE_TRANSCEIVER,
@@ -302,6 +302,7 @@ struct rig_caps tx500_caps =
     .set_ctcss_sql =  kenwood_set_ctcss_sql,
     .get_ctcss_sql =  kenwood_get_ctcss_sql,
     .get_ptt =  kenwood_get_ptt,
+    .get_status =  kenwood_get_status,
     .set_ptt =  kenwood_set_ptt,
     .get_dcd =  kenwood_get_dcd,
     .set_func =  kenwood_set_func,
@@ -859,12 +859,12 @@ static int ft1000mp_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
     {
     case RIG_VFO_A:
         cmd_index = FT1000MP_NATIVE_FREQA_SET;
-        CACHE(rig)->freqMainA = freq;
+        CACHE(rig)->slot[CACHE_SLOT_MAIN_A].freq = freq;
         break;
 
     case RIG_VFO_B:
         cmd_index = FT1000MP_NATIVE_FREQB_SET;
-        CACHE(rig)->freqMainB = freq;
+        CACHE(rig)->slot[CACHE_SLOT_MAIN_B].freq = freq;
         break;
 
     case RIG_VFO_MEM:
@@ -1850,8 +1850,8 @@ static int ft1000mp_set_split_freq_mode(RIG *rig, vfo_t vfo, freq_t freq,
 
     if (retval == RIG_OK)
     {
-        CACHE(rig)->freqMainB = freq;
-        CACHE(rig)->modeMainB = mode;
+        CACHE(rig)->slot[CACHE_SLOT_MAIN_B].freq = freq;
+        CACHE(rig)->slot[CACHE_SLOT_MAIN_B].mode = mode;
     }
 
     RETURNFUNC(retval);
@@ -1875,8 +1875,8 @@ static int ft1000mp_get_split_freq_mode(RIG *rig, vfo_t vfo, freq_t *freq,
 
     if (retval == RIG_OK)
     {
-        CACHE(rig)->freqMainB = *freq;
-        CACHE(rig)->modeMainB = *mode;
+        CACHE(rig)->slot[CACHE_SLOT_MAIN_B].freq = *freq;
+        CACHE(rig)->slot[CACHE_SLOT_MAIN_B].mode = *mode;
     }
 
     RETURNFUNC(retval);
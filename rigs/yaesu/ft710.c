@@ -121,7 +121,7 @@ struct rig_caps ft710_caps =
     RIG_MODEL(RIG_MODEL_FT710),
     .model_name =         "FT-710",
     .mfg_name =           "Yaesu",
-    .version =            NEWCAT_VER ".7",
+    .version =            NEWCAT_VER ".9",
     .copyright =          "LGPL",
     .status =             RIG_STATUS_STABLE,
     .rig_type =           RIG_TYPE_TRANSCEIVER,
@@ -276,6 +276,7 @@ struct rig_caps ft710_caps =
     .get_vfo =            newcat_get_vfo,
     .set_ptt =            newcat_set_ptt,
     .get_ptt =            newcat_get_ptt,
+    .get_status =         newcat_get_status,
     .set_split_vfo =      newcat_set_split_vfo,
     .get_split_vfo =      newcat_get_split_vfo,
     .set_rit =            newcat_set_clarifier_frequency,
@@ -320,5 +321,9 @@ struct rig_caps ft710_caps =
     .send_voice_mem =     newcat_send_voice_mem,
     .stop_voice_mem =     newcat_stop_voice_mem,
     .morse_qsize =        50,
+    .async_data_supported = 1,
+    .read_frame_direct =  newcat_read_frame_direct,
+    .is_async_frame =     newcat_is_async_frame,
+    .process_async_frame = newcat_process_async_frame,
     .hamlib_check_rig_caps = HAMLIB_CHECK_RIG_CAPS
 };
@@ -588,13 +588,13 @@ int ft747_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
 
     rig_debug(RIG_DEBUG_VERBOSE,
               "%s: called vfo=%s, freqMainA=%.0f, freqMainB=%.0f\n", __func__,
-              rig_strvfo(vfo), cachep->freqMainA, cachep->freqMainB);
+              rig_strvfo(vfo), cachep->slot[CACHE_SLOT_MAIN_A].freq, cachep->slot[CACHE_SLOT_MAIN_B].freq);
 
     if (vfo == RIG_VFO_CURR) { vfo = cachep->vfo; }
 
     if (cachep->ptt == RIG_PTT_ON)
     {
-        *freq = RIG_VFO_B ? cachep->freqMainB : cachep->freqMainA;
+        *freq = RIG_VFO_B ? cachep->slot[CACHE_SLOT_MAIN_B].freq : cachep->slot[CACHE_SLOT_MAIN_A].freq;
         return RIG_OK;
     }
 
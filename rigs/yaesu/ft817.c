@@ -873,7 +873,7 @@ static int ft817_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
     // we can't query VFOB while in transmit and split mode
     if (cachep->ptt && vfo == RIG_VFO_B && cachep->split)
     {
-        *freq = cachep->freqMainB;
+        *freq = cachep->slot[CACHE_SLOT_MAIN_B].freq;
         return RIG_OK;
     }
 
@@ -137,7 +137,7 @@ struct rig_caps ft891_caps =
     RIG_MODEL(RIG_MODEL_FT891),
     .model_name =         "FT-891",
     .mfg_name =           "Yaesu",
-    .version =            NEWCAT_VER ".11",
+    .version =            NEWCAT_VER ".12",
     .copyright =          "LGPL",
     .status =             RIG_STATUS_STABLE,
     .rig_type =           RIG_TYPE_TRANSCEIVER,
@@ -305,6 +305,7 @@ struct rig_caps ft891_caps =
     .get_mode =           newcat_get_mode,
     .set_ptt =            newcat_set_ptt,
     .get_ptt =            newcat_get_ptt,
+    .get_status =         newcat_get_status,
     .set_split_vfo =      ft891_set_split_vfo,
     .get_split_vfo =      ft891_get_split_vfo,
     .get_split_mode =     ft891_get_split_mode,
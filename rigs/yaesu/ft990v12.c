@@ -704,7 +704,7 @@ int ft990v12_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
     else
     {
         // M0EZP: Uni use cache
-// *freq = vfo == RIG_VFO_A ? CACHE(rig)->freqMainA : CACHE(rig)->freqMainB;
+// *freq = vfo == RIG_VFO_A ? CACHE(rig)->slot[CACHE_SLOT_MAIN_A].freq : CACHE(rig)->slot[CACHE_SLOT_MAIN_B].freq;
         return (RIG_OK);
     }
 }
@@ -196,7 +196,7 @@ struct rig_caps ft991_caps =
     RIG_MODEL(RIG_MODEL_FT991),
     .model_name =         "FT-991",
     .mfg_name =           "Yaesu",
-    .version =            NEWCAT_VER ".18",
+    .version =            NEWCAT_VER ".20",
     .copyright =          "LGPL",
     .status =             RIG_STATUS_STABLE,
     .rig_type =           RIG_TYPE_TRANSCEIVER,
@@ -381,6 +381,7 @@ struct rig_caps ft991_caps =
     .get_vfo =            ft991_get_vfo,
     .set_ptt =            newcat_set_ptt,
     .get_ptt =            newcat_get_ptt,
+    .get_status =         newcat_get_status,
     .set_split_vfo =      newcat_set_split_vfo,
     .get_split_vfo =      newcat_get_split_vfo,
     .set_split_freq =     ft991_set_split_freq,
@@ -433,6 +434,10 @@ struct rig_caps ft991_caps =
     .set_clock =          newcat_set_clock,
     .get_clock =          newcat_get_clock,
     .morse_qsize =        50,
+    .async_data_supported = 1,
+    .read_frame_direct =  newcat_read_frame_direct,
+    .is_async_frame =     newcat_is_async_frame,
+    .process_async_frame = newcat_process_async_frame,
     .hamlib_check_rig_caps = HAMLIB_CHECK_RIG_CAPS
 };
 
@@ -488,7 +493,7 @@ ft991_set_split_freq(RIG *rig, vfo_t vfo, freq_t tx_freq)
         return (rval);
     }
 
-    if (CACHE(rig)->freqMainB == tx_freq)
+    if (CACHE(rig)->slot[CACHE_SLOT_MAIN_B].freq == tx_freq)
     {
         rig_debug(RIG_DEBUG_TRACE, "%s: freq %.0f already set on VFOB\n", __func__,
                   tx_freq);
@@ -665,7 +670,7 @@ static int ft991_set_split_mode(RIG *rig, vfo_t vfo, rmode_t tx_mode,
         return -RIG_EINVAL;
     }
 
-    if (CACHE(rig)->modeMainB == tx_mode)
+    if (CACHE(rig)->slot[CACHE_SLOT_MAIN_B].mode == tx_mode)
     {
         rig_debug(RIG_DEBUG_TRACE, "%s: mode %s already set on VFOB\n", __func__,
                   rig_strrmode(tx_mode));
@@ -171,7 +171,7 @@ int ftx1_set_split_vfo(RIG *rig, vfo_t vfo, split_t split, vfo_t tx_vfo)
      *   - Split OFF: TX on MAIN (same as RX)
      *
      * CRITICAL: The Hamlib core's vfo_fixup() converts "Main" to "VFOA".
-     * Since VFOA and MAIN share the same cache slot (freqMainA), we MUST
+     * Since VFOA and MAIN share the same cache slot (CACHE_SLOT_MAIN_A), we MUST
      * force tx_vfo to SUB when split is ON. Otherwise:
      *   1. rig_set_split_freq caches TX freq for VFOA
      *   2. This overwrites the MAIN cache with the TX frequency
@@ -482,10 +482,10 @@ int ftx1_set_split_freq(RIG *rig, vfo_t vfo, freq_t tx_freq)
     /*
      * Save the Main freq before any cache corruption.
      * The Hamlib core will cache tx_freq for VFOA after we return,
-     * which corrupts the Main cache (they share freqMainA slot).
+     * which corrupts the Main cache (they share the MAIN_A slot).
      * We save it here so we can restore it below.
      */
-    saved_main_freq = cachep->freqMainA;
+    saved_main_freq = cachep->slot[CACHE_SLOT_MAIN_A].freq;
 
     /* Set VFO-B (TX VFO) frequency */
     SNPRINTF(priv->cmd_str, sizeof(priv->cmd_str), "FB%09.0f;", tx_freq);
@@ -508,7 +508,7 @@ int ftx1_set_split_freq(RIG *rig, vfo_t vfo, freq_t tx_freq)
         /*
          * WORKAROUND for Hamlib core cache issue:
          * The core will cache tx_freq for VFOA AFTER we return, which
-         * corrupts the Main cache (VFOA and MAIN share freqMainA slot).
+         * corrupts the Main cache (VFOA and MAIN share the MAIN_A slot).
          *
          * We save the correct Main freq here. It will be restored in
          * ftx1_get_split_freq, which GPredict calls before get_freq.
@@ -557,8 +557,7 @@ int ftx1_get_split_freq(RIG *rig, vfo_t vfo, freq_t *tx_freq)
         rig_debug(RIG_DEBUG_VERBOSE,
                   "%s: restoring Main cache to %.0f Hz\n",
                   __func__, priv->ftx1_cache_fix_freq);
-        cachep->freqMainA = priv->ftx1_cache_fix_freq;
-        elapsed_ms(&cachep->time_freqMainA, HAMLIB_ELAPSED_SET);
+        rig_set_cache_freq(rig, RIG_VFO_A, priv->ftx1_cache_fix_freq);
         priv->ftx1_cache_fix_needed = 0;
     }
 
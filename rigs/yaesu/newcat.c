@@ -40,6 +40,7 @@
 #include "misc.h"
 #include "cache.h"
 #include "cal.h"
+#include "event.h"
 #include "newcat.h"
 
 /* global variables */
@@ -434,24 +435,47 @@ const cal_table_float_t yaesu_default_id_meter_cal =
     }
 };
 
-// These assume there is a 'rig' in scope
-#define is_ft450 (RIG_MODEL_FT450==rig->caps->rig_model || RIG_MODEL_FT450D==rig->caps->rig_model)
-#define is_ft710 (RIG_MODEL_FT710==rig->caps->rig_model)
-#define is_ft891 (RIG_MODEL_FT891==rig->caps->rig_model)
-#define is_ft897 (RIG_MODEL_FT897==rig->caps->rig_model)
-#define is_ft897d (RIG_MODEL_FT897D==rig->caps->rig_model)
-#define is_ft950 (RIG_MODEL_FT950==rig->caps->rig_model)
-#define is_ft991 (RIG_MODEL_FT991==rig->caps->rig_model)
-#define is_ft2000 (RIG_MODEL_FT2000==rig->caps->rig_model)
-#define is_ftdx10 (RIG_MODEL_FTDX10==rig->caps->rig_model)
-#define is_ftdx101d (RIG_MODEL_FTDX101D==rig->caps->rig_model)
-#define is_ftdx101mp (RIG_MODEL_FTDX101MP==rig->caps->rig_model)
-#define is_ftdx1200 (RIG_MODEL_FTDX1200==rig->caps->rig_model)
-#define is_ftdx3000 (RIG_MODEL_FTDX3000==rig->caps->rig_model)
-#define is_ftdx5000 (RIG_MODEL_FTDX5000==rig->caps->rig_model)
-#define is_ftdx9000 (RIG_MODEL_FT9000==rig->caps->rig_model)
-#define is_ftdx9000Old (RIG_MODEL_FTD000OLD==rig->caps->rig_model)
-#define is_ftx1 (RIG_MODEL_FTX1==rig->caps->rig_model)
+// These assume there is a 'rig' in scope, and only hold after newcat_init()
+#define NC_MODEL(rig) (((struct newcat_priv_data *)STATE(rig)->priv)->model)
+#define is_ft450 (NC_MODEL(rig) == NC_MODEL_FT450)
+#define is_ft710 (NC_MODEL(rig) == NC_MODEL_FT710)
+#define is_ft891 (NC_MODEL(rig) == NC_MODEL_FT891)
+#define is_ft950 (NC_MODEL(rig) == NC_MODEL_FT950)
+#define is_ft991 (NC_MODEL(rig) == NC_MODEL_FT991)
+#define is_ft2000 (NC_MODEL(rig) == NC_MODEL_FT2000)
+#define is_ftdx10 (NC_MODEL(rig) == NC_MODEL_FTDX10)
+#define is_ftdx101d (NC_MODEL(rig) == NC_MODEL_FTDX101D)
+#define is_ftdx101mp (NC_MODEL(rig) == NC_MODEL_FTDX101MP)
+#define is_ftdx1200 (NC_MODEL(rig) == NC_MODEL_FTDX1200)
+#define is_ftdx3000 (NC_MODEL(rig) == NC_MODEL_FTDX3000)
+#define is_ftdx5000 (NC_MODEL(rig) == NC_MODEL_FTDX5000)
+#define is_ftdx9000 (NC_MODEL(rig) == NC_MODEL_FTDX9000)
+#define is_ftdx9000Old (NC_MODEL(rig) == NC_MODEL_FTDX9000OLD)
+#define is_ftx1 (NC_MODEL(rig) == NC_MODEL_FTX1)
+
+static const struct
+{
+    rig_model_t rig_model;
+    newcat_model_t model;
+} newcat_models[] =
+{
+    { RIG_MODEL_FT450, NC_MODEL_FT450 },
+    { RIG_MODEL_FT450D, NC_MODEL_FT450 },
+    { RIG_MODEL_FT710, NC_MODEL_FT710 },
+    { RIG_MODEL_FT891, NC_MODEL_FT891 },
+    { RIG_MODEL_FT950, NC_MODEL_FT950 },
+    { RIG_MODEL_FT991, NC_MODEL_FT991 },
+    { RIG_MODEL_FT2000, NC_MODEL_FT2000 },
+    { RIG_MODEL_FTDX10, NC_MODEL_FTDX10 },
+    { RIG_MODEL_FTDX101D, NC_MODEL_FTDX101D },
+    { RIG_MODEL_FTDX101MP, NC_MODEL_FTDX101MP },
+    { RIG_MODEL_FTDX1200, NC_MODEL_FTDX1200 },
+    { RIG_MODEL_FTDX3000, NC_MODEL_FTDX3000 },
+    { RIG_MODEL_FTDX5000, NC_MODEL_FTDX5000 },
+    { RIG_MODEL_FT9000, NC_MODEL_FTDX9000 },
+    { RIG_MODEL_FT9000OLD, NC_MODEL_FTDX9000OLD },
+    { RIG_MODEL_FTX1, NC_MODEL_FTX1 },
+};
 
 /*
  * Even though this table does make a handy reference, it could be deprecated as it is not really needed.
@@ -461,9 +485,9 @@ const cal_table_float_t yaesu_default_id_meter_cal =
  * PR - Speech Proc ON/OFF, and BC - Auto Notch filter ON/OFF.
  * The FT-450 returns -RIG_ENVAIL for these unavailable CAT commands.
  *
- * NOTE: The following table must be in alphabetical order by the
- * command.  This is because it is searched using a binary search
- * to determine whether or not a command is valid for a given rig.
+ * newcat_init() turns the column for the rig into a bitmap indexed by
+ * newcat_cmd_hash(), so the order only matters to the reader; keep it
+ * alphabetical.
  *
  * The list of supported commands is obtained from the rig's operator's
  * or CAT programming manual.
@@ -651,6 +675,7 @@ static int newcat_set_contour_width(RIG *rig, vfo_t vfo, int width);
 static int newcat_get_contour_width(RIG *rig, vfo_t vfo, int *width);
 static int newcat_get_index_from_width(pbwidth_t width, const struct newcat_width_info * info);
 static ncboolean newcat_valid_command(RIG *rig, char const *const command);
+static void newcat_init_valid_cmds(RIG *rig);
 
 /*
  * The BS command needs to know what band we're on so we can restore band info
@@ -753,6 +778,8 @@ int newcat_init(RIG *rig)
     priv->current_mem = NC_MEM_CHANNEL_NONE;
     priv->fast_set_commands = FALSE;
 
+    newcat_init_valid_cmds(rig);
+
     RETURNFUNC(RIG_OK);
 }
 
@@ -780,6 +807,14 @@ int newcat_cleanup(RIG *rig)
 }
 
 
+/* Whether AI is turned on once the async data handler runs */
+static int newcat_ai_wanted(RIG *rig)
+{
+    return STATE(rig)->async_data_enabled
+           && rig->caps->is_async_frame == newcat_is_async_frame;
+}
+
+
 /*
  * rig_open
  *
@@ -809,6 +844,16 @@ int newcat_open(RIG *rig)
     rig_debug(RIG_DEBUG_TRACE, "%s: serial_handshake = %s \n",
               __func__, handshake[rig->caps->serial_handshake]);
 
+    /* AI comes on once the async data handler runs, nothing reads the
+       sync data pipe before, so the open talks to the port itself */
+    priv->ai_active = 0;
+    priv->ai_pending = newcat_ai_wanted(rig);
+
+    if (priv->ai_pending)
+    {
+        rp->asyncio = 0;
+    }
+
     /* Ensure rig is powered on */
     if (!priv->poweron && rig_s->auto_power_on)
     {
@@ -826,8 +871,8 @@ int newcat_open(RIG *rig)
     rp->timeout = 100;
     newcat_get_trn(rig, &priv->trn_state);  /* ignore errors */
 
-    /* Currently we cannot cope with AI mode so turn it off in case
-       last client left it on */
+    /* Turn AI off in case last client left it on, it comes back on
+       later if we are running with async data */
     if (priv->trn_state > 0)
     {
         newcat_set_trn(rig, RIG_TRN_OFF);
@@ -940,6 +985,14 @@ int newcat_close(RIG *rig)
 
     ENTERFUNC;
 
+    // the async data handler has stopped, AI is restored talking to the port
+    if (newcat_ai_wanted(rig))
+    {
+        RIGPORT(rig)->asyncio = 0;
+    }
+
+    priv->ai_pending = 0;
+
     if (!no_restore_ai && priv->trn_state >= 0 && rig_s->comm_state
             && rig_s->powerstat != RIG_POWER_OFF)
     {
@@ -948,6 +1001,12 @@ int newcat_close(RIG *rig)
                                                    case it's not
                                                    supported */
     }
+    else if (priv->ai_active && rig_s->comm_state)
+    {
+        newcat_set_trn(rig, RIG_TRN_OFF);
+    }
+
+    priv->ai_active = 0;
 
     if (priv->poweron && rig_s->auto_power_off && rig_s->comm_state)
     {
@@ -1087,7 +1146,7 @@ int newcat_60m_exception(RIG *rig, freq_t freq, rmode_t mode)
     }
 
     // some rigs need to skip freq/mode settings as 60M only operates in memory mode
-    if (is_ft991 || is_ft897 || is_ft897d || is_ftdx5000 || is_ftdx10) { return 1; }
+    if (is_ft991 || is_ftdx5000 || is_ftdx10) { return 1; }
 
     if (!is_ftdx10 && !is_ft710 && !is_ftdx101d && !is_ftdx101mp && !is_ftx1) { return 0; }
 
@@ -1175,7 +1234,7 @@ int newcat_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
 
     ENTERFUNC;
 
-    if (newcat_60m_exception(rig, freq, cachep->modeMainA))
+    if (newcat_60m_exception(rig, freq, cachep->slot[CACHE_SLOT_MAIN_A].mode))
     {
         // we don't try to set freq on 60m for some rigs since we must be in memory mode
         // and we can't run split mode on 60M memory mode either
@@ -1743,7 +1802,7 @@ int newcat_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
 
     ENTERFUNC;
 
-    if (newcat_60m_exception(rig, cachep->freqMainA, mode)) { RETURNFUNC(RIG_OK); } // we don't set mode in this case
+    if (newcat_60m_exception(rig, cachep->slot[CACHE_SLOT_MAIN_A].freq, mode)) { RETURNFUNC(RIG_OK); } // we don't set mode in this case
 
     if (!newcat_valid_command(rig, "MD"))
     {
@@ -1812,11 +1871,11 @@ int newcat_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
 
     if (vfo == RIG_VFO_A || vfo == RIG_VFO_MAIN)
     {
-        cachep->modeMainA = mode;
+        cachep->slot[CACHE_SLOT_MAIN_A].mode = mode;
     }
     else
     {
-        cachep->modeMainB = mode;
+        cachep->slot[CACHE_SLOT_MAIN_B].mode = mode;
     }
 
     if (RIG_PASSBAND_NOCHANGE == width) { RETURNFUNC(err); }
@@ -2292,6 +2351,109 @@ int newcat_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 }
 
 
+/*
+ * Width of the P2 frequency field in an IF/OI reply of len characters,
+ * terminator included, or 0 for a layout we don't know.  The mode (P6)
+ * is at 12 + width, right before the VFO/memory flag (P7).
+ * e.g. FT450 has 27 byte IF response, FT991 has 28 byte if response
+ */
+static int newcat_if_freq_width(int len)
+{
+    switch (len)
+    {
+    case 27: return 8;
+
+    case 30:
+    case 41: // FT-991 V2-01 seems to randomly give 13 extra bytes
+    case 28: return 9;
+
+    default: return 0;
+    }
+}
+
+
+/*
+ * newcat_get_status
+ * IF (VFO A) and OI (VFO B) give freq and mode in one reply, where
+ * newcat_get_freq() and newcat_get_mode() need FA/FB, MD and the width
+ * commands.  PTT and split are not in it.
+ */
+int newcat_get_status(RIG *rig, vfo_t vfo, struct rig_vfo_status *status)
+{
+    struct newcat_priv_data *priv = (struct newcat_priv_data *)STATE(rig)->priv;
+    const char *cmd;
+    int width;
+    int err;
+
+    ENTERFUNC;
+
+    if (STATE(rig)->powerstat == 0)
+    {
+        RETURNFUNC(-RIG_ENAVAIL);
+    }
+
+    err = newcat_set_vfo_from_alias(rig, &vfo);
+
+    if (err < 0)
+    {
+        RETURNFUNC(err);
+    }
+
+    switch (vfo)
+    {
+    case RIG_VFO_A:
+    case RIG_VFO_MAIN:
+        cmd = "IF";
+        break;
+
+    case RIG_VFO_B:
+    case RIG_VFO_SUB:
+        cmd = "OI";
+        break;
+
+    default:
+        RETURNFUNC(-RIG_ENAVAIL);
+    }
+
+    if (!newcat_valid_command(rig, cmd))
+    {
+        RETURNFUNC(-RIG_ENAVAIL);
+    }
+
+    SNPRINTF(priv->cmd_str, sizeof(priv->cmd_str), "%s%c", cmd, cat_term);
+
+    if (RIG_OK != (err = newcat_get_cmd(rig)))
+    {
+        RETURNFUNC(err);
+    }
+
+    width = newcat_if_freq_width(strlen(priv->ret_data));
+
+    if (width == 0)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: unknown %s response length %d\n", __func__,
+                  cmd, (int)strlen(priv->ret_data));
+        RETURNFUNC(-RIG_EPROTO);
+    }
+
+    status->mode = newcat_rmode(priv->ret_data[12 + width]);
+
+    if (status->mode != RIG_MODE_NONE)
+    {
+        status->valid |= RIG_VFO_STATUS_MODE;
+    }
+
+    priv->ret_data[5 + width] = '\0';
+
+    if (sscanf(priv->ret_data + 5, "%"SCNfreq, &status->freq) == 1)
+    {
+        status->valid |= RIG_VFO_STATUS_FREQ;
+    }
+
+    RETURNFUNC(RIG_OK);
+}
+
+
 int newcat_get_dcd(RIG *rig, vfo_t vfo, dcd_t *dcd)
 {
     ENTERFUNC;
@@ -2691,11 +2853,11 @@ int newcat_set_split_mode(RIG *rig, vfo_t vfo, rmode_t tx_mode,
 
     if (vfo == RIG_VFO_A || vfo == RIG_VFO_MAIN)
     {
-        CACHE(rig)->modeMainA = tx_mode;
+        CACHE(rig)->slot[CACHE_SLOT_MAIN_A].mode = tx_mode;
     }
     else
     {
-        CACHE(rig)->modeMainB = tx_mode;
+        CACHE(rig)->slot[CACHE_SLOT_MAIN_B].mode = tx_mode;
     }
 
 
@@ -2738,8 +2900,8 @@ int newcat_set_split_vfo(RIG *rig, vfo_t vfo, split_t split, vfo_t tx_vfo)
         RETURNFUNC(err);
     }
 
-    if (newcat_60m_exception(rig, CACHE(rig)->freqMainA,
-                             CACHE(rig)->modeMainA))
+    if (newcat_60m_exception(rig, CACHE(rig)->slot[CACHE_SLOT_MAIN_A].freq,
+                             CACHE(rig)->slot[CACHE_SLOT_MAIN_A].mode))
     {
         rig_debug(RIG_DEBUG_VERBOSE,
                   "%s: force set_split off since we're on 60M exception\n", __func__);
@@ -4280,9 +4442,9 @@ int newcat_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val)
 
         rmode_t exclude = RIG_MODE_CW | RIG_MODE_CWR | RIG_MODE_RTTY | RIG_MODE_RTTYR;
 
-        if ((STATE(rig)->tx_vfo == RIG_VFO_A && (cachep->modeMainA & exclude))
-                || (STATE(rig)->tx_vfo == RIG_VFO_B && (cachep->modeMainB & exclude))
-                || (STATE(rig)->tx_vfo == RIG_VFO_C && (cachep->modeMainC & exclude)))
+        if ((STATE(rig)->tx_vfo == RIG_VFO_A && (cachep->slot[CACHE_SLOT_MAIN_A].mode & exclude))
+                || (STATE(rig)->tx_vfo == RIG_VFO_B && (cachep->slot[CACHE_SLOT_MAIN_B].mode & exclude))
+                || (STATE(rig)->tx_vfo == RIG_VFO_C && (cachep->slot[CACHE_SLOT_MAIN_C].mode & exclude)))
         {
             rig_debug(RIG_DEBUG_VERBOSE, "%s: rig cannot set MG in CW/RTTY modes\n",
                       __func__);
@@ -4862,7 +5024,7 @@ int newcat_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val)
         if (is_ftdx101d || is_ftdx101mp)
         {
             rmode_t curmode = STATE(rig)->current_vfo == RIG_VFO_A ?
-                              cachep->modeMainA : cachep->modeMainB;
+                              cachep->slot[CACHE_SLOT_MAIN_A].mode : cachep->slot[CACHE_SLOT_MAIN_B].mode;
             float valf = val.f / level_info->step.f;
 
             switch (curmode)
@@ -5074,9 +5236,9 @@ int newcat_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
 
         rmode_t exclude = RIG_MODE_CW | RIG_MODE_CWR | RIG_MODE_RTTY | RIG_MODE_RTTYR;
 
-        if ((STATE(rig)->tx_vfo == RIG_VFO_A && (cachep->modeMainA & exclude))
-                || (STATE(rig)->tx_vfo == RIG_VFO_B && (cachep->modeMainB & exclude))
-                || (STATE(rig)->tx_vfo == RIG_VFO_C && (cachep->modeMainC & exclude)))
+        if ((STATE(rig)->tx_vfo == RIG_VFO_A && (cachep->slot[CACHE_SLOT_MAIN_A].mode & exclude))
+                || (STATE(rig)->tx_vfo == RIG_VFO_B && (cachep->slot[CACHE_SLOT_MAIN_B].mode & exclude))
+                || (STATE(rig)->tx_vfo == RIG_VFO_C && (cachep->slot[CACHE_SLOT_MAIN_C].mode & exclude)))
         {
             rig_debug(RIG_DEBUG_VERBOSE, "%s: rig cannot read MG in CW/RTTY modes\n",
                       __func__);
@@ -5436,7 +5598,7 @@ int newcat_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
         if (is_ftdx101d || is_ftdx101mp)
         {
             rmode_t curmode = STATE(rig)->current_vfo == RIG_VFO_A ?
-                              cachep->modeMainA : cachep->modeMainB;
+                              cachep->slot[CACHE_SLOT_MAIN_A].mode : cachep->slot[CACHE_SLOT_MAIN_B].mode;
 
             switch (curmode)
             {
@@ -5478,7 +5640,7 @@ int newcat_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
         if (is_ftdx101d || is_ftdx101mp)
         {
             rmode_t curmode = STATE(rig)->current_vfo == RIG_VFO_A ?
-                              cachep->modeMainA : cachep->modeMainB;
+                              cachep->slot[CACHE_SLOT_MAIN_A].mode : cachep->slot[CACHE_SLOT_MAIN_B].mode;
 
             switch (curmode)
             {
@@ -8053,96 +8215,131 @@ const char *newcat_get_info(RIG *rig)
 
 
 /*
- * newcat_valid_command
- *
- * Determine whether or not the command is valid for the specified
- * rig.  This function should be called before sending the command
- * to the rig to make it easier to differentiate invalid and illegal
- * commands (for a rig).
+ * Perfect hash of a two letter command, -1 if command isn't one
  */
-
-ncboolean newcat_valid_command(RIG *rig, char const *const command)
+static inline int newcat_cmd_hash(char const *command)
 {
-    struct rig_caps *caps;
-    int search_high;
-    int search_low;
+    unsigned int c0 = (unsigned char) command[0] - 'A';
+    unsigned int c1;
 
-    rig_debug(RIG_DEBUG_TRACE, "%s %s\n", __func__, command);
+    if (c0 >= 26) { return -1; }
 
-    caps = rig->caps;
+    c1 = (unsigned char) command[1] - 'A';
+
+    if (c1 >= 26 || command[2] != '\0') { return -1; }
+
+    return (int)(c0 * 26 + c1);
+}
 
-    if (!caps)
+
+/*
+ * Pick the model and turn its valid_commands column into the bitmap
+ * newcat_valid_command() tests, once per rig instead of on every command.
+ */
+static void newcat_init_valid_cmds(RIG *rig)
+{
+    struct newcat_priv_data *priv = STATE(rig)->priv;
+    int i;
+
+    priv->model = NC_MODEL_UNKNOWN;
+
+    for (i = 0; i < (int)(sizeof(newcat_models) / sizeof(newcat_models[0])); i++)
     {
-        rig_debug(RIG_DEBUG_ERR, "%s: Rig capabilities not valid\n", __func__);
-        RETURNFUNC2(FALSE);
+        if (newcat_models[i].rig_model == rig->caps->rig_model)
+        {
+            priv->model = newcat_models[i].model;
+            break;
+        }
     }
 
-    if (!is_ft450 && !is_ft950 && !is_ft891 && !is_ft991 && !is_ft2000
-            && !is_ftdx5000 && !is_ftdx9000 && !is_ftdx1200 && !is_ftdx3000 && !is_ftdx101d
-            && !is_ftdx101mp && !is_ftdx10 && !is_ft710 && !is_ftx1)
+    memset(priv->valid_cmds, 0, sizeof(priv->valid_cmds));
+
+    if (priv->model == NC_MODEL_UNKNOWN)
     {
-        rig_debug(RIG_DEBUG_ERR, "%s: '%s' is unknown\n", __func__, caps->model_name);
-        RETURNFUNC2(FALSE);
+        rig_debug(RIG_DEBUG_ERR, "%s: '%s' is unknown\n", __func__,
+                  rig->caps->model_name);
+        return;
     }
 
-    /*
-     * Make sure the command is known, and then check to make sure
-     * is it valid for the rig.
-     */
+    for (i = 0; i < valid_commands_count; i++)
+    {
+        const yaesu_newcat_commands_t *c = &valid_commands[i];
+        ncboolean valid;
+        int hash;
 
-    search_low = 0;
-    search_high = valid_commands_count;
+        switch (priv->model)
+        {
+        case NC_MODEL_FT450: valid = c->ft450; break;
 
-    while (search_low <= search_high)
-    {
-        int search_test;
-        int search_index;
+        case NC_MODEL_FT891: valid = c->ft891; break;
 
-        search_index = (search_low + search_high) / 2;
-        search_test = strcmp(valid_commands[search_index].command, command);
+        case NC_MODEL_FT950: valid = c->ft950; break;
 
-        if (search_test > 0)
-        {
-            search_high = search_index - 1;
+        case NC_MODEL_FT991: valid = c->ft991; break;
+
+        case NC_MODEL_FT2000: valid = c->ft2000; break;
+
+        case NC_MODEL_FTDX5000: valid = c->ft5000; break;
+
+        case NC_MODEL_FTDX9000: valid = c->ft9000; break;
+
+        case NC_MODEL_FTDX1200: valid = c->ft1200; break;
+
+        case NC_MODEL_FTDX3000: valid = c->ft3000; break;
+
+        case NC_MODEL_FTDX101D: valid = c->ft101d; break;
+
+        case NC_MODEL_FTDX101MP: valid = c->ft101mp; break;
+
+        case NC_MODEL_FTDX10: valid = c->ftdx10; break;
+
+        case NC_MODEL_FT710: valid = c->ft710; break;
+
+        case NC_MODEL_FTX1: valid = c->ftx1; break;
+
+        // the ft9000Old column is incomplete and has never been used
+        default: valid = FALSE; break;
         }
-        else if (search_test < 0)
+
+        hash = newcat_cmd_hash(c->command);
+
+        if (valid && hash >= 0)
         {
-            search_low = search_index + 1;
+            priv->valid_cmds[hash / 64] |= (uint64_t) 1 << (hash % 64);
         }
-        else
-        {
-            ncboolean retval = FALSE;
-            /*
-             * The command is valid.  Now make sure it is supported by the rig.
-             */
-            // Until valid_commands gets a second index
-            if (is_ft450) { retval = valid_commands[search_index].ft450; }
-            else if (is_ft891) { retval = valid_commands[search_index].ft891; }
-            else if (is_ft950) { retval = valid_commands[search_index].ft950; }
-            else if (is_ft991) { retval = valid_commands[search_index].ft991; }
-            else if (is_ft2000) { retval =  valid_commands[search_index].ft2000; }
-            else if (is_ftdx5000) { retval = valid_commands[search_index].ft5000; }
-            else if (is_ftdx9000) { retval = valid_commands[search_index].ft9000; }
-            else if (is_ftdx1200) { retval = valid_commands[search_index].ft1200; }
-            else if (is_ftdx3000) { retval = valid_commands[search_index].ft3000; }
-            else if (is_ftdx101d) { retval = valid_commands[search_index].ft101d; }
-            else if (is_ftdx101mp) { retval = valid_commands[search_index].ft101mp; }
-            else if (is_ftdx10) { retval = valid_commands[search_index].ftdx10; }
-            else if (is_ft710) { retval = valid_commands[search_index].ft710; }
-            else if (is_ftx1) { retval = valid_commands[search_index].ftx1; }
+    }
+}
 
-            if (!retval)
-            {
-                rig_debug(RIG_DEBUG_TRACE, "%s: '%s' command '%s' not supported\n",
-                          __func__, caps->model_name, command);
-            }
-            RETURNFUNC2(retval);
-        }
+
+/*
+ * newcat_valid_command
+ *
+ * Determine whether or not the command is valid for the specified
+ * rig.  This function should be called before sending the command
+ * to the rig to make it easier to differentiate invalid and illegal
+ * commands (for a rig).  It runs before nearly every command, so it
+ * is a bit test in the map built by newcat_init_valid_cmds().
+ */
+ncboolean newcat_valid_command(RIG *rig, char const *const command)
+{
+    const struct newcat_priv_data *priv = STATE(rig)->priv;
+    int hash = newcat_cmd_hash(command);
+
+    if (hash < 0)
+    {
+        rig_debug(RIG_DEBUG_TRACE, "%s: '%s' command '%s' not valid\n",
+                  __func__, rig->caps->model_name, command);
+        return FALSE;
+    }
+
+    if (!(priv->valid_cmds[hash / 64] & ((uint64_t) 1 << (hash % 64))))
+    {
+        rig_debug(RIG_DEBUG_TRACE, "%s: '%s' command '%s' not supported\n",
+                  __func__, rig->caps->model_name, command);
+        return FALSE;
     }
 
-    rig_debug(RIG_DEBUG_TRACE, "%s: '%s' command '%s' not valid\n",
-              __func__, caps->model_name, command);
-    RETURNFUNC2(FALSE);
+    return TRUE;
 }
 
 
@@ -10271,6 +10468,58 @@ int newcat_vfomem_toggle(RIG *rig)
     RETURNFUNC(newcat_set_cmd(rig));
 }
 
+/*
+ * Auto information (AI) mode.
+ *
+ * With async data enabled, rigs whose caps use newcat_is_async_frame()
+ * run with AI1 and push FA/FB/MD/IF/TX frames whenever something changes
+ * on the rig.  The async data handler reads every frame; the reply we are
+ * reading right now (priv->ai_reply) goes through the sync data pipe to
+ * newcat_get_cmd()/newcat_set_cmd(), the rest is decoded into the cache.
+ */
+static void newcat_expect_reply(struct newcat_priv_data *priv,
+                                const char *cmd)
+{
+    int reply = cmd && cmd[0] ? (cmd[0] << 8) | cmd[1] : 0;
+
+    __atomic_store_n(&priv->ai_reply, reply, __ATOMIC_RELAXED);
+}
+
+/*
+ * AI frames can only be told apart from replies once the async data
+ * handler owns the port, so AI is turned on by the first command after
+ * that.
+ */
+static void newcat_ai_start(RIG *rig)
+{
+    struct newcat_priv_data *priv = (struct newcat_priv_data *)STATE(rig)->priv;
+    char cmd_str[NEWCAT_DATA_LEN];
+    int err;
+
+    if (!priv->ai_pending || !RIGPORT(rig)->asyncio)
+    {
+        return;
+    }
+
+    priv->ai_pending = 0;
+    priv->ai_active = 1;
+
+    // the caller has its own command waiting in cmd_str
+    memcpy(cmd_str, priv->cmd_str, sizeof(cmd_str));
+    err = newcat_set_trn(rig, RIG_TRN_RIG);
+    memcpy(priv->cmd_str, cmd_str, sizeof(cmd_str));
+
+    if (err != RIG_OK)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: cannot turn AI on: %s\n", __func__,
+                  rigerror(err));
+        priv->ai_active = 0;
+        return;
+    }
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: AI mode on\n", __func__);
+}
+
 /*
  * Writes a null  terminated command string from  priv->cmd_str to the
  * CAT  port and  returns a  response from  the rig  in priv->ret_data
@@ -10282,7 +10531,7 @@ int newcat_vfomem_toggle(RIG *rig)
  * "?;" busy please wait response; the command is not resent but up to
  * 'retry' retries to receive a valid response are made.
  */
-int newcat_get_cmd(RIG *rig)
+static int newcat_get_cmd_io(RIG *rig)
 {
     struct rig_state *state = STATE(rig);
     hamlib_port_t *rp = RIGPORT(rig);
@@ -10388,6 +10637,7 @@ int newcat_get_cmd(RIG *rig)
         {
             /* send the command */
             rig_debug(RIG_DEBUG_TRACE, "cmd_str = %s\n", priv->cmd_str);
+            newcat_expect_reply(priv, priv->cmd_str);
 
             rc = write_block(rp, (unsigned char *) priv->cmd_str,
                              strlen(priv->cmd_str));
@@ -10500,15 +10750,11 @@ int newcat_get_cmd(RIG *rig)
             continue;
         }
 
-        /* verify that reply was to the command we sent */
+        /* verify that reply was to the command we sent, in AI mode
+           newcat_is_async_frame() has already taken the pushed ones */
         if ((priv->ret_data[0] != priv->cmd_str[0]
                 || priv->ret_data[1] != priv->cmd_str[1]))
         {
-            /*
-             * TODO: When RIG_TRN is enabled, we can pass the string
-             * to the decoder for callback. That way we don't ignore
-             * any commands.
-             */
             rig_debug(RIG_DEBUG_ERR, "%s: wrong reply %.2s for command %.2s\n",
                       __func__, priv->ret_data, priv->cmd_str);
             // we were using BUSBUSY but microham devices need retries
@@ -10697,6 +10943,7 @@ repeat:
         if (strlen(valcmd) == 0) { RETURNFUNC(RIG_OK); }
 
         SNPRINTF(cmd, sizeof(cmd), "%s", valcmd);
+        newcat_expect_reply(priv, valcmd);
 
         // some rigs like FT-450/Signalink need a little time before we can ask for TX status again
         if (strncmp(valcmd, "TX", 2) == 0) { hl_usleep(50 * 1000); }
@@ -10775,7 +11022,7 @@ repeat:
  * "?;" busy please wait response; the command is not resent but up to
  * 'retry' retries to receive a valid response are made.
  */
-int newcat_set_cmd(RIG *rig)
+static int newcat_set_cmd_io(RIG *rig)
 {
     hamlib_port_t *rp = RIGPORT(rig);
     struct newcat_priv_data *priv = (struct newcat_priv_data *)STATE(rig)->priv;
@@ -10844,6 +11091,7 @@ int newcat_set_cmd(RIG *rig)
 
         /* send the verification command */
         rig_debug(RIG_DEBUG_TRACE, "cmd_str = %s\n", verify_cmd);
+        newcat_expect_reply(priv, verify_cmd);
 
         if (RIG_OK != (rc = write_block(rp, (unsigned char *) verify_cmd,
                                         strlen(verify_cmd))))
@@ -10955,6 +11203,139 @@ int newcat_set_cmd(RIG *rig)
     RETURNFUNC(rc);
 }
 
+int newcat_get_cmd(RIG *rig)
+{
+    struct newcat_priv_data *priv = (struct newcat_priv_data *)STATE(rig)->priv;
+    int rc;
+
+    newcat_ai_start(rig);
+    rc = newcat_get_cmd_io(rig);
+    newcat_expect_reply(priv, NULL);
+
+    return rc;
+}
+
+int newcat_set_cmd(RIG *rig)
+{
+    struct newcat_priv_data *priv = (struct newcat_priv_data *)STATE(rig)->priv;
+    int rc;
+
+    newcat_ai_start(rig);
+    rc = newcat_set_cmd_io(rig);
+    newcat_expect_reply(priv, NULL);
+
+    return rc;
+}
+
+int newcat_read_frame_direct(RIG *rig, size_t buffer_length,
+                             const unsigned char *buffer)
+{
+    return read_string_direct(RIGPORT(rig), (unsigned char *) buffer,
+                              buffer_length, &cat_term, sizeof(cat_term), 0, 1);
+}
+
+int newcat_is_async_frame(RIG *rig, size_t frame_length,
+                          const unsigned char *frame)
+{
+    const struct newcat_priv_data *priv = (struct newcat_priv_data *)
+                                          STATE(rig)->priv;
+    int reply;
+
+    if (!priv->ai_active)
+    {
+        return 0;
+    }
+
+    reply = __atomic_load_n(&priv->ai_reply, __ATOMIC_RELAXED);
+
+    // nobody is reading, so even an error reply is stale
+    if (reply == 0)
+    {
+        return 1;
+    }
+
+    // ?; N; E; O; belong to the command being read
+    if (frame_length <= 2)
+    {
+        return 0;
+    }
+
+    return reply != ((frame[0] << 8) | frame[1]);
+}
+
+int newcat_process_async_frame(RIG *rig, size_t frame_length,
+                               const unsigned char *frame)
+{
+    struct newcat_priv_data *priv = (struct newcat_priv_data *)STATE(rig)->priv;
+    char buf[NEWCAT_DATA_LEN];
+    freq_t freq;
+    int len;
+
+    if (frame_length < 3 || frame_length >= sizeof(buf))
+    {
+        return -RIG_EPROTO;
+    }
+
+    // strip the terminator
+    len = (int) frame_length - 1;
+    memcpy(buf, frame, len);
+    buf[len] = '\0';
+
+    rig_debug(RIG_DEBUG_TRACE, "%s: %s\n", __func__, buf);
+
+    // the IF; cache in newcat_get_cmd() is out of date now
+    priv->cache_start.tv_sec = 0;
+
+    if (buf[0] == 'F' && (buf[1] == 'A' || buf[1] == 'B'))
+    {
+        if (sscanf(buf + 2, "%"SCNfreq, &freq) != 1)
+        {
+            return -RIG_EPROTO;
+        }
+
+        return rig_fire_freq_event(rig, buf[1] == 'A' ? RIG_VFO_A : RIG_VFO_B, freq);
+    }
+
+    // MD0x is VFO A/Main, MD1x VFO B/Sub
+    if (buf[0] == 'M' && buf[1] == 'D' && len == 4)
+    {
+        return rig_fire_mode_event(rig, buf[2] == '1' ? RIG_VFO_B : RIG_VFO_A,
+                                   newcat_rmode(buf[3]), RIG_PASSBAND_NOCHANGE);
+    }
+
+    // TX0 is receive, TX1 CAT and TX2 front panel transmit
+    if (buf[0] == 'T' && buf[1] == 'X' && len == 3)
+    {
+        // pushed on every change, so the cached PTT is always current
+        STATE(rig)->use_cached_ptt = 1;
+        return rig_fire_ptt_event(rig, RIG_VFO_CURR,
+                                  buf[2] == '0' ? RIG_PTT_OFF : RIG_PTT_ON);
+    }
+
+    if (buf[0] == 'I' && buf[1] == 'F')
+    {
+        // len has no terminator
+        int width = newcat_if_freq_width(len + 1);
+        vfo_t vfo;
+
+        if (width == 0)
+        {
+            return -RIG_EPROTO;
+        }
+
+        // P7 tells whether the main side is on its VFO or a memory
+        vfo = buf[13 + width] == '0' ? RIG_VFO_A : RIG_VFO_MEM;
+        rig_fire_mode_event(rig, vfo, newcat_rmode(buf[12 + width]),
+                            RIG_PASSBAND_NOCHANGE);
+        buf[5 + width] = '\0';
+        sscanf(buf + 5, "%"SCNfreq, &freq);
+        return rig_fire_freq_event(rig, vfo, freq);
+    }
+
+    // the rig reports more than we keep in the cache
+    return RIG_OK;
+}
+
 struct
 {
     rmode_t mode;
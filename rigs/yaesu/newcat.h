@@ -125,6 +125,33 @@ struct newcat_priv_caps
     const struct newcat_width_info *rtty_widths;  // If NULL, use CW widths
 };
 
+/*
+ * Rigs driven by newcat, one per valid_commands column.  Variants that
+ * share a command set (FT-450/FT-450D) share an entry.
+ */
+typedef enum
+{
+    NC_MODEL_UNKNOWN = 0,
+    NC_MODEL_FT450,
+    NC_MODEL_FT710,
+    NC_MODEL_FT891,
+    NC_MODEL_FT950,
+    NC_MODEL_FT991,
+    NC_MODEL_FT2000,
+    NC_MODEL_FTDX10,
+    NC_MODEL_FTDX101D,
+    NC_MODEL_FTDX101MP,
+    NC_MODEL_FTDX1200,
+    NC_MODEL_FTDX3000,
+    NC_MODEL_FTDX5000,
+    NC_MODEL_FTDX9000,
+    NC_MODEL_FTDX9000OLD,
+    NC_MODEL_FTX1,
+} newcat_model_t;
+
+/* Two letter CAT commands, 'AA'..'ZZ' */
+#define NC_CMD_HASH_SIZE (26 * 26)
+
 /*
  * Private state for newcat rigs
  */
@@ -156,6 +183,11 @@ struct newcat_priv_data
     char ftx1_rx_clar_on;        /* Cached RX CLAR enable: '0' or '1' */
     char ftx1_tx_clar_on;        /* Cached TX CLAR enable: '0' or '1' */
     int ftx1_in_memory_mode;     /* 1 if driver knows the Main-side is in Memory mode (VM011) */
+    int ai_pending;              /* turn AI on once the async data handler runs */
+    int ai_active;               /* rig pushes FA/FB/MD/IF/TX, see newcat_is_async_frame() */
+    int ai_reply;                /* 2 char prefix of the reply being read, 0 if none */
+    newcat_model_t model;        /* set by newcat_init() from the caps */
+    uint64_t valid_cmds[(NC_CMD_HASH_SIZE + 63) / 64]; /* commands this model has, see newcat_valid_command() */
 };
 
 /*
@@ -197,6 +229,12 @@ int newcat_init(RIG *rig);
 int newcat_cleanup(RIG *rig);
 int newcat_open(RIG *rig);
 int newcat_close(RIG *rig);
+int newcat_read_frame_direct(RIG *rig, size_t buffer_length,
+                             const unsigned char *buffer);
+int newcat_is_async_frame(RIG *rig, size_t frame_length,
+                          const unsigned char *frame);
+int newcat_process_async_frame(RIG *rig, size_t frame_length,
+                               const unsigned char *frame);
 
 int newcat_set_conf(RIG *rig, hamlib_token_t token, const char *val);
 int newcat_get_conf(RIG *rig, hamlib_token_t token, char *val);
@@ -216,6 +254,7 @@ int newcat_get_mode(RIG *rig, vfo_t vfo, rmode_t *mode, pbwidth_t *width);
 
 int newcat_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt);
 int newcat_get_ptt(RIG * rig, vfo_t vfo, ptt_t * ptt);
+int newcat_get_status(RIG *rig, vfo_t vfo, struct rig_vfo_status *status);
 int newcat_set_ant(RIG * rig, vfo_t vfo, ant_t ant, value_t option);
 int newcat_get_ant(RIG * rig, vfo_t vfo, ant_t dummy, value_t * option, ant_t * ant_curr, ant_t * ant_tx, ant_t *ant_rx);
 int newcat_set_level(RIG * rig, vfo_t vfo, setting_t level, value_t val);
@@ -34,8 +34,10 @@
 #include <stdio.h>
 
 #include "hamlib/amplifier.h"
+#include "hamlib/port.h"
 
 #include "register.h"
+#include "model_list.h"
 
 //! @cond Doxygen_Suppress
 #ifndef PATH_MAX
@@ -101,41 +103,23 @@ static struct
 
 
 /*
- * This struct to keep track of known amp models.
- * It is chained, and used in a hash table, see below.
+ * Registered amp caps, sorted by model, see model_list.c.
  */
-//! @cond Doxygen_Suppress
-struct amp_list
-{
-    const struct amp_caps *caps;
-    struct amp_list *next;
-};
-
-
-#define AMPLSTHASHSZ 16
-#define HASH_FUNC(a) ((a)%AMPLSTHASHSZ)
-//! @endcond
-
+static struct model_list amp_models = MODEL_LIST_INITIALIZER;
 
-/*
- * The amp_hash_table is a hash table pointing to a list of next==NULL
- *  terminated caps.
- */
-static struct amp_list *amp_hash_table[AMPLSTHASHSZ] = { NULL, };
+/* Backends whose init has run, by amp_backend_list index */
+static char amp_backend_loaded[AMP_BACKEND_MAX];
 
 
 static int amp_lookup_backend(amp_model_t amp_model);
 
 
 /*
- * Basically, this is a hash insert function that doesn't check for dup!
+ * Add caps to the registry, a model can only be registered once.
  */
 //! @cond Doxygen_Suppress
 int HAMLIB_API amp_register(const struct amp_caps *caps)
 {
-    int hval;
-    struct amp_list *p;
-
     if (!caps)
     {
         return -RIG_EINVAL;
@@ -143,51 +127,19 @@ int HAMLIB_API amp_register(const struct amp_caps *caps)
 
     amp_debug(RIG_DEBUG_VERBOSE, "amp_register (%d)\n", caps->amp_model);
 
-#ifndef DONT_WANT_DUP_CHECK
-
-    if (amp_get_caps(caps->amp_model) != NULL)
-    {
-        return -RIG_EINVAL;
-    }
-
-#endif
-
-    p = (struct amp_list *)calloc(1, sizeof(struct amp_list));
-
-    if (!p)
-    {
-        return -RIG_ENOMEM;
-    }
-
-    hval = HASH_FUNC(caps->amp_model);
-    p->caps = caps;
-    // p->handle = NULL;
-    p->next = amp_hash_table[hval];
-    amp_hash_table[hval] = p;
-
-    return RIG_OK;
+    return model_list_add(&amp_models, caps->amp_model, caps);
 }
 //! @endcond
 
 
 /*
  * Get amp capabilities.
- * i.e. amp_hash_table lookup
+ * i.e. registry lookup
  */
 //! @cond Doxygen_Suppress
 const struct amp_caps *HAMLIB_API amp_get_caps(amp_model_t amp_model)
 {
-    struct amp_list *p;
-
-    for (p = amp_hash_table[HASH_FUNC(amp_model)]; p; p = p->next)
-    {
-        if (p->caps->amp_model == amp_model)
-        {
-            return p->caps;
-        }
-    }
-
-    return NULL;    /* sorry, caps not registered! */
+    return model_list_find(&amp_models, amp_model);
 }
 //! @endcond
 
@@ -253,6 +205,11 @@ int HAMLIB_API amp_check_backend(amp_model_t amp_model)
         return -RIG_ENAVAIL;
     }
 
+    if (amp_backend_loaded[be_idx])
+    {
+        return -RIG_ENAVAIL;
+    }
+
     retval = amp_load_backend(amp_backend_list[be_idx].be_name);
 
     return retval;
@@ -263,47 +220,22 @@ int HAMLIB_API amp_check_backend(amp_model_t amp_model)
 //! @cond Doxygen_Suppress
 int HAMLIB_API amp_unregister(amp_model_t amp_model)
 {
-    int hval;
-    struct amp_list *p, *q;
-
-    hval = HASH_FUNC(amp_model);
-    q = NULL;
-
-    for (p = amp_hash_table[hval]; p; p = p->next)
-    {
-        if (p->caps->amp_model == amp_model)
-        {
-            if (q == NULL)
-            {
-                amp_hash_table[hval] = p->next;
-            }
-            else
-            {
-                q->next = p->next;
-            }
-
-            free(p);
-            return RIG_OK;
-        }
-
-        q = p;
-    }
-
-    return -RIG_EINVAL; /* sorry, caps not registered! */
+    return model_list_remove(&amp_models, amp_model);
 }
 //! @endcond
 
 
 /*
  * amp_list_foreach
- * executes cfunc on all the elements stored in the amp hash list
+ * executes cfunc on the caps registered when it starts, in model order
  */
 //! @cond Doxygen_Suppress
 int HAMLIB_API amp_list_foreach(int (*cfunc)(const struct amp_caps *,
                                 rig_ptr_t),
                                 rig_ptr_t data)
 {
-    struct amp_list *p;
+    struct model_list_entry *models;
+    int count;
     int i;
 
     if (!cfunc)
@@ -311,16 +243,19 @@ int HAMLIB_API amp_list_foreach(int (*cfunc)(const struct amp_caps *,
         return -RIG_EINVAL;
     }
 
-    for (i = 0; i < AMPLSTHASHSZ; i++)
+    count = model_list_snapshot(&amp_models, &models);
+
+    for (i = 0; i < count; i++)
     {
-        for (p = amp_hash_table[i]; p; p = p->next)
-            if ((*cfunc)(p->caps, data) == 0)
-            {
-                return RIG_OK;
-            }
+        /* skip what cfunc unregistered on the way */
+        if (model_list_find(&amp_models, models[i].model) != models[i].caps) { continue; }
+
+        if ((*cfunc)(models[i].caps, data) == 0) { break; }
     }
 
-    return RIG_OK;
+    free(models);
+
+    return count < 0 ? count : RIG_OK;
 }
 //! @endcond
 
@@ -335,6 +270,8 @@ amp_model_t HAMLIB_API amp_probe_all(hamlib_port_t *p)
     int i;
     amp_model_t amp_model;
 
+    p->deadline_ns = 0;
+
     for (i = 0; i < AMP_BACKEND_MAX && amp_backend_list[i].be_name; i++)
     {
         if (amp_backend_list[i].be_probe)
@@ -391,7 +328,18 @@ int HAMLIB_API amp_load_backend(const char *be_name)
                 return -RIG_EINVAL;
             }
 
+            if (amp_backend_loaded[i])
+            {
+                return RIG_OK;
+            }
+
             status = (*be_init)(NULL);
+
+            if (status == RIG_OK)
+            {
+                amp_backend_loaded[i] = 1;
+            }
+
             return status;
         }
     }
@@ -24,6 +24,15 @@
 #include "cache.h"
 #include "hamlib/rig_state.h"
 #include "misc.h"
+#include "sleep.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
 
 #define CHECK_RIG_ARG(r) (!(r) || !(r)->caps || !STATE(r)->comm_state)
 
@@ -33,10 +42,537 @@
  * @{
  */
 
+/*
+ * The VFO slots are cache line aligned, more than calloc() promises, so
+ * the cache comes from an aligned allocation and is released with
+ * rig_cache_free().
+ */
+struct rig_cache *rig_cache_alloc(void)
+{
+    void *cache;
+
+#if defined(_WIN32)
+    cache = _aligned_malloc(sizeof(struct rig_cache), HL_CACHELINE);
+#else
+
+    if (posix_memalign(&cache, HL_CACHELINE, sizeof(struct rig_cache)) != 0)
+    {
+        cache = NULL;
+    }
+
+#endif
+
+    if (cache)
+    {
+        memset(cache, 0, sizeof(struct rig_cache));
+    }
+
+    return cache;
+}
+
+void rig_cache_free(struct rig_cache *cache)
+{
+#if defined(_WIN32)
+    _aligned_free(cache);
+#else
+    free(cache);
+#endif
+}
+
+/*
+ * The cache is published seqlock style.  A writer makes seq odd for the
+ * duration of an update and even again when done; readers copy what they
+ * need and start over if seq was odd or moved meanwhile.  Claiming the odd
+ * value with a compare-and-swap also serializes writers, since the API
+ * thread, the poll thread and async readers can all update the cache.
+ *
+ * Nothing between write_begin and write_end may read the cache through
+ * rig_cache_snapshot(), that would spin forever.
+ */
+static void rig_cache_backoff(int *spins)
+{
+    if (++(*spins) > 100)
+    {
+        hl_usleep(1);
+        *spins = 0;
+    }
+}
+
+void rig_cache_write_begin(RIG *rig)
+{
+    struct rig_cache *cachep = CACHE(rig);
+    int spins = 0;
+
+    for (;;)
+    {
+        unsigned int seq = __atomic_load_n(&cachep->seq, __ATOMIC_RELAXED);
+
+        if (!(seq & 1)
+                && __atomic_compare_exchange_n(&cachep->seq, &seq, seq + 1, 0,
+                                               __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            break;
+        }
+
+        rig_cache_backoff(&spins);
+    }
+
+    // the odd sequence must be visible before any of the new data
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void rig_cache_write_end(RIG *rig)
+{
+    struct rig_cache *cachep = CACHE(rig);
+
+    // seq_cst pairs with the waiter's waiters++ then seq load: either it
+    // sees the new seq or we see it waiting
+    __atomic_store_n(&cachep->seq, cachep->seq + 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&cachep->notify.waiters, __ATOMIC_SEQ_CST) > 0)
+    {
+        pthread_mutex_lock(&cachep->notify.lock);
+        pthread_cond_broadcast(&cachep->notify.cond);
+        pthread_mutex_unlock(&cachep->notify.lock);
+    }
+}
+
+/*
+ * Copy len bytes at src, which lies inside the cache, to dst so that
+ * the copy is from a single update.
+ */
+static void rig_cache_read(RIG *rig, void *dst, const void *src, size_t len)
+{
+    const struct rig_cache *cachep = CACHE(rig);
+    unsigned int seq;
+    int spins = 0;
+
+    for (;;)
+    {
+        seq = __atomic_load_n(&cachep->seq, __ATOMIC_ACQUIRE);
+
+        if (seq & 1)
+        {
+            rig_cache_backoff(&spins);
+            continue;
+        }
+
+        memcpy(dst, src, len);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&cachep->seq, __ATOMIC_RELAXED) == seq)
+        {
+            break;
+        }
+    }
+}
+
+/**
+ * \brief Take a consistent copy of the cache without locking
+ * \param rig  The rig handle
+ * \param snap Receives the copy
+ *
+ * Any number of threads may do this concurrently with a writer; the copy
+ * never mixes values (or values and timestamps) from different updates.
+ * The per item cache (levels, funcs...) is not part of the copy, its
+ * entries are read one at a time with rig_cache_get_item().
+ */
+void rig_cache_snapshot(RIG *rig, struct rig_cache *snap)
+{
+    rig_cache_read(rig, snap, CACHE(rig), offsetof(struct rig_cache, items));
+}
+
+/*
+ * Change notification.  The seqlock sequence doubles as a generation
+ * counter: it moves on with every cache update.  Threads that publish the
+ * cache (poll routine, multicast) sleep in rig_cache_wait() until it
+ * moves instead of waking up every few ms to compare fields.  Writers
+ * only take the lock when somebody is waiting.
+ */
+void rig_cache_notify_init(RIG *rig)
+{
+    struct rig_cache_notify *notify = &CACHE(rig)->notify;
+
+    pthread_mutex_init(&notify->lock, NULL);
+    pthread_cond_init(&notify->cond, NULL);
+}
+
+void rig_cache_notify_cleanup(RIG *rig)
+{
+    struct rig_cache_notify *notify = &CACHE(rig)->notify;
+
+    pthread_cond_destroy(&notify->cond);
+    pthread_mutex_destroy(&notify->lock);
+}
+
+/* The generation to pass to rig_cache_wait(), read before the snapshot */
+unsigned int rig_cache_generation(RIG *rig)
+{
+    return __atomic_load_n(&CACHE(rig)->seq, __ATOMIC_ACQUIRE) & ~1U;
+}
+
+/*
+ * Sleep until the cache has been updated since generation *gen, at most
+ * timeout_ms (< 0 for no limit).  Returns 1 and the new generation in
+ * *gen if it was, 0 on timeout.  An update counts even if it wrote the
+ * same values again.
+ */
+int rig_cache_wait(RIG *rig, unsigned int *gen, int timeout_ms)
+{
+    struct rig_cache *cachep = CACHE(rig);
+    struct rig_cache_notify *notify = &cachep->notify;
+    struct timespec deadline;
+    unsigned int now;
+
+    now = rig_cache_generation(rig);
+
+    if (now != *gen)
+    {
+        *gen = now;
+        return 1;
+    }
+
+    if (timeout_ms >= 0)
+    {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    pthread_mutex_lock(&notify->lock);
+    __atomic_add_fetch(&notify->waiters, 1, __ATOMIC_SEQ_CST);
+
+    // an update in progress (odd seq) will wake us when it ends
+    if ((__atomic_load_n(&cachep->seq, __ATOMIC_SEQ_CST) & ~1U) == *gen)
+    {
+        if (timeout_ms >= 0)
+        {
+            pthread_cond_timedwait(&notify->cond, &notify->lock, &deadline);
+        }
+        else
+        {
+            pthread_cond_wait(&notify->cond, &notify->lock);
+        }
+    }
+
+    __atomic_sub_fetch(&notify->waiters, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&notify->lock);
+
+    now = rig_cache_generation(rig);
+
+    if (now != *gen)
+    {
+        *gen = now;
+        return 1;
+    }
+
+    return 0;
+}
+
+/*
+ * Make rig_cache_wait() return, now or when it is next called, e.g. so a
+ * thread sees its stop flag.  This is an empty update.
+ */
+void rig_cache_wake(RIG *rig)
+{
+    rig_cache_write_begin(rig);
+    rig_cache_write_end(rig);
+}
+
+/*
+ * VFO to cache slot, indexed by the bit number of a single-bit vfo_t.
+ * Entries not listed are 0 and mean "not cacheable", which is why the
+ * slot numbers are stored plus one.
+ */
+static const unsigned char vfo_slot_map[32] =
+{
+    [0]  = CACHE_SLOT_MAIN_A + 1,   // RIG_VFO_A
+    [1]  = CACHE_SLOT_MAIN_B + 1,   // RIG_VFO_B
+    [2]  = CACHE_SLOT_MAIN_C + 1,   // RIG_VFO_C
+    [3]  = CACHE_SLOT_SUB_C + 1,    // RIG_VFO_SUB_C
+    [4]  = CACHE_SLOT_MAIN_C + 1,   // RIG_VFO_MAIN_C
+    [5]  = CACHE_SLOT_OTHER + 1,    // RIG_VFO_OTHER
+    [21] = CACHE_SLOT_SUB_A + 1,    // RIG_VFO_SUB_A
+    [22] = CACHE_SLOT_SUB_B + 1,    // RIG_VFO_SUB_B
+    [23] = CACHE_SLOT_MAIN_A + 1,   // RIG_VFO_MAIN_A
+    [24] = CACHE_SLOT_MAIN_B + 1,   // RIG_VFO_MAIN_B
+    [25] = CACHE_SLOT_MAIN_B + 1,   // RIG_VFO_SUB
+    [26] = CACHE_SLOT_MAIN_A + 1,   // RIG_VFO_MAIN
+    [27] = CACHE_SLOT_MAIN_A + 1,   // RIG_VFO_VFO
+    [28] = CACHE_SLOT_MEM + 1,      // RIG_VFO_MEM
+    [29] = CACHE_SLOT_CURR + 1,     // RIG_VFO_CURR
+};
+
+/*
+ * Returns the cache slot for an already resolved VFO, or -1 if that VFO
+ * (or combination of VFOs) is not cached.
+ */
+int rig_cache_slot(vfo_t vfo)
+{
+    if (vfo == 0 || (vfo & (vfo - 1)) != 0)
+    {
+        return -1;
+    }
+
+    return (int) vfo_slot_map[__builtin_ctz(vfo)] - 1;
+}
+
+int64_t rig_cache_now_ns(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    // never 0, that means "invalid"
+    return (int64_t) now.tv_sec * 1000000000 + now.tv_nsec + 1;
+}
+
+/* Age of a slot time in ms, "very old" when it was never set or invalidated */
+int rig_cache_age_ms(int64_t stamp)
+{
+    if (stamp == 0)
+    {
+        return 1000000;
+    }
+
+    return (int)((rig_cache_now_ns() - stamp) / 1000000);
+}
+
+/* Invalidate everything, used when the rig state is unknown */
+void rig_cache_reset(RIG *rig)
+{
+    struct rig_cache *cachep = CACHE(rig);
+    int i;
+
+    rig_cache_write_begin(rig);
+
+    for (i = 0; i < CACHE_SLOT_COUNT; i++)
+    {
+        cachep->slot[i].time_freq = 0;
+        cachep->slot[i].time_mode = 0;
+    }
+
+    for (i = 0; i < RIG_SETTING_MAX; i++)
+    {
+        cachep->items.level[i].time = 0;
+        cachep->items.func[i].time = 0;
+        cachep->items.parm[i].time = 0;
+    }
+
+    cachep->items.rit.time = 0;
+    cachep->items.xit.time = 0;
+    cachep->items.ant.time = 0;
+
+    elapsed_ms(&cachep->time_vfo, HAMLIB_ELAPSED_INVALIDATE);
+    elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_INVALIDATE);
+    elapsed_ms(&cachep->time_split, HAMLIB_ELAPSED_INVALIDATE);
+
+    rig_cache_write_end(rig);
+}
+
+/*
+ * Entry for kind/key, or NULL if that kind or key is not cached.  Keys
+ * are single setting_t bits; RIT and XIT have no key.
+ */
+static struct rig_cache_item *rig_cache_item(RIG *rig, hamlib_cache_t kind,
+        setting_t key)
+{
+    struct rig_cache_items *items = &CACHE(rig)->items;
+    int idx;
+
+    switch (kind)
+    {
+    case HAMLIB_CACHE_RIT:
+        return &items->rit;
+
+    case HAMLIB_CACHE_XIT:
+        return &items->xit;
+
+    case HAMLIB_CACHE_LEVEL:
+    case HAMLIB_CACHE_FUNC:
+    case HAMLIB_CACHE_PARM:
+        break;
+
+    default:
+        return NULL;
+    }
+
+    if (key == 0 || (key & (key - 1)) != 0)
+    {
+        return NULL;
+    }
+
+    idx = rig_setting2idx(key);
+
+    if (kind == HAMLIB_CACHE_LEVEL) { return &items->level[idx]; }
+
+    if (kind == HAMLIB_CACHE_FUNC) { return &items->func[idx]; }
+
+    // string parms point into backend storage, don't keep those
+    if (RIG_PARM_IS_STRING(key)) { return NULL; }
+
+    return &items->parm[idx];
+}
+
+/* Entries remember the real VFO so a VFO change makes them miss */
+static vfo_t rig_cache_item_vfo(RIG *rig, vfo_t vfo)
+{
+    if (vfo == RIG_VFO_CURR || vfo == RIG_VFO_NONE)
+    {
+        return STATE(rig)->current_vfo;
+    }
+
+    return vfo;
+}
+
+static int rig_cache_item_fresh(const struct rig_cache *cachep,
+                                hamlib_cache_t kind, int64_t stamp)
+{
+    int timeout_ms = cachep->items.timeout_ms[kind - HAMLIB_CACHE_LEVEL];
+
+    if (stamp == 0 || timeout_ms == 0)
+    {
+        return 0;
+    }
+
+    return timeout_ms == HAMLIB_CACHE_ALWAYS
+           || rig_cache_age_ms(stamp) < timeout_ms;
+}
+
+/**
+ * \brief Look up a cached level, func, parm, RIT or XIT value
+ * \param rig  The rig handle
+ * \param kind HAMLIB_CACHE_LEVEL, _FUNC, _PARM, _RIT or _XIT
+ * \param vfo  The VFO the value is wanted for
+ * \param key  The level, func or parm bit, 0 for RIT/XIT
+ * \param val  Receives the value on a hit
+ *
+ * \return RIG_OK on a hit, -RIG_ENAVAIL if there is no value younger
+ * than the timeout for \a kind.
+ */
+int rig_cache_get_item(RIG *rig, hamlib_cache_t kind, vfo_t vfo, setting_t key,
+                       value_t *val)
+{
+    const struct rig_cache_item *item = rig_cache_item(rig, kind, key);
+    struct rig_cache_item copy;
+
+    if (item == NULL || CACHE(rig)->items.timeout_ms[kind - HAMLIB_CACHE_LEVEL] == 0)
+    {
+        return -RIG_ENAVAIL;
+    }
+
+    rig_cache_read(rig, &copy, item, sizeof(copy));
+
+    if (copy.vfo != rig_cache_item_vfo(rig, vfo)
+            || !rig_cache_item_fresh(CACHE(rig), kind, copy.time))
+    {
+        return -RIG_ENAVAIL;
+    }
+
+    *val = copy.val;
+    return RIG_OK;
+}
+
+void rig_cache_set_item(RIG *rig, hamlib_cache_t kind, vfo_t vfo,
+                        setting_t key, value_t val)
+{
+    struct rig_cache_item *item = rig_cache_item(rig, kind, key);
+    int64_t now;
+
+    if (item == NULL)
+    {
+        return;
+    }
+
+    now = rig_cache_now_ns();
+
+    rig_cache_write_begin(rig);
+    item->val = val;
+    item->vfo = rig_cache_item_vfo(rig, vfo);
+    item->time = now;
+    rig_cache_write_end(rig);
+}
+
+/* Forget an entry, for setters whose value the rig may round.
+ * An entry holds one value whatever VFO set it, so it is forgotten
+ * regardless of vfo. */
+void rig_cache_invalidate_item(RIG *rig, hamlib_cache_t kind, vfo_t vfo,
+                               setting_t key)
+{
+    struct rig_cache_item *item = rig_cache_item(rig, kind, key);
+
+    (void)vfo;
+
+    rig_cache_write_begin(rig);
+
+    if (kind == HAMLIB_CACHE_ANT)
+    {
+        // antenna settings interact, forget them all
+        CACHE(rig)->items.ant.time = 0;
+    }
+    else if (item != NULL)
+    {
+        item->time = 0;
+    }
+
+    rig_cache_write_end(rig);
+}
+
+int rig_cache_get_ant(RIG *rig, vfo_t vfo, ant_t ant, value_t *option,
+                      ant_t *ant_curr, ant_t *ant_tx, ant_t *ant_rx)
+{
+    struct rig_cache_ant copy;
+
+    if (CACHE(rig)->items.timeout_ms[HAMLIB_CACHE_ANT - HAMLIB_CACHE_LEVEL] == 0)
+    {
+        return -RIG_ENAVAIL;
+    }
+
+    rig_cache_read(rig, &copy, &CACHE(rig)->items.ant, sizeof(copy));
+
+    if (copy.ant != ant || copy.vfo != rig_cache_item_vfo(rig, vfo)
+            || !rig_cache_item_fresh(CACHE(rig), HAMLIB_CACHE_ANT, copy.time))
+    {
+        return -RIG_ENAVAIL;
+    }
+
+    *option = copy.option;
+    *ant_curr = copy.ant_curr;
+    *ant_tx = copy.ant_tx;
+    *ant_rx = copy.ant_rx;
+    return RIG_OK;
+}
+
+void rig_cache_set_ant(RIG *rig, vfo_t vfo, ant_t ant, value_t option,
+                       ant_t ant_curr, ant_t ant_tx, ant_t ant_rx)
+{
+    struct rig_cache_ant *cant = &CACHE(rig)->items.ant;
+    int64_t now = rig_cache_now_ns();
+
+    rig_cache_write_begin(rig);
+    cant->ant = ant;
+    cant->option = option;
+    cant->ant_curr = ant_curr;
+    cant->ant_tx = ant_tx;
+    cant->ant_rx = ant_rx;
+    cant->vfo = rig_cache_item_vfo(rig, vfo);
+    cant->time = now;
+    rig_cache_write_end(rig);
+}
+
 int rig_set_cache_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
 {
     struct rig_cache *cachep = CACHE(rig);
     struct rig_state *rs = STATE(rig);
+    struct rig_cache_vfo *slot;
+    int64_t now;
+    int i;
 
     ENTERFUNC;
 
@@ -65,93 +601,50 @@ int rig_set_cache_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
 
     if (vfo == RIG_VFO_OTHER) { vfo = vfo_fixup(rig, vfo, cachep->split); }
 
-    if (vfo == rs->current_vfo)
+    if (vfo == RIG_VFO_ALL) // we'll use ALL to reset all VFO mode caches
     {
-        cachep->modeCurr = mode;
+        rig_cache_write_begin(rig);
 
-        if (width > 0)
+        for (i = CACHE_SLOT_MAIN_A; i <= CACHE_SLOT_SUB_C; i++)
         {
-            cachep->widthCurr = width;
+            cachep->slot[i].time_mode = 0;
         }
 
-        elapsed_ms(&cachep->time_modeCurr, HAMLIB_ELAPSED_SET);
+        rig_cache_write_end(rig);
+        RETURNFUNC(RIG_OK);
     }
 
-    switch (vfo)
-    {
-    case RIG_VFO_ALL: // we'll use NONE to reset all VFO caches
-        elapsed_ms(&cachep->time_modeMainA, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_modeMainB, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_modeMainC, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_modeSubA, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_modeSubB, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_modeSubC, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_widthMainA, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_widthMainB, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_widthMainC, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_widthSubA, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_widthSubB, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_widthSubC, HAMLIB_ELAPSED_INVALIDATE);
-        break;
-
-    case RIG_VFO_A:
-    case RIG_VFO_VFO:
-    case RIG_VFO_MAIN:
-    case RIG_VFO_MAIN_A:
-        cachep->modeMainA = mode;
+    i = rig_cache_slot(vfo);
 
-        if (width > 0) { cachep->widthMainA = width; }
-
-        elapsed_ms(&cachep->time_modeMainA, HAMLIB_ELAPSED_SET);
-        elapsed_ms(&cachep->time_widthMainA, HAMLIB_ELAPSED_SET);
-        break;
-
-    case RIG_VFO_B:
-    case RIG_VFO_SUB:
-    case RIG_VFO_MAIN_B:
-        cachep->modeMainB = mode;
-
-        if (width > 0) { cachep->widthMainB = width; }
+    if (i < 0 || i == CACHE_SLOT_CURR || i == CACHE_SLOT_OTHER)
+    {
+        rig_debug(RIG_DEBUG_WARN, "%s(%d): unknown vfo=%s\n", __func__, __LINE__,
+                  rig_strvfo(vfo));
+        RETURNFUNC(-RIG_EINTERNAL);
+    }
 
-        elapsed_ms(&cachep->time_modeMainB, HAMLIB_ELAPSED_SET);
-        elapsed_ms(&cachep->time_widthMainB, HAMLIB_ELAPSED_SET);
-        break;
+    now = rig_cache_now_ns();
 
-    case RIG_VFO_C:
-    case RIG_VFO_MAIN_C:
-        cachep->modeMainC = mode;
+    rig_cache_write_begin(rig);
 
-        if (width > 0) { cachep->widthMainC = width; }
+    if (vfo == rs->current_vfo)
+    {
+        slot = &cachep->slot[CACHE_SLOT_CURR];
+        slot->mode = mode;
 
-        elapsed_ms(&cachep->time_modeMainC, HAMLIB_ELAPSED_SET);
-        elapsed_ms(&cachep->time_widthMainC, HAMLIB_ELAPSED_SET);
-        break;
+        if (width > 0) { slot->width = width; }
 
-    case RIG_VFO_SUB_A:
-        cachep->modeSubA = mode;
-        elapsed_ms(&cachep->time_modeSubA, HAMLIB_ELAPSED_SET);
-        break;
+        slot->time_mode = now;
+    }
 
-    case RIG_VFO_SUB_B:
-        cachep->modeSubB = mode;
-        elapsed_ms(&cachep->time_modeSubB, HAMLIB_ELAPSED_SET);
-        break;
+    slot = &cachep->slot[i];
+    slot->mode = mode;
 
-    case RIG_VFO_SUB_C:
-        cachep->modeSubC = mode;
-        elapsed_ms(&cachep->time_modeSubC, HAMLIB_ELAPSED_SET);
-        break;
+    if (width > 0) { slot->width = width; }
 
-    case RIG_VFO_MEM:
-        cachep->modeMem = mode;
-        elapsed_ms(&cachep->time_modeMem, HAMLIB_ELAPSED_SET);
-        break;
+    slot->time_mode = now;
 
-    default:
-        rig_debug(RIG_DEBUG_WARN, "%s(%d): unknown vfo=%s\n", __func__, __LINE__,
-                  rig_strvfo(vfo));
-        RETURNFUNC(-RIG_EINTERNAL);
-    }
+    rig_cache_write_end(rig);
 
     rig_cache_show(rig, __func__, __LINE__);
     RETURNFUNC(RIG_OK);
@@ -159,9 +652,10 @@ int rig_set_cache_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
 
 int rig_set_cache_freq(RIG *rig, vfo_t vfo, freq_t freq)
 {
-    int flag = HAMLIB_ELAPSED_SET;
     struct rig_cache *cachep = CACHE(rig);
     struct rig_state *rs = STATE(rig);
+    int64_t stamp;
+    int i;
 
     if (rig_need_debug(RIG_DEBUG_CACHE))
     {
@@ -178,9 +672,6 @@ int rig_set_cache_freq(RIG *rig, vfo_t vfo, freq_t freq)
         vfo = rs->current_vfo;
     }
 
-    // if freq == 0 then we are asking to invalidate the cache
-    if (freq == 0) { flag = HAMLIB_ELAPSED_INVALIDATE; }
-
     // pick a sane default
     if (vfo == RIG_VFO_NONE || vfo == RIG_VFO_CURR) { vfo = RIG_VFO_A; }
 
@@ -193,91 +684,44 @@ int rig_set_cache_freq(RIG *rig, vfo_t vfo, freq_t freq)
                   rig_strvfo(vfo), freq);
     }
 
-    if (vfo == rs->current_vfo)
+    if (vfo == RIG_VFO_ALL) // we'll use ALL to reset all caches
     {
-        cachep->freqCurr = freq;
-        elapsed_ms(&cachep->time_freqCurr, flag);
-    }
-
-    switch (vfo)
-    {
-    case RIG_VFO_ALL: // we'll use NONE to reset all VFO caches
-        elapsed_ms(&cachep->time_freqMainA, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_freqMainB, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_freqMainC, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_freqSubA, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_freqSubB, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_freqSubC, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_freqMem, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_vfo, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_modeMainA, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_modeMainB, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_modeMainC, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_modeSubA, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_modeSubB, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_modeSubC, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_widthMainA, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_widthMainB, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_widthMainC, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_widthSubA, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_widthSubB, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_widthSubC, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_INVALIDATE);
-        elapsed_ms(&cachep->time_split, HAMLIB_ELAPSED_INVALIDATE);
-        break;
-
-    case RIG_VFO_A:
-    case RIG_VFO_VFO:
-    case RIG_VFO_MAIN:
-    case RIG_VFO_MAIN_A:
-        cachep->freqMainA = freq;
-        elapsed_ms(&cachep->time_freqMainA, flag);
-        break;
-
-    case RIG_VFO_B:
-    case RIG_VFO_MAIN_B:
-    case RIG_VFO_SUB:
-        cachep->freqMainB = freq;
-        elapsed_ms(&cachep->time_freqMainB, flag);
-        break;
-
-    case RIG_VFO_C:
-    case RIG_VFO_MAIN_C:
-        cachep->freqMainC = freq;
-        elapsed_ms(&cachep->time_freqMainC, flag);
-        break;
-
-    case RIG_VFO_SUB_A:
-        cachep->freqSubA = freq;
-        elapsed_ms(&cachep->time_freqSubA, flag);
-        break;
-
-    case RIG_VFO_SUB_B:
-        cachep->freqSubB = freq;
-        elapsed_ms(&cachep->time_freqSubB, flag);
-        break;
-
-    case RIG_VFO_SUB_C:
-        cachep->freqSubC = freq;
-        elapsed_ms(&cachep->time_freqSubC, flag);
-        break;
-
-    case RIG_VFO_MEM:
-        cachep->freqMem = freq;
-        elapsed_ms(&cachep->time_freqMem, flag);
-        break;
+        rig_cache_reset(rig);
+        return (RIG_OK);
+    }
 
-    case RIG_VFO_OTHER:
+    if (vfo == RIG_VFO_OTHER)
+    {
         rig_debug(RIG_DEBUG_VERBOSE, "%s(%d): ignoring VFO_OTHER\n", __func__,
                   __LINE__);
-        break;
+        return (RIG_OK);
+    }
 
-    default:
+    i = rig_cache_slot(vfo);
+
+    if (i < 0 || i == CACHE_SLOT_CURR)
+    {
         rig_debug(RIG_DEBUG_WARN, "%s(%d): unknown vfo?, vfo=%s\n", __func__, __LINE__,
                   rig_strvfo(vfo));
         return (-RIG_EINVAL);
     }
 
+    // if freq == 0 then we are asking to invalidate the cache
+    stamp = freq == 0 ? 0 : rig_cache_now_ns();
+
+    rig_cache_write_begin(rig);
+
+    if (vfo == rs->current_vfo)
+    {
+        cachep->slot[CACHE_SLOT_CURR].freq = freq;
+        cachep->slot[CACHE_SLOT_CURR].time_freq = stamp;
+    }
+
+    cachep->slot[i].freq = freq;
+    cachep->slot[i].time_freq = stamp;
+
+    rig_cache_write_end(rig);
+
     if (rig_need_debug(RIG_DEBUG_CACHE))
     {
         rig_cache_show(rig, __func__, __LINE__);
@@ -287,6 +731,113 @@ int rig_set_cache_freq(RIG *rig, vfo_t vfo, freq_t freq)
     return (RIG_OK);
 }
 
+void rig_set_cache_ptt(RIG *rig, ptt_t ptt)
+{
+    struct rig_cache *cachep = CACHE(rig);
+
+    rig_cache_write_begin(rig);
+    cachep->ptt = ptt;
+    elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
+    rig_cache_write_end(rig);
+}
+
+void rig_set_cache_vfo(RIG *rig, vfo_t vfo)
+{
+    struct rig_cache *cachep = CACHE(rig);
+
+    rig_cache_write_begin(rig);
+    cachep->vfo = vfo;
+    elapsed_ms(&cachep->time_vfo, HAMLIB_ELAPSED_SET);
+    rig_cache_write_end(rig);
+}
+
+// split and its TX VFO are published together so readers never mix them
+void rig_set_cache_split(RIG *rig, split_t split, vfo_t split_vfo)
+{
+    struct rig_cache *cachep = CACHE(rig);
+
+    rig_cache_write_begin(rig);
+    cachep->split = split;
+    cachep->split_vfo = split_vfo;
+    elapsed_ms(&cachep->time_split, HAMLIB_ELAPSED_SET);
+    rig_cache_write_end(rig);
+}
+
+/*
+ * Everything a backend get_status() read, published at once so readers
+ * see freq, mode, PTT and split from the same reply.
+ */
+void rig_set_cache_status(RIG *rig, const struct rig_vfo_status *status)
+{
+    struct rig_cache *cachep = CACHE(rig);
+    struct rig_cache_vfo *slot = NULL;
+    struct rig_cache_vfo *curr = NULL;
+    vfo_t vfo = status->vfo;
+    int64_t now = rig_cache_now_ns();
+    int i;
+
+    if (vfo == RIG_VFO_SUB && cachep->satmode) { vfo = RIG_VFO_SUB_A; }
+
+    i = rig_cache_slot(vfo);
+
+    if (i >= 0 && i != CACHE_SLOT_CURR && i != CACHE_SLOT_OTHER)
+    {
+        slot = &cachep->slot[i];
+
+        if (vfo == STATE(rig)->current_vfo)
+        {
+            curr = &cachep->slot[CACHE_SLOT_CURR];
+        }
+    }
+
+    rig_cache_write_begin(rig);
+
+    for (i = 0; i < 2; i++)
+    {
+        struct rig_cache_vfo *s = i == 0 ? slot : curr;
+
+        if (s == NULL) { continue; }
+
+        if (status->valid & RIG_VFO_STATUS_FREQ)
+        {
+            s->freq = status->freq;
+            s->time_freq = now;
+        }
+
+        if (status->valid & RIG_VFO_STATUS_MODE)
+        {
+            // the width of the previous mode says nothing about this one
+            if (!(status->valid & RIG_VFO_STATUS_WIDTH) && s->mode != status->mode)
+            {
+                s->width = 0;
+            }
+
+            s->mode = status->mode;
+            s->time_mode = now;
+        }
+
+        if (status->valid & RIG_VFO_STATUS_WIDTH)
+        {
+            s->width = status->width;
+        }
+    }
+
+    if (status->valid & RIG_VFO_STATUS_PTT)
+    {
+        cachep->ptt = status->ptt;
+        elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
+    }
+
+    if (status->valid & RIG_VFO_STATUS_SPLIT)
+    {
+        cachep->split = status->split;
+        cachep->split_vfo = status->tx_vfo;
+        elapsed_ms(&cachep->time_split, HAMLIB_ELAPSED_SET);
+    }
+
+    rig_cache_write_end(rig);
+}
+
 /**
  * \brief get cached values for a VFO
  * \param rig           The rig handle
@@ -311,8 +862,11 @@ int rig_set_cache_freq(RIG *rig, vfo_t vfo, freq_t freq)
 int rig_get_cache(RIG *rig, vfo_t vfo, freq_t *freq, int *cache_ms_freq,
                   rmode_t *mode, int *cache_ms_mode, pbwidth_t *width, int *cache_ms_width)
 {
-    struct rig_cache *cachep;
+    struct rig_cache snap;
+    const struct rig_cache *cachep;
+    const struct rig_cache_vfo *slot;
     struct rig_state *rs;
+    int i;
 
     if (CHECK_RIG_ARG(rig) || !freq || !cache_ms_freq ||
             !mode || !cache_ms_mode || !width || !cache_ms_width)
@@ -320,7 +874,9 @@ int rig_get_cache(RIG *rig, vfo_t vfo, freq_t *freq, int *cache_ms_freq,
         return -RIG_EINVAL;
     }
 
-    cachep = CACHE(rig);
+    // work on a private copy so freq, mode, width and their ages agree
+    rig_cache_snapshot(rig, &snap);
+    cachep = &snap;
     rs = STATE(rig);
 
     if (rig_need_debug(RIG_DEBUG_CACHE))
@@ -403,126 +959,23 @@ int rig_get_cache(RIG *rig, vfo_t vfo, freq_t *freq, int *cache_ms_freq,
     // If we're in satmode we map SUB to SUB_A
     if (vfo == RIG_VFO_SUB && cachep->satmode) { vfo = RIG_VFO_SUB_A; };
 
-    switch (vfo)
-    {
-    case RIG_VFO_CURR:
-        *freq = cachep->freqCurr;
-        *mode = cachep->modeCurr;
-        *width = cachep->widthCurr;
-        *cache_ms_freq = elapsed_ms(&cachep->time_freqCurr,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_mode = elapsed_ms(&cachep->time_modeCurr,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_width = elapsed_ms(&cachep->time_widthCurr,
-                                     HAMLIB_ELAPSED_GET);
-        break;
-
-    case RIG_VFO_OTHER:
-        *freq = cachep->freqOther;
-        *mode = cachep->modeOther;
-        *width = cachep->widthOther;
-        *cache_ms_freq = elapsed_ms(&cachep->time_freqOther,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_mode = elapsed_ms(&cachep->time_modeOther,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_width = elapsed_ms(&cachep->time_widthOther,
-                                     HAMLIB_ELAPSED_GET);
-        break;
-
-    case RIG_VFO_A:
-    case RIG_VFO_VFO:
-    case RIG_VFO_MAIN:
-    case RIG_VFO_MAIN_A:
-        *freq = cachep->freqMainA;
-        *mode = cachep->modeMainA;
-        *width = cachep->widthMainA;
-        *cache_ms_freq = elapsed_ms(&cachep->time_freqMainA,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_mode = elapsed_ms(&cachep->time_modeMainA,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_width = elapsed_ms(&cachep->time_widthMainA,
-                                     HAMLIB_ELAPSED_GET);
-        break;
-
-    case RIG_VFO_B:
-    case RIG_VFO_SUB:
-    case RIG_VFO_MAIN_B:
-        *freq = cachep->freqMainB;
-        *mode = cachep->modeMainB;
-        *width = cachep->widthMainB;
-        *cache_ms_freq = elapsed_ms(&cachep->time_freqMainB,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_mode = elapsed_ms(&cachep->time_modeMainB,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_width = elapsed_ms(&cachep->time_widthMainB,
-                                     HAMLIB_ELAPSED_GET);
-        break;
-
-    case RIG_VFO_SUB_A:
-        *freq = cachep->freqSubA;
-        *mode = cachep->modeSubA;
-        *width = cachep->widthSubA;
-        *cache_ms_freq = elapsed_ms(&cachep->time_freqSubA,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_mode = elapsed_ms(&cachep->time_modeSubA,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_width = elapsed_ms(&cachep->time_widthSubA,
-                                     HAMLIB_ELAPSED_GET);
-        break;
-
-    case RIG_VFO_SUB_B:
-        *freq = cachep->freqSubB;
-        *mode = cachep->modeSubB;
-        *width = cachep->widthSubB;
-        *cache_ms_freq = elapsed_ms(&cachep->time_freqSubB,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_mode = elapsed_ms(&cachep->time_modeSubB,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_width = elapsed_ms(&cachep->time_widthSubB,
-                                     HAMLIB_ELAPSED_GET);
-        break;
-
-    case RIG_VFO_C:
-        //case RIG_VFO_MAINC: // not used by any rig yet
-        *freq = cachep->freqMainC;
-        *mode = cachep->modeMainC;
-        *width = cachep->widthMainC;
-        *cache_ms_freq = elapsed_ms(&cachep->time_freqMainC,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_mode = elapsed_ms(&cachep->time_modeMainC,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_width = elapsed_ms(&cachep->time_widthMainC,
-                                     HAMLIB_ELAPSED_GET);
-        break;
-
-    case RIG_VFO_SUB_C:
-        *freq = cachep->freqSubC;
-        *mode = cachep->modeSubC;
-        *width = cachep->widthSubC;
-        *cache_ms_freq = elapsed_ms(&cachep->time_freqSubC,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_mode = elapsed_ms(&cachep->time_modeSubC,
-                                    HAMLIB_ELAPSED_GET);
-        *cache_ms_width = elapsed_ms(&cachep->time_widthSubC,
-                                     HAMLIB_ELAPSED_GET);
-        break;
-
-    case RIG_VFO_MEM:
-        *freq = cachep->freqMem;
-        *mode = cachep->modeMem;
-        *width = cachep->widthMem;
-        *cache_ms_freq = elapsed_ms(&cachep->time_freqMem, HAMLIB_ELAPSED_GET);
-        *cache_ms_mode = elapsed_ms(&cachep->time_modeMem, HAMLIB_ELAPSED_GET);
-        *cache_ms_width = elapsed_ms(&cachep->time_widthMem,
-                                     HAMLIB_ELAPSED_GET);
-        break;
+    i = rig_cache_slot(vfo);
 
-    default:
+    if (i < 0)
+    {
         rig_debug(RIG_DEBUG_WARN, "%s(%d): unknown vfo?, vfo=%s\n", __func__, __LINE__,
                   rig_strvfo(vfo));
         RETURNFUNC2(-RIG_EINVAL);
     }
 
+    slot = &cachep->slot[i];
+    *freq = slot->freq;
+    *mode = slot->mode;
+    *width = slot->width;
+    *cache_ms_freq = rig_cache_age_ms(slot->time_freq);
+    *cache_ms_mode = rig_cache_age_ms(slot->time_mode);
+    *cache_ms_width = *cache_ms_mode;
+
     rig_debug(RIG_DEBUG_CACHE, "%s(%d): vfo=%s, freq=%.0f, mode=%s, width=%d\n",
               __func__, __LINE__, rig_strvfo(vfo),
               (double)*freq, rig_strrmode(*mode), (int)*width);
@@ -571,47 +1024,67 @@ int rig_get_cache_freq(RIG *rig, vfo_t vfo, freq_t *freq, int *cache_ms_freq_p)
 
 /* Get cache timeout period
  * Returns value in msec, -1 if error
+ * VFO, freq, mode, width, PTT and split share one timeout, which is also
+ * what HAMLIB_CACHE_ALL selects.  Levels, funcs, parms, RIT, XIT and
+ * antenna each have their own and are only set individually.
  */
 int HAMLIB_API rig_get_cache_timeout_ms(RIG *rig, hamlib_cache_t selection)
 {
     rig_debug(RIG_DEBUG_TRACE, "%s: called selection=%d\n", __func__, selection);
     if (!rig) {return -1;}
+
+    if (selection >= HAMLIB_CACHE_LEVEL && selection <= HAMLIB_CACHE_ANT)
+    {
+        return CACHE(rig)->items.timeout_ms[selection - HAMLIB_CACHE_LEVEL];
+    }
+
     return CACHE(rig)->timeout_ms;
 }
 
 int HAMLIB_API rig_set_cache_timeout_ms(RIG *rig, hamlib_cache_t selection,
                                         int ms)
 {
+    struct rig_cache *cachep;
+
     rig_debug(RIG_DEBUG_TRACE, "%s: called selection=%d, ms=%d\n", __func__,
               selection, ms);
     if (!rig) {return -RIG_EINVAL;}
-    CACHE(rig)->timeout_ms = ms;
+
+    cachep = CACHE(rig);
+
+    if (selection >= HAMLIB_CACHE_LEVEL && selection <= HAMLIB_CACHE_ANT)
+    {
+        cachep->items.timeout_ms[selection - HAMLIB_CACHE_LEVEL] = ms;
+        return RIG_OK;
+    }
+
+    cachep->timeout_ms = ms;
     return RIG_OK;
 }
 
 void rig_cache_show(RIG *rig, const char *func, int line)
 {
-    struct rig_cache *cachep = CACHE(rig);
+    const struct rig_cache_vfo *slot = CACHE(rig)->slot;
 
     rig_debug(RIG_DEBUG_CACHE,
               "%s(%d): freqMainA=%.0f, modeMainA=%s, widthMainA=%d\n", func, line,
-              cachep->freqMainA, rig_strrmode(cachep->modeMainA),
-              (int)cachep->widthMainA);
+              slot[CACHE_SLOT_MAIN_A].freq, rig_strrmode(slot[CACHE_SLOT_MAIN_A].mode),
+              (int)slot[CACHE_SLOT_MAIN_A].width);
     rig_debug(RIG_DEBUG_CACHE,
               "%s(%d): freqMainB=%.0f, modeMainB=%s, widthMainB=%d\n", func, line,
-              cachep->freqMainB, rig_strrmode(cachep->modeMainB),
-              (int)cachep->widthMainB);
+              slot[CACHE_SLOT_MAIN_B].freq, rig_strrmode(slot[CACHE_SLOT_MAIN_B].mode),
+              (int)slot[CACHE_SLOT_MAIN_B].width);
 
     if (STATE(rig)->vfo_list & RIG_VFO_SUB_A)
     {
         rig_debug(RIG_DEBUG_CACHE,
                   "%s(%d): freqSubA=%.0f, modeSubA=%s, widthSubA=%d\n", func, line,
-                  cachep->freqSubA, rig_strrmode(cachep->modeSubA),
-                  (int)cachep->widthSubA);
+                  slot[CACHE_SLOT_SUB_A].freq, rig_strrmode(slot[CACHE_SLOT_SUB_A].mode),
+                  (int)slot[CACHE_SLOT_SUB_A].width);
         rig_debug(RIG_DEBUG_CACHE,
                   "%s(%d): freqSubB=%.0f, modeSubB=%s, widthSubB=%d\n", func, line,
-                  cachep->freqSubB, rig_strrmode(cachep->modeSubB),
-                  (int)cachep->widthSubB);
+                  slot[CACHE_SLOT_SUB_B].freq, rig_strrmode(slot[CACHE_SLOT_SUB_B].mode),
+                  (int)slot[CACHE_SLOT_SUB_B].width);
     }
 }
 
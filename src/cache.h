@@ -25,6 +25,8 @@
 #define _CACHE_H
 
 #include "hamlib/rig.h"
+#include "flight.h"
+#include "prio.h"
 
 __BEGIN_DECLS
 
@@ -36,6 +38,89 @@ __BEGIN_DECLS
  *      - n3gb 2025-05-14
  */
 
+#define HL_CACHELINE 64
+
+#if defined(__GNUC__)
+#define HL_CACHELINE_ALIGNED __attribute__((aligned(HL_CACHELINE)))
+#else
+#define HL_CACHELINE_ALIGNED
+#endif
+
+/*
+ * Cached VFO slots.  The abstraction is based on dual VFO rigs and mapped
+ * to all others, so there are four main states: MainA, MainB, SubA, SubB.
+ * Main is the Main VFO and Sub is for the 2nd VFO.  Most rigs have MainA
+ * and MainB, dual VFO rigs can have SubA and SubB too.  For dual VFO rigs
+ * simplex operations are all done on MainA/MainB -- ergo this abstraction.
+ */
+enum rig_cache_slot_e {
+    CACHE_SLOT_CURR,    // current VFO, whichever that is
+    CACHE_SLOT_OTHER,   // other VFO
+    CACHE_SLOT_MAIN_A,  // VFO_A, VFO_VFO, VFO_MAIN and VFO_MAIN_A
+    CACHE_SLOT_MAIN_B,  // VFO_B, VFO_SUB and VFO_MAIN_B
+    CACHE_SLOT_MAIN_C,  // VFO_C and VFO_MAIN_C
+    CACHE_SLOT_SUB_A,   // VFO_SUB_A -- only for rigs with dual Sub VFOs
+    CACHE_SLOT_SUB_B,   // VFO_SUB_B -- only for rigs with dual Sub VFOs
+    CACHE_SLOT_SUB_C,   // VFO_SUB_C -- only for rigs with 3 Sub VFOs
+    CACHE_SLOT_MEM,     // VFO_MEM -- last MEM channel
+    CACHE_SLOT_COUNT
+};
+
+/*
+ * Everything cached for one VFO, in one cache line.  Times are
+ * CLOCK_MONOTONIC nanoseconds of the last update, 0 when never set or
+ * invalidated.  Mode and width are always stored together and share a
+ * time; freq changes on its own (tuning) and must not refresh the mode.
+ */
+struct rig_cache_vfo {
+    freq_t freq;
+    rmode_t mode;
+    pbwidth_t width;    // if non-zero then rig has separate width for this VFO
+    int64_t time_freq;
+    int64_t time_mode;
+} HL_CACHELINE_ALIGNED;
+
+/*
+ * Cached levels, funcs, parms, RIT/XIT and antenna.  These are kept per
+ * item rather than per VFO: the VFO a value was read for is stored with
+ * it and a lookup for another VFO is a miss.  Each kind has its own
+ * timeout, see rig_set_cache_timeout_ms().
+ */
+#define CACHE_ITEM_KINDS (HAMLIB_CACHE_ANT - HAMLIB_CACHE_LEVEL + 1)
+
+struct rig_cache_item {
+    value_t val;
+    vfo_t vfo;
+    int64_t time;       // CLOCK_MONOTONIC ns, 0 when invalid
+};
+
+struct rig_cache_ant {
+    ant_t ant;          // antenna asked for
+    value_t option;
+    ant_t ant_curr;
+    ant_t ant_tx;
+    ant_t ant_rx;
+    vfo_t vfo;
+    int64_t time;
+};
+
+struct rig_cache_items {
+    int timeout_ms[CACHE_ITEM_KINDS];   // indexed by kind - HAMLIB_CACHE_LEVEL
+    struct rig_cache_item level[RIG_SETTING_MAX];
+    struct rig_cache_item func[RIG_SETTING_MAX];
+    struct rig_cache_item parm[RIG_SETTING_MAX];
+    struct rig_cache_item rit;
+    struct rig_cache_item xit;
+    struct rig_cache_ant ant;
+};
+
+/* Threads sleeping in rig_cache_wait() until the cache changes */
+struct rig_cache_notify {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int waiters;        // read by writers without the lock
+};
+
 /**
  * \brief Rig cache data
  *
@@ -43,77 +128,22 @@ __BEGIN_DECLS
  * Replaces cache structure(s) in state
  */
 struct rig_cache {
+    unsigned int seq; // seqlock sequence, odd while an update is in progress
     int timeout_ms;  // the cache timeout for invalidating itself
     vfo_t vfo;
-    //freq_t freq; // to be deprecated in 4.1 when full Main/Sub/A/B caching is implemented in 4.1
-    // other abstraction here is based on dual vfo rigs and mapped to all others
-    // So we have four possible states of rig
-    // MainA, MainB, SubA, SubB
-    // Main is the Main VFO and Sub is for the 2nd VFO
-    // Most rigs have MainA and MainB
-    // Dual VFO rigs can have SubA and SubB too
-    // For dual VFO rigs simplex operations are all done on MainA/MainB -- ergo this abstraction
-    freq_t freqCurr; // Other VFO
-    freq_t freqOther; // Other VFO
-    freq_t freqMainA; // VFO_A, VFO_MAIN, and VFO_MAINA
-    freq_t freqMainB; // VFO_B, VFO_SUB, and VFO_MAINB
-    freq_t freqMainC; // VFO_C, VFO_MAINC
-    freq_t freqSubA;  // VFO_SUBA -- only for rigs with dual Sub VFOs
-    freq_t freqSubB;  // VFO_SUBB -- only for rigs with dual Sub VFOs
-    freq_t freqSubC;  // VFO_SUBC -- only for rigs with 3 Sub VFOs
-    freq_t freqMem;   // VFO_MEM -- last MEM channel
-    rmode_t modeCurr;
-    rmode_t modeOther;
-    rmode_t modeMainA;
-    rmode_t modeMainB;
-    rmode_t modeMainC;
-    rmode_t modeSubA;
-    rmode_t modeSubB;
-    rmode_t modeSubC;
-    rmode_t modeMem;
-    pbwidth_t widthCurr; // if non-zero then rig has separate width for MainA
-    pbwidth_t widthOther; // if non-zero then rig has separate width for MainA
-    pbwidth_t widthMainA; // if non-zero then rig has separate width for MainA
-    pbwidth_t widthMainB; // if non-zero then rig has separate width for MainB
-    pbwidth_t widthMainC; // if non-zero then rig has separate width for MainC
-    pbwidth_t widthSubA;  // if non-zero then rig has separate width for SubA
-    pbwidth_t widthSubB;  // if non-zero then rig has separate width for SubB
-    pbwidth_t widthSubC;  // if non-zero then rig has separate width for SubC
-    pbwidth_t widthMem;  // if non-zero then rig has separate width for Mem
     ptt_t ptt;
     split_t split;
     vfo_t split_vfo;  // split caches two values
-    struct timespec time_freqCurr;
-    struct timespec time_freqOther;
-    struct timespec time_freqMainA;
-    struct timespec time_freqMainB;
-    struct timespec time_freqMainC;
-    struct timespec time_freqSubA;
-    struct timespec time_freqSubB;
-    struct timespec time_freqSubC;
-    struct timespec time_freqMem;
     struct timespec time_vfo;
-    struct timespec time_modeCurr;
-    struct timespec time_modeOther;
-    struct timespec time_modeMainA;
-    struct timespec time_modeMainB;
-    struct timespec time_modeMainC;
-    struct timespec time_modeSubA;
-    struct timespec time_modeSubB;
-    struct timespec time_modeSubC;
-    struct timespec time_modeMem;
-    struct timespec time_widthCurr;
-    struct timespec time_widthOther;
-    struct timespec time_widthMainA;
-    struct timespec time_widthMainB;
-    struct timespec time_widthMainC;
-    struct timespec time_widthSubA;
-    struct timespec time_widthSubB;
-    struct timespec time_widthSubC;
-    struct timespec time_widthMem;
     struct timespec time_ptt;
     struct timespec time_split;
     int satmode; // if rig is in satellite mode
+    struct rig_cache_vfo slot[CACHE_SLOT_COUNT]; // indexed by rig_cache_slot()
+    // from here on not copied by rig_cache_snapshot()
+    struct rig_cache_items items;
+    struct rig_flights flights; // gets in progress, see flight.c
+    struct rig_prio_sched sched; // rig_lock() queue, see prio.c
+    struct rig_cache_notify notify; // see rig_cache_wait()
 };
 
 /* Access macros */
@@ -125,7 +155,35 @@ struct rig_cache {
  */
 int rig_set_cache_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width);
 int rig_set_cache_freq(RIG *rig, vfo_t vfo, freq_t freq);
+void rig_set_cache_ptt(RIG *rig, ptt_t ptt);
+void rig_set_cache_vfo(RIG *rig, vfo_t vfo);
+void rig_set_cache_split(RIG *rig, split_t split, vfo_t split_vfo);
+void rig_set_cache_status(RIG *rig, const struct rig_vfo_status *status);
+struct rig_cache *rig_cache_alloc(void);
+void rig_cache_free(struct rig_cache *cache);
 void rig_cache_show(RIG *rig, const char *func, int line);
+void rig_cache_write_begin(RIG *rig);
+void rig_cache_write_end(RIG *rig);
+void rig_cache_snapshot(RIG *rig, struct rig_cache *snap);
+void rig_cache_notify_init(RIG *rig);
+void rig_cache_notify_cleanup(RIG *rig);
+unsigned int rig_cache_generation(RIG *rig);
+int rig_cache_wait(RIG *rig, unsigned int *gen, int timeout_ms);
+void rig_cache_wake(RIG *rig);
+int rig_cache_slot(vfo_t vfo);
+int64_t rig_cache_now_ns(void);
+int rig_cache_age_ms(int64_t stamp);
+void rig_cache_reset(RIG *rig);
+int rig_cache_get_item(RIG *rig, hamlib_cache_t kind, vfo_t vfo, setting_t key,
+                       value_t *val);
+void rig_cache_set_item(RIG *rig, hamlib_cache_t kind, vfo_t vfo,
+                        setting_t key, value_t val);
+void rig_cache_invalidate_item(RIG *rig, hamlib_cache_t kind, vfo_t vfo,
+                               setting_t key);
+int rig_cache_get_ant(RIG *rig, vfo_t vfo, ant_t ant, value_t *option,
+                      ant_t *ant_curr, ant_t *ant_tx, ant_t *ant_rx);
+void rig_cache_set_ant(RIG *rig, vfo_t vfo, ant_t ant, value_t option,
+                       ant_t ant_curr, ant_t ant_tx, ant_t ant_rx);
 
 __END_DECLS
 
@@ -222,6 +222,16 @@ static const struct confparams frontend_cfg_params[] =
         "Multicast data UDP port for sending commands to rig",
         "4532", RIG_CONF_NUMERIC, { .n = { 0, 1000000, 1 } }
     },
+    {
+        TOK_MULTICAST_SPECTRUM_FORMAT, "multicast_spectrum_format", "Multicast spectrum format",
+        "JSON sends spectrum lines in the JSON snapshot, BINARY as compact binary packets",
+        "JSON", RIG_CONF_COMBO, { .c = {{ "JSON", "BINARY", NULL }} }
+    },
+    {
+        TOK_MEM_INCREMENTAL, "mem_incremental", "Write changed memory channels only",
+        "ON skips memory channels whose content is the last known one, VERIFY also reads each written channel back",
+        "OFF", RIG_CONF_COMBO, { .c = {{ "OFF", "ON", "VERIFY", NULL }} }
+    },
     {
         TOK_FREQ_SKIP, "freq_skip", "Skip setting freq on non-active VFO",
         "True enables skipping setting the TX_VFO when RX_VFO is receiving and skips RX_VFO when TX_VFO is transmitting",
@@ -817,6 +827,42 @@ static int frontend_set_conf(RIG *rig, hamlib_token_t token, const char *val)
         rs->multicast_cmd_port = val_i;
         break;
 
+    case TOK_MULTICAST_SPECTRUM_FORMAT:
+        if (!strcasecmp(val, "JSON"))
+        {
+            rs->multicast_spectrum_format = RIG_MULTICAST_SPECTRUM_JSON;
+        }
+        else if (!strcasecmp(val, "BINARY"))
+        {
+            rs->multicast_spectrum_format = RIG_MULTICAST_SPECTRUM_BINARY;
+        }
+        else
+        {
+            return -RIG_EINVAL;
+        }
+
+        break;
+
+    case TOK_MEM_INCREMENTAL:
+        if (!strcasecmp(val, "OFF"))
+        {
+            rs->mem_incremental = RIG_MEM_INCREMENTAL_OFF;
+        }
+        else if (!strcasecmp(val, "ON"))
+        {
+            rs->mem_incremental = RIG_MEM_INCREMENTAL_ON;
+        }
+        else if (!strcasecmp(val, "VERIFY"))
+        {
+            rs->mem_incremental = RIG_MEM_INCREMENTAL_VERIFY;
+        }
+        else
+        {
+            return -RIG_EINVAL;
+        }
+
+        break;
+
     case TOK_FREQ_SKIP:
         if (1 != sscanf(val, "%ld", &val_i))
         {
@@ -1262,6 +1308,20 @@ static int frontend_get_conf2(RIG *rig, hamlib_token_t token, char *val,
         SNPRINTF(val, val_len, "%d", rs->multicast_cmd_port);
         break;
 
+    case TOK_MULTICAST_SPECTRUM_FORMAT:
+        SNPRINTF(val, val_len, "%s",
+                 rs->multicast_spectrum_format == RIG_MULTICAST_SPECTRUM_BINARY ?
+                 "BINARY" : "JSON");
+        break;
+
+    case TOK_MEM_INCREMENTAL:
+    {
+        static const char *const names[] = { "OFF", "ON", "VERIFY" };
+
+        SNPRINTF(val, val_len, "%s", names[rs->mem_incremental]);
+    }
+    break;
+
     case TOK_FREQ_SKIP:
         SNPRINTF(val, val_len, "%d", rs->freq_skip);
         break;
@@ -33,10 +33,13 @@
 #include "hamlib/config.h"
 
 #include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>  /* Standard input/output definitions */
 #include <stdlib.h>
 #include <string.h> /* String function definitions */
 #include <errno.h>
+#include <pthread.h>
 
 #ifdef ANDROID
 #  include <android/log.h>
@@ -57,11 +60,11 @@
 
 /** \brief Sets the number of hexadecimal pairs to print per line. */
 #define DUMP_HEX_WIDTH 16
-#define DEBUG_HISTORY_STACK_SIZE 1024
 
 
 static int rig_debug_level = RIG_DEBUG_TRACE;
 static int rig_debug_time_stamp = 0;
+static int rig_debug_history_level = RIG_DEBUG_CACHE;
 FILE *rig_debug_stream;
 static vprintf_cb_t rig_vprintf_cb;
 static rig_ptr_t rig_vprintf_arg;
@@ -180,6 +183,22 @@ int HAMLIB_API rig_need_debug(enum rig_debug_level_e debug_level)
 }
 
 
+/**
+ * \brief Change the levels recorded in the debug history.
+ *
+ * \param debug_level The most detailed level recorded, #RIG_DEBUG_NONE
+ * turns the history off.
+ *
+ * Messages above this level are not recorded and none of their arguments
+ * is copied, so an application that never reads the history can turn it
+ * off.  By default every level is recorded for rigerror().
+ */
+void HAMLIB_API rig_set_debug_history_level(enum rig_debug_level_e debug_level)
+{
+    rig_debug_history_level = debug_level;
+}
+
+
 /**
  * \brief Enable or disable the time stamp on debugging output.
  *
@@ -194,6 +213,875 @@ void HAMLIB_API rig_set_debug_time_stamp(int flag)
 }
 
 
+/*
+ * Debug trace history.
+ *
+ * Every rig_debug() call is recorded, whether or not the level is enabled,
+ * so that rigerror() can show what led up to a failure.  Formatting all of
+ * those messages up front is expensive, so each thread records the format
+ * pointer and a copy of the arguments into its own ring and the text is only
+ * produced when the history is requested.
+ *
+ * Each ring has a single writer (its thread) and is read lock-free by
+ * whichever thread materializes the history: entries are published with a
+ * per-entry sequence number, and string arguments live in a byte arena whose
+ * monotonic head tells a reader whether the bytes it copied were overwritten.
+ */
+
+#define DEBUG_HISTORY_ENTRIES 32
+#define DEBUG_HISTORY_ARENA_SIZE 16384
+#define DEBUG_HISTORY_TEXT_MAX (DEBUG_HISTORY_ARENA_SIZE / 2)
+#define DEBUG_HISTORY_MAX_ARGS 16
+#define DEBUG_HISTORY_MAX_LINES 20
+
+enum debug_arg_kind
+{
+    DEBUG_ARG_NONE,     /* "%%" */
+    DEBUG_ARG_INT,
+    DEBUG_ARG_LONG,
+    DEBUG_ARG_LLONG,
+    DEBUG_ARG_INTMAX,
+    DEBUG_ARG_SIZE,
+    DEBUG_ARG_PTRDIFF,
+    DEBUG_ARG_DOUBLE,
+    DEBUG_ARG_PTR,
+    DEBUG_ARG_STR,
+    DEBUG_ARG_UNSUPPORTED
+};
+
+struct debug_conv
+{
+    const char *end;    /* one past the conversion character */
+    int stars;          /* '*' width/precision arguments preceding the value */
+    int precision;      /* -1 none, -2 from '*', otherwise the literal value */
+    int kind;
+};
+
+struct debug_history_arg
+{
+    int kind;
+    union
+    {
+        intmax_t i;
+        double d;
+        const void *p;
+        struct
+        {
+            unsigned int offset;
+            unsigned int len;
+        } s;
+    } u;
+};
+
+struct debug_history_entry
+{
+    unsigned long seq;          /* 0 while being written */
+    int deferred;               /* text starts with a copy of the format */
+    uint64_t text_pos;          /* arena position of the captured strings */
+    unsigned int text_len;
+    int nargs;
+    struct debug_history_arg args[DEBUG_HISTORY_MAX_ARGS];
+};
+
+struct debug_history_ring
+{
+    struct debug_history_ring *next;
+    int in_use;
+    unsigned int head;
+    uint64_t arena_head;
+    struct debug_history_entry entries[DEBUG_HISTORY_ENTRIES];
+    char arena[DEBUG_HISTORY_ARENA_SIZE];
+};
+
+static struct debug_history_ring *debug_history_rings;
+static unsigned long debug_history_seq;
+static unsigned long debug_history_floor;
+static pthread_key_t debug_history_key;
+static pthread_once_t debug_history_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t debug_history_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+static void debug_history_release(void *arg)
+{
+    struct debug_history_ring *ring = arg;
+
+    __atomic_store_n(&ring->in_use, 0, __ATOMIC_RELEASE);
+}
+
+
+static void debug_history_key_init(void)
+{
+    pthread_key_create(&debug_history_key, debug_history_release);
+}
+
+
+/* Returns the calling thread's ring, adopting an abandoned one if possible */
+static struct debug_history_ring *debug_history_ring(void)
+{
+    struct debug_history_ring *ring;
+
+    pthread_once(&debug_history_once, debug_history_key_init);
+
+    ring = pthread_getspecific(debug_history_key);
+
+    if (ring != NULL)
+    {
+        return ring;
+    }
+
+    pthread_mutex_lock(&debug_history_lock);
+
+    for (ring = debug_history_rings; ring != NULL; ring = ring->next)
+    {
+        if (!__atomic_load_n(&ring->in_use, __ATOMIC_ACQUIRE))
+        {
+            break;
+        }
+    }
+
+    if (ring == NULL)
+    {
+        ring = calloc(1, sizeof(*ring));
+
+        if (ring != NULL)
+        {
+            ring->next = debug_history_rings;
+            debug_history_rings = ring;
+        }
+    }
+
+    if (ring != NULL)
+    {
+        __atomic_store_n(&ring->in_use, 1, __ATOMIC_RELAXED);
+        pthread_setspecific(debug_history_key, ring);
+    }
+
+    pthread_mutex_unlock(&debug_history_lock);
+
+    return ring;
+}
+
+
+/* Parses the conversion following a '%'; p points just past the '%' */
+static void debug_conv_parse(const char *p, struct debug_conv *conv)
+{
+    int length = 0;
+
+    conv->stars = 0;
+    conv->precision = -1;
+    conv->kind = DEBUG_ARG_UNSUPPORTED;
+
+    if (*p == '%')
+    {
+        conv->kind = DEBUG_ARG_NONE;
+        conv->end = p + 1;
+        return;
+    }
+
+    while (*p && strchr("-+ #0'", *p)) { ++p; }
+
+    if (*p == '*')
+    {
+        ++conv->stars;
+        ++p;
+    }
+    else
+    {
+        while (*p >= '0' && *p <= '9') { ++p; }
+    }
+
+    if (*p == '.')
+    {
+        ++p;
+
+        if (*p == '*')
+        {
+            ++conv->stars;
+            conv->precision = -2;
+            ++p;
+        }
+        else
+        {
+            conv->precision = 0;
+
+            while (*p >= '0' && *p <= '9')
+            {
+                conv->precision = conv->precision * 10 + (*p++ - '0');
+            }
+        }
+    }
+
+    switch (*p)
+    {
+    case 'h':
+        length = (p[1] == 'h') ? 'H' : 'h';
+        p += (p[1] == 'h') ? 2 : 1;
+        break;
+
+    case 'l':
+        length = (p[1] == 'l') ? 'q' : 'l';
+        p += (p[1] == 'l') ? 2 : 1;
+        break;
+
+    case 'q':
+    case 'j':
+    case 'z':
+    case 't':
+    case 'L':
+        length = *p++;
+        break;
+    }
+
+    conv->end = *p ? p + 1 : p;
+
+    switch (*p)
+    {
+    case 'd':
+    case 'i':
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+        switch (length)
+        {
+        case 0:
+        case 'h':
+        case 'H': conv->kind = DEBUG_ARG_INT; break;
+
+        case 'l': conv->kind = DEBUG_ARG_LONG; break;
+
+        case 'q': conv->kind = DEBUG_ARG_LLONG; break;
+
+        case 'j': conv->kind = DEBUG_ARG_INTMAX; break;
+
+        case 'z': conv->kind = DEBUG_ARG_SIZE; break;
+
+        case 't': conv->kind = DEBUG_ARG_PTRDIFF; break;
+        }
+
+        break;
+
+    case 'c':
+        if (length == 0) { conv->kind = DEBUG_ARG_INT; }
+
+        break;
+
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        if (length == 0 || length == 'l') { conv->kind = DEBUG_ARG_DOUBLE; }
+
+        break;
+
+    case 's':
+        if (length == 0) { conv->kind = DEBUG_ARG_STR; }
+
+        break;
+
+    case 'p':
+        if (length == 0) { conv->kind = DEBUG_ARG_PTR; }
+
+        break;
+    }
+}
+
+
+static void debug_arena_put(struct debug_history_ring *ring, uint64_t pos,
+                            const char *src, size_t len)
+{
+    size_t offset = (size_t)(pos % DEBUG_HISTORY_ARENA_SIZE);
+    size_t first = DEBUG_HISTORY_ARENA_SIZE - offset;
+
+    if (first > len) { first = len; }
+
+    memcpy(ring->arena + offset, src, first);
+    memcpy(ring->arena, src + first, len - first);
+}
+
+
+static void debug_arena_get(const struct debug_history_ring *ring,
+                            uint64_t pos, char *dst, size_t len)
+{
+    size_t offset = (size_t)(pos % DEBUG_HISTORY_ARENA_SIZE);
+    size_t first = DEBUG_HISTORY_ARENA_SIZE - offset;
+
+    if (first > len) { first = len; }
+
+    memcpy(dst, ring->arena + offset, first);
+    memcpy(dst + first, ring->arena, len - first);
+}
+
+
+/* Appends len bytes to the entry's text, returning the number stored */
+static size_t debug_history_put_text(struct debug_history_ring *ring,
+                                     struct debug_history_entry *entry,
+                                     const char *src, size_t len)
+{
+    uint64_t pos = entry->text_pos + entry->text_len;
+
+    if (len > DEBUG_HISTORY_TEXT_MAX - entry->text_len)
+    {
+        len = DEBUG_HISTORY_TEXT_MAX - entry->text_len;
+    }
+
+    /* claim the space before touching it so readers can detect reuse */
+    __atomic_store_n(&ring->arena_head, pos + len, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    debug_arena_put(ring, pos, src, len);
+    entry->text_len += len;
+
+    return len;
+}
+
+
+/* Stores a NUL terminated copy of a string argument */
+static void debug_history_put_string(struct debug_history_ring *ring,
+                                     struct debug_history_entry *entry,
+                                     struct debug_history_arg *arg,
+                                     const char *s, size_t len)
+{
+    if (entry->text_len >= DEBUG_HISTORY_TEXT_MAX)
+    {
+        arg->kind = DEBUG_ARG_NONE;
+        return;
+    }
+
+    if (len > DEBUG_HISTORY_TEXT_MAX - entry->text_len - 1)
+    {
+        len = DEBUG_HISTORY_TEXT_MAX - entry->text_len - 1;
+    }
+
+    arg->u.s.offset = entry->text_len;
+    arg->u.s.len = debug_history_put_text(ring, entry, s, len);
+    debug_history_put_text(ring, entry, "", 1);
+}
+
+
+/* Captures the arguments; returns 0 if fmt needs formatting right away */
+static int debug_history_capture(struct debug_history_ring *ring,
+                                 struct debug_history_entry *entry,
+                                 const char *fmt, va_list ap)
+{
+    const char *p = fmt;
+
+    while ((p = strchr(p, '%')) != NULL)
+    {
+        struct debug_conv conv;
+        struct debug_history_arg *arg;
+        int precision = -1;
+        int i;
+
+        debug_conv_parse(p + 1, &conv);
+        p = conv.end;
+
+        if (conv.kind == DEBUG_ARG_NONE)
+        {
+            continue;
+        }
+
+        if (conv.kind == DEBUG_ARG_UNSUPPORTED
+                || entry->nargs + conv.stars >= DEBUG_HISTORY_MAX_ARGS)
+        {
+            return 0;
+        }
+
+        for (i = 0; i < conv.stars; ++i)
+        {
+            arg = &entry->args[entry->nargs++];
+            arg->kind = DEBUG_ARG_INT;
+            arg->u.i = va_arg(ap, int);
+            precision = (int)arg->u.i;
+        }
+
+        if (conv.precision != -2)
+        {
+            precision = conv.precision;
+        }
+
+        arg = &entry->args[entry->nargs++];
+        arg->kind = conv.kind;
+
+        switch (conv.kind)
+        {
+        case DEBUG_ARG_INT: arg->u.i = va_arg(ap, int); break;
+
+        case DEBUG_ARG_LONG: arg->u.i = va_arg(ap, long); break;
+
+        case DEBUG_ARG_LLONG: arg->u.i = va_arg(ap, long long); break;
+
+        case DEBUG_ARG_INTMAX: arg->u.i = va_arg(ap, intmax_t); break;
+
+        case DEBUG_ARG_SIZE: arg->u.i = (intmax_t)va_arg(ap, size_t); break;
+
+        case DEBUG_ARG_PTRDIFF: arg->u.i = va_arg(ap, ptrdiff_t); break;
+
+        case DEBUG_ARG_DOUBLE: arg->u.d = va_arg(ap, double); break;
+
+        case DEBUG_ARG_PTR: arg->u.p = va_arg(ap, void *); break;
+
+        case DEBUG_ARG_STR:
+        {
+            const char *s = va_arg(ap, const char *);
+            size_t len;
+
+            if (s == NULL) { s = "(null)"; }
+
+            len = (precision >= 0) ? strnlen(s, precision) : strlen(s);
+            debug_history_put_string(ring, entry, arg, s, len);
+            break;
+        }
+        }
+    }
+
+    return 1;
+}
+
+
+static void debug_history_begin(struct debug_history_entry *entry)
+{
+    __atomic_store_n(&entry->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+
+static void debug_history_publish(struct debug_history_entry *entry)
+{
+    unsigned long seq = __atomic_add_fetch(&debug_history_seq, 1,
+                                           __ATOMIC_RELAXED);
+
+    __atomic_store_n(&entry->seq, seq, __ATOMIC_RELEASE);
+}
+
+
+static void debug_history_record(const char *fmt, va_list ap)
+{
+    struct debug_history_ring *ring = debug_history_ring();
+    struct debug_history_entry *entry;
+    size_t fmt_len;
+    va_list aq;
+
+    if (ring == NULL)
+    {
+        return;
+    }
+
+    entry = &ring->entries[ring->head++ % DEBUG_HISTORY_ENTRIES];
+    debug_history_begin(entry);
+
+    entry->deferred = 1;
+    entry->nargs = 0;
+    entry->text_pos = ring->arena_head;
+    entry->text_len = 0;
+
+    /* the format is copied too, it need not outlive the call */
+    fmt_len = strlen(fmt) + 1;
+
+    va_copy(aq, ap);
+
+    if (fmt_len <= DEBUG_HISTORY_TEXT_MAX / 2)
+    {
+        debug_history_put_text(ring, entry, fmt, fmt_len);
+    }
+
+    if (fmt_len > DEBUG_HISTORY_TEXT_MAX / 2
+            || !debug_history_capture(ring, entry, fmt, aq))
+    {
+        /* a conversion we cannot replay later, e.g. %n or %Lf */
+        char text[DEBUG_HISTORY_TEXT_MAX];
+        int len = vsnprintf(text, sizeof(text), fmt, ap);
+
+        entry->deferred = 0;
+        entry->nargs = 0;
+        entry->text_len = 0;
+
+        if (len >= (int)sizeof(text))
+        {
+            len = sizeof(text) - 1;
+        }
+
+        if (len > 0)
+        {
+            debug_history_put_text(ring, entry, text, len);
+        }
+    }
+
+    va_end(aq);
+
+    debug_history_publish(entry);
+}
+
+
+static void debug_history_record_text(const char *s)
+{
+    struct debug_history_ring *ring = debug_history_ring();
+    struct debug_history_entry *entry;
+
+    if (ring == NULL)
+    {
+        return;
+    }
+
+    entry = &ring->entries[ring->head++ % DEBUG_HISTORY_ENTRIES];
+    debug_history_begin(entry);
+
+    entry->deferred = 0;
+    entry->nargs = 0;
+    entry->text_pos = ring->arena_head;
+    entry->text_len = 0;
+    debug_history_put_text(ring, entry, s, strlen(s));
+
+    debug_history_publish(entry);
+}
+
+
+/* Replays a captured entry into out, returning the formatted length */
+static size_t debug_history_format(const struct debug_history_entry *entry,
+                                   const char *text, char *out, size_t outlen)
+{
+    const char *p;
+    size_t len = 0;
+    int argi = 0;
+
+    if (!entry->deferred)
+    {
+        len = entry->text_len < outlen ? entry->text_len : outlen - 1;
+        memcpy(out, text, len);
+        out[len] = '\0';
+        return len;
+    }
+
+    for (p = text; *p && len < outlen - 1;)
+    {
+        struct debug_conv conv;
+        const struct debug_history_arg *arg;
+        char spec[64];
+        size_t speclen = 0;
+        const char *q;
+        int n = 0;
+
+        if (*p != '%')
+        {
+            out[len++] = *p++;
+            continue;
+        }
+
+        debug_conv_parse(p + 1, &conv);
+
+        if (conv.kind == DEBUG_ARG_NONE)
+        {
+            out[len++] = '%';
+            p = conv.end;
+            continue;
+        }
+
+        /* rebuild the conversion with any '*' replaced by its value */
+        for (q = p; q < conv.end && speclen < sizeof(spec) - 16; ++q)
+        {
+            if (*q == '*')
+            {
+                speclen += snprintf(spec + speclen, sizeof(spec) - speclen, "%d",
+                                    (int)entry->args[argi++].u.i);
+            }
+            else
+            {
+                spec[speclen++] = *q;
+            }
+        }
+
+        spec[speclen] = '\0';
+        p = conv.end;
+
+        if (argi >= entry->nargs)
+        {
+            break;
+        }
+
+        arg = &entry->args[argi++];
+
+        switch (arg->kind)
+        {
+        case DEBUG_ARG_INT:
+            n = snprintf(out + len, outlen - len, spec, (int)arg->u.i);
+            break;
+
+        case DEBUG_ARG_LONG:
+            n = snprintf(out + len, outlen - len, spec, (long)arg->u.i);
+            break;
+
+        case DEBUG_ARG_LLONG:
+            n = snprintf(out + len, outlen - len, spec, (long long)arg->u.i);
+            break;
+
+        case DEBUG_ARG_INTMAX:
+            n = snprintf(out + len, outlen - len, spec, arg->u.i);
+            break;
+
+        case DEBUG_ARG_SIZE:
+            n = snprintf(out + len, outlen - len, spec, (size_t)arg->u.i);
+            break;
+
+        case DEBUG_ARG_PTRDIFF:
+            n = snprintf(out + len, outlen - len, spec, (ptrdiff_t)arg->u.i);
+            break;
+
+        case DEBUG_ARG_DOUBLE:
+            n = snprintf(out + len, outlen - len, spec, arg->u.d);
+            break;
+
+        case DEBUG_ARG_PTR:
+            n = snprintf(out + len, outlen - len, spec, arg->u.p);
+            break;
+
+        case DEBUG_ARG_STR:
+            n = snprintf(out + len, outlen - len, spec, text + arg->u.s.offset);
+            break;
+
+        default:
+            /* string argument that did not fit in the arena */
+            n = snprintf(out + len, outlen - len, "%s", "...");
+            break;
+        }
+
+        if (n > 0)
+        {
+            len += ((size_t)n < outlen - len) ? (size_t)n : outlen - len - 1;
+        }
+    }
+
+    out[len] = '\0';
+    return len;
+}
+
+
+struct debug_history_snapshot
+{
+    const struct debug_history_ring *ring;
+    const struct debug_history_entry *slot;
+    struct debug_history_entry entry;
+};
+
+
+/* Copies an entry header out of a ring, returning 0 if empty or mid-write */
+static int debug_history_snapshot(const struct debug_history_ring *ring,
+                                  const struct debug_history_entry *slot,
+                                  struct debug_history_snapshot *snap)
+{
+    unsigned long seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+
+    if (seq == 0)
+    {
+        return 0;
+    }
+
+    memcpy(&snap->entry, slot, sizeof(snap->entry));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq
+            || snap->entry.text_len > DEBUG_HISTORY_TEXT_MAX)
+    {
+        return 0;
+    }
+
+    snap->entry.seq = seq;
+    snap->ring = ring;
+    snap->slot = slot;
+
+    return 1;
+}
+
+
+/* Copies the entry's strings, returning 0 if they were overwritten */
+static int debug_history_snapshot_text(const struct debug_history_snapshot
+                                       *snap, char *text)
+{
+    uint64_t head;
+
+    debug_arena_get(snap->ring, snap->entry.text_pos, text, snap->entry.text_len);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    head = __atomic_load_n(&snap->ring->arena_head, __ATOMIC_RELAXED);
+
+    return head - snap->entry.text_pos <= DEBUG_HISTORY_ARENA_SIZE
+           && __atomic_load_n(&snap->slot->seq, __ATOMIC_RELAXED) == snap->entry.seq;
+}
+
+
+static int debug_history_cmp(const void *a, const void *b)
+{
+    unsigned long sa = ((const struct debug_history_snapshot *)a)->entry.seq;
+    unsigned long sb = ((const struct debug_history_snapshot *)b)->entry.seq;
+
+    return (sa > sb) - (sa < sb);
+}
+
+
+/*
+ * Appends a message to debugmsgsave keeping roughly the last 20 lines.
+ * Caller holds debug_history_lock.
+ */
+static void debug_history_append(const char *s)
+{
+    const size_t maxmsg = DEBUGMSGSAVE_SIZE / 2;
+    size_t append_len;
+    size_t current_len;
+    size_t i;
+    size_t nlines;
+    char *keep;
+
+    current_len = strlen(debugmsgsave);
+    keep = debugmsgsave;
+
+    for (i = 0, nlines = 0; i < current_len; ++i)
+    {
+        if (debugmsgsave[i] == '\n') { ++nlines; }
+    }
+
+    while (nlines > DEBUG_HISTORY_MAX_LINES - 1 || current_len > maxmsg)
+    {
+        char *newline = strchr(keep, '\n');
+
+        if (newline == NULL)
+        {
+            keep += current_len;
+            current_len = 0;
+            break;
+        }
+
+        size_t remove_len = (size_t)(newline + 1 - keep);
+        keep = newline + 1;
+        current_len -= remove_len;
+        --nlines;
+    }
+
+    if (keep != debugmsgsave)
+    {
+        memmove(debugmsgsave, keep, current_len + 1);
+    }
+
+    append_len = strlen(s);
+
+    if (append_len <= sizeof(debugmsgsave) - current_len - 1)
+    {
+        memmove(debugmsgsave + current_len, s, append_len + 1);
+    }
+}
+
+
+/* Formats the recorded history of all threads into debugmsgsave */
+static void debug_history_materialize(void)
+{
+    struct debug_history_snapshot *snaps;
+    struct debug_history_ring *ring;
+    char **messages;
+    char *text;
+    char *out;
+    unsigned long floor;
+    size_t nrings = 0;
+    size_t count = 0;
+    size_t nmessages = 0;
+    size_t lines = 0;
+    size_t bytes = 0;
+    size_t i;
+
+    if (!rig_debug_history_level)
+    {
+        pthread_mutex_lock(&debug_history_lock);
+        debugmsgsave[0] = '\0';
+        pthread_mutex_unlock(&debug_history_lock);
+        return;
+    }
+
+    pthread_mutex_lock(&debug_history_lock);
+
+    debugmsgsave[0] = '\0';
+    floor = __atomic_load_n(&debug_history_floor, __ATOMIC_RELAXED);
+
+    for (ring = debug_history_rings; ring != NULL; ring = ring->next)
+    {
+        ++nrings;
+    }
+
+    snaps = malloc(nrings * DEBUG_HISTORY_ENTRIES * sizeof(*snaps));
+    messages = calloc(nrings * DEBUG_HISTORY_ENTRIES, sizeof(*messages));
+    text = malloc(DEBUG_HISTORY_TEXT_MAX);
+    out = malloc(DEBUGMSGSAVE_SIZE);
+
+    if (nrings == 0 || !snaps || !messages || !text || !out)
+    {
+        free(snaps);
+        free(messages);
+        free(text);
+        free(out);
+        pthread_mutex_unlock(&debug_history_lock);
+        return;
+    }
+
+    for (ring = debug_history_rings; ring != NULL; ring = ring->next)
+    {
+        for (i = 0; i < DEBUG_HISTORY_ENTRIES; ++i)
+        {
+            if (debug_history_snapshot(ring, &ring->entries[i], &snaps[count])
+                    && snaps[count].entry.seq > floor)
+            {
+                ++count;
+            }
+        }
+    }
+
+    qsort(snaps, count, sizeof(*snaps), debug_history_cmp);
+
+    /* format newest first until older messages would be trimmed anyway */
+    for (i = count; i > 0 && lines <= DEBUG_HISTORY_MAX_LINES
+            && bytes <= DEBUGMSGSAVE_SIZE / 2; --i)
+    {
+        size_t len;
+        const char *nl;
+
+        if (!debug_history_snapshot_text(&snaps[i - 1], text))
+        {
+            continue;
+        }
+
+        len = debug_history_format(&snaps[i - 1].entry, text, out,
+                                   DEBUGMSGSAVE_SIZE);
+        messages[nmessages] = strdup(out);
+
+        if (messages[nmessages] == NULL)
+        {
+            break;
+        }
+
+        ++nmessages;
+        bytes += len;
+
+        for (nl = out; (nl = strchr(nl, '\n')) != NULL; ++nl)
+        {
+            ++lines;
+        }
+    }
+
+    while (nmessages > 0)
+    {
+        --nmessages;
+        debug_history_append(messages[nmessages]);
+        free(messages[nmessages]);
+    }
+
+    free(out);
+    free(text);
+    free(messages);
+    free(snaps);
+
+    pthread_mutex_unlock(&debug_history_lock);
+}
+
+
 /**
  * \brief Print debugging messages through `stderr` by default.
  *
@@ -202,51 +1090,27 @@ void HAMLIB_API rig_set_debug_time_stamp(int flag)
  *
  * The formatted character string is passed to the `vfprintf`(3) C library
  * call and follows its format specification.
+ *
+ * Messages up to the rig_set_debug_history_level() level are also recorded
+ * in the debug history whatever the current level.  Their format and string
+ * arguments are copied, but only formatted when the history is requested
+ * through rigerror() or rig_get_debug_history().
  */
 void HAMLIB_API rig_debug(enum rig_debug_level_e debug_level,
                           const char *fmt, ...)
 {
     static pthread_mutex_t client_debug_lock = PTHREAD_MUTEX_INITIALIZER;
-    char history_stack[DEBUG_HISTORY_STACK_SIZE];
-    char *history_msg = history_stack;
-    size_t history_capacity = sizeof(history_stack);
-    int history_len;
     va_list ap;
 
-    history_msg[0] = '\0';
-    va_start(ap, fmt);
-    history_len = vsnprintf(history_msg, history_capacity, fmt, ap);
-    va_end(ap);
-
-    if (history_len >= 0
-            && (size_t)history_len >= history_capacity
-            && (size_t)history_len < DEBUGMSGSAVE_SIZE)
+    if (debug_level <= rig_debug_history_level && rig_debug_history_level)
     {
-        history_capacity = (size_t)history_len + 1;
-        history_msg = malloc(history_capacity);
-
-        if (history_msg != NULL)
-        {
-            va_start(ap, fmt);
-            history_len = vsnprintf(history_msg, history_capacity, fmt, ap);
-            va_end(ap);
-
-            if (history_len != (int)history_capacity - 1)
-            {
-                history_len = -1;
-            }
-        }
+        va_start(ap, fmt);
+        debug_history_record(fmt, ap);
+        va_end(ap);
     }
 
     if (!rig_need_debug(debug_level))
     {
-        if (history_msg != NULL && history_len >= 0
-                && (size_t)history_len < history_capacity)
-        {
-            add2debugmsgsave(history_msg);
-        }
-
-        if (history_msg != history_stack) { free(history_msg); }
         return;
     }
 
@@ -312,17 +1176,62 @@ void HAMLIB_API rig_debug(enum rig_debug_level_e debug_level,
     va_end(ap);
 #endif
     pthread_mutex_unlock(&client_debug_lock);
+}
 
-    if (history_msg != NULL && history_len >= 0
-            && (size_t)history_len < history_capacity)
-    {
-        add2debugmsgsave(history_msg);
-    }
 
-    if (history_msg != history_stack) { free(history_msg); }
+/**
+ * \brief Append an already formatted message to the debug history.
+ *
+ * \param s The message, normally terminated by a newline.
+ *
+ * \sa rigerror()
+ */
+void HAMLIB_API add2debugmsgsave(const char *s)
+{
+    debug_history_record_text(s);
 }
 
 
+/**
+ * \brief Get the recent debug history.
+ *
+ * Formats the most recent rig_debug() messages of all threads, whether or
+ * not their level was enabled, into `debugmsgsave`.  With the history level
+ * at RIG_DEBUG_NONE nothing is formatted and the history is empty.
+ *
+ * `debugmsgsave` itself is deprecated: it is not kept up to date as
+ * messages come in, only when the history is requested.
+ *
+ * \return A pointer to `debugmsgsave` holding up to the last 20 lines.
+ *
+ * \sa rigerror(), rig_debug_clear()
+ */
+const char *HAMLIB_API rig_get_debug_history(void)
+{
+    debug_history_materialize();
+
+    return debugmsgsave;
+}
+
+
+/**
+ * \brief Forget the debug history recorded so far.
+ *
+ * \sa rig_debug_clear()
+ */
+void HAMLIB_API rig_debug_history_clear(void)
+{
+    pthread_mutex_lock(&debug_history_lock);
+    __atomic_store_n(&debug_history_floor,
+                     __atomic_load_n(&debug_history_seq, __ATOMIC_RELAXED),
+                     __ATOMIC_RELAXED);
+    debugmsgsave[0] = debugmsgsave2[0] = debugmsgsave3[0] = '\0';
+    pthread_mutex_unlock(&debug_history_lock);
+}
+
+
+
+
 /**
  * \brief Set callback to handle debugging messages.
  *
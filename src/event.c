@@ -47,6 +47,8 @@
 #include "misc.h"
 #include "cache.h"
 #include "network.h"
+#include "spectrum_history.h"
+#include "spectrum_pool.h"
 
 #define CHECK_RIG_ARG(r) (!(r) || !(r)->caps || !STATE(r)->comm_state)
 
@@ -66,7 +68,8 @@ static void *rig_poll_routine(void *arg)
     rig_poll_routine_args *args = (rig_poll_routine_args *)arg;
     RIG *rig = args->rig;
     struct rig_state *rs = STATE(rig);
-    struct rig_cache *cachep = CACHE(rig);
+    struct rig_cache snap;
+    const struct rig_cache *cachep = &snap;
     int update_occurred;
 
     vfo_t vfo = RIG_VFO_NONE, tx_vfo = RIG_VFO_NONE;
@@ -78,23 +81,32 @@ static void *rig_poll_routine(void *arg)
               width_sub_b = 0, width_sub_c = 0;
     ptt_t ptt = RIG_PTT_OFF;
     split_t split = RIG_SPLIT_OFF;
+    unsigned int gen;
+    int64_t last_publish;
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s(%d): Starting rig poll routine thread\n",
               __FILE__, __LINE__);
 
+    // let interactive callers go first
+    rig_set_thread_prio(RIG_PRIO_POLL);
+
     // Rig cache time should be equal to rig poll interval (should be set automatically by rigctld at least)
     rig_set_cache_timeout_ms(rig, HAMLIB_CACHE_ALL, rs->poll_interval);
 
-    // Attempt to detect changes with the interval below (in milliseconds)
-    int change_detection_interval = 50;
-    int interval_count = 0;
-
     update_occurred = 0;
 
     network_publish_rig_poll_data(rig);
+    last_publish = rig_cache_now_ns();
 
     while (rs->poll_routine_thread_run)
     {
+        int64_t now;
+        int wait_ms;
+
+        // compare against a consistent copy, the API thread keeps writing
+        gen = rig_cache_generation(rig);
+        rig_cache_snapshot(rig, &snap);
+
         if (rs->current_vfo != vfo)
         {
             vfo = rs->current_vfo;
@@ -107,39 +119,39 @@ static void *rig_poll_routine(void *arg)
             update_occurred = 1;
         }
 
-        if (cachep->freqMainA != freq_main_a)
+        if (cachep->slot[CACHE_SLOT_MAIN_A].freq != freq_main_a)
         {
-            freq_main_a = cachep->freqMainA;
+            freq_main_a = cachep->slot[CACHE_SLOT_MAIN_A].freq;
             update_occurred = 1;
         }
 
-        if (cachep->freqMainB != freq_main_b)
+        if (cachep->slot[CACHE_SLOT_MAIN_B].freq != freq_main_b)
         {
-            freq_main_b = cachep->freqMainB;
+            freq_main_b = cachep->slot[CACHE_SLOT_MAIN_B].freq;
             update_occurred = 1;
         }
 
-        if (cachep->freqMainC != freq_main_c)
+        if (cachep->slot[CACHE_SLOT_MAIN_C].freq != freq_main_c)
         {
-            freq_main_b = cachep->freqMainC;
+            freq_main_c = cachep->slot[CACHE_SLOT_MAIN_C].freq;
             update_occurred = 1;
         }
 
-        if (cachep->freqSubA != freq_sub_a)
+        if (cachep->slot[CACHE_SLOT_SUB_A].freq != freq_sub_a)
         {
-            freq_sub_a = cachep->freqSubA;
+            freq_sub_a = cachep->slot[CACHE_SLOT_SUB_A].freq;
             update_occurred = 1;
         }
 
-        if (cachep->freqSubB != freq_sub_b)
+        if (cachep->slot[CACHE_SLOT_SUB_B].freq != freq_sub_b)
         {
-            freq_sub_b = cachep->freqSubB;
+            freq_sub_b = cachep->slot[CACHE_SLOT_SUB_B].freq;
             update_occurred = 1;
         }
 
-        if (cachep->freqSubC != freq_sub_c)
+        if (cachep->slot[CACHE_SLOT_SUB_C].freq != freq_sub_c)
         {
-            freq_sub_c = cachep->freqSubC;
+            freq_sub_c = cachep->slot[CACHE_SLOT_SUB_C].freq;
             update_occurred = 1;
         }
 
@@ -155,94 +167,92 @@ static void *rig_poll_routine(void *arg)
             update_occurred = 1;
         }
 
-        if (cachep->modeMainA != mode_main_a)
+        if (cachep->slot[CACHE_SLOT_MAIN_A].mode != mode_main_a)
         {
-            mode_main_a = cachep->modeMainA;
+            mode_main_a = cachep->slot[CACHE_SLOT_MAIN_A].mode;
             update_occurred = 1;
         }
 
-        if (cachep->modeMainB != mode_main_b)
+        if (cachep->slot[CACHE_SLOT_MAIN_B].mode != mode_main_b)
         {
-            mode_main_b = cachep->modeMainB;
+            mode_main_b = cachep->slot[CACHE_SLOT_MAIN_B].mode;
             update_occurred = 1;
         }
 
-        if (cachep->modeMainC != mode_main_c)
+        if (cachep->slot[CACHE_SLOT_MAIN_C].mode != mode_main_c)
         {
-            mode_main_c = cachep->modeMainC;
+            mode_main_c = cachep->slot[CACHE_SLOT_MAIN_C].mode;
             update_occurred = 1;
         }
 
-        if (cachep->modeSubA != mode_sub_a)
+        if (cachep->slot[CACHE_SLOT_SUB_A].mode != mode_sub_a)
         {
-            mode_sub_a = cachep->modeSubA;
+            mode_sub_a = cachep->slot[CACHE_SLOT_SUB_A].mode;
             update_occurred = 1;
         }
 
-        if (cachep->modeSubB != mode_sub_b)
+        if (cachep->slot[CACHE_SLOT_SUB_B].mode != mode_sub_b)
         {
-            mode_sub_b = cachep->modeSubB;
+            mode_sub_b = cachep->slot[CACHE_SLOT_SUB_B].mode;
             update_occurred = 1;
         }
 
-        if (cachep->modeSubC != mode_sub_c)
+        if (cachep->slot[CACHE_SLOT_SUB_C].mode != mode_sub_c)
         {
-            mode_sub_c = cachep->modeSubC;
+            mode_sub_c = cachep->slot[CACHE_SLOT_SUB_C].mode;
             update_occurred = 1;
         }
 
-        if (cachep->widthMainA != width_main_a)
+        if (cachep->slot[CACHE_SLOT_MAIN_A].width != width_main_a)
         {
-            width_main_a = cachep->widthMainA;
+            width_main_a = cachep->slot[CACHE_SLOT_MAIN_A].width;
             update_occurred = 1;
         }
 
-        if (cachep->widthMainB != width_main_b)
+        if (cachep->slot[CACHE_SLOT_MAIN_B].width != width_main_b)
         {
-            width_main_b = cachep->widthMainB;
+            width_main_b = cachep->slot[CACHE_SLOT_MAIN_B].width;
             update_occurred = 1;
         }
 
-        if (cachep->widthMainC != width_main_c)
+        if (cachep->slot[CACHE_SLOT_MAIN_C].width != width_main_c)
         {
-            width_main_c = cachep->widthMainC;
+            width_main_c = cachep->slot[CACHE_SLOT_MAIN_C].width;
             update_occurred = 1;
         }
 
-        if (cachep->widthSubA != width_sub_a)
+        if (cachep->slot[CACHE_SLOT_SUB_A].width != width_sub_a)
         {
-            width_sub_a = cachep->widthSubA;
+            width_sub_a = cachep->slot[CACHE_SLOT_SUB_A].width;
             update_occurred = 1;
         }
 
-        if (cachep->widthSubB != width_sub_b)
+        if (cachep->slot[CACHE_SLOT_SUB_B].width != width_sub_b)
         {
-            width_sub_b = cachep->widthSubB;
+            width_sub_b = cachep->slot[CACHE_SLOT_SUB_B].width;
             update_occurred = 1;
         }
 
-        if (cachep->widthSubC != width_sub_c)
+        if (cachep->slot[CACHE_SLOT_SUB_C].width != width_sub_c)
         {
-            width_sub_c = cachep->widthSubC;
+            width_sub_c = cachep->slot[CACHE_SLOT_SUB_C].width;
             update_occurred = 1;
         }
 
-        if (update_occurred)
+        now = rig_cache_now_ns();
+
+        // Publish on change, and every poll_interval if nothing changed
+        if (update_occurred
+                || now - last_publish >= rs->poll_interval * 1000000LL)
         {
             network_publish_rig_poll_data(rig);
             update_occurred = 0;
-            interval_count = 0;
+            last_publish = now;
         }
 
-        hl_usleep(change_detection_interval * 1000);
-        interval_count++;
-
-        // Publish updates every poll_interval if no changes have been detected
-        if (interval_count >= (rs->poll_interval / change_detection_interval))
-        {
-            interval_count = 0;
-            network_publish_rig_poll_data(rig);
-        }
+        // Sleep until the cache is written to or the next heartbeat is due
+        wait_ms = rs->poll_interval - (int)((now - last_publish) / 1000000);
+        rig_cache_wait(rig, &gen, wait_ms > 0 ? wait_ms : 0);
     }
 
     network_publish_rig_poll_data(rig);
@@ -334,6 +344,7 @@ int rig_poll_routine_stop(RIG *rig)
     }
 
     rs->poll_routine_thread_run = 0;
+    rig_cache_wake(rig);
 
     poll_routine_priv = (rig_poll_routine_priv_data *) rs->poll_routine_priv_data;
 
@@ -536,6 +547,8 @@ int HAMLIB_API rig_set_pltune_callback(RIG *rig, pltune_cb_t cb, rig_ptr_t arg)
  * \param arg   A Pointer to some private data to pass later on to the callback
  *
  *  Install a callback for spectrum line reception events, to be called when in async mode.
+ *  The line is only valid during the call, unless it is held with
+ *  rig_hold_spectrum_line().
  *
  * \return RIG_OK if the operation has been successful, otherwise
  * a negative value if an error occurred (in which case, cause is
@@ -672,13 +685,11 @@ int rig_fire_mode_event(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
 
 int rig_fire_vfo_event(RIG *rig, vfo_t vfo)
 {
-    struct rig_cache *cachep = CACHE(rig);
     ENTERFUNC;
 
     rig_debug(RIG_DEBUG_TRACE, "Event: vfo changed to %s\n", rig_strvfo(vfo));
 
-    cachep->vfo = vfo;
-    elapsed_ms(&cachep->time_vfo, HAMLIB_ELAPSED_SET);
+    rig_set_cache_vfo(rig, vfo);
 
     network_publish_rig_transceive_data(rig);
 
@@ -693,14 +704,12 @@ int rig_fire_vfo_event(RIG *rig, vfo_t vfo)
 
 int rig_fire_ptt_event(RIG *rig, vfo_t vfo, ptt_t ptt)
 {
-    struct rig_cache *cachep = CACHE(rig);
     ENTERFUNC;
 
     rig_debug(RIG_DEBUG_TRACE, "Event: PTT changed to %i on %s\n", ptt,
               rig_strvfo(vfo));
 
-    cachep->ptt = ptt;
-    elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
+    rig_set_cache_ptt(rig, ptt);
 
     network_publish_rig_transceive_data(rig);
 
@@ -809,8 +818,14 @@ static int print_spectrum_line(char *str, size_t length,
 }
 
 
-int rig_fire_spectrum_event(RIG *rig, struct rig_spectrum_line *line)
+/*
+ * Hand a completed line to everyone that wants it.  Each consumer that
+ * keeps the line takes its own reference; the caller keeps its one.
+ */
+int rig_fire_spectrum_buffer(RIG *rig, struct spectrum_buffer *buf)
 {
+    struct rig_spectrum_line *line = &buf->line;
+
     ENTERFUNC;
 
     if (rig_need_debug(RIG_DEBUG_TRACE))
@@ -821,7 +836,10 @@ int rig_fire_spectrum_event(RIG *rig, struct rig_spectrum_line *line)
                   spectrum_debug);
     }
 
-    network_publish_rig_spectrum_data(rig, line);
+    buf->pool->lines++;
+
+    spectrum_history_push(rig, buf);
+    network_publish_rig_spectrum_data(rig, buf);
 
     if (rig->callbacks.spectrum_event)
     {
@@ -831,4 +849,38 @@ int rig_fire_spectrum_event(RIG *rig, struct rig_spectrum_line *line)
     RETURNFUNC(RIG_OK);
 }
 
+/* For a line that was not assembled in a pooled buffer: copied once */
+int rig_fire_spectrum_event(RIG *rig, struct rig_spectrum_line *line)
+{
+    struct spectrum_buffer *buf = spectrum_buffer_of(line);
+    int result;
+
+    if (buf)
+    {
+        return rig_fire_spectrum_buffer(rig, buf);
+    }
+
+    if (line->spectrum_data_length > HAMLIB_MAX_SPECTRUM_DATA)
+    {
+        return -RIG_EINVAL;
+    }
+
+    buf = spectrum_buffer_get(rig);
+
+    if (!buf)
+    {
+        return -RIG_ENOMEM;
+    }
+
+    buf->line = *line;
+    buf->line.spectrum_data = buf->data;
+    memcpy(buf->data, line->spectrum_data, line->spectrum_data_length);
+    buf->pool->copies++;
+
+    result = rig_fire_spectrum_buffer(rig, buf);
+    spectrum_buffer_unref(buf);
+
+    return result;
+}
+
 /** @} */
@@ -35,5 +35,8 @@ int rig_fire_dcd_event(RIG *rig, vfo_t vfo, dcd_t dcd);
 int rig_fire_pltune_event(RIG *rig, vfo_t vfo, freq_t *freq, rmode_t *mode, pbwidth_t *width);
 int rig_fire_spectrum_event(RIG *rig, struct rig_spectrum_line *line);
 
+struct spectrum_buffer;
+int rig_fire_spectrum_buffer(RIG *rig, struct spectrum_buffer *buf);
+
 #endif /* _EVENT_H */
 
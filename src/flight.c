@@ -0,0 +1,207 @@
+/*
+ *  Hamlib Interface - coalescing of concurrent identical gets
+ *  Copyright (c) 2026 The Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+/*
+ * Single flight gets.
+ *
+ * When several threads (API callers, the poll thread, rigctld clients)
+ * ask for the same thing at the same time, only the first one goes to the
+ * rig; the others wait for it and return its result.  A flight is keyed
+ * by op, VFO and setting.  Callers that arrive after a flight has landed
+ * start a new one, so nobody gets a result older than their own call.
+ *
+ * A thread that leads a flight or holds the API lock never waits: the
+ * leader it would wait for may need that lock, or be waiting for us.
+ * Such callers (typically a backend calling back into rig.c) just run
+ * uncoalesced.
+ */
+
+#include "hamlib/config.h"
+
+#include "hamlib/rig.h"
+#include "hamlib/rig_state.h"
+#include "cache.h"
+#include "flight.h"
+
+void rig_flight_init(RIG *rig)
+{
+    struct rig_flights *flights = &CACHE(rig)->flights;
+
+    pthread_mutex_init(&flights->lock, NULL);
+    pthread_cond_init(&flights->cond, NULL);
+}
+
+void rig_flight_cleanup(RIG *rig)
+{
+    struct rig_flights *flights = &CACHE(rig)->flights;
+
+    pthread_cond_destroy(&flights->cond);
+    pthread_mutex_destroy(&flights->lock);
+}
+
+/*
+ * Returns 1 when another caller's flight answered and *result is filled
+ * in.  Otherwise returns 0 and the caller must do the get itself and then
+ * call rig_flight_end() with *flight, which may be NULL when all slots are
+ * busy.
+ */
+int rig_flight_begin(RIG *rig, enum rig_flight_op_e op, vfo_t vfo,
+                     setting_t key, struct rig_flight **flight,
+                     struct rig_flight_result *result)
+{
+    struct rig_flights *flights = &CACHE(rig)->flights;
+    struct rig_flight *free_slot = NULL;
+    pthread_t self = pthread_self();
+    int can_wait;
+    int i;
+
+    *flight = NULL;
+
+    if (vfo == RIG_VFO_CURR)
+    {
+        vfo = STATE(rig)->current_vfo;
+    }
+
+    // only we ever set api_owner to ourselves, see rig_flight_api_lock()
+    can_wait = !(__atomic_load_n(&flights->api_depth, __ATOMIC_RELAXED) > 0
+                 && pthread_equal(flights->api_owner, self));
+
+    pthread_mutex_lock(&flights->lock);
+
+    for (i = 0; i < RIG_FLIGHT_SLOTS && can_wait; i++)
+    {
+        const struct rig_flight *f = &flights->slot[i];
+
+        if (f->op != RIG_FLIGHT_NONE && !f->done && pthread_equal(f->leader, self))
+        {
+            can_wait = 0;
+        }
+    }
+
+    for (i = 0; i < RIG_FLIGHT_SLOTS; i++)
+    {
+        struct rig_flight *f = &flights->slot[i];
+
+        if (f->op == RIG_FLIGHT_NONE)
+        {
+            if (!free_slot) { free_slot = f; }
+
+            continue;
+        }
+
+        if (f->done || f->op != op || f->vfo != vfo || f->key != key)
+        {
+            continue;
+        }
+
+        if (!can_wait)
+        {
+            // run it ourselves, the flight stays with its leader
+            free_slot = NULL;
+            break;
+        }
+
+        f->waiters++;
+
+        while (!f->done)
+        {
+            pthread_cond_wait(&flights->cond, &flights->lock);
+        }
+
+        *result = f->result;
+
+        if (--f->waiters == 0)
+        {
+            f->op = RIG_FLIGHT_NONE;
+        }
+
+        flights->shared++;
+        pthread_mutex_unlock(&flights->lock);
+        return 1;
+    }
+
+    if (free_slot)
+    {
+        free_slot->op = op;
+        free_slot->vfo = vfo;
+        free_slot->key = key;
+        free_slot->leader = self;
+        free_slot->waiters = 0;
+        free_slot->done = 0;
+        *flight = free_slot;
+    }
+
+    flights->led++;
+    pthread_mutex_unlock(&flights->lock);
+    return 0;
+}
+
+void rig_flight_end(RIG *rig, struct rig_flight *flight,
+                    const struct rig_flight_result *result)
+{
+    struct rig_flights *flights = &CACHE(rig)->flights;
+
+    if (!flight)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&flights->lock);
+
+    if (flight->waiters == 0)
+    {
+        flight->op = RIG_FLIGHT_NONE;
+    }
+    else
+    {
+        flight->result = *result;
+        flight->done = 1;
+        pthread_cond_broadcast(&flights->cond);
+    }
+
+    pthread_mutex_unlock(&flights->lock);
+}
+
+/*
+ * Called by rig_lock() with the API lock held, so the owner fields are
+ * only written by the thread that owns it.
+ */
+void rig_flight_api_lock(RIG *rig, int lock)
+{
+    struct rig_flights *flights = &CACHE(rig)->flights;
+
+    if (lock)
+    {
+        if (flights->api_depth == 0)
+        {
+            flights->api_owner = pthread_self();
+        }
+
+        __atomic_store_n(&flights->api_depth, flights->api_depth + 1,
+                         __ATOMIC_RELAXED);
+    }
+    else
+    {
+        __atomic_store_n(&flights->api_depth, flights->api_depth - 1,
+                         __ATOMIC_RELAXED);
+    }
+}
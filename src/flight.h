@@ -0,0 +1,84 @@
+/*
+ *  Hamlib Interface - coalescing of concurrent identical gets
+ *  Copyright (c) 2026 The Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#ifndef _HL_FLIGHT_H
+#define _HL_FLIGHT_H 1
+
+#include <pthread.h>
+
+#include "hamlib/rig.h"
+
+__BEGIN_DECLS
+
+/* Gets that may be shared between concurrent callers */
+enum rig_flight_op_e {
+    RIG_FLIGHT_NONE,    // slot is free
+    RIG_FLIGHT_FREQ,
+    RIG_FLIGHT_MODE,
+    RIG_FLIGHT_PTT,
+    RIG_FLIGHT_LEVEL,
+};
+
+/* What a get returned, only the fields for its op are meaningful */
+struct rig_flight_result {
+    int retcode;
+    freq_t freq;
+    rmode_t mode;
+    pbwidth_t width;
+    ptt_t ptt;
+    value_t val;
+};
+
+struct rig_flight {
+    enum rig_flight_op_e op;
+    vfo_t vfo;
+    setting_t key;
+    pthread_t leader;   // the thread talking to the rig
+    int waiters;
+    int done;           // result is valid, slot is freed by the last waiter
+    struct rig_flight_result result;
+};
+
+#define RIG_FLIGHT_SLOTS 8
+
+struct rig_flights {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct rig_flight slot[RIG_FLIGHT_SLOTS];
+    pthread_t api_owner;    // thread holding the API lock, if api_depth > 0
+    int api_depth;
+    unsigned long led;      // gets that went to the rig
+    unsigned long shared;   // gets answered from another caller's flight
+};
+
+void rig_flight_init(RIG *rig);
+void rig_flight_cleanup(RIG *rig);
+int rig_flight_begin(RIG *rig, enum rig_flight_op_e op, vfo_t vfo,
+                     setting_t key, struct rig_flight **flight,
+                     struct rig_flight_result *result);
+void rig_flight_end(RIG *rig, struct rig_flight *flight,
+                    const struct rig_flight_result *result);
+void rig_flight_api_lock(RIG *rig, int lock);
+
+__END_DECLS
+
+#endif /* _HL_FLIGHT_H */
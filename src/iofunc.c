@@ -39,6 +39,7 @@
 #include <fcntl.h>   /* File control definitions */
 #include <errno.h>   /* Error number definitions */
 #include <sys/time.h>
+#include <time.h>
 #include <sys/types.h>
 
 #include "hamlib/port.h"
@@ -51,9 +52,34 @@
 #include "network.h"
 #include "cm108.h"
 #include "asyncpipe.h"
+#include "cache.h"
 
 #define HAMLIB_TRACE2 rig_debug(RIG_DEBUG_TRACE,"%s trace(%d)\n",  __FILE__, __LINE__)
 
+/* The device and the sync data pipe are read by different threads when
+ * asyncio is on, so each gets its own read-ahead buffer. */
+#define PORT_RXBUF(p, direct) (&(p)->rxbuf[(direct) ? 0 : 1])
+
+/* p->timeout, cut short by the port deadline if there is one */
+static int port_timeout_ms(const hamlib_port_t *p)
+{
+    int64_t left;
+
+    if (p->deadline_ns == 0)
+    {
+        return p->timeout;
+    }
+
+    left = (p->deadline_ns - rig_cache_now_ns()) / 1000000;
+
+    if (left <= 0)
+    {
+        return 0;
+    }
+
+    return left < p->timeout ? (int) left : p->timeout;
+}
+
 #if defined(WIN32) && defined(HAVE_WINDOWS_H)
 #include <windows.h>
 
@@ -232,7 +258,10 @@ int HAMLIB_API port_open(hamlib_port_t *p)
     int want_state_delay = 0;
 
     p->fd = -1;
+    p->next_write_us = 0;
     init_sync_data_pipe(p);
+    port_rxbuf_discard(p, 1);
+    port_rxbuf_discard(p, 0);
 
     if (p->asyncio)
     {
@@ -418,6 +447,8 @@ int HAMLIB_API port_close(hamlib_port_t *p, rig_port_t port_type)
     }
 
     close_sync_data_pipe(p);
+    port_rxbuf_discard(p, 1);
+    port_rxbuf_discard(p, 0);
 
     return (ret);
 }
@@ -736,9 +767,10 @@ static int port_wait_for_data_direct(hamlib_port_t *p)
     fd_set rfds, efds;
     int fd = p->fd;
     struct timeval tv, tv_timeout;
+    int timeout = port_timeout_ms(p);
     int result;
-    tv_timeout.tv_sec = p->timeout / 1000;
-    tv_timeout.tv_usec = (p->timeout % 1000) * 1000;
+    tv_timeout.tv_sec = timeout / 1000;
+    tv_timeout.tv_usec = (timeout % 1000) * 1000;
     //rig_debug(RIG_DEBUG_CACHE, "%s(%d): timeout=%ld,%ld\n", __func__, __LINE__, tv_timeout.tv_sec, tv_timeout.tv_usec);
 
     tv = tv_timeout;    /* select may have updated it */
@@ -797,6 +829,7 @@ int HAMLIB_API write_block_sync_error(hamlib_port_t *p,
 int HAMLIB_API port_flush_sync_pipes(hamlib_port_t *p)
 {
     // TODO: To be implemented for Windows
+    port_rxbuf_discard(p, 0);
     return RIG_OK;
 }
 
@@ -895,14 +928,15 @@ static int port_wait_for_data(hamlib_port_t *p, int direct)
     fd_set rfds, efds;
     int fd, errorfd, maxfd;
     struct timeval tv, tv_timeout;
+    int timeout = port_timeout_ms(p);
     int result;
 
     fd = direct ? p->fd : p->fd_sync_read;
     errorfd = direct ? -1 : p->fd_sync_error_read;
     maxfd = (fd > errorfd) ? fd : errorfd;
 
-    tv_timeout.tv_sec = p->timeout / 1000;
-    tv_timeout.tv_usec = (p->timeout % 1000) * 1000;
+    tv_timeout.tv_sec = timeout / 1000;
+    tv_timeout.tv_usec = (timeout % 1000) * 1000;
 
     tv = tv_timeout;    /* select may have updated it */
 
@@ -1005,7 +1039,7 @@ int HAMLIB_API port_flush_sync_pipes(hamlib_port_t *p)
 
     rig_debug(RIG_DEBUG_TRACE, "%s: flushing sync pipes\n", __func__);
 
-    nbytes = 0;
+    nbytes = port_rxbuf_discard(p, 0);
 
     while ((n = read(p->fd_sync_read, buf, sizeof(buf))) > 0)
     {
@@ -1030,6 +1064,27 @@ int HAMLIB_API port_flush_sync_pipes(hamlib_port_t *p)
 
 #endif
 
+/* Monotonic time in us, for write pacing */
+static int64_t pace_now_us(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (int64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/* Sleep until the monotonic time deadline, if it is still ahead */
+static void pace_until(int64_t deadline)
+{
+    int64_t left = deadline - pace_now_us();
+
+    if (left > 0)
+    {
+        hl_usleep(left);
+    }
+}
+
 /**
  * \brief Write a block of characters to an fd.
  * \param p rig port descriptor
@@ -1046,6 +1101,12 @@ int HAMLIB_API port_flush_sync_pipes(hamlib_port_t *p)
  * Also, post_write_delay is for some Yaesu rigs (eg: FT747) that
  * get confused with sequential fast writes between cmd sequences.
  *
+ * Both delays are deadlines rather than sleeps: bytes are paced from the
+ * start of the block, so time spent in write() or oversleeping does not
+ * add up, and the gap after a block is only waited out at the start of
+ * the next one, minus whatever time already passed (typically reading
+ * the reply).
+ *
  * input:
  *
  * fd - file descriptor to write to
@@ -1053,7 +1114,7 @@ int HAMLIB_API port_flush_sync_pipes(hamlib_port_t *p)
  * count - count of byte to send from the txbuffer
  * write_delay - write delay in ms between 2 chars
  * post_write_delay - minimum delay between two writes
- * post_write_date - timeval of last write
+ * next_write_us - monotonic time the next write may start at
  *
  * Actually, this function has nothing specific to serial comm,
  * it could work very well also with any file handle, like a socket.
@@ -1063,6 +1124,7 @@ int HAMLIB_API write_block(hamlib_port_t *p, const unsigned char *txbuffer,
                            size_t count)
 {
     int ret;
+    int64_t next_write = 0;
 
     if (p->fd < 0)
     {
@@ -1070,36 +1132,20 @@ int HAMLIB_API write_block(hamlib_port_t *p, const unsigned char *txbuffer,
         return (-RIG_EIO);
     }
 
-#ifdef WANT_NON_ACTIVE_POST_WRITE_DELAY
-
-    if (p->post_write_date.tv_sec != 0)
+    if (p->next_write_us != 0)
     {
-        signed int date_delay;    /* in us */
-        struct timeval tv;
-
-        /* FIXME in Y2038 ... */
-        gettimeofday(&tv, NULL);
-        date_delay = p->post_write_delay * 1000 -
-                     ((tv.tv_sec - p->post_write_date.tv_sec) * 1000000 +
-                      (tv.tv_usec - p->post_write_date.tv_usec));
-
-        if (date_delay > 0)
-        {
-            /*
-             * optional delay after last write
-             */
-            hl_sleep(date_delay);
-        }
-
-        p->post_write_date.tv_sec = 0;
+        pace_until(p->next_write_us);
+        p->next_write_us = 0;
     }
 
-#endif
-
     if (p->write_delay > 0)
     {
+        int64_t start = pace_now_us();
+
         for (int i = 0; i < count; i++)
         {
+            if (i > 0) { pace_until(start + (int64_t) i * p->write_delay * 1000); }
+
             ret = port_write(p, txbuffer + i, 1);
 
             if (ret != 1)
@@ -1113,9 +1159,10 @@ int HAMLIB_API write_block(hamlib_port_t *p, const unsigned char *txbuffer,
 
                 return -RIG_EIO;
             }
-
-            if (p->write_delay > 0) { hl_usleep(p->write_delay * 1000); }
         }
+
+        // the last byte needs its gap too
+        next_write = start + (int64_t) count * p->write_delay * 1000;
     }
     else
     {
@@ -1138,29 +1185,98 @@ int HAMLIB_API write_block(hamlib_port_t *p, const unsigned char *txbuffer,
               (int)count);
     dump_hex((unsigned char *) txbuffer, count);
 
+    /* otherwise some yaesu rigs get confused */
+    /* with sequential fast writes*/
     if (p->post_write_delay > 0)
     {
-#if 0
-#ifdef WANT_NON_ACTIVE_POST_WRITE_DELAY
-#define POST_WRITE_DELAY_TRSHLD 10
+        int64_t after = pace_now_us() + (int64_t) p->post_write_delay * 1000;
 
-        if (p->post_write_delay > POST_WRITE_DELAY_TRSHLD)
+        if (after > next_write) { next_write = after; }
+    }
+
+    p->next_write_us = next_write;
+
+    return RIG_OK;
+}
+
+/**
+ * \brief Drop the bytes held in a port read-ahead buffer
+ * \param p rig port descriptor
+ * \param direct 1 for the device buffer, 0 for the synchronous data pipe one
+ * \return number of bytes discarded
+ *
+ * Must be called wherever pending input is thrown away (flush, open, close)
+ * so that stale read-ahead data does not turn up in the next reply.
+ */
+int HAMLIB_API port_rxbuf_discard(hamlib_port_t *p, int direct)
+{
+    int discarded = PORT_RXBUF(p, direct)->len;
+
+    PORT_RXBUF(p, direct)->head = 0;
+    PORT_RXBUF(p, direct)->len = 0;
+
+    return discarded;
+}
+
+/*
+ * Refill an empty read-ahead buffer with whatever the source has ready,
+ * up to the size of the buffer, in a single read.
+ */
+static ssize_t port_rxbuf_fill(hamlib_port_t *p, int direct)
+{
+    struct hamlib_port_rxbuf *rb = PORT_RXBUF(p, direct);
+    ssize_t rd_count;
+
+    rb->head = 0;
+    rd_count = port_read_generic(p, rb->data, sizeof(rb->data), direct);
+    rb->len = rd_count > 0 ? (int) rd_count : 0;
+
+    return rd_count;
+}
+
+/*
+ * Move up to max buffered bytes into dst, stopping after the first
+ * character found in stopset.  *stopped tells the caller whether the
+ * terminator was reached.  Returns the number of bytes moved.
+ */
+static int port_rxbuf_take(hamlib_port_t *p, int direct, unsigned char *dst,
+                           int max, const char *stopset, int stopset_len,
+                           int *stopped)
+{
+    struct hamlib_port_rxbuf *rb = PORT_RXBUF(p, direct);
+    const unsigned char *src = rb->data + rb->head;
+    int n = rb->len < max ? rb->len : max;
+
+    *stopped = 0;
+
+    if (stopset && stopset_len == 1)
+    {
+        const unsigned char *end = memchr(src, stopset[0], n);
+
+        if (end)
         {
-            struct timeval tv;
-            gettimeofday(&tv, NULL);
-            p->post_write_date.tv_sec = tv.tv_sec;
-            p->post_write_date.tv_usec = tv.tv_usec;
+            n = (int)(end - src) + 1;
+            *stopped = 1;
+        }
+    }
+    else if (stopset && stopset_len > 1)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            if (memchr(stopset, src[i], stopset_len))
+            {
+                n = i + 1;
+                *stopped = 1;
+                break;
+            }
         }
-        else
-#endif
-#endif
-            hl_usleep(p->post_write_delay * 1000); /* optional delay after last write */
-
-        /* otherwise some yaesu rigs get confused */
-        /* with sequential fast writes*/
     }
 
-    return RIG_OK;
+    memcpy(dst, src, n);
+    rb->head += n;
+    rb->len -= n;
+
+    return n;
 }
 
 static int read_block_generic(hamlib_port_t *p, unsigned char *rxbuffer,
@@ -1179,6 +1295,16 @@ static int read_block_generic(hamlib_port_t *p, unsigned char *rxbuffer,
     /* Store the time of the read loop start */
     gettimeofday(&start_time, NULL);
 
+    /* hand out what an earlier read_string() read ahead first */
+    if (count > 0 && PORT_RXBUF(p, direct)->len > 0)
+    {
+        int stopped;
+        int max = count < HAMLIB_PORT_RXBUF_SIZE ? (int) count : HAMLIB_PORT_RXBUF_SIZE;
+
+        total_count = port_rxbuf_take(p, direct, rxbuffer, max, NULL, 0, &stopped);
+        count -= total_count;
+    }
+
     short timeout_retries = p->timeout_retry;
 
     while (count > 0)
@@ -1319,8 +1445,7 @@ static int read_string_generic(hamlib_port_t *p,
 {
     struct timeval start_time, end_time, elapsed_time;
     int total_count = 0;
-    int i = 0;
-    static int minlen = 1; // dynamic minimum length of rig response data
+    int flrig_stop;
 
     if (p != NULL && !p->asyncio && !direct)
     {
@@ -1344,6 +1469,9 @@ static int read_string_generic(hamlib_port_t *p,
         return 0;
     }
 
+    // special read for FLRig, the terminator is a whole tag
+    flrig_stop = stopset != NULL && strcmp(stopset, "</methodResponse>") == 0;
+
     /* Store the time of the read loop start */
     gettimeofday(&start_time, NULL);
 
@@ -1353,25 +1481,35 @@ static int read_string_generic(hamlib_port_t *p,
 
     while (total_count < rxmax - 1) // allow 1 byte for end-of-string
     {
-        ssize_t rd_count = 0;
-        int result;
-        result = port_wait_for_data(p, direct);
+        int stopped;
+        int room = (int)(rxmax - 1 - total_count);
 
-        if (result == -RIG_ETIMEOUT)
+        /*
+         * Only go to the device when everything read ahead last time has
+         * been consumed, and then take as much as it has ready in one read
+         * rather than one character at a time.
+         */
+        if (PORT_RXBUF(p, direct)->len == 0)
         {
-            if (timeout_retries > 0)
-            {
-                timeout_retries--;
-                rig_debug(RIG_DEBUG_CACHE, "%s(%d): retrying read timeout %d/%d timeout=%d\n",
-                          __func__, __LINE__,
-                          p->timeout_retry - timeout_retries, p->timeout_retry, p->timeout);
-                hl_usleep(10 * 1000);
-                continue;
-            }
+            ssize_t rd_count;
+            int result;
+            int i = 0;
+
+            result = port_wait_for_data(p, direct);
 
-            // a timeout is a timeout no matter how many bytes
-            //if (0 == total_count)
+            if (result == -RIG_ETIMEOUT)
             {
+                if (timeout_retries > 0)
+                {
+                    timeout_retries--;
+                    rig_debug(RIG_DEBUG_CACHE, "%s(%d): retrying read timeout %d/%d timeout=%d\n",
+                              __func__, __LINE__,
+                              p->timeout_retry - timeout_retries, p->timeout_retry, p->timeout);
+                    hl_usleep(10 * 1000);
+                    continue;
+                }
+
+                // a timeout is a timeout no matter how many bytes
                 /* Record timeout time and calculate elapsed time */
                 gettimeofday(&end_time, NULL);
                 timersub(&end_time, &start_time, &elapsed_time);
@@ -1395,97 +1533,76 @@ static int read_string_generic(hamlib_port_t *p,
                 return -RIG_ETIMEOUT;
             }
 
-            break; /* return what we have read */
-        }
-
-        if (result < 0)
-        {
-            if (direct)
+            if (result < 0)
             {
-                dump_hex(rxbuffer, total_count);
+                if (direct)
+                {
+                    dump_hex(rxbuffer, total_count);
+                }
+
+                rig_debug(RIG_DEBUG_ERR, "%s(%d): I/O error after %d chars, direct=%d: %d\n",
+                          __func__, __LINE__, total_count, direct, result);
+                return result;
             }
 
-            rig_debug(RIG_DEBUG_ERR, "%s(%d): I/O error after %d chars, direct=%d: %d\n",
-                      __func__, __LINE__, total_count, direct, result);
-            return result;
-        }
+            /* The file descriptor must have been set up non blocking. */
+            do
+            {
+                rd_count = port_rxbuf_fill(p, direct);
 
-        /*
-         * read 1 character from the rig, (check if in stop set)
-         * The file descriptor must have been set up non blocking.
-         */
-        do
-        {
-#if 0
-#ifndef __MINGW32__
-            // The ioctl works on Linux but not mingw
-            int avail = 0;
-            ioctl(p->fd, FIONREAD, &avail);
-            //rig_debug(RIG_DEBUG_ERR, "xs: avail=%d expected_len=%d, minlen=%d, direct=%d\n", __func__, avail, expected_len, minlen, direct);
-#endif
-#endif
-shortcut:
-            rd_count = port_read_generic(p, &rxbuffer[total_count],
-                                         expected_len == 1 ? 1 : minlen, direct);
-//            rig_debug(RIG_DEBUG_VERBOSE, "%s: read %d bytes tot=%d\n", __func__, (int)rd_count, total_count);
-            minlen -= rd_count;
+                if (rd_count >= 0 || (errno != EAGAIN && errno != EBUSY))
+                {
+                    break;
+                }
 
-            if (errno == EAGAIN)
-            {
                 hl_usleep(5 * 1000);
-//                rig_debug(RIG_DEBUG_WARN, "%s: port_read is busy? direct=%d\n", __func__,
-//                          direct);
             }
+            while (++i < 10);   // 50ms should be enough
 
-            // special read for FLRig
-            if (stopset != NULL && strcmp(stopset, "</methodResponse>") == 0)
+            /* if we get 0 bytes or an error something is wrong */
+            if (rd_count <= 0)
             {
-                if (strstr((char *)rxbuffer, stopset))
-                {
-                    HAMLIB_TRACE2;
-                }
-
-                else
+                if (direct)
                 {
-                    HAMLIB_TRACE2;
-                    goto shortcut;
+                    dump_hex((unsigned char *) rxbuffer, total_count);
                 }
-            }
 
-        }
+                rig_debug(RIG_DEBUG_ERR, "%s(): read failed, direct=%d - %s\n", __func__,
+                          direct, strerror(errno));
 
-        while (++i < 10 && errno == EBUSY);   // 50ms should be enough
-
-        /* if we get 0 bytes or an error something is wrong */
-        if (rd_count <= 0)
-        {
-            if (direct)
-            {
-                dump_hex((unsigned char *) rxbuffer, total_count);
+                return -RIG_EIO;
             }
-
-            rig_debug(RIG_DEBUG_ERR, "%s(): read failed, direct=%d - %s\n", __func__,
-                      direct, strerror(errno));
-
-            return -RIG_EIO;
         }
 
-        total_count += (int) rd_count;
-
-        if (total_count == rxmax) { break; }
-
-        if (stopset && memchr(stopset, rxbuffer[total_count - 1], stopset_len))
+        if (flrig_stop)
         {
-            if (minlen == 1) { minlen = total_count; }
+            int taken = port_rxbuf_take(p, direct, &rxbuffer[total_count], room, NULL, 0,
+                                        &stopped);
+            const char *tag = strstr((char *)rxbuffer, stopset);
+
+            total_count += taken;
 
-            if (minlen < total_count)
+            if (tag)
             {
-                minlen = total_count;
-                //rig_debug(RIG_DEBUG_VERBOSE, "%s: minlen now %d\n", __func__, minlen);
+                /* give back whatever followed the closing tag */
+                int excess = total_count - (int)(tag - (char *)rxbuffer)
+                             - (int) strlen(stopset);
+
+                PORT_RXBUF(p, direct)->head -= excess;
+                PORT_RXBUF(p, direct)->len += excess;
+                total_count -= excess;
+                memset(&rxbuffer[total_count], 0, excess);
+                HAMLIB_TRACE2;
+                break;
             }
 
-            break;
+            continue;
         }
+
+        total_count += port_rxbuf_take(p, direct, &rxbuffer[total_count], room,
+                                       stopset, stopset_len, &stopped);
+
+        if (stopped) { break; }
     }
 
     if (total_count > 1 && rxbuffer[0] == ';')
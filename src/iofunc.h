@@ -50,6 +50,8 @@ extern HAMLIB_EXPORT(int) write_block_sync_error(hamlib_port_t *p,
 
 extern HAMLIB_EXPORT(int) port_flush_sync_pipes(hamlib_port_t *p);
 
+extern HAMLIB_EXPORT(int) port_rxbuf_discard(hamlib_port_t *p, int direct);
+
 extern HAMLIB_EXPORT(int) read_string(hamlib_port_t *p,
                                       unsigned char *rxbuffer,
                                       size_t rxmax,
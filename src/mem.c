@@ -37,14 +37,23 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <errno.h>
 
 #include "hamlib/rig.h"
 #include "hamlib/rig_state.h"
+#include "iofunc.h"
+#include "mem.h"
 
 #ifndef DOC_HIDDEN
 
 #define CHECK_RIG_ARG(r) (!(r) || !(r)->caps || !STATE(r)->comm_state)
 
+static int set_channel(RIG *rig, vfo_t vfo, const channel_t *chan);
+static int set_channel_incremental(RIG *rig, vfo_t vfo, const channel_t *chan,
+                                   int *written);
+static int get_channel(RIG *rig, vfo_t vfox, channel_t *chan, int read_only);
+static int read_channel(RIG *rig, vfo_t vfox, channel_t *chan, int read_only);
+
 #endif /* !DOC_HIDDEN */
 
 
@@ -348,6 +357,365 @@ static int rig_mem_caps_empty(const channel_cap_t *mem_cap)
 }
 
 
+/*
+ * mem_cap less what the rig has no call for, so that reading a channel
+ * does not go through calls that can only fail.  Split, freq and VFO
+ * are left alone, the frontend emulates or caches them.
+ */
+static void rig_mem_caps_readable(RIG *rig, const channel_cap_t *mem_cap,
+                                  channel_cap_t *readable)
+{
+    const struct rig_caps *rc = rig->caps;
+
+    *readable = *mem_cap;
+
+    if (!rc->get_mode) { readable->mode = readable->width = 0; }
+
+    if (!rc->get_rptr_shift) { readable->rptr_shift = 0; }
+
+    if (!rc->get_rptr_offs) { readable->rptr_offs = 0; }
+
+    if (!rc->get_ant) { readable->ant = 0; }
+
+    if (!rc->get_ts) { readable->tuning_step = 0; }
+
+    if (!rc->get_rit) { readable->rit = 0; }
+
+    if (!rc->get_xit) { readable->xit = 0; }
+
+    if (!rc->get_ctcss_tone) { readable->ctcss_tone = 0; }
+
+    if (!rc->get_ctcss_sql) { readable->ctcss_sql = 0; }
+
+    if (!rc->get_dcs_code) { readable->dcs_code = 0; }
+
+    if (!rc->get_dcs_sql) { readable->dcs_sql = 0; }
+
+    if (!rc->get_ext_level) { readable->ext_levels = 0; }
+
+    readable->levels = rc->get_level ? rig_has_get_level(rig,
+                       mem_cap->levels) : 0;
+    readable->funcs = rc->get_func ? rig_has_get_func(rig, mem_cap->funcs) : 0;
+}
+
+
+/*
+ * Last known content of the memory channels, for mem_incremental: an
+ * open addressing table of channel hashes keyed by bank and channel
+ * number.  A channel whose content is not known keeps its slot with
+ * known == 0, so entries are never removed.
+ */
+struct mem_hash_entry
+{
+    int used;
+    int known;
+    int bank_num;
+    int channel_num;
+    uint32_t hash;
+};
+
+struct mem_hashes
+{
+    struct mem_hash_entry *slots;
+    int size;       /* a power of two */
+    int used;
+};
+
+#define MEM_HASHES_MIN 256
+
+static unsigned int mem_hash_key(int bank_num, int channel_num)
+{
+    return ((unsigned int) bank_num * 2654435761u) ^ (unsigned int) channel_num
+           * 40503u;
+}
+
+static struct mem_hash_entry *mem_hash_find(struct mem_hash_entry *slots,
+        int size, int bank_num, int channel_num)
+{
+    unsigned int i = mem_hash_key(bank_num, channel_num) & (size - 1);
+
+    while (slots[i].used
+            && (slots[i].bank_num != bank_num || slots[i].channel_num != channel_num))
+    {
+        i = (i + 1) & (size - 1);
+    }
+
+    return &slots[i];
+}
+
+/* The channel's entry, created when create is set, or NULL */
+static struct mem_hash_entry *mem_hash_slot(RIG *rig, int bank_num,
+        int channel_num, int create)
+{
+    struct mem_hashes *mh = STATE(rig)->mem_hashes;
+    struct mem_hash_entry *e;
+
+    if (!mh)
+    {
+        if (!create) { return NULL; }
+
+        mh = calloc(1, sizeof(*mh));
+
+        if (!mh) { return NULL; }
+
+        STATE(rig)->mem_hashes = mh;
+    }
+
+    /* kept at most half full */
+    if (create && 2 * (mh->used + 1) > mh->size)
+    {
+        int size = mh->size ? 2 * mh->size : MEM_HASHES_MIN;
+        struct mem_hash_entry *slots = calloc(size, sizeof(*slots));
+        int i;
+
+        if (!slots) { return NULL; }
+
+        for (i = 0; i < mh->size; i++)
+        {
+            if (mh->slots[i].used)
+            {
+                *mem_hash_find(slots, size, mh->slots[i].bank_num,
+                               mh->slots[i].channel_num) = mh->slots[i];
+            }
+        }
+
+        free(mh->slots);
+        mh->slots = slots;
+        mh->size = size;
+    }
+
+    if (!mh->size) { return NULL; }
+
+    e = mem_hash_find(mh->slots, mh->size, bank_num, channel_num);
+
+    if (!e->used)
+    {
+        if (!create) { return NULL; }
+
+        e->used = 1;
+        e->bank_num = bank_num;
+        e->channel_num = channel_num;
+        mh->used++;
+    }
+
+    return e;
+}
+
+static void mem_hash_record(RIG *rig, const channel_t *chan, uint32_t hash)
+{
+    struct mem_hash_entry *e = mem_hash_slot(rig, chan->bank_num,
+                               chan->channel_num, 1);
+
+    if (e)
+    {
+        e->known = 1;
+        e->hash = hash;
+    }
+}
+
+/* An empty channel reads as a channel_t with only its number set */
+static uint32_t mem_hash_empty(RIG *rig, int bank_num, int channel_num)
+{
+    channel_t chan;
+
+    memset(&chan, 0, sizeof(chan));
+    chan.bank_num = bank_num;
+    chan.channel_num = channel_num;
+
+    return rig_channel_hash(rig, &chan);
+}
+
+static void mem_hash_record_empty(RIG *rig, int bank_num, int channel_num)
+{
+    struct mem_hash_entry *e = mem_hash_slot(rig, bank_num, channel_num, 1);
+
+    if (e)
+    {
+        e->known = 1;
+        e->hash = mem_hash_empty(rig, bank_num, channel_num);
+    }
+}
+
+static void mem_hash_forget(RIG *rig, const channel_t *chan)
+{
+    struct mem_hash_entry *e = mem_hash_slot(rig, chan->bank_num,
+                               chan->channel_num, 0);
+
+    if (e) { e->known = 0; }
+}
+
+void mem_hashes_cleanup(RIG *rig)
+{
+    struct mem_hashes *mh = STATE(rig)->mem_hashes;
+
+    if (mh)
+    {
+        free(mh->slots);
+        free(mh);
+        STATE(rig)->mem_hashes = NULL;
+    }
+}
+
+/* FNV-1a */
+static uint32_t hash_bytes(uint32_t h, const void *data, size_t len)
+{
+    const unsigned char *p = data;
+
+    while (len--)
+    {
+        h ^= *p++;
+        h *= 16777619u;
+    }
+
+    return h;
+}
+
+#define HASH_FIELD(h, field) ((h) = hash_bytes((h), &(field), sizeof(field)))
+#endif  /* !DOC_HIDDEN */
+
+
+/**
+ * \brief hash of the content of a memory channel
+ * \param rig   The rig handle
+ * \param chan  The channel
+ *
+ *  Hashes the fields of \a chan that the rig stores in a memory channel,
+ *  as told by the channel caps of \a chan->channel_num, or all of them
+ *  when the rig has no caps for it.  Two channels with the same hash
+ *  program the rig the same way.
+ *
+ *  With the mem_incremental conf parameter set, rig_set_channel() does
+ *  not write a memory channel whose hash is the last one written to or
+ *  read from the rig.
+ *
+ * \return the hash, never 0
+ *
+ * \sa rig_load_chan_hashes(), rig_save_chan_hashes()
+ */
+uint32_t HAMLIB_API rig_channel_hash(RIG *rig, const channel_t *chan)
+{
+    const channel_cap_t *mem_cap = &mem_cap_all;
+    const chan_t *chan_list = STATE(rig)->chan_list;
+    uint32_t h = 2166136261u;
+    int i;
+
+    for (i = 0; i < HAMLIB_CHANLSTSIZ && !RIG_IS_CHAN_END(chan_list[i]); i++)
+    {
+        if (chan->channel_num >= chan_list[i].startc
+                && chan->channel_num <= chan_list[i].endc)
+        {
+            if (!rig_mem_caps_empty(&chan_list[i].mem_caps))
+            {
+                mem_cap = &chan_list[i].mem_caps;
+            }
+
+            break;
+        }
+    }
+
+    if (mem_cap->ant) { HASH_FIELD(h, chan->ant); }
+
+    if (mem_cap->freq) { HASH_FIELD(h, chan->freq); }
+
+    if (mem_cap->mode) { HASH_FIELD(h, chan->mode); }
+
+    if (mem_cap->width) { HASH_FIELD(h, chan->width); }
+
+    if (mem_cap->tx_freq) { HASH_FIELD(h, chan->tx_freq); }
+
+    if (mem_cap->tx_mode) { HASH_FIELD(h, chan->tx_mode); }
+
+    if (mem_cap->tx_width) { HASH_FIELD(h, chan->tx_width); }
+
+    if (mem_cap->split) { HASH_FIELD(h, chan->split); }
+
+    if (mem_cap->tx_vfo) { HASH_FIELD(h, chan->tx_vfo); }
+
+    if (mem_cap->rptr_shift) { HASH_FIELD(h, chan->rptr_shift); }
+
+    if (mem_cap->rptr_offs) { HASH_FIELD(h, chan->rptr_offs); }
+
+    if (mem_cap->tuning_step) { HASH_FIELD(h, chan->tuning_step); }
+
+    if (mem_cap->rit) { HASH_FIELD(h, chan->rit); }
+
+    if (mem_cap->xit) { HASH_FIELD(h, chan->xit); }
+
+    if (mem_cap->funcs)
+    {
+        setting_t funcs = chan->funcs & mem_cap->funcs;
+
+        HASH_FIELD(h, funcs);
+    }
+
+    for (i = 0; i < RIG_SETTING_MAX; i++)
+    {
+        setting_t level = rig_idx2setting(i);
+
+        if (!(mem_cap->levels & level)) { continue; }
+
+        if (RIG_LEVEL_IS_FLOAT(level))
+        {
+            HASH_FIELD(h, chan->levels[i].f);
+        }
+        else
+        {
+            HASH_FIELD(h, chan->levels[i].i);
+        }
+    }
+
+    if (mem_cap->ctcss_tone) { HASH_FIELD(h, chan->ctcss_tone); }
+
+    if (mem_cap->ctcss_sql) { HASH_FIELD(h, chan->ctcss_sql); }
+
+    if (mem_cap->dcs_code) { HASH_FIELD(h, chan->dcs_code); }
+
+    if (mem_cap->dcs_sql) { HASH_FIELD(h, chan->dcs_sql); }
+
+    if (mem_cap->scan_group) { HASH_FIELD(h, chan->scan_group); }
+
+    if (mem_cap->flags) { HASH_FIELD(h, chan->flags); }
+
+    if (mem_cap->channel_desc)
+    {
+        h = hash_bytes(h, chan->channel_desc, strnlen(chan->channel_desc,
+                       sizeof(chan->channel_desc)));
+    }
+
+    if (mem_cap->tag)
+    {
+        h = hash_bytes(h, chan->tag, strnlen(chan->tag, sizeof(chan->tag)));
+    }
+
+    if (mem_cap->ext_levels)
+    {
+        const struct ext_list *p;
+
+        for (p = chan->ext_levels; p && !RIG_IS_EXT_END(*p); p++)
+        {
+            const struct confparams *cfp = rig_ext_lookup_tok(rig, p->token);
+
+            HASH_FIELD(h, p->token);
+
+            /* strings and binaries are pointers, their content is not hashed */
+            if (cfp && cfp->type == RIG_CONF_NUMERIC)
+            {
+                HASH_FIELD(h, p->val.f);
+            }
+            else if (cfp && (cfp->type == RIG_CONF_CHECKBUTTON
+                             || cfp->type == RIG_CONF_COMBO))
+            {
+                HASH_FIELD(h, p->val.i);
+            }
+        }
+    }
+
+    return h ? h : 1;
+}
+
+
+#ifndef DOC_HIDDEN
+
 /*
  * stores current VFO state into chan by emulating rig_get_channel
  */
@@ -358,6 +726,7 @@ static int generic_save_channel(RIG *rig, channel_t *chan)
     vfo_t vfo;
     setting_t setting;
     const channel_cap_t *mem_cap = NULL;
+    channel_cap_t readable;
     value_t vdummy = {0};
 
     chan_num = chan->channel_num;
@@ -383,6 +752,9 @@ static int generic_save_channel(RIG *rig, channel_t *chan)
         mem_cap = &mem_cap_all;
     }
 
+    rig_mem_caps_readable(rig, mem_cap, &readable);
+    mem_cap = &readable;
+
     if (mem_cap->freq)
     {
         int retval = rig_get_freq(rig, RIG_VFO_CURR, &chan->freq);
@@ -512,7 +884,10 @@ static int generic_save_channel(RIG *rig, channel_t *chan)
      * - flags
      */
 
-    rig_ext_level_foreach(rig, generic_retr_extl, (rig_ptr_t)chan);
+    if (mem_cap->ext_levels)
+    {
+        rig_ext_level_foreach(rig, generic_retr_extl, (rig_ptr_t)chan);
+    }
 
     return RIG_OK;
 }
@@ -678,17 +1053,13 @@ static int generic_restore_channel(RIG *rig, const channel_t *chan)
  * a negative value if an error occurred (in which case, cause is
  * set appropriately).
  *
+ * With the mem_incremental conf parameter set, a memory channel whose
+ * content is the last known one is not written, see rig_channel_hash().
+ *
  * \sa rig_get_channel()
  */
 int HAMLIB_API rig_set_channel(RIG *rig, vfo_t vfo, const channel_t *chan)
 {
-    struct rig_caps *rc;
-    int curr_chan_num = -1, get_mem_status = RIG_OK;
-    vfo_t curr_vfo;
-    vfo_t vfotmp; /* requested vfo */
-    int retcode;
-    int can_emulate_by_vfo_mem, can_emulate_by_vfo_op;
-
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
     if (CHECK_RIG_ARG(rig) || !chan)
@@ -696,6 +1067,26 @@ int HAMLIB_API rig_set_channel(RIG *rig, vfo_t vfo, const channel_t *chan)
         return -RIG_EINVAL;
     }
 
+    if (STATE(rig)->mem_incremental != RIG_MEM_INCREMENTAL_OFF
+            && chan->vfo == RIG_VFO_MEM)
+    {
+        return set_channel_incremental(rig, vfo, chan, NULL);
+    }
+
+    return set_channel(rig, vfo, chan);
+}
+
+
+#ifndef DOC_HIDDEN
+static int set_channel(RIG *rig, vfo_t vfo, const channel_t *chan)
+{
+    struct rig_caps *rc;
+    int curr_chan_num = -1, get_mem_status = RIG_OK;
+    vfo_t curr_vfo;
+    vfo_t vfotmp; /* requested vfo */
+    int retcode;
+    int can_emulate_by_vfo_mem, can_emulate_by_vfo_op;
+
     /*
      * TODO: check validity of chan->channel_num
      */
@@ -785,6 +1176,80 @@ int HAMLIB_API rig_set_channel(RIG *rig, vfo_t vfo, const channel_t *chan)
 }
 
 
+/*
+ * Writes the memory channel unless its content is the last known one,
+ * and with RIG_MEM_INCREMENTAL_VERIFY reads it back.  *written tells
+ * which it was.
+ */
+static int set_channel_incremental(RIG *rig, vfo_t vfo, const channel_t *chan,
+                                   int *written)
+{
+    const struct mem_hash_entry *e = mem_hash_slot(rig, chan->bank_num,
+                                     chan->channel_num, 0);
+    uint32_t hash = rig_channel_hash(rig, chan);
+    int retcode;
+
+    if (written) { *written = 0; }
+
+    if (e && e->known && e->hash == hash)
+    {
+        rig_debug(RIG_DEBUG_TRACE, "%s: channel %d unchanged\n", __func__,
+                  chan->channel_num);
+        return RIG_OK;
+    }
+
+    /* whatever happens now, the rig's content is not known any more */
+    mem_hash_forget(rig, chan);
+
+    retcode = set_channel(rig, vfo, chan);
+
+    if (retcode != RIG_OK)
+    {
+        return retcode;
+    }
+
+    if (written) { *written = 1; }
+
+    if (STATE(rig)->mem_incremental == RIG_MEM_INCREMENTAL_VERIFY)
+    {
+        channel_t back;
+        uint32_t back_hash;
+
+        memset(&back, 0, sizeof(back));
+        back.vfo = RIG_VFO_MEM;
+        back.bank_num = chan->bank_num;
+        back.channel_num = chan->channel_num;
+
+        retcode = get_channel(rig, vfo, &back, 1);
+        back_hash = rig_channel_hash(rig, &back);
+        free(back.ext_levels);
+
+        /* a cleared channel reads back as not there */
+        if (retcode == -RIG_ENAVAIL
+                && hash == mem_hash_empty(rig, chan->bank_num, chan->channel_num))
+        {
+            back_hash = hash;
+        }
+        else if (retcode != RIG_OK)
+        {
+            return retcode;
+        }
+
+        if (back_hash != hash)
+        {
+            rig_debug(RIG_DEBUG_ERR, "%s: channel %d reads back different\n",
+                      __func__, chan->channel_num);
+            return -RIG_EPROTO;
+        }
+    }
+
+    mem_hash_record(rig, chan, hash);
+
+    return RIG_OK;
+}
+#endif  /* !DOC_HIDDEN */
+
+
 /**
  * \brief get channel data
  * \param rig   The rig handle
@@ -822,18 +1287,14 @@ int HAMLIB_API rig_set_channel(RIG *rig, vfo_t vfo, const channel_t *chan)
  * a negative value if an error occurred (in which case, cause is
  * set appropriately).
  *
+ * With the mem_incremental conf parameter set, the content read is
+ * remembered as the memory channel's last known one.
+ *
  * \sa rig_set_channel()
  */
 int HAMLIB_API rig_get_channel(RIG *rig, vfo_t vfox, channel_t *chan,
                                int read_only)
 {
-    struct rig_caps *rc;
-    int curr_chan_num = -1, get_mem_status = RIG_OK;
-    vfo_t curr_vfo;
-    vfo_t vfotmp = RIG_VFO_NONE; /* requested vfo */
-    int retcode = RIG_OK;
-    int can_emulate_by_vfo_mem, can_emulate_by_vfo_op;
-
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
     if (CHECK_RIG_ARG(rig) || !chan)
@@ -841,6 +1302,45 @@ int HAMLIB_API rig_get_channel(RIG *rig, vfo_t vfox, channel_t *chan,
         return -RIG_EINVAL;
     }
 
+    return get_channel(rig, vfox, chan, read_only);
+}
+
+
+#ifndef DOC_HIDDEN
+static int get_channel(RIG *rig, vfo_t vfox, channel_t *chan, int read_only)
+{
+    int mem = chan->vfo == RIG_VFO_MEM;
+    int bank_num = chan->bank_num, channel_num = chan->channel_num;
+    int retcode = read_channel(rig, vfox, chan, read_only);
+
+    if (STATE(rig)->mem_incremental == RIG_MEM_INCREMENTAL_OFF || !mem)
+    {
+        return retcode;
+    }
+
+    /* backends may set chan->vfo to the VFO the channel is read into */
+    if (retcode == RIG_OK)
+    {
+        mem_hash_record(rig, chan, rig_channel_hash(rig, chan));
+    }
+    else if (retcode == -RIG_ENAVAIL)
+    {
+        mem_hash_record_empty(rig, bank_num, channel_num);
+    }
+
+    return retcode;
+}
+
+
+static int read_channel(RIG *rig, vfo_t vfox, channel_t *chan, int read_only)
+{
+    struct rig_caps *rc;
+    int curr_chan_num = -1, get_mem_status = RIG_OK;
+    vfo_t curr_vfo;
+    vfo_t vfotmp = RIG_VFO_NONE; /* requested vfo */
+    int retcode = RIG_OK;
+    int can_emulate_by_vfo_mem, can_emulate_by_vfo_op;
+
     /*
      * TODO: check validity of chan->channel_num
      */
@@ -934,7 +1434,194 @@ int HAMLIB_API rig_get_channel(RIG *rig, vfo_t vfox, channel_t *chan,
 }
 
 
-#ifndef DOC_HIDDEN
+/*
+ * Reads all channels with the backend's mem_batch commands.  Commands
+ * are written while fewer than batch->window are waiting for a reply,
+ * so a dump costs about one round trip per window instead of one per
+ * command.  The rig answers in order: the n-th reply read belongs to
+ * the n-th command written.  The rig stays locked for the whole dump.
+ */
+static int get_chan_all_cb_batch(RIG *rig, vfo_t vfo, chan_cb_t chan_cb,
+                                 rig_ptr_t arg)
+{
+    const struct rig_mem_batch *batch = rig->caps->mem_batch;
+    hamlib_port_t *rp = RIGPORT(rig);
+    chan_t *chan_list = STATE(rig)->chan_list;
+    channel_t *chan = NULL;
+    short *nums, *lists;
+    char cmd[64];
+    char reply[256];
+    int total = 0, sent = 0, received = 0;
+    int skip = 0;
+    int incremental = STATE(rig)->mem_incremental != RIG_MEM_INCREMENTAL_OFF;
+    int retval = RIG_OK;
+    int i, j, n;
+
+    for (i = 0; !RIG_IS_CHAN_END(chan_list[i]) && i < HAMLIB_CHANLSTSIZ; i++)
+    {
+        total += chan_list[i].endc - chan_list[i].startc + 1;
+    }
+
+    nums = calloc(total + 1, sizeof(*nums));
+    lists = calloc(total + 1, sizeof(*lists));
+
+    if (!nums || !lists)
+    {
+        free(nums);
+        free(lists);
+        return -RIG_ENOMEM;
+    }
+
+    for (i = 0, n = 0; !RIG_IS_CHAN_END(chan_list[i]) && i < HAMLIB_CHANLSTSIZ; i++)
+    {
+        for (j = chan_list[i].startc; j <= chan_list[i].endc; j++, n++)
+        {
+            nums[n] = j;
+            lists[n] = i;
+        }
+    }
+
+    total *= batch->cmds;
+
+    rig_lock(rig, 1);
+    rig_flush(rp);
+
+    if (batch->start && (retval = batch->start(rig)) != RIG_OK)
+    {
+        goto batch_quit;
+    }
+
+    while (received < total)
+    {
+        int k = received / batch->cmds;
+        int c = received % batch->cmds;
+
+        while (sent < total && sent - received < batch->window)
+        {
+            n = batch->encode(rig, nums[sent / batch->cmds], sent % batch->cmds, cmd,
+                              sizeof(cmd));
+
+            if (n < 0)
+            {
+                retval = n;
+                goto batch_finish;
+            }
+
+            retval = write_block(rp, (unsigned char *) cmd, n);
+
+            if (retval != RIG_OK)
+            {
+                goto batch_finish;
+            }
+
+            sent++;
+        }
+
+        n = read_string(rp, (unsigned char *) reply, sizeof(reply),
+                        &batch->terminator, 1, 0, 1);
+
+        if (n < 0)
+        {
+            retval = n;
+            goto batch_finish;
+        }
+
+        received++;
+
+        if (c == 0)
+        {
+            /*
+             * first channel of a chan_list entry, or the one after an empty
+             * channel, whose struct was not handed back: ask for a new one
+             */
+            if (k == 0 || lists[k] != lists[k - 1] || skip)
+            {
+                chan = NULL;
+                retval = chan_cb(rig, vfo, &chan, nums[k], chan_list, arg);
+
+                if (retval != RIG_OK)
+                {
+                    goto batch_finish;
+                }
+
+                if (chan == NULL)
+                {
+                    retval = -RIG_ENOMEM;
+                    goto batch_finish;
+                }
+            }
+
+            skip = 0;
+            memset(chan, 0, sizeof(*chan));
+            chan->vfo = RIG_VFO_MEM;
+            chan->channel_num = nums[k];
+        }
+
+        if (skip)
+        {
+            continue;
+        }
+
+        retval = batch->decode(rig, chan, c, reply, n);
+
+        if (retval == -RIG_ENAVAIL)
+        {
+            /* empty channel, its other replies are read and dropped */
+            skip = 1;
+            retval = RIG_OK;
+
+            if (incremental) { mem_hash_record_empty(rig, 0, nums[k]); }
+
+            continue;
+        }
+
+        if (retval != RIG_OK)
+        {
+            goto batch_finish;
+        }
+
+        if (c == batch->cmds - 1)
+        {
+            int chan_next = k + 1 < total / batch->cmds && lists[k + 1] == lists[k]
+                            ? nums[k + 1] : nums[k];
+
+            if (incremental)
+            {
+                mem_hash_record(rig, chan, rig_channel_hash(rig, chan));
+            }
+
+            chan_cb(rig, vfo, &chan, chan_next, chan_list, arg);
+        }
+    }
+
+batch_finish:
+
+    /* after an error, let the replies still on their way arrive and go */
+    for (; received < sent; received++)
+    {
+        if (read_string(rp, (unsigned char *) reply, sizeof(reply),
+                        &batch->terminator, 1, 0, 1) < 0)
+        {
+            rig_flush(rp);
+            break;
+        }
+    }
+
+    if (batch->finish)
+    {
+        batch->finish(rig);
+    }
+
+batch_quit:
+    rig_lock(rig, 0);
+
+    free(nums);
+    free(lists);
+
+    return retval;
+}
+
+
 int get_chan_all_cb_generic(RIG *rig, vfo_t vfo, chan_cb_t chan_cb,
                             rig_ptr_t arg)
 {
@@ -1005,6 +1692,8 @@ int set_chan_all_cb_generic(RIG *rig, vfo_t vfo, chan_cb_t chan_cb,
                             rig_ptr_t arg)
 {
     int i, j, retval;
+    int incremental = STATE(rig)->mem_incremental != RIG_MEM_INCREMENTAL_OFF;
+    int count = 0, changed = 0;
     chan_t *chan_list = STATE(rig)->chan_list;
     channel_t *chan;
 
@@ -1017,15 +1706,33 @@ int set_chan_all_cb_generic(RIG *rig, vfo_t vfo, chan_cb_t chan_cb,
             chan_cb(rig, vfo, &chan, j, chan_list, arg);
             chan->vfo = RIG_VFO_MEM;
 
-            retval = rig_set_channel(rig, vfo, chan);
+            if (incremental)
+            {
+                int written;
+
+                retval = set_channel_incremental(rig, vfo, chan, &written);
+                changed += written;
+            }
+            else
+            {
+                retval = rig_set_channel(rig, vfo, chan);
+            }
 
             if (retval != RIG_OK)
             {
                 return retval;
             }
+
+            count++;
         }
     }
 
+    if (incremental)
+    {
+        rig_debug(RIG_DEBUG_VERBOSE, "%s: %d of %d channels written\n", __func__,
+                  changed, count);
+    }
+
     return RIG_OK;
 }
 
@@ -1068,6 +1775,9 @@ static int map_chan(RIG *rig,
  *
  *  Write the data associated with a all the memory channels.
  *  This is the preferred method to support clonable rigs.
+ *  With the mem_incremental conf parameter set, only the channels that
+ *  differ from their last known content are written, unless the backend
+ *  uploads all channels at once.
  *
  * \return RIG_OK if the operation has been successful, otherwise
  * a negative value if an error occurred (in which case, cause is
@@ -1115,6 +1825,11 @@ int HAMLIB_API rig_set_chan_all_cb(RIG *rig, vfo_t vfo, chan_cb_t chan_cb,
  *  This means the application has to provide a struct where to store
  *  future data for channel channel_num. If channel_num == chan->channel_num,
  *  the application does not need to provide a new allocated structure.
+ *  Empty channels are skipped, \a chan_cb is not called for them.
+ *
+ *  Without a backend get_chan_all_cb, a rig with rig_caps.mem_batch has
+ *  its channels read with the commands pipelined, otherwise they are
+ *  read one by one with rig_get_channel().
  *
  * \return RIG_OK if the operation has been successful, otherwise
  * a negative value if an error occurred (in which case, cause is
@@ -1142,6 +1857,10 @@ int HAMLIB_API rig_get_chan_all_cb(RIG *rig, vfo_t vfo, chan_cb_t chan_cb,
         return rc->get_chan_all_cb(rig, vfo, chan_cb, arg);
     }
 
+    if (rc->mem_batch)
+    {
+        return get_chan_all_cb_batch(rig, vfo, chan_cb, arg);
+    }
 
     /* if not available, emulate it */
     retval = get_chan_all_cb_generic(rig, vfo, chan_cb, arg);
@@ -1156,6 +1875,9 @@ int HAMLIB_API rig_get_chan_all_cb(RIG *rig, vfo_t vfo, chan_cb_t chan_cb,
  * \param chans The location of data to set for all channels
  *
  * Write the data associated with all the memory channels.
+ * With the mem_incremental conf parameter set, only the channels that
+ * differ from their last known content are written, unless the backend
+ * uploads all channels at once.
  *
  * \return RIG_OK if the operation has been successful, otherwise
  * a negative value if an error occurred (in which case, cause is
@@ -1228,6 +1950,11 @@ int HAMLIB_API rig_get_chan_all(RIG *rig, vfo_t vfo, channel_t chans[])
         return rc->get_chan_all_cb(rig, vfo, map_chan, (rig_ptr_t)&map_arg);
     }
 
+    if (rc->mem_batch)
+    {
+        return get_chan_all_cb_batch(rig, vfo, map_chan, (rig_ptr_t)&map_arg);
+    }
+
     /*
      * if not available, emulate it
      *
@@ -1671,4 +2398,141 @@ int HAMLIB_API rig_mem_count(RIG *rig)
     return count;
 }
 
+
+#define CHAN_HASHES_MAGIC "# Hamlib channel hashes"
+
+/**
+ * \brief save the last known content of the memory channels
+ * \param rig   The rig handle
+ * \param path  The file to write
+ *
+ *  Writes the hashes of the channels last read from or written to the
+ *  rig with the mem_incremental conf parameter set, so that a later
+ *  session can load them with rig_load_chan_hashes() and write only the
+ *  channels that changed since.
+ *
+ * \return RIG_OK if the operation has been successful, otherwise
+ * a negative value if an error occurred (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_load_chan_hashes(), rig_channel_hash()
+ */
+int HAMLIB_API rig_save_chan_hashes(RIG *rig, const char *path)
+{
+    const struct mem_hashes *mh;
+    FILE *f;
+    int i, retval = RIG_OK;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (CHECK_RIG_ARG(rig) || !path)
+    {
+        return -RIG_EINVAL;
+    }
+
+    f = fopen(path, "w");
+
+    if (!f)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: cannot open %s: %s\n", __func__, path,
+                  strerror(errno));
+        return -RIG_EIO;
+    }
+
+    fprintf(f, "%s\nmodel %u\n", CHAN_HASHES_MAGIC, rig->caps->rig_model);
+
+    mh = STATE(rig)->mem_hashes;
+
+    for (i = 0; mh && i < mh->size; i++)
+    {
+        if (mh->slots[i].used && mh->slots[i].known)
+        {
+            fprintf(f, "%d %d %08x\n", mh->slots[i].bank_num,
+                    mh->slots[i].channel_num, (unsigned int) mh->slots[i].hash);
+        }
+    }
+
+    if (ferror(f)) { retval = -RIG_EIO; }
+
+    if (fclose(f) != 0) { retval = -RIG_EIO; }
+
+    return retval;
+}
+
+
+/**
+ * \brief load the last known content of the memory channels
+ * \param rig   The rig handle
+ * \param path  A file written by rig_save_chan_hashes()
+ *
+ *  Replaces what is known of the rig's memory channels with the hashes
+ *  saved in \a path.  They are only right as long as the channels were
+ *  not changed by other means since.
+ *
+ * \return RIG_OK if the operation has been successful, otherwise
+ * a negative value if an error occurred (in which case, cause is
+ * set appropriately).  -RIG_EINVAL if the file is not for this rig
+ * model, and nothing is known then.
+ *
+ * \sa rig_save_chan_hashes(), rig_channel_hash()
+ */
+int HAMLIB_API rig_load_chan_hashes(RIG *rig, const char *path)
+{
+    channel_t chan;
+    char line[128];
+    unsigned int model, hash;
+    FILE *f;
+    int retval = RIG_OK;
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+
+    if (CHECK_RIG_ARG(rig) || !path)
+    {
+        return -RIG_EINVAL;
+    }
+
+    f = fopen(path, "r");
+
+    if (!f)
+    {
+        rig_debug(RIG_DEBUG_VERBOSE, "%s: cannot open %s: %s\n", __func__, path,
+                  strerror(errno));
+        return -RIG_EIO;
+    }
+
+    mem_hashes_cleanup(rig);
+
+    if (!fgets(line, sizeof(line), f)
+            || strncmp(line, CHAN_HASHES_MAGIC, strlen(CHAN_HASHES_MAGIC)) != 0
+            || !fgets(line, sizeof(line), f)
+            || sscanf(line, "model %u", &model) != 1
+            || model != rig->caps->rig_model)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: %s is not for model %u\n", __func__, path,
+                  rig->caps->rig_model);
+        fclose(f);
+        return -RIG_EINVAL;
+    }
+
+    memset(&chan, 0, sizeof(chan));
+
+    while (fgets(line, sizeof(line), f))
+    {
+        if (sscanf(line, "%d %d %x", &chan.bank_num, &chan.channel_num,
+                   &hash) != 3)
+        {
+            rig_debug(RIG_DEBUG_WARN, "%s: line ignored: %s", __func__, line);
+            continue;
+        }
+
+        mem_hash_record(rig, &chan, hash);
+    }
+
+    if (ferror(f)) { retval = -RIG_EIO; }
+
+    fclose(f);
+
+    return retval;
+}
+
 /*! @} */
@@ -1943,6 +1943,59 @@ const char *HAMLIB_API rig_strspectrummode(enum rig_spectrum_mode_e mode)
     return "";
 }
 
+static const struct
+{
+    enum rig_spectrum_history_e op;
+    const char *str;
+} rig_spectrum_history_str[] =
+{
+    { RIG_SPECTRUM_HISTORY_LAST, "LAST" },
+    { RIG_SPECTRUM_HISTORY_AVERAGE, "AVG" },
+    { RIG_SPECTRUM_HISTORY_MAX, "MAX" },
+    { RIG_SPECTRUM_HISTORY_MIN, "MIN" },
+    { RIG_SPECTRUM_HISTORY_LAST, "" },
+};
+
+/**
+ * \brief Convert enum RIG_SPECTRUM_HISTORY_... to alpha string
+ * \param op RIG_SPECTRUM_HISTORY_...
+ * \return alpha string
+ *
+ * \sa rig_get_spectrum_history()
+ */
+const char *HAMLIB_API rig_strspectrumhistory(enum rig_spectrum_history_e op)
+{
+    for (int i = 0; rig_spectrum_history_str[i].str[0] != '\0'; i++)
+    {
+        if (op == rig_spectrum_history_str[i].op)
+        {
+            return rig_spectrum_history_str[i].str;
+        }
+    }
+
+    return "";
+}
+
+/**
+ * \brief Convert alpha string to enum RIG_SPECTRUM_HISTORY_...
+ * \param s alpha string
+ * \return RIG_SPECTRUM_HISTORY_..., or -1 if \a s is not one
+ *
+ * \sa rig_get_spectrum_history()
+ */
+int HAMLIB_API rig_parse_spectrum_history(const char *s)
+{
+    for (int i = 0; rig_spectrum_history_str[i].str[0] != '\0'; i++)
+    {
+        if (strcmp(s, rig_spectrum_history_str[i].str) == 0)
+        {
+            return rig_spectrum_history_str[i].op;
+        }
+    }
+
+    return -1;
+}
+
 static long timediff(const struct timeval *tv1, const struct timeval *tv2)
 {
     struct timeval tv;
@@ -2844,6 +2897,9 @@ void *HAMLIB_API rig_get_function_ptr(rig_model_t rig_model,
     case RIG_FUNCTION_PROCESS_ASYNC_FRAME:
         return caps->process_async_frame;
 
+    case RIG_FUNCTION_GET_STATUS:
+        return caps->get_status;
+
     default:
         rig_debug(RIG_DEBUG_ERR, "Unknown function?? function=%d\n", rig_function);
     }
@@ -0,0 +1,181 @@
+/*
+ *  Hamlib Interface - sorted model registry
+ *  Copyright (c) 2026 The Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+/*
+ * Backing store for the rig, rotator and amplifier registries.
+ *
+ * Backends register their caps when they are loaded, mostly in ascending
+ * model order, so inserts are nearly always appends.  Lookups are a
+ * binary search and walking the list visits only registered models, in
+ * model order.  Walks go over a snapshot so the callback may look up,
+ * register or unregister models without deadlocking.
+ */
+
+#include "hamlib/config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "model_list.h"
+
+#define MODEL_LIST_MIN_SIZE 64
+
+/* Index of model, or of where it would be inserted */
+static int model_list_index(const struct model_list *list, unsigned int model)
+{
+    int lo = 0;
+    int hi = list->count;
+
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+
+        if (list->entries[mid].model < model)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+int model_list_add(struct model_list *list, unsigned int model,
+                   const void *caps)
+{
+    int i;
+
+    pthread_rwlock_wrlock(&list->lock);
+
+    i = model_list_index(list, model);
+
+    if (i < list->count && list->entries[i].model == model)
+    {
+        pthread_rwlock_unlock(&list->lock);
+        return -RIG_EINVAL;
+    }
+
+    if (list->count == list->size)
+    {
+        int size = list->size ? list->size * 2 : MODEL_LIST_MIN_SIZE;
+        struct model_list_entry *entries;
+
+        entries = realloc(list->entries, size * sizeof(*entries));
+
+        if (!entries)
+        {
+            pthread_rwlock_unlock(&list->lock);
+            return -RIG_ENOMEM;
+        }
+
+        list->entries = entries;
+        list->size = size;
+    }
+
+    memmove(&list->entries[i + 1], &list->entries[i],
+            (list->count - i) * sizeof(list->entries[0]));
+    list->entries[i].model = model;
+    list->entries[i].caps = caps;
+    list->count++;
+
+    pthread_rwlock_unlock(&list->lock);
+
+    return RIG_OK;
+}
+
+const void *model_list_find(struct model_list *list, unsigned int model)
+{
+    const void *caps = NULL;
+    int i;
+
+    pthread_rwlock_rdlock(&list->lock);
+
+    i = model_list_index(list, model);
+
+    if (i < list->count && list->entries[i].model == model)
+    {
+        caps = list->entries[i].caps;
+    }
+
+    pthread_rwlock_unlock(&list->lock);
+
+    return caps;
+}
+
+int model_list_remove(struct model_list *list, unsigned int model)
+{
+    int i;
+
+    pthread_rwlock_wrlock(&list->lock);
+
+    i = model_list_index(list, model);
+
+    if (i == list->count || list->entries[i].model != model)
+    {
+        pthread_rwlock_unlock(&list->lock);
+        return -RIG_EINVAL;
+    }
+
+    list->count--;
+    memmove(&list->entries[i], &list->entries[i + 1],
+            (list->count - i) * sizeof(list->entries[0]));
+
+    pthread_rwlock_unlock(&list->lock);
+
+    return RIG_OK;
+}
+
+/*
+ * Copy of the entries for a walk, to free() after it.  Returns the number
+ * of entries or -RIG_ENOMEM.
+ */
+int model_list_snapshot(struct model_list *list,
+                        struct model_list_entry **entries)
+{
+    int count;
+
+    pthread_rwlock_rdlock(&list->lock);
+
+    count = list->count;
+    *entries = NULL;
+
+    if (count > 0)
+    {
+        *entries = malloc(count * sizeof(**entries));
+
+        if (*entries)
+        {
+            memcpy(*entries, list->entries, count * sizeof(**entries));
+        }
+        else
+        {
+            count = -RIG_ENOMEM;
+        }
+    }
+
+    pthread_rwlock_unlock(&list->lock);
+
+    return count;
+}
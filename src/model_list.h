@@ -0,0 +1,61 @@
+/*
+ *  Hamlib Interface - sorted model registry
+ *  Copyright (c) 2026 The Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#ifndef _HL_MODEL_LIST_H
+#define _HL_MODEL_LIST_H 1
+
+#include <pthread.h>
+
+#include "hamlib/rig.h"
+
+__BEGIN_DECLS
+
+struct model_list_entry {
+    unsigned int model;
+    const void *caps;
+};
+
+/*
+ * Registered caps, densely packed and sorted by model number.  Backends
+ * load lazily from rig_init() and friends, so lookups on one thread can
+ * run while another registers a backend and grows the array: every
+ * access takes the lock.
+ */
+struct model_list {
+    struct model_list_entry *entries;
+    int count;
+    int size;
+    pthread_rwlock_t lock;
+};
+
+#define MODEL_LIST_INITIALIZER { NULL, 0, 0, PTHREAD_RWLOCK_INITIALIZER }
+
+int model_list_add(struct model_list *list, unsigned int model,
+                   const void *caps);
+const void *model_list_find(struct model_list *list, unsigned int model);
+int model_list_remove(struct model_list *list, unsigned int model);
+int model_list_snapshot(struct model_list *list,
+                        struct model_list_entry **entries);
+
+__END_DECLS
+
+#endif /* _HL_MODEL_LIST_H */
@@ -65,6 +65,7 @@ int multicast_stop(RIG *rig)
 
     if (rs->multicast) { rs->multicast->runflag = 0; }
 
+    rig_cache_wake(rig);
     pthread_join(rs->multicast->threadid, NULL);
     return RIG_OK;
 }
@@ -76,7 +77,7 @@ static int multicast_status_changed(RIG *rig)
     struct rig_cache *cachep = CACHE(rig);
     struct rig_state *rs = STATE(rig);
 #if 0
-    freq_t freq, freqsave = cachep->freqMainA;
+    freq_t freq, freqsave = cachep->slot[CACHE_SLOT_MAIN_A].freq;
 
     if ((retval = rig_get_freq(rig, RIG_VFO_A, &freq)) != RIG_OK)
     {
@@ -87,10 +88,10 @@ static int multicast_status_changed(RIG *rig)
 
 #endif
 
-    rmode_t modeA, modeAsave = cachep->modeMainA;
-    rmode_t modeB, modeBsave = cachep->modeMainB;
-    pbwidth_t widthA, widthAsave = cachep->widthMainA;
-    pbwidth_t widthB, widthBsave = cachep->widthMainB;
+    rmode_t modeA, modeAsave = cachep->slot[CACHE_SLOT_MAIN_A].mode;
+    rmode_t modeB, modeBsave = cachep->slot[CACHE_SLOT_MAIN_B].mode;
+    pbwidth_t widthA, widthAsave = cachep->slot[CACHE_SLOT_MAIN_A].width;
+    pbwidth_t widthB, widthBsave = cachep->slot[CACHE_SLOT_MAIN_B].width;
 
 #if  0
 
@@ -222,23 +223,26 @@ void json_add_time(char *msg, int addComma)
 
 void json_add_vfoA(RIG *rig, char *msg)
 {
-    struct rig_cache *cachep = CACHE(rig);
+    struct rig_cache snap;
+    const struct rig_cache *cachep = &snap;
     struct rig_state *rs = STATE(rig);
 
+    rig_cache_snapshot(rig, &snap);
+
     strcat(msg, "{\n");
     json_add_string(msg, "Name", "VFOA", 1);
-    json_add_int(msg, "Freq", cachep->freqMainA, 1);
+    json_add_int(msg, "Freq", cachep->slot[CACHE_SLOT_MAIN_A].freq, 1);
 
-    if (strlen(rig_strrmode(cachep->modeMainA)) > 0)
+    if (strlen(rig_strrmode(cachep->slot[CACHE_SLOT_MAIN_A].mode)) > 0)
     {
-        json_add_string(msg, "Mode", rig_strrmode(cachep->modeMainA), 1);
+        json_add_string(msg, "Mode", rig_strrmode(cachep->slot[CACHE_SLOT_MAIN_A].mode), 1);
     }
     else
     {
         json_add_string(msg, "Mode", "None", 1);
     }
 
-    json_add_int(msg, "Width", cachep->widthMainA, 0);
+    json_add_int(msg, "Width", cachep->slot[CACHE_SLOT_MAIN_A].width, 0);
 
 #if 0 // not working quite yet
     // what about full duplex? rx_vfo would be in rx all the time?
@@ -279,23 +283,26 @@ void json_add_vfoA(RIG *rig, char *msg)
 
 void json_add_vfoB(RIG *rig, char *msg)
 {
-    struct rig_cache *cachep = CACHE(rig);
+    struct rig_cache snap;
+    const struct rig_cache *cachep = &snap;
     struct rig_state *rs = STATE(rig);
 
+    rig_cache_snapshot(rig, &snap);
+
     strcat(msg, ",\n{\n");
     json_add_string(msg, "Name", "VFOB", 1);
-    json_add_int(msg, "Freq", cachep->freqMainB, 1);
+    json_add_int(msg, "Freq", cachep->slot[CACHE_SLOT_MAIN_B].freq, 1);
 
-    if (strlen(rig_strrmode(cachep->modeMainB)) > 0)
+    if (strlen(rig_strrmode(cachep->slot[CACHE_SLOT_MAIN_B].mode)) > 0)
     {
-        json_add_string(msg, "Mode", rig_strrmode(cachep->modeMainB), 1);
+        json_add_string(msg, "Mode", rig_strrmode(cachep->slot[CACHE_SLOT_MAIN_B].mode), 1);
     }
     else
     {
         json_add_string(msg, "Mode", "None", 1);
     }
 
-    json_add_int(msg, "Width", cachep->widthMainB, 0);
+    json_add_int(msg, "Width", cachep->slot[CACHE_SLOT_MAIN_B].width, 0);
 
 #if 0 // not working yet
 
@@ -332,9 +339,12 @@ static int multicast_send_json(RIG *rig)
 {
     char msg[8192]; // could be pretty big
     char buf[4096];
-    struct rig_cache *cachep = CACHE(rig);
+    struct rig_cache snap;
+    const struct rig_cache *cachep = &snap;
     struct rig_state *rs = STATE(rig);
 
+    rig_cache_snapshot(rig, &snap);
+
 //    sprintf(msg,"%s:f=%.1f", date_strget(msg, (int)sizeof(msg), 0), f);
     msg[0] = 0;
     snprintf(buf, sizeof(buf), "%s:%s", rig->caps->model_name,
@@ -393,7 +403,8 @@ void *multicast_thread_rx(void *vrig)
     return NULL;
 }
 
-#define LOOPCOUNT 50
+// send the state at least this often, changed or not
+#define MULTICAST_HEARTBEAT_MS 500
 // cppcheck-suppress unusedFunction
 void *multicast_thread(void *vrig)
 {
@@ -404,26 +415,33 @@ void *multicast_thread(void *vrig)
     // do the 1st packet all the time
     //multicast_status_changed(rig);
     //multicast_send_json(rig);
-    int loopcount = LOOPCOUNT;
+    unsigned int gen;
+    int64_t last_send = 0;
 
     freq_t freqA, freqAsave = 0;
     freq_t freqB, freqBsave = 0;
     rmode_t modeA, modeAsave = 0;
     rmode_t modeB, modeBsave = 0;
     ptt_t ptt, pttsave = 0;
-    struct rig_cache *cachep = CACHE(rig);
+    struct rig_cache snap;
+    const struct rig_cache *cachep = &snap;
     struct rig_state *rs = STATE(rig);
 
     rs->multicast->runflag = 1;
 
     while (rs->multicast->runflag)
     {
+        int64_t now;
+        int wait_ms;
+
         while (STATE(rig)->powerstat == RIG_POWER_OFF)
         {
             rig_debug(RIG_DEBUG_VERBOSE, "%s: waiting for RIG_POWER_ON\n", __func__);
             hl_usleep(500 * 1000);
         }
 
+        gen = rig_cache_generation(rig);
+
 #if 0
 
         if ((retval = rig_get_freq(rig, RIG_VFO_A, &freqA)) != RIG_OK)
@@ -438,27 +456,29 @@ void *multicast_thread(void *vrig)
         }
         else
         {
-            freqB = cachep->freqMainB;
+            freqB = cachep->slot[CACHE_SLOT_MAIN_B].freq;
         }
 
 #else
-        freqA = cachep->freqMainA;
-        freqB = cachep->freqMainB;
-        modeA = cachep->modeMainA;
-        modeB = cachep->modeMainB;
+        rig_cache_snapshot(rig, &snap);
+        freqA = cachep->slot[CACHE_SLOT_MAIN_A].freq;
+        freqB = cachep->slot[CACHE_SLOT_MAIN_B].freq;
+        modeA = cachep->slot[CACHE_SLOT_MAIN_A].mode;
+        modeB = cachep->slot[CACHE_SLOT_MAIN_B].mode;
         ptt = cachep->ptt;
 #endif
+        now = rig_cache_now_ns();
 
         if (freqA != freqAsave
                 || freqB != freqBsave
                 || modeA != modeAsave
                 || modeB != modeBsave
                 || ptt != pttsave
-                || loopcount-- <= 0)
+                || now - last_send >= MULTICAST_HEARTBEAT_MS * 1000000LL)
         {
 #if 0
 
-            if (loopcount <= 0)
+            if (now - last_send >= MULTICAST_HEARTBEAT_MS * 1000000LL)
             {
                 rig_debug(RIG_DEBUG_CACHE, "%s: sending multicast packet timeout\n", __func__);
             }
@@ -473,15 +493,12 @@ void *multicast_thread(void *vrig)
             modeAsave = modeA;
             modeBsave = modeB;
             pttsave = ptt;
-            loopcount = LOOPCOUNT;
-        }
-        else
-        {
-            //rig_debug(RIG_DEBUG_VERBOSE, "%s: loop\n", __func__);
-            hl_usleep(10 * 1000);
+            last_send = now;
         }
 
-
+        // sleep until the cache is written to or the heartbeat is due
+        wait_ms = MULTICAST_HEARTBEAT_MS - (int)((now - last_send) / 1000000);
+        rig_cache_wait(rig, &gen, wait_ms > 0 ? wait_ms : 0);
     }
 
 #ifdef _WIN32
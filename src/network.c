@@ -80,6 +80,8 @@
 #include "misc.h"
 #include "asyncpipe.h"
 #include "snapshot_data.h"
+#include "spectrum_packet.h"
+#include "spectrum_pool.h"
 
 #ifdef HAVE_WINDOWS_H
 // cppcheck-suppress missingInclude
@@ -102,6 +104,9 @@ static int is_networked(char *address, int address_length);
 #define MULTICAST_PUBLISHER_DATA_PACKET_TYPE_TRANSCEIVE 0x02
 #define MULTICAST_PUBLISHER_DATA_PACKET_TYPE_SPECTRUM   0x03
 
+/* A publisher that falls further behind than this skips spectrum lines */
+#define MULTICAST_PUBLISHER_SPECTRUM_QUEUE_MAX 32
+
 #pragma pack(push,1)
 typedef struct multicast_publisher_data_packet_s
 {
@@ -126,6 +131,7 @@ typedef struct multicast_publisher_args_s
 #endif
 
     pthread_mutex_t write_lock;
+    int spectrum_queued;    // lines in the pipe, each holding a buffer
 } multicast_publisher_args;
 
 typedef struct multicast_publisher_priv_data_s
@@ -405,6 +411,9 @@ int network_flush2(hamlib_port_t *rp, unsigned char *stopset, char *buf,
         return 0;
     }
 
+    // include what read_string() has already pulled off the socket
+    len += rp->rxbuf[0].len;
+
     if (len > 0)
     {
         buf[0] = 0;
@@ -433,6 +442,11 @@ void network_flush(hamlib_port_t *rp)
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
+    if (!rp->asyncio)
+    {
+        port_rxbuf_discard(rp, 1);
+    }
+
     for (;;)
     {
         int ret;
@@ -876,7 +890,13 @@ int network_publish_rig_transceive_data(RIG *rig)
     return result;
 }
 
-int network_publish_rig_spectrum_data(RIG *rig, struct rig_spectrum_line *line)
+/*
+ * Only a pointer to the line goes through the pipe, with a reference the
+ * publisher drops once the line is encoded.  No more than
+ * MULTICAST_PUBLISHER_SPECTRUM_QUEUE_MAX lines wait there, so a publisher
+ * that stalls cannot use up the spectrum pool.
+ */
+int network_publish_rig_spectrum_data(RIG *rig, struct spectrum_buffer *buf)
 {
     int result;
     struct rig_state *rs = STATE(rig);
@@ -886,8 +906,9 @@ int network_publish_rig_spectrum_data(RIG *rig, struct rig_spectrum_line *line)
     {
         .type = MULTICAST_PUBLISHER_DATA_PACKET_TYPE_SPECTRUM,
         .padding = 0,
-        .data_length = sizeof(struct rig_spectrum_line) + line->spectrum_data_length,
+        .data_length = sizeof(buf),
     };
+    unsigned char message[sizeof(packet) + sizeof(buf)];
 
     if (rs->multicast_publisher_priv_data == NULL)
     {
@@ -895,37 +916,36 @@ int network_publish_rig_spectrum_data(RIG *rig, struct rig_spectrum_line *line)
         return RIG_OK;
     }
 
-    // Acquire write lock to write all data in one go to the pipe
-    multicast_publisher_write_lock(rig);
-
-    result = multicast_publisher_write_packet_header(rig, &packet);
-
-    if (result != RIG_OK)
-    {
-        multicast_publisher_write_unlock(rig);
-        RETURNFUNC2(result);
-    }
-
     mcast_publisher_priv = (multicast_publisher_priv_data *)
                            rs->multicast_publisher_priv_data;
     mcast_publisher_args = &mcast_publisher_priv->args;
 
-    result = multicast_publisher_write_data(
-                 mcast_publisher_args, sizeof(struct rig_spectrum_line), (unsigned char *) line);
-
-    if (result != RIG_OK)
+    if (__atomic_add_fetch(&mcast_publisher_args->spectrum_queued, 1,
+                           __ATOMIC_RELAXED) > MULTICAST_PUBLISHER_SPECTRUM_QUEUE_MAX)
     {
-        multicast_publisher_write_unlock(rig);
-        RETURNFUNC2(result);
+        __atomic_sub_fetch(&mcast_publisher_args->spectrum_queued, 1,
+                           __ATOMIC_RELAXED);
+        rig_debug(RIG_DEBUG_VERBOSE, "%s: publisher behind, spectrum line skipped\n",
+                  __func__);
+        return RIG_OK;
     }
 
-    result = multicast_publisher_write_data(
-                 mcast_publisher_args, line->spectrum_data_length, line->spectrum_data);
+    // one write, so the reader never sees a header without its pointer
+    memcpy(message, &packet, sizeof(packet));
+    memcpy(message + sizeof(packet), &buf, sizeof(buf));
 
+    spectrum_buffer_ref(buf);
+
+    multicast_publisher_write_lock(rig);
+    result = multicast_publisher_write_data(mcast_publisher_args, sizeof(message),
+                                            message);
     multicast_publisher_write_unlock(rig);
 
     if (result != RIG_OK)
     {
+        __atomic_sub_fetch(&mcast_publisher_args->spectrum_queued, 1,
+                           __ATOMIC_RELAXED);
+        spectrum_buffer_unref(buf);
         RETURNFUNC2(result);
     }
 
@@ -934,11 +954,11 @@ int network_publish_rig_spectrum_data(RIG *rig, struct rig_spectrum_line *line)
 
 static int multicast_publisher_read_packet(multicast_publisher_args
         const *mcast_publisher_args,
-        uint8_t *type, struct rig_spectrum_line *spectrum_line,
-        unsigned char *spectrum_data)
+        uint8_t *type, struct spectrum_buffer **spectrum_buffer)
 {
     int result;
     multicast_publisher_data_packet packet;
+    struct spectrum_buffer *buf;
 
     result = multicast_publisher_read_data(mcast_publisher_args, sizeof(packet),
                                            (unsigned char *) &packet);
@@ -955,35 +975,23 @@ static int multicast_publisher_read_packet(multicast_publisher_args
         break;
 
     case MULTICAST_PUBLISHER_DATA_PACKET_TYPE_SPECTRUM:
-        result = multicast_publisher_read_data(
-                     mcast_publisher_args, sizeof(struct rig_spectrum_line),
-                     (unsigned char *) spectrum_line);
-
-        if (result < 0)
-        {
-            return (result);
-        }
-
-        if (packet.data_length - sizeof(struct rig_spectrum_line) !=
-                spectrum_line->spectrum_data_length)
+        if (packet.data_length != sizeof(buf))
         {
             rig_debug(RIG_DEBUG_ERR,
                       "%s: multicast publisher data error, expected %d bytes of spectrum data, got %d bytes\n",
-                      __func__, (int)spectrum_line->spectrum_data_length,
-                      (int)(packet.data_length - sizeof(struct rig_spectrum_line)));
+                      __func__, (int)sizeof(buf), (int)packet.data_length);
             return (-RIG_EPROTO);
         }
 
-        spectrum_line->spectrum_data = spectrum_data;
-
-        result = multicast_publisher_read_data(mcast_publisher_args,
-                                               spectrum_line->spectrum_data_length, spectrum_data);
+        result = multicast_publisher_read_data(mcast_publisher_args, sizeof(buf),
+                                               (unsigned char *) &buf);
 
         if (result < 0)
         {
             return (result);
         }
 
+        *spectrum_buffer = buf;
         break;
 
     default:
@@ -1000,8 +1008,8 @@ static int multicast_publisher_read_packet(multicast_publisher_args
 
 static void *multicast_publisher(void *arg)
 {
-    unsigned char spectrum_data[HAMLIB_MAX_SPECTRUM_DATA];
     char snapshot_buffer[HAMLIB_MAX_SNAPSHOT_PACKET_SIZE];
+    struct spectrum_packet_state spectrum_state;
 #ifdef __MINGW32__
     char ip4[32];
 #endif
@@ -1010,7 +1018,7 @@ static void *multicast_publisher(void *arg)
             arg;
     RIG *rig = args->rig;
     struct rig_state *rs = STATE(rig);
-    struct rig_spectrum_line spectrum_line;
+    struct spectrum_buffer *spectrum_buffer = NULL;
     uint8_t packet_type = MULTICAST_PUBLISHER_DATA_PACKET_TYPE_SPECTRUM;
     multicast_publisher_priv_data *mcast_publisher_priv =
         (multicast_publisher_priv_data *)
@@ -1035,6 +1043,7 @@ static void *multicast_publisher(void *arg)
 #endif
 
     snapshot_init();
+    memset(&spectrum_state, 0, sizeof(spectrum_state));
 
     memset(&dest_addr, 0, sizeof(dest_addr));
     dest_addr.sin_family = AF_INET;
@@ -1046,9 +1055,16 @@ static void *multicast_publisher(void *arg)
     while (rs->multicast_publisher_run)
     {
         int result;
+        size_t packet_length;
+
+        if (spectrum_buffer)
+        {
+            spectrum_buffer_unref(spectrum_buffer);
+            spectrum_buffer = NULL;
+            __atomic_sub_fetch(&args->spectrum_queued, 1, __ATOMIC_RELAXED);
+        }
 
-        result = multicast_publisher_read_packet(args, &packet_type, &spectrum_line,
-                 spectrum_data);
+        result = multicast_publisher_read_packet(args, &packet_type, &spectrum_buffer);
 
         if (result != RIG_OK)
         {
@@ -1063,24 +1079,45 @@ static void *multicast_publisher(void *arg)
             continue;
         }
 
-        result = snapshot_serialize(sizeof(snapshot_buffer), snapshot_buffer, rig,
-                                    packet_type == MULTICAST_PUBLISHER_DATA_PACKET_TYPE_SPECTRUM ? &spectrum_line :
-                                    NULL);
-
-        if (result != RIG_OK)
+        if (packet_type == MULTICAST_PUBLISHER_DATA_PACKET_TYPE_SPECTRUM
+                && rs->multicast_spectrum_format == RIG_MULTICAST_SPECTRUM_BINARY)
         {
-            rig_debug(RIG_DEBUG_ERR, "%s: error serializing rig snapshot data, result=%d\n",
-                      __func__, result);
-            continue;
+            result = spectrum_packet_encode(&spectrum_state, &spectrum_buffer->line,
+                                            (unsigned char *) snapshot_buffer,
+                                            sizeof(snapshot_buffer));
+
+            if (result < 0)
+            {
+                rig_debug(RIG_DEBUG_ERR, "%s: error encoding spectrum packet, result=%d\n",
+                          __func__, result);
+                continue;
+            }
+
+            packet_length = result;
         }
+        else
+        {
+            result = snapshot_serialize(sizeof(snapshot_buffer), snapshot_buffer, rig,
+                                        packet_type == MULTICAST_PUBLISHER_DATA_PACKET_TYPE_SPECTRUM ?
+                                        &spectrum_buffer->line : NULL);
 
-        rig_debug(RIG_DEBUG_CACHE, "%s: sending rig snapshot data: %s\n", __func__,
-                  snapshot_buffer);
+            if (result != RIG_OK)
+            {
+                rig_debug(RIG_DEBUG_ERR, "%s: error serializing rig snapshot data, result=%d\n",
+                          __func__, result);
+                continue;
+            }
+
+            rig_debug(RIG_DEBUG_CACHE, "%s: sending rig snapshot data: %s\n", __func__,
+                      snapshot_buffer);
+
+            packet_length = strlen(snapshot_buffer);
+        }
 
         send_result = sendto(
                           socket_fd,
                           snapshot_buffer,
-                          strlen(snapshot_buffer),
+                          packet_length,
                           0,
                           (struct sockaddr *) &dest_addr,
                           sizeof(dest_addr)
@@ -1100,6 +1137,11 @@ static void *multicast_publisher(void *arg)
         }
     }
 
+    if (spectrum_buffer)
+    {
+        spectrum_buffer_unref(spectrum_buffer);
+    }
+
     rs->multicast_publisher_run = 0;
     mcast_publisher_priv->thread_id = 0;
 
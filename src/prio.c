@@ -0,0 +1,284 @@
+/*
+ *  Hamlib Interface - priority scheduling of rig access
+ *  Copyright (c) 2026 The Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+
+/*
+ * Priority scheduled rig access.
+ *
+ * rig_lock() used to be a plain recursive mutex, so whoever grabbed it
+ * next got the rig, and a PTT could queue behind a memory dump or a
+ * series of meter polls.  Now threads queue up and the rig is handed to
+ * the best waiter when the current owner lets go: PTT/CW keying, then
+ * sets, then interactive gets, then the poll routine.  Equal priorities
+ * are served in arrival order.  A PTT thus waits at most for the command
+ * in progress and for earlier PTTs.
+ *
+ * Gets and polls move up one priority for every RIG_PRIO_AGING_MS they
+ * wait, up to the level of sets, so a busy client cannot starve the poll
+ * routine forever.
+ *
+ * The priority comes from the call site (rig_set_ptt() and friends ask
+ * for RIG_PRIO_PTT, setters for RIG_PRIO_SET) or, for a plain
+ * rig_lock(rig, 1), from the calling thread, see rig_set_thread_prio().
+ */
+
+#include "hamlib/config.h"
+
+#include "hamlib/rig.h"
+#include "hamlib/rig_state.h"
+#include "cache.h"
+#include "prio.h"
+
+static pthread_key_t thread_prio_key;
+static pthread_once_t thread_prio_once = PTHREAD_ONCE_INIT;
+
+static void thread_prio_key_create(void)
+{
+    pthread_key_create(&thread_prio_key, NULL);
+}
+
+/**
+ * \brief Set the priority of rig access from the calling thread
+ * \param prio RIG_PRIO_GET for interactive use, RIG_PRIO_POLL for
+ * background polling
+ *
+ * Applies to every rig the thread uses.  API calls that key the
+ * transmitter or change settings use RIG_PRIO_PTT or RIG_PRIO_SET
+ * regardless.
+ */
+void HAMLIB_API rig_set_thread_prio(rig_prio_t prio)
+{
+    pthread_once(&thread_prio_once, thread_prio_key_create);
+    // stored off by one so that an unset key reads as RIG_PRIO_GET
+    pthread_setspecific(thread_prio_key, (void *)(intptr_t)(prio + 1));
+}
+
+rig_prio_t rig_prio_thread(void)
+{
+    intptr_t prio;
+
+    pthread_once(&thread_prio_once, thread_prio_key_create);
+    prio = (intptr_t) pthread_getspecific(thread_prio_key);
+
+    return prio ? (rig_prio_t)(prio - 1) : RIG_PRIO_GET;
+}
+
+void rig_prio_init(RIG *rig)
+{
+    struct rig_prio_sched *sched = &CACHE(rig)->sched;
+
+    pthread_mutex_init(&sched->lock, NULL);
+    pthread_cond_init(&sched->cond, NULL);
+}
+
+void rig_prio_cleanup(RIG *rig)
+{
+    struct rig_prio_sched *sched = &CACHE(rig)->sched;
+
+    pthread_cond_destroy(&sched->cond);
+    pthread_mutex_destroy(&sched->lock);
+}
+
+static void record_wait(struct rig_prio_sched *sched, rig_prio_t prio,
+                        int64_t wait_ns)
+{
+    struct rig_prio_stats *stats = &sched->stats[prio];
+    unsigned long us = wait_ns > 0 ? (unsigned long)(wait_ns / 1000) : 0;
+    int bucket = us ? 64 - __builtin_clzll(us) : 0;
+
+    if (bucket >= RIG_PRIO_HIST_BUCKETS)
+    {
+        bucket = RIG_PRIO_HIST_BUCKETS - 1;
+    }
+
+    stats->count++;
+    stats->total_us += us;
+    stats->hist[bucket]++;
+
+    if (us > stats->max_us) { stats->max_us = us; }
+}
+
+static rig_prio_t effective_prio(const struct rig_prio_waiter *w, int64_t now)
+{
+    int64_t aged;
+
+    if (w->prio <= RIG_PRIO_SET)
+    {
+        return w->prio;
+    }
+
+    aged = w->prio - (now - w->since) / (RIG_PRIO_AGING_MS * 1000000LL);
+
+    return aged < RIG_PRIO_SET ? RIG_PRIO_SET : (rig_prio_t) aged;
+}
+
+void rig_prio_lock(RIG *rig, rig_prio_t prio)
+{
+    struct rig_prio_sched *sched = &CACHE(rig)->sched;
+    struct rig_prio_waiter self;
+    struct rig_prio_waiter **tail;
+
+    if (prio < RIG_PRIO_PTT || prio >= RIG_PRIO_COUNT)
+    {
+        prio = RIG_PRIO_GET;
+    }
+
+    self.next = NULL;
+    self.thread = pthread_self();
+    self.prio = prio;
+    self.granted = 0;
+
+    pthread_mutex_lock(&sched->lock);
+
+    if (sched->depth > 0 && pthread_equal(sched->owner, self.thread))
+    {
+        sched->depth++;
+        pthread_mutex_unlock(&sched->lock);
+        return;
+    }
+
+    self.since = rig_cache_now_ns();
+
+    if (sched->depth == 0)
+    {
+        // the rig is handed over directly on unlock, so nobody is waiting
+        sched->owner = self.thread;
+        sched->depth = 1;
+        record_wait(sched, prio, 0);
+        pthread_mutex_unlock(&sched->lock);
+        return;
+    }
+
+    for (tail = &sched->waiters; *tail; tail = &(*tail)->next) {}
+
+    *tail = &self;
+
+    while (!self.granted)
+    {
+        pthread_cond_wait(&sched->cond, &sched->lock);
+    }
+
+    record_wait(sched, prio, rig_cache_now_ns() - self.since);
+    pthread_mutex_unlock(&sched->lock);
+}
+
+void rig_prio_unlock(RIG *rig)
+{
+    struct rig_prio_sched *sched = &CACHE(rig)->sched;
+    struct rig_prio_waiter **best = NULL;
+    struct rig_prio_waiter **w;
+    rig_prio_t best_prio = RIG_PRIO_COUNT;
+    int64_t now;
+
+    pthread_mutex_lock(&sched->lock);
+
+    if (sched->depth == 0 || !pthread_equal(sched->owner, pthread_self()))
+    {
+        pthread_mutex_unlock(&sched->lock);
+        rig_debug(RIG_DEBUG_ERR, "%s: rig not locked by this thread\n", __func__);
+        return;
+    }
+
+    if (--sched->depth > 0 || !sched->waiters)
+    {
+        pthread_mutex_unlock(&sched->lock);
+        return;
+    }
+
+    now = rig_cache_now_ns();
+
+    // strictly better only, so equal priorities go in arrival order
+    for (w = &sched->waiters; *w; w = &(*w)->next)
+    {
+        rig_prio_t prio = effective_prio(*w, now);
+
+        if (prio < best_prio)
+        {
+            best_prio = prio;
+            best = w;
+        }
+    }
+
+    sched->owner = (*best)->thread;
+    sched->depth = 1;
+    (*best)->granted = 1;
+    *best = (*best)->next;
+
+    pthread_cond_broadcast(&sched->cond);
+    pthread_mutex_unlock(&sched->lock);
+}
+
+/**
+ * \brief Get the rig access wait times of one priority
+ * \param rig The rig handle
+ * \param prio The priority
+ * \param stats Where to store them
+ *
+ * Counts every rig_lock() that had to be acquired, i.e. not the nested
+ * ones, since rig_init().
+ *
+ * \return RIG_OK or -RIG_EINVAL
+ */
+int HAMLIB_API rig_get_prio_stats(RIG *rig, rig_prio_t prio,
+                                  struct rig_prio_stats *stats)
+{
+    struct rig_prio_sched *sched;
+
+    if (!rig || !CACHE(rig) || !stats || prio < RIG_PRIO_PTT
+            || prio >= RIG_PRIO_COUNT)
+    {
+        return -RIG_EINVAL;
+    }
+
+    sched = &CACHE(rig)->sched;
+
+    pthread_mutex_lock(&sched->lock);
+    *stats = sched->stats[prio];
+    pthread_mutex_unlock(&sched->lock);
+
+    return RIG_OK;
+}
+
+void rig_prio_dump(RIG *rig)
+{
+    static const char *const names[RIG_PRIO_COUNT] =
+    {
+        "PTT", "SET", "GET", "POLL"
+    };
+    struct rig_prio_stats stats;
+    int prio;
+
+    for (prio = RIG_PRIO_PTT; prio < RIG_PRIO_COUNT; prio++)
+    {
+        rig_get_prio_stats(rig, prio, &stats);
+
+        if (stats.count == 0)
+        {
+            continue;
+        }
+
+        rig_debug(RIG_DEBUG_VERBOSE,
+                  "%s: %-4s waits=%lu avg=%luus max=%luus\n", __func__,
+                  names[prio], stats.count, stats.total_us / stats.count,
+                  stats.max_us);
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ *  Hamlib Interface - priority scheduling of rig access
+ *  Copyright (c) 2026 The Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+
+#ifndef _HL_PRIO_H
+#define _HL_PRIO_H 1
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "hamlib/rig.h"
+
+__BEGIN_DECLS
+
+/* One thread waiting in rig_lock(), lives on that thread's stack */
+struct rig_prio_waiter {
+    struct rig_prio_waiter *next;
+    pthread_t thread;
+    rig_prio_t prio;
+    int64_t since;      // rig_cache_now_ns() when it started waiting
+    int granted;        // set by the thread handing the rig over
+};
+
+struct rig_prio_sched {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_t owner;    // thread holding the rig, if depth > 0
+    int depth;          // rig_lock() is recursive
+    struct rig_prio_waiter *waiters;    // in arrival order
+    struct rig_prio_stats stats[RIG_PRIO_COUNT];
+};
+
+/* A waiter moves up one priority per this much waiting, but never to PTT */
+#define RIG_PRIO_AGING_MS 250
+
+void rig_prio_init(RIG *rig);
+void rig_prio_cleanup(RIG *rig);
+void rig_prio_lock(RIG *rig, rig_prio_t prio);
+void rig_prio_unlock(RIG *rig);
+rig_prio_t rig_prio_thread(void);
+void rig_lock_prio(RIG *rig, rig_prio_t prio);
+void rig_prio_dump(RIG *rig);
+
+__END_DECLS
+
+#endif /* _HL_PRIO_H */
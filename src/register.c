@@ -31,10 +31,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
+#include <pthread.h>
 
 #include "register.h"
+#include "model_list.h"
+#include "cache.h"
 
 #include "hamlib/rig.h"
+#include "hamlib/port.h"
 
 //! @cond Doxygen_Suppress
 #ifndef PATH_MAX
@@ -166,102 +171,52 @@ static struct
 
 
 /*
- * This struct to keep track of known rig models.
- * It is chained, and used in a hash table, see below.
+ * Registered rig caps, sorted by model.  A backend registers all of its
+ * models the first time one of them is asked for, see rig_check_backend().
  */
-//! @cond Doxygen_Suppress
-struct rig_list
-{
-    struct rig_caps *caps;
-    struct rig_list *next;
-};
-//! @endcond
-
+static struct model_list rig_models = MODEL_LIST_INITIALIZER;
 
-// This size has to be > than the max# of rigs for any manufacturer
-// A fatal error will occur when running rigctl if this value is too small
-//! @cond Doxygen_Suppress
-#define RIGLSTHASHSZ 65535
-#define HASH_FUNC(a) ((a)%RIGLSTHASHSZ)
-//! @endcond
-
-
-/*
- * The rig_hash_table is a hash table pointing to a list of next==NULL
- *  terminated caps.
- */
-static struct rig_list *rig_hash_table[RIGLSTHASHSZ] = { NULL, };
+/* Backends whose init has run, by rig_backend_list index */
+static char rig_backend_loaded[RIG_BACKEND_MAX];
 
 
 static int rig_lookup_backend(rig_model_t rig_model);
 
 
 /*
- * Basically, this is a hash insert function that doesn't check for dup!
+ * Add caps to the registry, a model can only be registered once.
  */
 //! @cond Doxygen_Suppress
 int HAMLIB_API rig_register(struct rig_caps *caps)
 {
-    int hval;
-    struct rig_list *p;
-
-    //rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
+    int retval;
 
     if (!caps)
     {
         return -RIG_EINVAL;
     }
 
-#if 0
-    rig_debug(RIG_DEBUG_ERR,
-              "%s: rig_register (%u)\n",
-              __func__,
-              caps->rig_model);
-#endif
-
-    p = (struct rig_list *)calloc(1, sizeof(struct rig_list));
+    retval = model_list_add(&rig_models, caps->rig_model, caps);
 
-    if (!p)
+    if (retval == -RIG_EINVAL)
     {
-        return -RIG_ENOMEM;
+        rig_debug(RIG_DEBUG_ERR, "%s: model %u registered twice\n", __func__,
+                  caps->rig_model);
     }
 
-    hval = HASH_FUNC(caps->rig_model);
-
-    if (rig_hash_table[hval])
-    {
-        printf("Hash collision!!! Fatal error!!\n");
-        exit(1);
-    }
-
-    p->caps = caps;
-    // p->handle = NULL;
-    p->next = rig_hash_table[hval];
-    rig_hash_table[hval] = p;
-
-    return RIG_OK;
+    return retval;
 }
 //! @endcond
 
 /*
  * Get rig capabilities.
- * ie. rig_hash_table lookup
+ * ie. registry lookup
  */
 
 //! @cond Doxygen_Suppress
 struct rig_caps *HAMLIB_API rig_get_caps(rig_model_t rig_model)
 {
-    struct rig_list *p;
-
-    for (p = rig_hash_table[HASH_FUNC(rig_model)]; p; p = p->next)
-    {
-        if (p->caps->rig_model == rig_model)
-        {
-            return p->caps;
-        }
-    }
-
-    return NULL;    /* sorry, caps not registered! */
+    return (struct rig_caps *) model_list_find(&rig_models, rig_model);
 }
 //! @endcond
 
@@ -309,24 +264,6 @@ int HAMLIB_API rig_check_backend(rig_model_t rig_model)
         return RIG_OK;
     }
 
-#if 0 // this stopped a 2nd rig_init call with a valid model to fail -- reversing
-
-    // hmmm...no caps so did we already load the rigs?
-    for (n = 0, i = 0; i < RIGLSTHASHSZ; i++)
-    {
-        if (rig_hash_table[i]) { ++n; }
-    }
-
-
-    if (n > 1)
-    {
-        rig_debug(RIG_DEBUG_ERR, "%s: rig model %u not found and rig count=%d\n",
-                  __func__, rig_model, n);
-        return -RIG_ENAVAIL;
-    }
-
-#endif
-
     be_idx = rig_lookup_backend(rig_model);
 
     /*
@@ -341,18 +278,14 @@ int HAMLIB_API rig_check_backend(rig_model_t rig_model)
         return -RIG_ENAVAIL;
     }
 
-    // do we need to load the backend?
-//    if (rig_backend_list[be_idx].be_init_all == 0)
+    if (rig_backend_loaded[be_idx])
     {
-        retval = rig_load_backend(rig_backend_list[be_idx].be_name);
-    }
-#if 0
-    else
-    {
-        retval = RIG_OK;
+        rig_debug(RIG_DEBUG_VERBOSE, "%s: backend %s has no model %u\n",
+                  __func__, rig_backend_list[be_idx].be_name, rig_model);
+        return -RIG_ENAVAIL;
     }
 
-#endif
+    retval = rig_load_backend(rig_backend_list[be_idx].be_name);
 
     return retval;
 }
@@ -363,103 +296,79 @@ int HAMLIB_API rig_check_backend(rig_model_t rig_model)
 //! @cond Doxygen_Suppress
 int HAMLIB_API rig_unregister(rig_model_t rig_model)
 {
-    int hval;
-    struct rig_list *p, *q;
-
-    hval = HASH_FUNC(rig_model);
-    q = NULL;
-
-    for (p = rig_hash_table[hval]; p; p = p->next)
-    {
-        if (p->caps->rig_model == rig_model)
-        {
-            if (q == NULL)
-            {
-                rig_hash_table[hval] = p->next;
-            }
-            else
-            {
-                q->next = p->next;
-            }
-
-            free(p);
-            return RIG_OK;
-        }
-
-        q = p;
-    }
-
-    return -RIG_EINVAL; /* sorry, caps not registered! */
+    return model_list_remove(&rig_models, rig_model);
 }
 //! @endcond
 
 /*
  * rig_list_foreach
- * executes cfunc on all the elements stored in the rig hash list
+ * executes cfunc on all the registered caps, in model order
+ * The models registered when it starts are walked: those cfunc
+ * unregisters before their turn are skipped, those it registers (e.g. by
+ * loading a backend) are not visited.
  */
 //! @cond Doxygen_Suppress
 int HAMLIB_API rig_list_foreach(int (*cfunc)(const struct rig_caps *,
                                 rig_ptr_t),
                                 rig_ptr_t data)
 {
-    struct rig_list *p;
+    struct model_list_entry *models;
+    int count;
+    int i;
 
     if (!cfunc)
     {
         return -RIG_EINVAL;
     }
 
-    for (int i = 0; i < RIGLSTHASHSZ; i++)
-    {
-        struct rig_list *next = NULL;
+    count = model_list_snapshot(&rig_models, &models);
 
-        for (p = rig_hash_table[i]; p; p = next)
-        {
-            next = p->next;       /* read before call in case it is unregistered */
+    for (i = 0; i < count; i++)
+    {
+        /* skip what cfunc unregistered on the way */
+        if (model_list_find(&rig_models, models[i].model) != models[i].caps) { continue; }
 
-            if ((*cfunc)(p->caps, data) == 0)
-            {
-                return RIG_OK;
-            }
-        }
+        if ((*cfunc)(models[i].caps, data) == 0) { break; }
     }
 
-    return RIG_OK;
+    free(models);
+
+    return count < 0 ? count : RIG_OK;
 }
 //! @endcond
 
 /*
  * rig_list_foreach_model
- * executes cfunc on all the elements stored in the rig hash list
+ * executes cfunc on all the registered models, in model order,
+ * like rig_list_foreach()
  */
 //! @cond Doxygen_Suppress
 int HAMLIB_API rig_list_foreach_model(int (*cfunc)(const rig_model_t rig_model,
                                       rig_ptr_t),
                                       rig_ptr_t data)
 {
-    struct rig_list *p;
+    struct model_list_entry *models;
+    int count;
+    int i;
 
     if (!cfunc)
     {
         return -RIG_EINVAL;
     }
 
-    for (int i = 0; i < RIGLSTHASHSZ; i++)
-    {
-        struct rig_list *next = NULL;
+    count = model_list_snapshot(&rig_models, &models);
 
-        for (p = rig_hash_table[i]; p; p = next)
-        {
-            next = p->next;       /* read before call in case it is unregistered */
+    for (i = 0; i < count; i++)
+    {
+        /* skip what cfunc unregistered on the way */
+        if (model_list_find(&rig_models, models[i].model) != models[i].caps) { continue; }
 
-            if ((*cfunc)(p->caps->rig_model, data) == 0)
-            {
-                return RIG_OK;
-            }
-        }
+        if ((*cfunc)(models[i].model, data) == 0) { break; }
     }
 
-    return RIG_OK;
+    free(models);
+
+    return count < 0 ? count : RIG_OK;
 }
 //! @endcond
 
@@ -504,6 +413,192 @@ rig_model_t rig_probe_first(hamlib_port_t *p)
 //! @endcond
 
 
+/*
+ * Order rig_probe_ports() tries the probing backends in.  Each backend
+ * loops over its own baud rates, reopening the port for every one, so
+ * the families with a single query per rate go first and Icom, which
+ * scans every CI-V address at each rate, goes last.  Backends not listed
+ * here are tried after these, in rig_backend_list order.
+ */
+static const int rig_probe_order[] =
+{
+    RIG_KENWOOD,    /* "ID;" at 115200 down to 1200 */
+    RIG_YAESU,
+    RIG_UNIDEN,     /* 9600, 19200 */
+    RIG_GUOHETEC,   /* 9600 up to 115200 */
+    RIG_DRAKE,
+    RIG_LOWE,
+    RIG_ADAT,
+    RIG_ICOM,       /* 19200, 9600, 300, 0x01..0x7f each */
+};
+
+#define RIG_PROBE_ORDER_COUNT (int)(sizeof(rig_probe_order) / sizeof(rig_probe_order[0]))
+
+/* Shared by a rig_probe_ports() call and its workers */
+struct rig_probe_job
+{
+    pthread_mutex_t lock;   /* one cfunc call at a time */
+    int found;
+    rig_probe_func_t cfunc;
+    rig_ptr_t data;
+    int64_t deadline_ns;    /* rig_cache_now_ns() when the budget runs out, 0 for none */
+};
+
+struct rig_probe_worker
+{
+    struct rig_probe_job *job;
+    hamlib_port_t port;
+    pthread_t thread;
+    int started;
+};
+
+static int rig_probe_expired(const struct rig_probe_job *job)
+{
+    return job->deadline_ns != 0 && rig_cache_now_ns() >= job->deadline_ns;
+}
+
+static rig_model_t rig_probe_backend(hamlib_port_t *p, int be_idx)
+{
+    rig_model_t (*probe)(hamlib_port_t *, rig_probe_func_t, rig_ptr_t);
+
+    probe = rig_backend_list[be_idx].be_probe_all;
+
+    if (!probe)
+    {
+        return RIG_MODEL_NONE;
+    }
+
+    return (*probe)(p, dummy_rig_probe, (rig_ptr_t)NULL);
+}
+
+/*
+ * Probes one port.  The port carries the deadline, so once it passes the
+ * backend being tried gets nothing but timeouts and the rest are skipped.
+ */
+static void *rig_probe_worker(void *arg)
+{
+    struct rig_probe_worker *w = arg;
+    struct rig_probe_job *job = w->job;
+    rig_model_t model = RIG_MODEL_NONE;
+    char done[RIG_BACKEND_MAX] = { 0 };
+    int i, j;
+
+    for (i = 0; i < RIG_PROBE_ORDER_COUNT && model == RIG_MODEL_NONE; i++)
+    {
+        for (j = 0; j < RIG_BACKEND_MAX && rig_backend_list[j].be_name; j++)
+        {
+            if (rig_backend_list[j].be_num == rig_probe_order[i])
+            {
+                break;
+            }
+        }
+
+        if (j == RIG_BACKEND_MAX || !rig_backend_list[j].be_name
+                || rig_probe_expired(job))
+        {
+            continue;
+        }
+
+        done[j] = 1;
+        model = rig_probe_backend(&w->port, j);
+    }
+
+    for (j = 0; j < RIG_BACKEND_MAX && rig_backend_list[j].be_name
+            && model == RIG_MODEL_NONE; j++)
+    {
+        if (!done[j] && !rig_probe_expired(job))
+        {
+            model = rig_probe_backend(&w->port, j);
+        }
+    }
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: %s: model %u\n", __func__,
+              w->port.pathname, model);
+
+    pthread_mutex_lock(&job->lock);
+
+    if (model != RIG_MODEL_NONE)
+    {
+        job->found++;
+    }
+
+    if (job->cfunc)
+    {
+        (*job->cfunc)(&w->port, model, job->data);
+    }
+
+    pthread_mutex_unlock(&job->lock);
+
+    return NULL;
+}
+
+/*
+ * rig_probe_ports_backends
+ * called straight by rig_probe_ports
+ */
+//! @cond Doxygen_Suppress
+int rig_probe_ports_backends(const char *const pathnames[], int count,
+                             int budget_ms, rig_probe_func_t cfunc,
+                             rig_ptr_t data)
+{
+    struct rig_probe_job job;
+    struct rig_probe_worker *workers;
+    int i;
+
+    workers = calloc(count, sizeof(*workers));
+
+    if (!workers)
+    {
+        return -RIG_ENOMEM;
+    }
+
+    pthread_mutex_init(&job.lock, NULL);
+    job.found = 0;
+    job.cfunc = cfunc;
+    job.data = data;
+    job.deadline_ns = budget_ms > 0
+                      ? rig_cache_now_ns() + (int64_t) budget_ms * 1000000 : 0;
+
+    for (i = 0; i < count; i++)
+    {
+        struct rig_probe_worker *w = &workers[i];
+
+        w->job = &job;
+        w->port.type.rig = RIG_PORT_SERIAL;
+        w->port.parm.serial.data_bits = 8;
+        w->port.parm.serial.stop_bits = 1;
+        w->port.parm.serial.parity = RIG_PARITY_NONE;
+        w->port.parm.serial.handshake = RIG_HANDSHAKE_NONE;
+        w->port.fd = -1;
+        w->port.deadline_ns = job.deadline_ns;
+        strncpy(w->port.pathname, pathnames[i], HAMLIB_FILPATHLEN - 1);
+
+        w->started = pthread_create(&w->thread, NULL, rig_probe_worker, w) == 0;
+
+        if (!w->started)
+        {
+            // no thread, probe it here
+            rig_probe_worker(w);
+        }
+    }
+
+    // the deadline bounds every read, so nobody is left probing after this
+    for (i = 0; i < count; i++)
+    {
+        if (workers[i].started)
+        {
+            pthread_join(workers[i].thread, NULL);
+        }
+    }
+
+    pthread_mutex_destroy(&job.lock);
+    free(workers);
+
+    return job.found;
+}
+//! @endcond
+
+
 /*
  * rig_probe_all_backends
  * called straight by rig_probe_all
@@ -529,8 +624,6 @@ int rig_probe_all_backends(hamlib_port_t *p,
 //! @cond Doxygen_Suppress
 int rig_load_all_backends()
 {
-    memset(rig_hash_table, 0, sizeof(rig_hash_table));
-
     for (int i = 0; i < RIG_BACKEND_MAX && rig_backend_list[i].be_name; i++)
     {
         rig_load_backend(rig_backend_list[i].be_name);
@@ -558,16 +651,28 @@ int HAMLIB_API rig_load_backend(const char *be_name)
     {
         if (!strcmp(be_name, rig_backend_list[i].be_name))
         {
-            be_init = rig_backend_list[i].be_init_all ;
+            int retval;
 
-            if (be_init)
+            if (rig_backend_loaded[i])
             {
-                return (*be_init)(NULL);
+                return RIG_OK;
             }
-            else
+
+            be_init = rig_backend_list[i].be_init_all ;
+
+            if (!be_init)
             {
                 return -RIG_EINVAL;
             }
+
+            retval = (*be_init)(NULL);
+
+            if (retval == RIG_OK)
+            {
+                rig_backend_loaded[i] = 1;
+            }
+
+            return retval;
         }
     }
 
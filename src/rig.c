@@ -73,6 +73,9 @@
 #include "sprintflst.h"
 #include "hamlibdatetime.h"
 #include "cache.h"
+#include "spectrum_history.h"
+#include "spectrum_pool.h"
+#include "mem.h"
 
 /**
  * \brief Hamlib short license name
@@ -187,6 +190,7 @@ const char hamlib_copyright[231] = /* hamlib 1.2 ABI specifies 231 bytes */
 
 // Rig lock for all front side thread control
 #define LOCK(n) rig_lock(rig,n)
+#define LOCK_PRIO(p) rig_lock_prio(rig,RIG_PRIO_##p)
 
 static bool morse_busy_load(const struct rig_state *rs)
 {
@@ -392,70 +396,6 @@ char debugmsgsave[DEBUGMSGSAVE_SIZE] = "";
 char debugmsgsave2[DEBUGMSGSAVE_SIZE] = ""; // deprecated
 char debugmsgsave3[DEBUGMSGSAVE_SIZE] = ""; // deprecated
 
-MUTEX(mutex_debugmsgsave);
-
-
-/**
- * @brief Handle stack trace messages.
- * 
- * @ingroup lib_internal
- *
- * Maintains an array of debug messages to build a stack trace of up to 20
- * lines.
- *
- * @sa rigerror()
- */
-void add2debugmsgsave(const char *s)
-{
-    const size_t maxmsg = DEBUGMSGSAVE_SIZE / 2;
-    size_t append_len;
-    size_t current_len;
-    size_t i;
-    size_t nlines;
-    char *keep;
-
-    MUTEX_LOCK(mutex_debugmsgsave);
-
-    current_len = strlen(debugmsgsave);
-    keep = debugmsgsave;
-
-    for (i = 0, nlines = 0; i < current_len; ++i)
-    {
-        if (debugmsgsave[i] == '\n') { ++nlines; }
-    }
-
-    while (nlines > 19 || current_len > maxmsg)
-    {
-        char *newline = strchr(keep, '\n');
-
-        if (newline == NULL)
-        {
-            keep += current_len;
-            current_len = 0;
-            break;
-        }
-
-        size_t remove_len = (size_t)(newline + 1 - keep);
-        keep = newline + 1;
-        current_len -= remove_len;
-        --nlines;
-    }
-
-    if (keep != debugmsgsave)
-    {
-        memmove(debugmsgsave, keep, current_len + 1);
-    }
-
-    append_len = strlen(s);
-    if (append_len <= sizeof(debugmsgsave) - current_len - 1)
-    {
-        memmove(debugmsgsave + current_len, s, append_len + 1);
-    }
-
-    MUTEX_UNLOCK(mutex_debugmsgsave);
-}
-
-
 /**
  * \brief Get the string describing the passed error code.
  *
@@ -521,9 +461,18 @@ const char *HAMLIB_API rigerror(int errnum)
              rigerror_table[errnum],
              debugmsgsave3, debugmsgsave2, debugmsgsave);
 #else
+    const char *history;
+
     snprintf(msg, sizeof(msg), "%s\n", rigerror_table[errnum]);
     add2debugmsgsave(msg);
-    snprintf(msg, sizeof(msg), "%s", debugmsgsave);
+    history = rig_get_debug_history();
+
+    // empty with the debug history off
+    if (*history)
+    {
+        snprintf(msg, sizeof(msg), "%s", history);
+    }
+
 #endif
     return msg;
 }
@@ -569,7 +518,10 @@ static void vaporize(RIG *rig)
 {
     if (CACHE(rig))
     {
-        free(CACHE(rig));
+        rig_flight_cleanup(rig);
+        rig_prio_cleanup(rig);
+        rig_cache_notify_cleanup(rig);
+        rig_cache_free(CACHE(rig));
         CACHE(rig) = NULL;
     }
 
@@ -590,6 +542,9 @@ static void vaporize(RIG *rig)
     }
     if (STATE(rig))
     {
+        spectrum_history_cleanup(rig);
+        spectrum_pool_cleanup(rig);
+        mem_hashes_cleanup(rig);
         free(STATE(rig));
         STATE(rig) = NULL;
     }
@@ -721,14 +676,24 @@ RIG *HAMLIB_API rig_init(rig_model_t rig_model)
     // Allocate space for cached data
     needed = sizeof(struct rig_cache);
     rig_debug(RIG_DEBUG_TRACE, "Requesting %zu bytes for rig_cache\n", needed);
-    CACHE(rig) = calloc(1, needed);
+    CACHE(rig) = rig_cache_alloc();
     if (!CACHE(rig))
     {
-        rig_debug(RIG_DEBUG_ERR, "%s:Cache calloc failed\n", __func__);
+        rig_debug(RIG_DEBUG_ERR, "%s:Cache alloc failed\n", __func__);
         vaporize(rig);
         return NULL;
     }
     cachep = CACHE(rig);
+    rig_flight_init(rig);
+    rig_prio_init(rig);
+    rig_cache_notify_init(rig);
+
+    if (spectrum_pool_init(rig) != RIG_OK || spectrum_history_init(rig) != RIG_OK)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: spectrum pool/history calloc failed\n", __func__);
+        vaporize(rig);
+        return NULL;
+    }
 
     rs->rig_model = caps->rig_model;
     rs->priv = NULL;
@@ -999,7 +964,8 @@ RIG *HAMLIB_API rig_init(rig_model_t rig_model)
     // So we assume power is on until one of the backends KNOWS it is off
     rs->powerstat = RIG_POWER_ON; // default to power on until proven otherwise
 
-    // Set up lock for any API entry point
+    // Hamlib serializes API entry with rig_lock(), but applications may
+    // still lock api_mutex, so keep it a valid recursive mutex
     pthread_mutexattr_t api_attr;
     pthread_mutexattr_init(&api_attr);
     pthread_mutexattr_settype(&api_attr, PTHREAD_MUTEX_RECURSIVE);
@@ -1764,6 +1730,8 @@ int HAMLIB_API rig_close(RIG *rig)
         network_multicast_publisher_stop(rig);
     }
 
+    rig_prio_dump(rig);
+
     // Let the backend say 73 to the rig.
     // and ignore the return code.
     if (caps->rig_close)
@@ -1919,7 +1887,7 @@ int HAMLIB_API rig_cleanup(RIG *rig)
         rig->caps->rig_cleanup(rig);
     }
 
-    //pthread_mutex_destroy(&STATE(rig)->api_mutex);
+    pthread_mutex_destroy(&STATE(rig)->api_mutex);
 
     /* Release all buffers, and the rig_struct itself */
     vaporize(rig);
@@ -2163,7 +2131,7 @@ int rig_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
 
     ELAPSED1;
     ENTERFUNC;
-    LOCK(1);
+    LOCK_PRIO(SET);
 
 
 #if BUILTINFUNC
@@ -2180,13 +2148,13 @@ int rig_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
         if (vfo == RIG_VFO_A || vfo == RIG_VFO_MAIN || (vfo == RIG_VFO_CURR
                 && rs->current_vfo == RIG_VFO_A))
         {
-            if (cachep->freqMainA != freq && (((int)freq % 10) != 0)
+            if (cachep->slot[CACHE_SLOT_MAIN_A].freq != freq && (((int)freq % 10) != 0)
                     && (((int)freq % 100) != 55))
             {
                 rs->doppler = 1;
                 rig_debug(RIG_DEBUG_VERBOSE,
                           "%s(%d): potential doppler detected because old freq %f != new && new freq has 1Hz or such values\n",
-                          __func__, __LINE__, cachep->freqMainA);
+                          __func__, __LINE__, cachep->slot[CACHE_SLOT_MAIN_A].freq);
             }
 
             freq += rs->offset_vfoa;
@@ -2194,13 +2162,13 @@ int rig_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
         else if (vfo == RIG_VFO_B || vfo == RIG_VFO_SUB || (vfo == RIG_VFO_CURR
                  && rs->current_vfo == RIG_VFO_B))
         {
-            if (cachep->freqMainB != freq && ((int)freq % 10) != 0
+            if (cachep->slot[CACHE_SLOT_MAIN_B].freq != freq && ((int)freq % 10) != 0
                     && (((int)freq % 100) != 55))
             {
                 rs->doppler = 1;
                 rig_debug(RIG_DEBUG_VERBOSE,
                           "%s(%d): potential doppler detected because old freq %f != new && new freq has 1Hz or such values\n",
-                          __func__, __LINE__, cachep->freqMainB);
+                          __func__, __LINE__, cachep->slot[CACHE_SLOT_MAIN_B].freq);
             }
 
             freq += rs->offset_vfob;
@@ -2449,29 +2417,11 @@ int rig_set_freq(RIG *rig, vfo_t vfo, freq_t freq)
 }
 
 
-/**
- * \brief get the frequency of the target VFO
- * \param rig   The rig handle
- * \param vfo   The target VFO
- * \param freq  The location where to store the current frequency
- *
- *  Retrieves the frequency of the target VFO.
- *  The value stored at \a freq location equals RIG_FREQ_NONE when the current
- *  frequency of the VFO is not defined (e.g. blank memory).
- *
- * \return RIG_OK if the operation has been successful, otherwise
- * a negative value if an error occurred (in which case, cause is
- * set appropriately).
- *
- * \sa rig_set_freq()
+/*
+ * rig_get_freq() proper, the public function below only makes sure that
+ * concurrent identical calls share one trip to the rig.
  */
-#if BUILTINFUNC
-#undef rig_get_freq
-int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq, const char *func)
-#define rig_get_freq(r,v,f) rig_get_freq(r,v,f,__builtin_FUNCTION())
-#else
-int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
-#endif
+static int rig_get_freq_direct(RIG *rig, vfo_t vfo, freq_t *freq)
 {
     const struct rig_caps *caps;
     struct rig_cache *cachep;
@@ -2494,14 +2444,8 @@ int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
     cachep = CACHE(rig);
 
     ENTERFUNC;
-#if BUILTINFUNC
-    rig_debug(RIG_DEBUG_VERBOSE, "%s called vfo=%s, called from %s\n",
-              __func__,
-              rig_strvfo(vfo), func);
-#else
     rig_debug(RIG_DEBUG_VERBOSE, "%s called vfo=%s\n", __func__,
               rig_strvfo(vfo));
-#endif
 
     ELAPSED1;
 
@@ -2524,7 +2468,7 @@ int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
               rig_strvfo(vfo), rig_strvfo(curr_vfo));
 
     /* morse_busy is a hint that the port may be busy - this reduces
-     *   the chance that we get stalled on the api_mutex.
+     *   the chance that we get stalled on the rig lock.
      *   But it still may happen(just not very often.)
      * It is copied to use_cache so the value is consistent throughout, and
      *   in case we ever need to add other conditions.
@@ -2581,7 +2525,7 @@ int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
             rig_debug(RIG_DEBUG_TRACE,
                       "%s: split is on so returning VFOA last known freq\n",
                       __func__);
-            *freq = cachep->freqMainA;
+            *freq = cachep->slot[CACHE_SLOT_MAIN_A].freq;
             ELAPSED2;
             LOCK(0);
             RETURNFUNC(RIG_OK);
@@ -2769,6 +2713,58 @@ int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
     RETURNFUNC(retcode);
 }
 
+
+/**
+ * \brief get the frequency of the target VFO
+ * \param rig   The rig handle
+ * \param vfo   The target VFO
+ * \param freq  The location where to store the current frequency
+ *
+ *  Retrieves the frequency of the target VFO.
+ *  The value stored at \a freq location equals RIG_FREQ_NONE when the current
+ *  frequency of the VFO is not defined (e.g. blank memory).
+ *
+ * \return RIG_OK if the operation has been successful, otherwise
+ * a negative value if an error occurred (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_set_freq()
+ */
+#if BUILTINFUNC
+#undef rig_get_freq
+int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq, const char *func)
+#define rig_get_freq(r,v,f) rig_get_freq(r,v,f,__builtin_FUNCTION())
+#else
+int HAMLIB_API rig_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
+#endif
+{
+    struct rig_flight *flight;
+    struct rig_flight_result result;
+
+    if (CHECK_RIG_ARG(rig) || !freq)
+    {
+        return rig_get_freq_direct(rig, vfo, freq);
+    }
+
+#if BUILTINFUNC
+    rig_debug(RIG_DEBUG_VERBOSE, "%s called vfo=%s, called from %s\n",
+              __func__,
+              rig_strvfo(vfo), func);
+#endif
+
+    if (rig_flight_begin(rig, RIG_FLIGHT_FREQ, vfo, 0, &flight, &result))
+    {
+        *freq = result.freq;
+        return result.retcode;
+    }
+
+    result.retcode = rig_get_freq_direct(rig, vfo, freq);
+    result.freq = *freq;
+    rig_flight_end(rig, flight, &result);
+
+    return result.retcode;
+}
+
 /**
  * \brief get the frequency of VFOA and VFOB
  * \param rig   The rig handle
@@ -2832,7 +2828,7 @@ int HAMLIB_API rig_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
 
     ENTERFUNC;
     ELAPSED1;
-    LOCK(1);
+    LOCK_PRIO(SET);
 
     rig_debug(RIG_DEBUG_VERBOSE,
               "%s called, vfo=%s, mode=%s, width=%d, curr_vfo=%s\n", __func__,
@@ -2992,32 +2988,9 @@ int HAMLIB_API rig_set_mode(RIG *rig, vfo_t vfo, rmode_t mode, pbwidth_t width)
     RETURNFUNC(retcode);
 }
 
-/**
- * \brief get the mode of the target VFO
- * \param rig   The rig handle
- * \param vfo   The target VFO
- * \param mode  The location where to store the current mode
- * \param width The location where to store the current passband width
- *
- *  Retrieves the mode and passband of the target VFO.
- *  If the backend is unable to determine the width, the \a width
- *  will be set to RIG_PASSBAND_NORMAL as a default.
- *  The value stored at \a mode location equals RIG_MODE_NONE when the current
- *  mode of the VFO is not defined (e.g. blank memory).
- *
- *  Note that if either \a mode or \a width is NULL, -RIG_EINVAL is returned.
- *  Both must be given even if only one is actually wanted.
- *
- * \return RIG_OK if the operation has been successful, otherwise
- * a negative value if an error occurred (in which case, cause is
- * set appropriately).
- *
- * \sa rig_set_mode()
- */
-int HAMLIB_API rig_get_mode(RIG *rig,
-                            vfo_t vfo,
-                            rmode_t *mode,
-                            pbwidth_t *width)
+/* rig_get_mode() proper, see rig_get_freq_direct() */
+static int rig_get_mode_direct(RIG *rig, vfo_t vfo, rmode_t *mode,
+                               pbwidth_t *width)
 {
     const struct rig_caps *caps;
     struct rig_state *rs;
@@ -3167,6 +3140,57 @@ int HAMLIB_API rig_get_mode(RIG *rig,
 }
 
 
+/**
+ * \brief get the mode of the target VFO
+ * \param rig   The rig handle
+ * \param vfo   The target VFO
+ * \param mode  The location where to store the current mode
+ * \param width The location where to store the current passband width
+ *
+ *  Retrieves the mode and passband of the target VFO.
+ *  If the backend is unable to determine the width, the \a width
+ *  will be set to RIG_PASSBAND_NORMAL as a default.
+ *  The value stored at \a mode location equals RIG_MODE_NONE when the current
+ *  mode of the VFO is not defined (e.g. blank memory).
+ *
+ *  Note that if either \a mode or \a width is NULL, -RIG_EINVAL is returned.
+ *  Both must be given even if only one is actually wanted.
+ *
+ * \return RIG_OK if the operation has been successful, otherwise
+ * a negative value if an error occurred (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_set_mode()
+ */
+int HAMLIB_API rig_get_mode(RIG *rig,
+                            vfo_t vfo,
+                            rmode_t *mode,
+                            pbwidth_t *width)
+{
+    struct rig_flight *flight;
+    struct rig_flight_result result;
+
+    if (CHECK_RIG_ARG(rig) || !mode || !width)
+    {
+        return rig_get_mode_direct(rig, vfo, mode, width);
+    }
+
+    if (rig_flight_begin(rig, RIG_FLIGHT_MODE, vfo, 0, &flight, &result))
+    {
+        *mode = result.mode;
+        *width = result.width;
+        return result.retcode;
+    }
+
+    result.retcode = rig_get_mode_direct(rig, vfo, mode, width);
+    result.mode = *mode;
+    result.width = *width;
+    rig_flight_end(rig, flight, &result);
+
+    return result.retcode;
+}
+
+
 /**
  * \brief get the normal passband of a mode
  * \param rig   The rig handle
@@ -3416,7 +3440,7 @@ int HAMLIB_API rig_set_vfo(RIG *rig, vfo_t vfo)
     HAMLIB_TRACE;
     vfo_t vfo_save = rs->current_vfo;
 
-    LOCK(1);
+    LOCK_PRIO(SET);
 
     if (vfo != RIG_VFO_CURR) { rs->current_vfo = vfo; }
 
@@ -3425,8 +3449,7 @@ int HAMLIB_API rig_set_vfo(RIG *rig, vfo_t vfo)
     if (retcode == RIG_OK)
     {
         vfo = rs->current_vfo; // vfo may change in the rig backend
-        cachep->vfo = vfo;
-        elapsed_ms(&cachep->time_vfo, HAMLIB_ELAPSED_SET);
+        rig_set_cache_vfo(rig, vfo);
         rig_debug(RIG_DEBUG_TRACE, "%s: rs->current_vfo=%s\n", __func__,
                   rig_strvfo(vfo));
     }
@@ -3545,7 +3568,9 @@ int HAMLIB_API rig_get_vfo(RIG *rig, vfo_t *vfo)
         if (retcode == RIG_OK)
         {
             rs->current_vfo = *vfo;
+            rig_cache_write_begin(rig);
             cachep->vfo = *vfo;
+            rig_cache_write_end(rig);
             //cache_ms = elapsed_ms(&cachep->time_vfo, HAMLIB_ELAPSED_SET);
         }
         else
@@ -3593,7 +3618,6 @@ int HAMLIB_API rig_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
     const struct rig_caps *caps;
     struct rig_state *rs;
     hamlib_port_t *rp, *pttp;
-    struct rig_cache *cachep;
     int retcode = RIG_OK;
 
     if (CHECK_RIG_ARG(rig))
@@ -3607,11 +3631,10 @@ int HAMLIB_API rig_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
 
     caps = rig->caps;
     rs = STATE(rig);
-    cachep = CACHE(rig);
     rp = RIGPORT(rig);
     pttp = PTTPORT(rig);
 
-    LOCK(1);
+    LOCK_PRIO(PTT);
 
     switch (pttp->type.ptt)
     {
@@ -3894,8 +3917,7 @@ int HAMLIB_API rig_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
     // is requested on a rig that can't change freq on a transmitting VFO
     if (ptt != RIG_PTT_ON) { hl_usleep(50 * 1000); }
 
-    cachep->ptt = ptt;
-    elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
+    rig_set_cache_ptt(rig, ptt);
 
     if (retcode != RIG_OK) { rig_debug(RIG_DEBUG_ERR, "%s: Return code=%d\n", __func__, retcode); }
 
@@ -3907,26 +3929,14 @@ int HAMLIB_API rig_set_ptt(RIG *rig, vfo_t vfo, ptt_t ptt)
 }
 
 
-/**
- * \brief get the status of the PTT
- * \param rig   The rig handle
- * \param vfo   The target VFO
- * \param ptt   The location where to store the status of the PTT
- *
- *  Retrieves the status of PTT (are we on the air?).
- *
- * \return RIG_OK if the operation has been successful, otherwise
- * a negative value if an error occurred (in which case, cause is
- * set appropriately).
- *
- * \sa rig_set_ptt()
- */
-int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
+/* rig_get_ptt() proper, see rig_get_freq_direct() */
+static int rig_get_ptt_direct(RIG *rig, vfo_t vfo, ptt_t *ptt)
 {
     const struct rig_caps *caps;
     struct rig_state *rs;
     hamlib_port_t *rp, *pttp;
     struct rig_cache *cachep;
+    struct rig_cache snap;
     int retcode = RIG_OK;
     int status;
     vfo_t curr_vfo;
@@ -3954,13 +3964,14 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
         RETURNFUNC(-RIG_EINVAL);
     }
 
-    cache_ms = elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_GET);
+    rig_cache_snapshot(rig, &snap);
+    cache_ms = elapsed_ms(&snap.time_ptt, HAMLIB_ELAPSED_GET);
     rig_debug(RIG_DEBUG_TRACE, "%s: cache check age=%dms\n", __func__, cache_ms);
 
-    if (cache_ms < cachep->timeout_ms)
+    if (cache_ms < snap.timeout_ms || rs->use_cached_ptt)
     {
         rig_debug(RIG_DEBUG_TRACE, "%s: cache hit age=%dms\n", __func__, cache_ms);
-        *ptt = cachep->ptt;
+        *ptt = snap.ptt;
         ELAPSED2;
         RETURNFUNC(RIG_OK);
     }
@@ -3994,8 +4005,7 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 
             if (retcode == RIG_OK)
             {
-                cachep->ptt = *ptt;
-                elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
+                rig_set_cache_ptt(rig, *ptt);
             }
 
             ELAPSED2;
@@ -4048,8 +4058,7 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
             {
                 /* Return the first error code */
                 retcode = rc2;
-                cachep->ptt = *ptt;
-                elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
+                rig_set_cache_ptt(rig, *ptt);
             }
         }
 
@@ -4066,8 +4075,7 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 
             if (retcode == RIG_OK)
             {
-                elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
-                cachep->ptt = *ptt;
+                rig_set_cache_ptt(rig, *ptt);
             }
 
             LOCK(0);
@@ -4089,8 +4097,7 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
             *ptt = status ? RIG_PTT_ON : RIG_PTT_OFF;
         }
 
-        cachep->ptt = *ptt;
-        elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
+        rig_set_cache_ptt(rig, *ptt);
         ELAPSED2;
         LOCK(0);
         RETURNFUNC(retcode);
@@ -4104,8 +4111,7 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 
             if (retcode == RIG_OK)
             {
-                elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
-                cachep->ptt = *ptt;
+                rig_set_cache_ptt(rig, *ptt);
             }
 
             ELAPSED2;
@@ -4127,8 +4133,7 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
             *ptt = status ? RIG_PTT_ON : RIG_PTT_OFF;
         }
 
-        cachep->ptt = *ptt;
-        elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
+        rig_set_cache_ptt(rig, *ptt);
         ELAPSED2;
         LOCK(0);
         RETURNFUNC(retcode);
@@ -4141,8 +4146,7 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 
             if (retcode == RIG_OK)
             {
-                elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
-                cachep->ptt = *ptt;
+                rig_set_cache_ptt(rig, *ptt);
             }
 
             ELAPSED2;
@@ -4154,8 +4158,7 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 
         if (retcode == RIG_OK)
         {
-            elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
-            cachep->ptt = *ptt;
+            rig_set_cache_ptt(rig, *ptt);
         }
 
         ELAPSED2;
@@ -4170,8 +4173,7 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 
             if (retcode == RIG_OK)
             {
-                elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
-                cachep->ptt = *ptt;
+                rig_set_cache_ptt(rig, *ptt);
             }
 
             ELAPSED2;
@@ -4183,8 +4185,7 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 
         if (retcode == RIG_OK)
         {
-            elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
-            cachep->ptt = *ptt;
+            rig_set_cache_ptt(rig, *ptt);
         }
 
         ELAPSED2;
@@ -4200,8 +4201,7 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
 
             if (retcode == RIG_OK)
             {
-                elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
-                cachep->ptt = *ptt;
+                rig_set_cache_ptt(rig, *ptt);
             }
 
             ELAPSED2;
@@ -4209,7 +4209,9 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
             RETURNFUNC(retcode);
         }
 
+        rig_cache_write_begin(rig);
         elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
+        rig_cache_write_end(rig);
         retcode = gpio_ptt_get(pttp, ptt);
         ELAPSED2;
         LOCK(0);
@@ -4226,13 +4228,53 @@ int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
         RETURNFUNC(-RIG_EINVAL);
     }
 
+    rig_cache_write_begin(rig);
     elapsed_ms(&cachep->time_ptt, HAMLIB_ELAPSED_SET);
+    rig_cache_write_end(rig);
     ELAPSED2;
     LOCK(0);
     RETURNFUNC(RIG_OK);
 }
 
 
+/**
+ * \brief get the status of the PTT
+ * \param rig   The rig handle
+ * \param vfo   The target VFO
+ * \param ptt   The location where to store the status of the PTT
+ *
+ *  Retrieves the status of PTT (are we on the air?).
+ *
+ * \return RIG_OK if the operation has been successful, otherwise
+ * a negative value if an error occurred (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_set_ptt()
+ */
+int HAMLIB_API rig_get_ptt(RIG *rig, vfo_t vfo, ptt_t *ptt)
+{
+    struct rig_flight *flight;
+    struct rig_flight_result result;
+
+    if (CHECK_RIG_ARG(rig) || !ptt)
+    {
+        return rig_get_ptt_direct(rig, vfo, ptt);
+    }
+
+    if (rig_flight_begin(rig, RIG_FLIGHT_PTT, vfo, 0, &flight, &result))
+    {
+        *ptt = result.ptt;
+        return result.retcode;
+    }
+
+    result.retcode = rig_get_ptt_direct(rig, vfo, ptt);
+    result.ptt = *ptt;
+    rig_flight_end(rig, flight, &result);
+
+    return result.retcode;
+}
+
+
 /**
  * \brief get the status of the DCD
  * \param rig   The rig handle
@@ -5848,21 +5890,16 @@ int HAMLIB_API rig_set_split_vfo(RIG *rig,
         {
             // Only update cache on success
             rs->rx_vfo = rs->current_vfo;
-            cachep->split = split;
-
-            if (split == RIG_SPLIT_OFF)
-            {
-                rs->tx_vfo = rs->current_vfo;
-                cachep->split_vfo = rs->current_vfo;
-            }
-            else
-            {
-                rs->tx_vfo = tx_vfo;
-                cachep->split_vfo = tx_vfo;
-            }
+            rs->tx_vfo = split == RIG_SPLIT_OFF ? rs->current_vfo : tx_vfo;
+            rig_set_cache_split(rig, split, rs->tx_vfo);
+        }
+        else
+        {
+            rig_cache_write_begin(rig);
+            elapsed_ms(&cachep->time_split, HAMLIB_ELAPSED_SET);
+            rig_cache_write_end(rig);
         }
 
-        elapsed_ms(&cachep->time_split, HAMLIB_ELAPSED_SET);
         ELAPSED2;
         RETURNFUNC(retcode);
     }
@@ -5907,32 +5944,34 @@ int HAMLIB_API rig_set_split_vfo(RIG *rig,
     if (retcode == RIG_OK)
     {
         // Only update cache on success
-        cachep->split = split;
-
         if (split == RIG_SPLIT_OFF)
         {
             if (caps->targetable_vfo & RIG_TARGETABLE_FREQ)
             {
                 rs->rx_vfo = rx_vfo;
                 rs->tx_vfo = rx_vfo;
-                cachep->split_vfo = rx_vfo;
             }
             else
             {
                 rs->rx_vfo = rs->current_vfo;
                 rs->tx_vfo = rs->current_vfo;
-                cachep->split_vfo = rs->current_vfo;
             }
         }
         else
         {
             rs->rx_vfo = rx_vfo;
             rs->tx_vfo = tx_vfo;
-            cachep->split_vfo = tx_vfo;
         }
+
+        rig_set_cache_split(rig, split, rs->tx_vfo);
+    }
+    else
+    {
+        rig_cache_write_begin(rig);
+        elapsed_ms(&cachep->time_split, HAMLIB_ELAPSED_SET);
+        rig_cache_write_end(rig);
     }
 
-    elapsed_ms(&cachep->time_split, HAMLIB_ELAPSED_SET);
     ELAPSED2;
     RETURNFUNC(retcode);
 }
@@ -5960,7 +5999,7 @@ int HAMLIB_API rig_get_split_vfo(RIG *rig,
 {
     const struct rig_caps *caps;
     struct rig_state *rs;
-    struct rig_cache *cachep;
+    struct rig_cache snap;
     int retcode;
     int cache_ms;
     bool use_cache;
@@ -5984,7 +6023,7 @@ int HAMLIB_API rig_get_split_vfo(RIG *rig,
 
     caps = rig->caps;
     rs = STATE(rig);
-    cachep = CACHE(rig);
+    rig_cache_snapshot(rig, &snap);
 
     // See comments in rig_get_freq
     use_cache = morse_busy_load(rs);
@@ -5994,19 +6033,19 @@ int HAMLIB_API rig_get_split_vfo(RIG *rig,
         rig_debug(RIG_DEBUG_TRACE, "%s: ?get_split_vfo=%d use_cache=%d\n", __func__,
                   caps->get_split_vfo != NULL, use_cache);
         // if we can't get the vfo we will return whatever we have cached
-        *split = cachep->split;
-        *tx_vfo = cachep->split_vfo;
+        *split = snap.split;
+        *tx_vfo = snap.split_vfo;
         ELAPSED2;
         RETURNFUNC(RIG_OK);
     }
 
-    cache_ms = elapsed_ms(&cachep->time_split, HAMLIB_ELAPSED_GET);
+    cache_ms = elapsed_ms(&snap.time_split, HAMLIB_ELAPSED_GET);
     rig_debug(RIG_DEBUG_TRACE, "%s: cache check age=%dms\n", __func__, cache_ms);
 
-    if (cache_ms < cachep->timeout_ms)
+    if (cache_ms < snap.timeout_ms)
     {
-        *split = cachep->split;
-        *tx_vfo = cachep->split_vfo;
+        *split = snap.split;
+        *tx_vfo = snap.split_vfo;
         rig_debug(RIG_DEBUG_TRACE, "%s: cache hit age=%dms, split=%d, tx_vfo=%s\n",
                   __func__, cache_ms, *split, rig_strvfo(*tx_vfo));
         ELAPSED2;
@@ -6024,11 +6063,9 @@ int HAMLIB_API rig_get_split_vfo(RIG *rig,
     {
         // Only update cache on success
         rs->tx_vfo = *tx_vfo;
-        cachep->split = *split;
-        cachep->split_vfo = *tx_vfo;
-        elapsed_ms(&cachep->time_split, HAMLIB_ELAPSED_SET);
+        rig_set_cache_split(rig, *split, *tx_vfo);
         rig_debug(RIG_DEBUG_TRACE, "%s(%d): cache.split=%d\n", __func__, __LINE__,
-                  cachep->split);
+                  *split);
     }
 
     ELAPSED2;
@@ -6071,17 +6108,23 @@ int HAMLIB_API rig_set_rit(RIG *rig, vfo_t vfo, shortfreq_t rit)
         RETURNFUNC(-RIG_ENAVAIL);
     }
 
+    LOCK_PRIO(SET);
+
     if ((caps->targetable_vfo & RIG_TARGETABLE_RITXIT)
             || vfo == RIG_VFO_CURR
             || vfo == STATE(rig)->current_vfo)
     {
         HAMLIB_TRACE;
         retcode = caps->set_rit(rig, vfo, rit);
+        // after the set, a get in between would cache the old value again
+        rig_cache_invalidate_item(rig, HAMLIB_CACHE_RIT, vfo, 0);
+        LOCK(0);
         RETURNFUNC(retcode);
     }
 
     if (!caps->set_vfo)
     {
+        LOCK(0);
         RETURNFUNC(-RIG_ENAVAIL);
     }
 
@@ -6091,10 +6134,12 @@ int HAMLIB_API rig_set_rit(RIG *rig, vfo_t vfo, shortfreq_t rit)
 
     if (retcode != RIG_OK)
     {
+        LOCK(0);
         RETURNFUNC(retcode);
     }
 
     retcode = caps->set_rit(rig, vfo, rit);
+    rig_cache_invalidate_item(rig, HAMLIB_CACHE_RIT, vfo, 0);
     /* try and revert even if we had an error above */
     rc2 = caps->set_vfo(rig, curr_vfo);
 
@@ -6104,6 +6149,7 @@ int HAMLIB_API rig_set_rit(RIG *rig, vfo_t vfo, shortfreq_t rit)
         retcode = rc2;
     }
 
+    LOCK(0);
     RETURNFUNC(retcode);
 }
 
@@ -6127,6 +6173,7 @@ int HAMLIB_API rig_get_rit(RIG *rig, vfo_t vfo, shortfreq_t *rit)
     const struct rig_caps *caps;
     int retcode, rc2;
     vfo_t curr_vfo;
+    value_t cached;
 
     if (CHECK_RIG_ARG(rig))
     {
@@ -6148,17 +6195,34 @@ int HAMLIB_API rig_get_rit(RIG *rig, vfo_t vfo, shortfreq_t *rit)
         RETURNFUNC(-RIG_ENAVAIL);
     }
 
+    if (rig_cache_get_item(rig, HAMLIB_CACHE_RIT, vfo, 0, &cached) == RIG_OK)
+    {
+        *rit = cached.i;
+        RETURNFUNC(RIG_OK);
+    }
+
+    LOCK(1);
+
     if ((caps->targetable_vfo & RIG_TARGETABLE_RITXIT)
             || vfo == RIG_VFO_CURR
             || vfo == STATE(rig)->current_vfo)
     {
         HAMLIB_TRACE;
         retcode = caps->get_rit(rig, vfo, rit);
+
+        if (retcode == RIG_OK)
+        {
+            cached.i = *rit;
+            rig_cache_set_item(rig, HAMLIB_CACHE_RIT, vfo, 0, cached);
+        }
+
+        LOCK(0);
         RETURNFUNC(retcode);
     }
 
     if (!caps->set_vfo)
     {
+        LOCK(0);
         RETURNFUNC(-RIG_ENAVAIL);
     }
 
@@ -6168,6 +6232,7 @@ int HAMLIB_API rig_get_rit(RIG *rig, vfo_t vfo, shortfreq_t *rit)
 
     if (retcode != RIG_OK)
     {
+        LOCK(0);
         RETURNFUNC(retcode);
     }
 
@@ -6178,10 +6243,13 @@ int HAMLIB_API rig_get_rit(RIG *rig, vfo_t vfo, shortfreq_t *rit)
 
     if (RIG_OK == retcode)
     {
+        cached.i = *rit;
+        rig_cache_set_item(rig, HAMLIB_CACHE_RIT, vfo, 0, cached);
         /* Return the first error code */
         retcode = rc2;
     }
 
+    LOCK(0);
     RETURNFUNC(retcode);
 }
 
@@ -6221,17 +6289,23 @@ int HAMLIB_API rig_set_xit(RIG *rig, vfo_t vfo, shortfreq_t xit)
         RETURNFUNC(-RIG_ENAVAIL);
     }
 
+    LOCK_PRIO(SET);
+
     if ((caps->targetable_vfo & RIG_TARGETABLE_RITXIT)
             || vfo == RIG_VFO_CURR
             || vfo == STATE(rig)->current_vfo)
     {
         HAMLIB_TRACE;
         retcode = caps->set_xit(rig, vfo, xit);
+        // after the set, a get in between would cache the old value again
+        rig_cache_invalidate_item(rig, HAMLIB_CACHE_XIT, vfo, 0);
+        LOCK(0);
         RETURNFUNC(retcode);
     }
 
     if (!caps->set_vfo)
     {
+        LOCK(0);
         RETURNFUNC(-RIG_ENAVAIL);
     }
 
@@ -6241,10 +6315,12 @@ int HAMLIB_API rig_set_xit(RIG *rig, vfo_t vfo, shortfreq_t xit)
 
     if (retcode != RIG_OK)
     {
+        LOCK(0);
         RETURNFUNC(retcode);
     }
 
     retcode = caps->set_xit(rig, vfo, xit);
+    rig_cache_invalidate_item(rig, HAMLIB_CACHE_XIT, vfo, 0);
     /* try and revert even if we had an error above */
     rc2 = caps->set_vfo(rig, curr_vfo);
 
@@ -6254,6 +6330,7 @@ int HAMLIB_API rig_set_xit(RIG *rig, vfo_t vfo, shortfreq_t xit)
         retcode = rc2;
     }
 
+    LOCK(0);
     RETURNFUNC(retcode);
 }
 
@@ -6277,6 +6354,7 @@ int HAMLIB_API rig_get_xit(RIG *rig, vfo_t vfo, shortfreq_t *xit)
     const struct rig_caps *caps;
     int retcode, rc2;
     vfo_t curr_vfo;
+    value_t cached;
 
     if (CHECK_RIG_ARG(rig))
     {
@@ -6298,17 +6376,34 @@ int HAMLIB_API rig_get_xit(RIG *rig, vfo_t vfo, shortfreq_t *xit)
         RETURNFUNC(-RIG_ENAVAIL);
     }
 
+    if (rig_cache_get_item(rig, HAMLIB_CACHE_XIT, vfo, 0, &cached) == RIG_OK)
+    {
+        *xit = cached.i;
+        RETURNFUNC(RIG_OK);
+    }
+
+    LOCK(1);
+
     if ((caps->targetable_vfo & RIG_TARGETABLE_RITXIT)
             || vfo == RIG_VFO_CURR
             || vfo == STATE(rig)->current_vfo)
     {
         HAMLIB_TRACE;
         retcode = caps->get_xit(rig, vfo, xit);
+
+        if (retcode == RIG_OK)
+        {
+            cached.i = *xit;
+            rig_cache_set_item(rig, HAMLIB_CACHE_XIT, vfo, 0, cached);
+        }
+
+        LOCK(0);
         RETURNFUNC(retcode);
     }
 
     if (!caps->set_vfo)
     {
+        LOCK(0);
         RETURNFUNC(-RIG_ENAVAIL);
     }
 
@@ -6318,6 +6413,7 @@ int HAMLIB_API rig_get_xit(RIG *rig, vfo_t vfo, shortfreq_t *xit)
 
     if (retcode != RIG_OK)
     {
+        LOCK(0);
         RETURNFUNC(retcode);
     }
 
@@ -6328,10 +6424,13 @@ int HAMLIB_API rig_get_xit(RIG *rig, vfo_t vfo, shortfreq_t *xit)
 
     if (RIG_OK == retcode)
     {
+        cached.i = *xit;
+        rig_cache_set_item(rig, HAMLIB_CACHE_XIT, vfo, 0, cached);
         /* Return the first error code */
         retcode = rc2;
     }
 
+    LOCK(0);
     RETURNFUNC(retcode);
 }
 
@@ -6525,17 +6624,23 @@ int HAMLIB_API rig_set_ant(RIG *rig, vfo_t vfo, ant_t ant, value_t option)
         RETURNFUNC(-RIG_ENAVAIL);
     }
 
+    LOCK_PRIO(SET);
+
     if ((caps->targetable_vfo & RIG_TARGETABLE_ANT)
             || vfo == RIG_VFO_CURR
             || vfo == STATE(rig)->current_vfo)
     {
         HAMLIB_TRACE;
         retcode = caps->set_ant(rig, vfo, ant, option);
+        // after the set, a get in between would cache the old value again
+        rig_cache_invalidate_item(rig, HAMLIB_CACHE_ANT, vfo, 0);
+        LOCK(0);
         RETURNFUNC(retcode);
     }
 
     if (!caps->set_vfo)
     {
+        LOCK(0);
         RETURNFUNC(-RIG_ENAVAIL);
     }
 
@@ -6545,11 +6650,13 @@ int HAMLIB_API rig_set_ant(RIG *rig, vfo_t vfo, ant_t ant, value_t option)
 
     if (retcode != RIG_OK)
     {
+        LOCK(0);
         RETURNFUNC(retcode);
     }
 
     HAMLIB_TRACE;
     retcode = caps->set_ant(rig, vfo, ant, option);
+    rig_cache_invalidate_item(rig, HAMLIB_CACHE_ANT, vfo, 0);
     /* try and revert even if we had an error above */
     rc2 = caps->set_vfo(rig, curr_vfo);
 
@@ -6559,6 +6666,7 @@ int HAMLIB_API rig_set_ant(RIG *rig, vfo_t vfo, ant_t ant, value_t option)
         retcode = rc2;
     }
 
+    LOCK(0);
     RETURNFUNC(retcode);
 }
 
@@ -6614,22 +6722,38 @@ int HAMLIB_API rig_get_ant(RIG *rig, vfo_t vfo, ant_t ant, value_t *option,
         RETURNFUNC(-RIG_ENAVAIL);
     }
 
+    if (rig_cache_get_ant(rig, vfo, ant, option, ant_curr, ant_tx,
+                          ant_rx) == RIG_OK)
+    {
+        RETURNFUNC(RIG_OK);
+    }
+
     /* Set antenna default to unknown and clear option.
      * So we have sane defaults for all backends */
     *ant_tx = *ant_rx = *ant_curr = RIG_ANT_UNKNOWN;
     option->i = 0;
 
+    LOCK(1);
+
     if ((caps->targetable_vfo & RIG_TARGETABLE_ANT)
             || vfo == RIG_VFO_CURR
             || vfo == STATE(rig)->current_vfo)
     {
         HAMLIB_TRACE;
         retcode = caps->get_ant(rig, vfo, ant, option, ant_curr, ant_tx, ant_rx);
+
+        if (retcode == RIG_OK)
+        {
+            rig_cache_set_ant(rig, vfo, ant, *option, *ant_curr, *ant_tx, *ant_rx);
+        }
+
+        LOCK(0);
         RETURNFUNC(retcode);
     }
 
     if (!caps->set_vfo)
     {
+        LOCK(0);
         RETURNFUNC(-RIG_ENAVAIL);
     }
 
@@ -6639,6 +6763,7 @@ int HAMLIB_API rig_get_ant(RIG *rig, vfo_t vfo, ant_t ant, value_t *option,
 
     if (retcode != RIG_OK)
     {
+        LOCK(0);
         RETURNFUNC(retcode);
     }
 
@@ -6649,10 +6774,12 @@ int HAMLIB_API rig_get_ant(RIG *rig, vfo_t vfo, ant_t ant, value_t *option,
 
     if (RIG_OK == retcode)
     {
+        rig_cache_set_ant(rig, vfo, ant, *option, *ant_curr, *ant_tx, *ant_rx);
         /* Return the first error code */
         retcode = rc2;
     }
 
+    LOCK(0);
     RETURNFUNC(retcode);
 }
 
@@ -6992,6 +7119,10 @@ extern int rig_probe_first(hamlib_port_t *p);
 extern int rig_probe_all_backends(hamlib_port_t *p,
                                   rig_probe_func_t cfunc,
                                   rig_ptr_t data);
+
+extern int rig_probe_ports_backends(const char *const pathnames[], int count,
+                                    int budget_ms, rig_probe_func_t cfunc,
+                                    rig_ptr_t data);
 //! @endcond
 
 
@@ -7016,6 +7147,9 @@ rig_model_t HAMLIB_API rig_probe(hamlib_port_t *port)
         return (RIG_MODEL_NONE);
     }
 
+    /* only rig_probe_ports() gives its ports a deadline */
+    port->deadline_ns = 0;
+
     return rig_probe_first(port);
 }
 
@@ -7046,10 +7180,48 @@ int HAMLIB_API rig_probe_all(hamlib_port_t *port,
         return (-RIG_EINVAL);
     }
 
+    port->deadline_ns = 0;
+
     return rig_probe_all_backends(port, cfunc, data);
 }
 
 
+/**
+ * \brief probe several serial ports at once
+ * \param pathnames Serial device names, e.g. "/dev/ttyUSB0"
+ * \param count     Number of entries in \a pathnames
+ * \param budget_ms Overall time limit in milliseconds, 0 for none
+ * \param cfunc     Function called once for each port
+ * \param data      Arbitrary data passed to cfunc
+ *
+ *  Each port is probed in its own thread, so the time taken is that of
+ *  the slowest port rather than the sum of all of them.  Backends are
+ *  tried in an order that puts the quick single-command probes first.
+ *
+ *  \a cfunc is called once per port, from one thread at a time, with the
+ *  model found or RIG_MODEL_NONE.  The budget also cuts short every read
+ *  of the probes, so a port still being probed when it runs out is given
+ *  up on and reported as RIG_MODEL_NONE.  All the threads have exited
+ *  when this returns.
+ *
+ * \return the number of ports a rig was found on, otherwise a negative
+ * value if an error occurred.
+ */
+int HAMLIB_API rig_probe_ports(const char *const pathnames[],
+                               int count,
+                               int budget_ms,
+                               rig_probe_func_t cfunc,
+                               rig_ptr_t data)
+{
+    if (!pathnames || count <= 0)
+    {
+        return (-RIG_EINVAL);
+    }
+
+    return rig_probe_ports_backends(pathnames, count, budget_ms, cfunc, data);
+}
+
+
 /**
  * \brief check retrieval ability of VFO operations
  * \param rig   The rig handle
@@ -7485,7 +7657,7 @@ int HAMLIB_API rig_send_morse(RIG *rig, vfo_t vfo, const char *msg)
             || vfo == rs->current_vfo)
     {
 #if 0
-        LOCK(1);
+        LOCK_PRIO(PTT);
         retcode = caps->send_morse(rig, vfo, msg);
         LOCK(0);
 #else
@@ -7558,7 +7730,7 @@ int HAMLIB_API rig_stop_morse(RIG *rig, vfo_t vfo)
 
     resetFIFO(rs->fifo_morse); // clear out the CW queue
 
-    LOCK(1);
+    LOCK_PRIO(PTT);
     if (vfo == RIG_VFO_CURR
             || vfo == rs->current_vfo)
     {
@@ -7618,7 +7790,9 @@ static int wait_morse_ptt(RIG *rig, vfo_t vfo)
         int retval;
         rig_debug(RIG_DEBUG_TRACE, "%s: loop#%d until ptt=0, ptt=%d\n", __func__, loops,
                   pttStatus);
+        rig_cache_write_begin(rig);
         elapsed_ms(&CACHE(rig)->time_ptt, HAMLIB_ELAPSED_INVALIDATE);
+        rig_cache_write_end(rig);
         HAMLIB_TRACE;
         retval = rig_get_ptt(rig, vfo, &pttStatus);
 
@@ -8107,7 +8281,7 @@ int HAMLIB_API rig_get_vfo_info(RIG *rig, vfo_t vfo, freq_t *freq,
     int allTheTimeB = (vfo & (RIG_VFO_B | RIG_VFO_SUB))
                       && (rig->caps->targetable_vfo & RIG_TARGETABLE_MODE);
     int justOnceB = (vfo & (RIG_VFO_B | RIG_VFO_SUB))
-                    && (cachep->modeMainB == RIG_MODE_NONE);
+                    && (cachep->slot[CACHE_SLOT_MAIN_B].mode == RIG_MODE_NONE);
 
     if (allTheTimeA || allTheTimeB || justOnceB)
     {
@@ -8122,8 +8296,8 @@ int HAMLIB_API rig_get_vfo_info(RIG *rig, vfo_t vfo, freq_t *freq,
     }
     else // we'll just us VFOA so we don't swap vfos -- freq is what's important
     {
-        *mode = cachep->modeMainA;
-        *width = cachep->widthMainA;
+        *mode = cachep->slot[CACHE_SLOT_MAIN_A].mode;
+        *width = cachep->slot[CACHE_SLOT_MAIN_A].width;
     }
 
     *satmode = cachep->satmode;
@@ -8142,6 +8316,137 @@ int HAMLIB_API rig_get_vfo_info(RIG *rig, vfo_t vfo, freq_t *freq,
     RETURNFUNC(RIG_OK);
 }
 
+/**
+ * \brief get freq, mode, PTT and split of a VFO at once
+ * \param rig   The rig handle
+ * \param vfo   The VFO to get
+ * \param status The values are stored here
+ *
+ *  Gets the operating state of a VFO with as few round trips to the rig as
+ *  it allows.  Backends with a get_status() hook read everything one status
+ *  reply holds (e.g. the Kenwood and Yaesu IF answers) and the whole reply
+ *  goes into the cache at once; whatever it lacks, and everything for
+ *  other backends, is read with rig_get_freq(), rig_get_mode(),
+ *  rig_get_ptt() and rig_get_split_vfo(), which may answer from the cache.
+ *
+ *  Freq and mode are always returned.  When the rig does not report the
+ *  width along with the mode, \a width is the last one read for that mode,
+ *  or the normal passband.  PTT and split are skipped if the rig can't
+ *  read them.  \a status->valid tells which fields are set.
+ *
+ * \return RIG_OK if the operation has been successful, otherwise
+ * a negative value if an error occurred (in which case use rigerror(return)
+ * for error message).
+ *
+ * \sa rig_get_vfo_info()
+ */
+int HAMLIB_API rig_get_status(RIG *rig, vfo_t vfo,
+                              struct rig_vfo_status *status)
+{
+    const struct rig_caps *caps;
+    struct rig_cache *cachep;
+    int retval;
+
+    if (CHECK_RIG_ARG(rig))
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: rig or rig->caps is null\n", __func__);
+        return -RIG_EINVAL;
+    }
+
+    ENTERFUNC;
+    ELAPSED1;
+
+    if (!status)
+    {
+        ELAPSED2;
+        RETURNFUNC(-RIG_EINVAL);
+    }
+
+    caps = rig->caps;
+    cachep = CACHE(rig);
+
+    memset(status, 0, sizeof(*status));
+    vfo = vfo_fixup(rig, vfo, cachep->split);
+
+    if (vfo == RIG_VFO_CURR) { vfo = STATE(rig)->current_vfo; }
+
+    if (caps->get_status)
+    {
+        status->vfo = vfo;
+        LOCK(1);
+        HAMLIB_TRACE;
+        retval = caps->get_status(rig, vfo, status);
+        LOCK(0);
+
+        if (retval == RIG_OK)
+        {
+            rig_set_cache_status(rig, status);
+        }
+        else
+        {
+            rig_debug(RIG_DEBUG_VERBOSE, "%s: get_status failed: %s\n", __func__,
+                      rigerror2(retval));
+            status->valid = 0;
+        }
+    }
+
+    status->vfo = vfo;
+
+    if (!(status->valid & RIG_VFO_STATUS_FREQ))
+    {
+        retval = rig_get_freq(rig, vfo, &status->freq);
+
+        if (retval != RIG_OK)
+        {
+            ELAPSED2;
+            RETURNFUNC(retval);
+        }
+
+        status->valid |= RIG_VFO_STATUS_FREQ;
+    }
+
+    if (!(status->valid & RIG_VFO_STATUS_MODE))
+    {
+        retval = rig_get_mode(rig, vfo, &status->mode, &status->width);
+
+        if (retval != RIG_OK)
+        {
+            ELAPSED2;
+            RETURNFUNC(retval);
+        }
+
+        status->valid |= RIG_VFO_STATUS_MODE | RIG_VFO_STATUS_WIDTH;
+    }
+    else if (!(status->valid & RIG_VFO_STATUS_WIDTH))
+    {
+        freq_t freq;
+        rmode_t mode;
+        pbwidth_t width;
+        int cache_ms_freq, cache_ms_mode, cache_ms_width;
+
+        rig_get_cache(rig, vfo, &freq, &cache_ms_freq, &mode, &cache_ms_mode,
+                      &width, &cache_ms_width);
+        status->width = (mode == status->mode && width > 0) ? width :
+                        rig_passband_normal(rig, status->mode);
+    }
+
+    if (!(status->valid & RIG_VFO_STATUS_PTT)
+            && rig_get_ptt(rig, RIG_VFO_CURR, &status->ptt) == RIG_OK)
+    {
+        status->valid |= RIG_VFO_STATUS_PTT;
+    }
+
+    if (!(status->valid & RIG_VFO_STATUS_SPLIT)
+            && rig_get_split_vfo(rig, RIG_VFO_CURR, &status->split,
+                                 &status->tx_vfo) == RIG_OK)
+    {
+        status->valid |= RIG_VFO_STATUS_SPLIT;
+    }
+
+    ELAPSED2;
+    RETURNFUNC(RIG_OK);
+}
+
 /**
  * \brief get list of available vfos
  * \param rig   The rig handle
@@ -8407,22 +8712,29 @@ HAMLIB_EXPORT(void) sync_callback(int lock)
 }
 #endif
 
-void rig_lock(RIG *rig, int lock)
+/*
+ * Take the rig with an explicit priority, release with rig_lock(rig, 0).
+ * rig_lock(rig, 1) uses the priority of the calling thread.
+ */
+void rig_lock_prio(RIG *rig, rig_prio_t prio)
 {
+    rig_prio_lock(rig, prio);
+    rig_flight_api_lock(rig, 1);
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: client lock engaged\n", __func__);
+}
 
-    struct rig_state *rs = STATE(rig);
-
+void rig_lock(RIG *rig, int lock)
+{
     if (lock)
     {
-        pthread_mutex_lock(&rs->api_mutex);
-        rig_debug(RIG_DEBUG_VERBOSE, "%s: client lock engaged\n", __func__);
+        rig_lock_prio(rig, rig_prio_thread());
     }
     else
     {
         rig_debug(RIG_DEBUG_VERBOSE, "%s: client lock disengaged\n", __func__);
-        pthread_mutex_unlock(&rs->api_mutex);
+        rig_flight_api_lock(rig, 0);
+        rig_prio_unlock(rig);
     }
-
 }
 
 
@@ -8470,6 +8782,10 @@ static int async_data_handler_start(RIG *rig)
         RETURNFUNC(-RIG_EINTERNAL);
     }
 
+    // replies now come through the sync data pipe, also for a backend
+    // that opened the rig talking to the port itself
+    RIGPORT(rig)->asyncio = 1;
+
     RETURNFUNC(RIG_OK);
 }
 
@@ -8547,6 +8863,9 @@ static int async_data_handler_stop(RIG *rig)
         rs->async_data_handler_priv_data = NULL;
     }
 
+    // nothing pushes PTT changes any more
+    rs->use_cached_ptt = 0;
+
 
     RETURNFUNC(RIG_OK);
 }
@@ -8616,8 +8935,7 @@ static void *async_data_handler(void *arg)
     rig_debug(RIG_DEBUG_VERBOSE, "%s: Starting async data handler thread\n",
               __func__);
 
-    // TODO: check how to enable "transceive" on recent Kenwood/Yaesu rigs
-    // TODO: add initial support for async in Kenwood kenwood_transaction (+one) functions -> add transaction_active flag usage
+    // TODO: check how to enable "transceive" on recent Yaesu rigs
     // TODO: add initial support for async in Yaesu newcat_get_cmd/set_cmd (+validate) functions -> add transaction_active flag usage
 
     while (rs->async_data_handler_thread_run)
@@ -8795,7 +9113,7 @@ static void *morse_data_handler(void *arg)
                 int nloops = 10;
 
                 morse_busy_store(rs, true);
-                rig_lock(rig, 1);        // Do the actual lockout
+                rig_lock_prio(rig, RIG_PRIO_PTT); // Do the actual lockout
 
                 do
                 {
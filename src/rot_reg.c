@@ -34,8 +34,10 @@
 #include <stdio.h>
 
 #include "hamlib/rotator.h"
+#include "hamlib/port.h"
 
 #include "register.h"
+#include "model_list.h"
 
 //! @cond Doxygen_Suppress
 #ifndef PATH_MAX
@@ -158,43 +160,23 @@ static struct
 
 
 /*
- * This struct to keep track of known rot models.
- * It is chained, and used in a hash table, see below.
+ * Registered rot caps, sorted by model, see model_list.c.
  */
-//! @cond Doxygen_Suppress
-struct rot_list
-{
-    const struct rot_caps *caps;
-    struct rot_list *next;
-};
-//! @endcond
+static struct model_list rot_models = MODEL_LIST_INITIALIZER;
 
-
-//! @cond Doxygen_Suppress
-#define ROTLSTHASHSZ 16
-#define HASH_FUNC(a) ((a)%ROTLSTHASHSZ)
-//! @endcond
-
-
-/*
- * The rot_hash_table is a hash table pointing to a list of next==NULL
- *  terminated caps.
- */
-static struct rot_list *rot_hash_table[ROTLSTHASHSZ] = { NULL, };
+/* Backends whose init has run, by rot_backend_list index */
+static char rot_backend_loaded[ROT_BACKEND_MAX];
 
 
 static int rot_lookup_backend(rot_model_t rot_model);
 
 
 /*
- * Basically, this is a hash insert function that doesn't check for dup!
+ * Add caps to the registry, a model can only be registered once.
  */
 //! @cond Doxygen_Suppress
 int HAMLIB_API rot_register(const struct rot_caps *caps)
 {
-    int hval;
-    struct rot_list *p;
-
     if (!caps)
     {
         return -RIG_EINVAL;
@@ -202,51 +184,19 @@ int HAMLIB_API rot_register(const struct rot_caps *caps)
 
     rot_debug(RIG_DEBUG_VERBOSE, "rot_register (%d)\n", caps->rot_model);
 
-#ifndef DONT_WANT_DUP_CHECK
-
-    if (rot_get_caps(caps->rot_model) != NULL)
-    {
-        return -RIG_EINVAL;
-    }
-
-#endif
-
-    p = (struct rot_list *)calloc(1, sizeof(struct rot_list));
-
-    if (!p)
-    {
-        return -RIG_ENOMEM;
-    }
-
-    hval = HASH_FUNC(caps->rot_model);
-    p->caps = caps;
-    // p->handle = NULL;
-    p->next = rot_hash_table[hval];
-    rot_hash_table[hval] = p;
-
-    return RIG_OK;
+    return model_list_add(&rot_models, caps->rot_model, caps);
 }
 //! @endcond
 
 
 /*
  * Get rot capabilities.
- * i.e. rot_hash_table lookup
+ * i.e. registry lookup
  */
 //! @cond Doxygen_Suppress
 const struct rot_caps *HAMLIB_API rot_get_caps(rot_model_t rot_model)
 {
-    struct rot_list *p;
-
-    for (p = rot_hash_table[HASH_FUNC(rot_model)]; p; p = p->next)
-    {
-        if (p->caps->rot_model == rot_model)
-        {
-            return p->caps;
-        }
-    }
-
-    return NULL;    /* sorry, caps not registered! */
+    return model_list_find(&rot_models, rot_model);
 }
 //! @endcond
 
@@ -310,6 +260,11 @@ int HAMLIB_API rot_check_backend(rot_model_t rot_model)
         return -RIG_ENAVAIL;
     }
 
+    if (rot_backend_loaded[be_idx])
+    {
+        return -RIG_ENAVAIL;
+    }
+
     retval = rot_load_backend(rot_backend_list[be_idx].be_name);
 
     return retval;
@@ -320,47 +275,22 @@ int HAMLIB_API rot_check_backend(rot_model_t rot_model)
 //! @cond Doxygen_Suppress
 int HAMLIB_API rot_unregister(rot_model_t rot_model)
 {
-    int hval;
-    struct rot_list *p, *q;
-
-    hval = HASH_FUNC(rot_model);
-    q = NULL;
-
-    for (p = rot_hash_table[hval]; p; p = p->next)
-    {
-        if (p->caps->rot_model == rot_model)
-        {
-            if (q == NULL)
-            {
-                rot_hash_table[hval] = p->next;
-            }
-            else
-            {
-                q->next = p->next;
-            }
-
-            free(p);
-            return RIG_OK;
-        }
-
-        q = p;
-    }
-
-    return -RIG_EINVAL; /* sorry, caps not registered! */
+    return model_list_remove(&rot_models, rot_model);
 }
 //! @endcond
 
 
 /*
  * rot_list_foreach
- * executes cfunc on all the elements stored in the rot hash list
+ * executes cfunc on the caps registered when it starts, in model order
  */
 //! @cond Doxygen_Suppress
 int HAMLIB_API rot_list_foreach(int (*cfunc)(const struct rot_caps *,
                                 rig_ptr_t),
                                 rig_ptr_t data)
 {
-    struct rot_list *p;
+    struct model_list_entry *models;
+    int count;
     int i;
 
     if (!cfunc)
@@ -368,16 +298,19 @@ int HAMLIB_API rot_list_foreach(int (*cfunc)(const struct rot_caps *,
         return -RIG_EINVAL;
     }
 
-    for (i = 0; i < ROTLSTHASHSZ; i++)
+    count = model_list_snapshot(&rot_models, &models);
+
+    for (i = 0; i < count; i++)
     {
-        for (p = rot_hash_table[i]; p; p = p->next)
-            if ((*cfunc)(p->caps, data) == 0)
-            {
-                return RIG_OK;
-            }
+        /* skip what cfunc unregistered on the way */
+        if (model_list_find(&rot_models, models[i].model) != models[i].caps) { continue; }
+
+        if ((*cfunc)(models[i].caps, data) == 0) { break; }
     }
 
-    return RIG_OK;
+    free(models);
+
+    return count < 0 ? count : RIG_OK;
 }
 //! @endcond
 
@@ -392,6 +325,8 @@ rot_model_t HAMLIB_API rot_probe_all(hamlib_port_t *p)
     int i;
     rot_model_t rot_model;
 
+    p->deadline_ns = 0;
+
     for (i = 0; i < ROT_BACKEND_MAX && rot_backend_list[i].be_name; i++)
     {
         if (rot_backend_list[i].be_probe)
@@ -448,7 +383,18 @@ int HAMLIB_API rot_load_backend(const char *be_name)
                 return -RIG_EINVAL;
             }
 
+            if (rot_backend_loaded[i])
+            {
+                return RIG_OK;
+            }
+
             status = (*be_init)(NULL);
+
+            if (status == RIG_OK)
+            {
+                rot_backend_loaded[i] = 1;
+            }
+
             return status;
         }
     }
@@ -73,6 +73,7 @@
 //! @endcond
 
 #include "serial.h"
+#include "iofunc.h"
 #include "misc.h"
 
 #ifdef HAVE_SYS_IOCCOM_H
@@ -248,6 +249,14 @@ int HAMLIB_API serial_open(hamlib_port_t *rp)
 
     rig_debug(RIG_DEBUG_VERBOSE, "%s: %s\n", __func__, rp->pathname);
 
+    /*
+     * backend probes open a port of the caller's without port_open(), once
+     * per baud rate, so nothing read ahead before may carry over
+     */
+    rp->next_write_us = 0;
+    port_rxbuf_discard(rp, 1);
+    port_rxbuf_discard(rp, 0);
+
     if (!strncmp(rp->pathname, "uh-rig", 6))
     {
         /*
@@ -824,6 +833,12 @@ int HAMLIB_API serial_flush(hamlib_port_t *p)
     short timeout_retry_save;
     unsigned char buf[4096];
 
+    // data read ahead by read_string() is as stale as what is still queued
+    if (!p->asyncio)
+    {
+        port_rxbuf_discard(p, 1);
+    }
+
 #ifdef __WIN32__
     struct termios_list *index;
     index = win32_serial_find_port(p->fd);
@@ -45,6 +45,7 @@
 #include "hamlib/rig_state.h"
 #include "cal.h"
 #include "misc.h"
+#include "cache.h"
 
 
 #ifndef DOC_HIDDEN
@@ -91,7 +92,7 @@ int HAMLIB_API rig_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val)
         return -RIG_ENAVAIL;
     }
 
-    rig_lock(rig, 1);
+    rig_lock_prio(rig, RIG_PRIO_SET);
     if ((caps->targetable_vfo & RIG_TARGETABLE_LEVEL)
             || vfo == RIG_VFO_CURR
             || vfo == STATE(rig)->current_vfo)
@@ -104,6 +105,9 @@ int HAMLIB_API rig_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val)
         }
 
         retcode = caps->set_level(rig, vfo, level, val);
+        // the rig may round the value, so read it back next time; only
+        // after the set, a get in between would cache the old value again
+        rig_cache_invalidate_item(rig, HAMLIB_CACHE_LEVEL, vfo, level);
         rig_lock(rig, 0);
         return retcode;
     }
@@ -124,37 +128,19 @@ int HAMLIB_API rig_set_level(RIG *rig, vfo_t vfo, setting_t level, value_t val)
     }
 
     retcode = caps->set_level(rig, vfo, level, val);
+    rig_cache_invalidate_item(rig, HAMLIB_CACHE_LEVEL, vfo, level);
     caps->set_vfo(rig, curr_vfo);
     rig_lock(rig, 0);
     return retcode;
 }
 
 
-/**
- * \brief get the value of a level
- * \param rig   The rig handle
- * \param vfo   The target VFO
- * \param level The level setting
- * \param val   The location where to store the value of \a level
- *
- *  Retrieves the value of a \a level.
- *  The level value \a val can be a float or an integer. See #value_t
- *  for more information.
- *
- *      RIG_LEVEL_STRENGTH: \a val is an integer, representing the S Meter
- *      level in dB relative to S9, according to the ideal S Meter scale.
- *      The ideal S Meter scale is as follow: S0=-54, S1=-48, S2=-42, S3=-36,
- *      S4=-30, S5=-24, S6=-18, S7=-12, S8=-6, S9=0, +10=10, +20=20,
- *      +30=30, +40=40, +50=50 and +60=60. This is the responsibility
- *      of the backend to return values calibrated for this scale.
- *
- * \return RIG_OK if the operation has been successful, otherwise
- * a negative value if an error occurred (in which case, cause is
- * set appropriately).
- *
- * \sa rig_has_get_level(), rig_set_level()
+/*
+ * rig_get_level() proper, the public function below only makes sure that
+ * concurrent identical calls share one trip to the rig.
  */
-int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
+static int rig_get_level_direct(RIG *rig, vfo_t vfo, setting_t level,
+                                value_t *val)
 {
     const struct rig_caps *caps;
     struct rig_state *rs = STATE(rig);
@@ -176,6 +162,11 @@ int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
         return -RIG_ENAVAIL;
     }
 
+    if (rig_cache_get_item(rig, HAMLIB_CACHE_LEVEL, vfo, level, val) == RIG_OK)
+    {
+        return RIG_OK;
+    }
+
     rig_lock(rig, 1); // Keep Out!
     /*
      * Special case(frontend emulation): calibrated S-meter reading
@@ -197,6 +188,7 @@ int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
         }
 
         val->i = (int)rig_raw2val(rawstr.i, &rs->str_cal);
+        rig_cache_set_item(rig, HAMLIB_CACHE_LEVEL, vfo, level, *val);
         rig_lock(rig, 0);
         return RIG_OK;
     }
@@ -207,6 +199,12 @@ int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
             || vfo == rs->current_vfo)
     {
         retcode = caps->get_level(rig, vfo, level, val);
+
+        if (retcode == RIG_OK)
+        {
+            rig_cache_set_item(rig, HAMLIB_CACHE_LEVEL, vfo, level, *val);
+        }
+
         rig_lock(rig, 0);
         return retcode;
     }
@@ -228,11 +226,65 @@ int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
 
     retcode = caps->get_level(rig, vfo, level, val);
     caps->set_vfo(rig, curr_vfo);
+
+    if (retcode == RIG_OK)
+    {
+        rig_cache_set_item(rig, HAMLIB_CACHE_LEVEL, vfo, level, *val);
+    }
+
     rig_lock(rig, 0);
     return retcode;
 }
 
 
+/**
+ * \brief get the value of a level
+ * \param rig   The rig handle
+ * \param vfo   The target VFO
+ * \param level The level setting
+ * \param val   The location where to store the value of \a level
+ *
+ *  Retrieves the value of a \a level.
+ *  The level value \a val can be a float or an integer. See #value_t
+ *  for more information.
+ *
+ *      RIG_LEVEL_STRENGTH: \a val is an integer, representing the S Meter
+ *      level in dB relative to S9, according to the ideal S Meter scale.
+ *      The ideal S Meter scale is as follow: S0=-54, S1=-48, S2=-42, S3=-36,
+ *      S4=-30, S5=-24, S6=-18, S7=-12, S8=-6, S9=0, +10=10, +20=20,
+ *      +30=30, +40=40, +50=50 and +60=60. This is the responsibility
+ *      of the backend to return values calibrated for this scale.
+ *
+ * \return RIG_OK if the operation has been successful, otherwise
+ * a negative value if an error occurred (in which case, cause is
+ * set appropriately).
+ *
+ * \sa rig_has_get_level(), rig_set_level()
+ */
+int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
+{
+    struct rig_flight *flight;
+    struct rig_flight_result result;
+
+    if (CHECK_RIG_ARG(rig) || !val)
+    {
+        return rig_get_level_direct(rig, vfo, level, val);
+    }
+
+    if (rig_flight_begin(rig, RIG_FLIGHT_LEVEL, vfo, level, &flight, &result))
+    {
+        *val = result.val;
+        return result.retcode;
+    }
+
+    result.retcode = rig_get_level_direct(rig, vfo, level, val);
+    result.val = *val;
+    rig_flight_end(rig, flight, &result);
+
+    return result.retcode;
+}
+
+
 /**
  * \brief set a radio parameter
  * \param rig   The rig handle
@@ -251,6 +303,8 @@ int HAMLIB_API rig_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
  */
 int HAMLIB_API rig_set_parm(RIG *rig, setting_t parm, value_t val)
 {
+    int retcode;
+
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
     if (CHECK_RIG_ARG(rig))
@@ -263,7 +317,13 @@ int HAMLIB_API rig_set_parm(RIG *rig, setting_t parm, value_t val)
         return -RIG_ENAVAIL;
     }
 
-    return rig->caps->set_parm(rig, parm, val);
+    rig_lock_prio(rig, RIG_PRIO_SET);
+    retcode = rig->caps->set_parm(rig, parm, val);
+    // after the set, a get in between would cache the old value again
+    rig_cache_invalidate_item(rig, HAMLIB_CACHE_PARM, RIG_VFO_NONE, parm);
+    rig_lock(rig, 0);
+
+    return retcode;
 }
 
 
@@ -285,6 +345,8 @@ int HAMLIB_API rig_set_parm(RIG *rig, setting_t parm, value_t val)
  */
 int HAMLIB_API rig_get_parm(RIG *rig, setting_t parm, value_t *val)
 {
+    int retcode;
+
     rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
 
     if (CHECK_RIG_ARG(rig) || !val)
@@ -297,7 +359,23 @@ int HAMLIB_API rig_get_parm(RIG *rig, setting_t parm, value_t *val)
         return -RIG_ENAVAIL;
     }
 
-    return rig->caps->get_parm(rig, parm, val);
+    if (rig_cache_get_item(rig, HAMLIB_CACHE_PARM, RIG_VFO_NONE, parm,
+                           val) == RIG_OK)
+    {
+        return RIG_OK;
+    }
+
+    rig_lock(rig, 1);
+    retcode = rig->caps->get_parm(rig, parm, val);
+
+    if (retcode == RIG_OK)
+    {
+        rig_cache_set_item(rig, HAMLIB_CACHE_PARM, RIG_VFO_NONE, parm, *val);
+    }
+
+    rig_lock(rig, 0);
+
+    return retcode;
 }
 
 
@@ -540,12 +618,18 @@ int HAMLIB_API rig_set_func(RIG *rig, vfo_t vfo, setting_t func, int status)
         }
     }
 
+    rig_lock_prio(rig, RIG_PRIO_SET);
+
     if ((caps->targetable_vfo & RIG_TARGETABLE_FUNC)
             || vfo == RIG_VFO_CURR
             || vfo == rs->current_vfo)
     {
 
-        return caps->set_func(rig, vfo, func, status);
+        retcode = caps->set_func(rig, vfo, func, status);
+        // after the set, a get in between would cache the old value again
+        rig_cache_invalidate_item(rig, HAMLIB_CACHE_FUNC, vfo, func);
+        rig_lock(rig, 0);
+        return retcode;
     }
     else
     {
@@ -556,6 +640,7 @@ int HAMLIB_API rig_set_func(RIG *rig, vfo_t vfo, setting_t func, int status)
 
     if (!caps->set_vfo)
     {
+        rig_lock(rig, 0);
         return -RIG_ENTARGET;
     }
 
@@ -564,12 +649,15 @@ int HAMLIB_API rig_set_func(RIG *rig, vfo_t vfo, setting_t func, int status)
 
     if (retcode != RIG_OK)
     {
+        rig_lock(rig, 0);
         return retcode;
     }
 
     retcode = caps->set_func(rig, vfo, func, status);
+    rig_cache_invalidate_item(rig, HAMLIB_CACHE_FUNC, vfo, func);
     caps->set_vfo(rig, curr_vfo);
 
+    rig_lock(rig, 0);
     return retcode;
 }
 
@@ -599,6 +687,7 @@ int HAMLIB_API rig_get_func(RIG *rig, vfo_t vfo, setting_t func, int *status)
     struct rig_state *rs = STATE(rig);
     int retcode;
     vfo_t curr_vfo;
+    value_t cached;
 
     // too verbose
     //rig_debug(RIG_DEBUG_VERBOSE, "%s called\n", __func__);
@@ -615,16 +704,33 @@ int HAMLIB_API rig_get_func(RIG *rig, vfo_t vfo, setting_t func, int *status)
         return -RIG_ENAVAIL;
     }
 
+    if (rig_cache_get_item(rig, HAMLIB_CACHE_FUNC, vfo, func, &cached) == RIG_OK)
+    {
+        *status = cached.i;
+        return RIG_OK;
+    }
+
+    rig_lock(rig, 1);
+
     if ((caps->targetable_vfo & RIG_TARGETABLE_FUNC)
             || vfo == RIG_VFO_CURR
             || vfo == rs->current_vfo)
     {
+        retcode = caps->get_func(rig, vfo, func, status);
 
-        return caps->get_func(rig, vfo, func, status);
+        if (retcode == RIG_OK)
+        {
+            cached.i = *status;
+            rig_cache_set_item(rig, HAMLIB_CACHE_FUNC, vfo, func, cached);
+        }
+
+        rig_lock(rig, 0);
+        return retcode;
     }
 
     if (!caps->set_vfo)
     {
+        rig_lock(rig, 0);
         return -RIG_ENTARGET;
     }
 
@@ -633,12 +739,20 @@ int HAMLIB_API rig_get_func(RIG *rig, vfo_t vfo, setting_t func, int *status)
 
     if (retcode != RIG_OK)
     {
+        rig_lock(rig, 0);
         return retcode;
     }
 
     retcode = caps->get_func(rig, vfo, func, status);
     caps->set_vfo(rig, curr_vfo);
 
+    if (retcode == RIG_OK)
+    {
+        cached.i = *status;
+        rig_cache_set_item(rig, HAMLIB_CACHE_FUNC, vfo, func, cached);
+    }
+
+    rig_lock(rig, 0);
     return retcode;
 }
 
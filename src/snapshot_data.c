@@ -1,5 +1,8 @@
 #define _XOPEN_SOURCE 700
 #include <unistd.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
 #include "hamlib/config.h"
 #include "hamlib/rig.h"
 #include "hamlib/port.h"
@@ -10,470 +13,458 @@
 #include "hamlibdatetime.h"
 #include "sprintflst.h"
 
-#include "cJSON.h"
-
 #define SPECTRUM_MODE_FIXED "FIXED"
 #define SPECTRUM_MODE_CENTER "CENTER"
 
 char snapshot_data_pid[20];
 
-static int snapshot_serialize_rig(cJSON *rig_node, RIG *rig)
+/*
+ * Snapshots are written straight into the caller's buffer, with no tree
+ * and no heap allocations.  The output is byte for byte what
+ * cJSON_PrintUnformatted() gave for the cJSON tree that used to be built
+ * here: no whitespace, cJSON's string escapes and its number format.
+ */
+struct json_out
 {
-    cJSON *node;
-    char buf[1024];
-    struct rig_cache *cachep = CACHE(rig);
-    struct rig_state *rs = STATE(rig);
-
-    cJSON *id_node = cJSON_CreateObject();
-    cJSON_AddStringToObject(id_node, "model", rig->caps->model_name);
-    cJSON_AddStringToObject(id_node, "endpoint", RIGPORT(rig)->pathname);
-    cJSON_AddStringToObject(id_node, "process", snapshot_data_pid);
-    cJSON_AddStringToObject(id_node, "deviceId", rs->device_id);
-    cJSON_AddItemToObject(rig_node, "id", id_node);
+    char *buf;
+    size_t len;         // size of buf, including the terminating NUL
+    size_t pos;
+    int overflow;
+};
 
-    node = cJSON_AddStringToObject(rig_node, "status",
-                                   rig_strcommstatus(rs->comm_status));
-
-    if (node == NULL)
-    {
-        goto error;
-    }
-
-    // TODO: need to store last error code
-    node = cJSON_AddStringToObject(rig_node, "errorMsg", "");
-
-    if (node == NULL)
+static void out_raw(struct json_out *out, const char *s, size_t n)
+{
+    if (out->overflow || n >= out->len - out->pos)
     {
-        goto error;
+        out->overflow = 1;
+        return;
     }
 
-    node = cJSON_AddStringToObject(rig_node, "name", rig->caps->model_name);
-
-    if (node == NULL)
-    {
-        goto error;
-    }
+    memcpy(out->buf + out->pos, s, n);
+    out->pos += n;
+}
 
-    node = cJSON_AddBoolToObject(rig_node, "split",
-                                 cachep->split == RIG_SPLIT_ON ? 1 : 0);
+#define OUT_LIT(out, s) out_raw(out, s, sizeof(s) - 1)
 
-    if (node == NULL)
-    {
-        goto error;
-    }
+static void out_stringn(struct json_out *out, const char *s, size_t n)
+{
+    static const char hex[] = "0123456789abcdef";
+    const unsigned char *p = (const unsigned char *) s;
+    const unsigned char *end = p + n;
 
-    node = cJSON_AddStringToObject(rig_node, "splitVfo",
-                                   rig_strvfo(cachep->split_vfo));
+    OUT_LIT(out, "\"");
 
-    if (node == NULL)
+    while (p < end)
     {
-        goto error;
-    }
+        const unsigned char *run = p;
+        char esc[6] = { '\\', 'u', '0', '0', 0, 0 };
 
-    node = cJSON_AddBoolToObject(rig_node, "satMode",
-                                 cachep->satmode ? 1 : 0);
+        while (p < end && *p > 31 && *p != '"' && *p != '\\') { p++; }
 
-    if (node == NULL)
-    {
-        goto error;
-    }
+        out_raw(out, (const char *) run, p - run);
 
-    rig_sprintf_mode(buf, sizeof(buf), rs->mode_list);
-    char *p;
-    cJSON *modes_array = cJSON_CreateArray();
+        if (p == end) { break; }
 
-    for (p = strtok(buf, " "); p; p = strtok(NULL, " "))
-    {
-        if (strlen(buf) > 0)
+        switch (*p)
         {
-            cJSON *tmp = cJSON_CreateString(p);
-            cJSON_AddItemToArray(modes_array, tmp);
-        }
-    }
-
-    cJSON_AddItemToObject(rig_node, "modes", modes_array);
-
-    return RIG_OK;
-
-error:
-    RETURNFUNC2(-RIG_EINTERNAL);
-}
-
-// 128 max modes should last a while
-#define MAX_MODES 128
-
-static int snapshot_serialize_vfo(cJSON *vfo_node, RIG *rig, vfo_t vfo)
-{
-    freq_t freq;
-    int freq_ms, mode_ms, width_ms;
-    rmode_t mode;
-    //rmode_t modes[MAX_MODES];
-    pbwidth_t width;
-    ptt_t ptt;
-    split_t split;
-    vfo_t split_vfo;
-    int result;
-    int is_rx, is_tx;
-    cJSON *node;
-    struct rig_cache *cachep = CACHE(rig);
-    struct rig_state *rs = STATE(rig);
-
-    // TODO: This data should match rig_get_info command response
+        case '"': OUT_LIT(out, "\\\""); break;
 
-    node = cJSON_AddStringToObject(vfo_node, "name", rig_strvfo(vfo));
+        case '\\': OUT_LIT(out, "\\\\"); break;
 
-    if (node == NULL)
-    {
-        goto error;
-    }
+        case '\b': OUT_LIT(out, "\\b"); break;
 
-    result = rig_get_cache(rig, vfo, &freq, &freq_ms, &mode, &mode_ms, &width,
-                           &width_ms);
+        case '\f': OUT_LIT(out, "\\f"); break;
 
-    if (result == RIG_OK)
-    {
-        node = cJSON_AddNumberToObject(vfo_node, "freq", freq);
+        case '\n': OUT_LIT(out, "\\n"); break;
 
-        if (node == NULL)
-        {
-            goto error;
-        }
+        case '\r': OUT_LIT(out, "\\r"); break;
 
-        node = cJSON_AddStringToObject(vfo_node, "mode", rig_strrmode(mode));
+        case '\t': OUT_LIT(out, "\\t"); break;
 
-        if (node == NULL)
-        {
-            goto error;
+        default:
+            esc[4] = hex[*p >> 4];
+            esc[5] = hex[*p & 15];
+            out_raw(out, esc, sizeof(esc));
+            break;
         }
 
-        node = cJSON_AddNumberToObject(vfo_node, "width", (double) width);
-
-        if (node == NULL)
-        {
-            goto error;
-        }
+        p++;
     }
 
-    split = cachep->split;
-    split_vfo = cachep->split_vfo;
+    OUT_LIT(out, "\"");
+}
 
-    is_rx = (split == RIG_SPLIT_OFF && vfo == rs->current_vfo)
-            || (split == RIG_SPLIT_ON && vfo != split_vfo);
-    is_tx = (split == RIG_SPLIT_OFF && vfo == rs->current_vfo)
-            || (split == RIG_SPLIT_ON && vfo == split_vfo);
-    ptt = cachep->ptt && is_tx;
+static void out_string(struct json_out *out, const char *s)
+{
+    out_stringn(out, s ? s : "", s ? strlen(s) : 0);
+}
 
-    if (is_tx)
+static void out_bool(struct json_out *out, int value)
+{
+    if (value)
     {
-        node = cJSON_AddBoolToObject(vfo_node, "ptt", ptt == RIG_PTT_OFF ? 0 : 1);
+        OUT_LIT(out, "true");
     }
     else
     {
-        node = cJSON_AddBoolToObject(vfo_node, "ptt", 0);
+        OUT_LIT(out, "false");
     }
+}
+
+/* Integers as integers, other values with the fewest digits that read back */
+static void out_number(struct json_out *out, double d)
+{
+    char tmp[26];
+    int valueint;
+    int length;
 
-    if (node == NULL)
+    // cJSON saturates the integer copy of a number
+    if (d >= INT_MAX)
     {
-        goto error;
+        valueint = INT_MAX;
     }
-
-
-    node = cJSON_AddBoolToObject(vfo_node, "rx", is_rx);
-
-    if (node == NULL)
+    else if (d <= (double) INT_MIN)
     {
-        goto error;
+        valueint = INT_MIN;
     }
-
-    node = cJSON_AddBoolToObject(vfo_node, "tx", is_tx);
-
-    if (node == NULL)
+    else
     {
-        goto error;
+        valueint = (int) d;
     }
 
-    return RIG_OK;
+    if (isnan(d) || isinf(d))
+    {
+        OUT_LIT(out, "null");
+        return;
+    }
 
-error:
-    RETURNFUNC2(-RIG_EINTERNAL);
-}
+    if (d == (double) valueint)
+    {
+        length = snprintf(tmp, sizeof(tmp), "%d", valueint);
+    }
+    else
+    {
+        double test;
 
-static int snapshot_serialize_spectrum(cJSON *spectrum_node, RIG *rig,
-                                       struct rig_spectrum_line *spectrum_line)
-{
-    // Spectrum data is represented as a hexadecimal ASCII string where each data byte is represented as 2 ASCII letters
-    char spectrum_data_string[HAMLIB_MAX_SPECTRUM_DATA * 2];
-    cJSON *node;
-    int i;
-    struct rig_spectrum_scope *scopes = rig->caps->spectrum_scopes;
-    char *name = "?";
+        length = snprintf(tmp, sizeof(tmp), "%1.15g", d);
 
-    for (i = 0; scopes[i].name != NULL; i++)
-    {
-        if (scopes[i].id == spectrum_line->id)
+        if (sscanf(tmp, "%lg", &test) != 1
+                || fabs(test - d) > fmax(fabs(test), fabs(d)) * DBL_EPSILON)
         {
-            name = scopes[i].name;
+            length = snprintf(tmp, sizeof(tmp), "%1.17g", d);
         }
     }
 
-    node = cJSON_AddNumberToObject(spectrum_node, "id", spectrum_line->id);
-
-    if (node == NULL)
+    if (length < 0 || length >= (int) sizeof(tmp))
     {
-        goto error;
+        out->overflow = 1;
+        return;
     }
 
-    node = cJSON_AddStringToObject(spectrum_node, "name", name);
-
-    if (node == NULL)
-    {
-        goto error;
-    }
+    out_raw(out, tmp, length);
+}
 
-    node = cJSON_AddStringToObject(spectrum_node, "type",
-                                   spectrum_line->spectrum_mode == RIG_SPECTRUM_MODE_CENTER ?
-                                   SPECTRUM_MODE_CENTER : SPECTRUM_MODE_FIXED);
+static void out_hex(struct json_out *out, const unsigned char *data, size_t n)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    char *p;
+    size_t i;
 
-    if (node == NULL)
+    if (out->overflow || 2 * n + 2 >= out->len - out->pos)
     {
-        goto error;
+        out->overflow = 1;
+        return;
     }
 
-    node = cJSON_AddNumberToObject(spectrum_node, "minLevel",
-                                   spectrum_line->data_level_min);
+    p = out->buf + out->pos;
+    *p++ = '"';
 
-    if (node == NULL)
+    for (i = 0; i < n; i++)
     {
-        goto error;
+        *p++ = hex[data[i] >> 4];
+        *p++ = hex[data[i] & 15];
     }
 
-    node = cJSON_AddNumberToObject(spectrum_node, "maxLevel",
-                                   spectrum_line->data_level_max);
+    *p = '"';
+    out->pos += 2 * n + 2;
+}
 
-    if (node == NULL)
-    {
-        goto error;
-    }
+/* The part of every snapshot that never changes, made by snapshot_init() */
+static char snapshot_prefix[256];
+static size_t snapshot_prefix_length;
 
-    node = cJSON_AddNumberToObject(spectrum_node, "minStrength",
-                                   spectrum_line->signal_strength_min);
+static void snapshot_serialize_rig(struct json_out *out, RIG *rig,
+                                   const struct rig_cache *cachep)
+{
+    char buf[1024];
+    char *p;
+    int count = 0;
+    struct rig_state *rs = STATE(rig);
 
-    if (node == NULL)
+    OUT_LIT(out, "\"rig\":{\"id\":{\"model\":");
+    out_string(out, rig->caps->model_name);
+    OUT_LIT(out, ",\"endpoint\":");
+    out_string(out, RIGPORT(rig)->pathname);
+    OUT_LIT(out, ",\"process\":");
+    out_string(out, snapshot_data_pid);
+    OUT_LIT(out, ",\"deviceId\":");
+    out_string(out, rs->device_id);
+    OUT_LIT(out, "},\"status\":");
+    out_string(out, rig_strcommstatus(rs->comm_status));
+    // TODO: need to store last error code
+    OUT_LIT(out, ",\"errorMsg\":\"\",\"name\":");
+    out_string(out, rig->caps->model_name);
+    OUT_LIT(out, ",\"split\":");
+    out_bool(out, cachep->split == RIG_SPLIT_ON);
+    OUT_LIT(out, ",\"splitVfo\":");
+    out_string(out, rig_strvfo(cachep->split_vfo));
+    OUT_LIT(out, ",\"satMode\":");
+    out_bool(out, cachep->satmode);
+
+    OUT_LIT(out, ",\"modes\":[");
+    rig_sprintf_mode(buf, sizeof(buf), rs->mode_list);
+
+    for (p = buf + strspn(buf, " "); *p; p += strspn(p, " "))
     {
-        goto error;
-    }
+        size_t n = strcspn(p, " ");
 
-    node = cJSON_AddNumberToObject(spectrum_node, "maxStrength",
-                                   spectrum_line->signal_strength_max);
+        if (count++) { OUT_LIT(out, ","); }
 
-    if (node == NULL)
-    {
-        goto error;
+        out_stringn(out, p, n);
+        p += n;
     }
 
-    node = cJSON_AddNumberToObject(spectrum_node, "centerFreq",
-                                   spectrum_line->center_freq);
+    OUT_LIT(out, "]}");
+}
 
-    if (node == NULL)
-    {
-        goto error;
-    }
+static void snapshot_serialize_vfo(struct json_out *out, RIG *rig,
+                                   const struct rig_cache *cachep, vfo_t vfo)
+{
+    freq_t freq;
+    int freq_ms, mode_ms, width_ms;
+    rmode_t mode;
+    pbwidth_t width;
+    split_t split;
+    vfo_t split_vfo;
+    int is_rx, is_tx;
+    struct rig_state *rs = STATE(rig);
 
-    node = cJSON_AddNumberToObject(spectrum_node, "span", spectrum_line->span_freq);
+    // TODO: This data should match rig_get_info command response
+
+    OUT_LIT(out, "{\"name\":");
+    out_string(out, rig_strvfo(vfo));
 
-    if (node == NULL)
+    if (rig_get_cache(rig, vfo, &freq, &freq_ms, &mode, &mode_ms, &width,
+                      &width_ms) == RIG_OK)
     {
-        goto error;
+        OUT_LIT(out, ",\"freq\":");
+        out_number(out, freq);
+        OUT_LIT(out, ",\"mode\":");
+        out_string(out, rig_strrmode(mode));
+        OUT_LIT(out, ",\"width\":");
+        out_number(out, (double) width);
     }
 
-    node = cJSON_AddNumberToObject(spectrum_node, "lowFreq",
-                                   spectrum_line->low_edge_freq);
+    split = cachep->split;
+    split_vfo = cachep->split_vfo;
 
-    if (node == NULL)
-    {
-        goto error;
-    }
+    is_rx = (split == RIG_SPLIT_OFF && vfo == rs->current_vfo)
+            || (split == RIG_SPLIT_ON && vfo != split_vfo);
+    is_tx = (split == RIG_SPLIT_OFF && vfo == rs->current_vfo)
+            || (split == RIG_SPLIT_ON && vfo == split_vfo);
+
+    OUT_LIT(out, ",\"ptt\":");
+    out_bool(out, is_tx && cachep->ptt != RIG_PTT_OFF);
+    OUT_LIT(out, ",\"rx\":");
+    out_bool(out, is_rx);
+    OUT_LIT(out, ",\"tx\":");
+    out_bool(out, is_tx);
+    OUT_LIT(out, "}");
+}
 
-    node = cJSON_AddNumberToObject(spectrum_node, "highFreq",
-                                   spectrum_line->high_edge_freq);
+static void snapshot_serialize_spectrum(struct json_out *out, RIG *rig,
+                                        const struct rig_spectrum_line *spectrum_line)
+{
+    int i;
+    struct rig_spectrum_scope *scopes = rig->caps->spectrum_scopes;
+    char *name = "?";
 
-    if (node == NULL)
+    for (i = 0; scopes[i].name != NULL; i++)
     {
-        goto error;
+        if (scopes[i].id == spectrum_line->id)
+        {
+            name = scopes[i].name;
+        }
     }
 
-    node = cJSON_AddNumberToObject(spectrum_node, "length",
-                                   (double) spectrum_line->spectrum_data_length);
+    OUT_LIT(out, "{\"id\":");
+    out_number(out, spectrum_line->id);
+    OUT_LIT(out, ",\"name\":");
+    out_string(out, name);
+    OUT_LIT(out, ",\"type\":");
+    out_string(out, spectrum_line->spectrum_mode == RIG_SPECTRUM_MODE_CENTER ?
+               SPECTRUM_MODE_CENTER : SPECTRUM_MODE_FIXED);
+    OUT_LIT(out, ",\"minLevel\":");
+    out_number(out, spectrum_line->data_level_min);
+    OUT_LIT(out, ",\"maxLevel\":");
+    out_number(out, spectrum_line->data_level_max);
+    OUT_LIT(out, ",\"minStrength\":");
+    out_number(out, spectrum_line->signal_strength_min);
+    OUT_LIT(out, ",\"maxStrength\":");
+    out_number(out, spectrum_line->signal_strength_max);
+    OUT_LIT(out, ",\"centerFreq\":");
+    out_number(out, spectrum_line->center_freq);
+    OUT_LIT(out, ",\"span\":");
+    out_number(out, spectrum_line->span_freq);
+    OUT_LIT(out, ",\"lowFreq\":");
+    out_number(out, spectrum_line->low_edge_freq);
+    OUT_LIT(out, ",\"highFreq\":");
+    out_number(out, spectrum_line->high_edge_freq);
+    OUT_LIT(out, ",\"length\":");
+    out_number(out, (double) spectrum_line->spectrum_data_length);
 
-    if (node == NULL)
-    {
-        goto error;
-    }
+    // Spectrum data is represented as a hexadecimal ASCII string where each data byte is represented as 2 ASCII letters
+    OUT_LIT(out, ",\"data\":");
+    out_hex(out, spectrum_line->spectrum_data,
+            spectrum_line->spectrum_data_length);
+    OUT_LIT(out, "}");
+}
 
-    to_hex(spectrum_line->spectrum_data_length, spectrum_line->spectrum_data,
-           sizeof(spectrum_data_string), spectrum_data_string);
-    node = cJSON_AddStringToObject(spectrum_node, "data", spectrum_data_string);
+/* FNV-1a, to tell whether a VFO section is the one sent last time */
+static uint64_t snapshot_hash(const char *s, size_t n)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t i;
 
-    if (node == NULL)
+    for (i = 0; i < n; i++)
     {
-        goto error;
+        hash = (hash ^ (unsigned char) s[i]) * 0x100000001b3ULL;
     }
 
-    return RIG_OK;
-
-error:
-    RETURNFUNC2(-RIG_EINTERNAL);
+    return hash;
 }
 
 void snapshot_init()
 {
+    struct json_out out = { snapshot_prefix, sizeof(snapshot_prefix), 0, 0 };
+
     snprintf(snapshot_data_pid, sizeof(snapshot_data_pid), "%d", getpid());
+
+    OUT_LIT(&out, "{\"app\":");
+    out_string(&out, PACKAGE_NAME);
+    OUT_LIT(&out, ",\"version\":");
+    out_string(&out, PACKAGE_VERSION " " HAMLIBDATETIME);
+    OUT_LIT(&out, ",\"seq\":");
+    snapshot_prefix_length = out.pos;
 }
 
 int snapshot_serialize(size_t buffer_length, char *buffer, RIG *rig,
                        struct rig_spectrum_line *spectrum_line)
 {
-    cJSON *root_node;
-    cJSON *rig_node, *vfos_array, *vfo_node, *spectra_array, *spectrum_node;
-    cJSON *node;
-    cJSON_bool bool_result;
+    return snapshot_serialize_vfos(buffer_length, buffer, rig, spectrum_line,
+                                   NULL);
+}
+
+/*
+ * As snapshot_serialize(), but with a vfo_state the vfos array only has
+ * the VFOs whose section differs from the one in the previous snapshot
+ * made with the same vfo_state.  The first snapshot has all of them.
+ */
+int snapshot_serialize_vfos(size_t buffer_length, char *buffer, RIG *rig,
+                            struct rig_spectrum_line *spectrum_line,
+                            struct snapshot_vfo_state *vfo_state)
+{
+    struct json_out out = { buffer, buffer_length, 0, 0 };
+    struct rig_cache snap;
     char buf[256];
-    int result;
+    int count = 0;
     int i;
     struct rig_state *rs = STATE(rig);
 
-    root_node = cJSON_CreateObject();
-
-    if (root_node == NULL)
+    if (buffer_length == 0)
     {
-        RETURNFUNC2(-RIG_EINTERNAL);
+        RETURNFUNC2(-RIG_EINVAL);
     }
 
-    node = cJSON_AddStringToObject(root_node, "app", PACKAGE_NAME);
-
-    if (node == NULL)
+    if (snapshot_prefix_length == 0)
     {
-        goto error;
+        snapshot_init();
     }
 
-    node = cJSON_AddStringToObject(root_node, "version",
-                                   PACKAGE_VERSION " " HAMLIBDATETIME);
-
-    if (node == NULL)
-    {
-        goto error;
-    }
+    rig_cache_snapshot(rig, &snap);
 
-    node = cJSON_AddNumberToObject(root_node, "seq",
-                                   rs->snapshot_packet_sequence_number);
-
-    if (node == NULL)
-    {
-        goto error;
-    }
+    out_raw(&out, snapshot_prefix, snapshot_prefix_length);
+    out_number(&out, rs->snapshot_packet_sequence_number);
 
     date_strget(buf, sizeof(buf), 0);
-    node = cJSON_AddStringToObject(root_node, "time", buf);
-
-    if (node == NULL)
-    {
-        goto error;
-    }
-
+    OUT_LIT(&out, ",\"time\":");
+    out_string(&out, buf);
 
     // TODO: Calculate 32-bit CRC of the entire JSON record replacing the CRC value with 0
-    node = cJSON_AddNumberToObject(root_node, "crc", 0);
+    OUT_LIT(&out, ",\"crc\":0,");
 
-    if (node == NULL)
-    {
-        goto error;
-    }
-
-    rig_node = cJSON_CreateObject();
-
-    if (rig_node == NULL)
-    {
-        goto error;
-    }
+    snapshot_serialize_rig(&out, rig, &snap);
 
-    result = snapshot_serialize_rig(rig_node, rig);
-
-    if (result != RIG_OK)
-    {
-        cJSON_Delete(rig_node);
-        goto error;
-    }
-
-    cJSON_AddItemToObject(root_node, "rig", rig_node);
-
-    vfos_array = cJSON_CreateArray();
-
-    if (vfos_array == NULL)
-    {
-        goto error;
-    }
+    OUT_LIT(&out, ",\"vfos\":[");
 
     for (i = 0; i < HAMLIB_MAX_VFOS; i++)
     {
         vfo_t vfo = rs->vfo_list & RIG_VFO_N(i);
+        size_t start = out.pos;
+        size_t section;
 
         if (!vfo)
         {
             continue;
         }
 
-        vfo_node = cJSON_CreateObject();
-        result = snapshot_serialize_vfo(vfo_node, rig, vfo);
+        if (count) { OUT_LIT(&out, ","); }
+
+        section = out.pos;
+        snapshot_serialize_vfo(&out, rig, &snap, vfo);
 
-        if (result != RIG_OK)
+        if (vfo_state && !out.overflow)
         {
-            cJSON_Delete(vfo_node);
-            goto error;
+            uint64_t hash = snapshot_hash(buffer + section, out.pos - section);
+
+            if (vfo_state->valid && vfo_state->hash[i] == hash)
+            {
+                out.pos = start;
+                continue;
+            }
+
+            vfo_state->hash[i] = hash;
         }
 
-        cJSON_AddItemToArray(vfos_array, vfo_node);
+        count++;
     }
 
-    cJSON_AddItemToObject(root_node, "vfos", vfos_array);
+    OUT_LIT(&out, "]");
 
     if (spectrum_line != NULL)
     {
-        spectra_array = cJSON_CreateArray();
-
-        if (spectra_array == NULL)
-        {
-            goto error;
-        }
+        OUT_LIT(&out, ",\"spectra\":[");
+        snapshot_serialize_spectrum(&out, rig, spectrum_line);
+        OUT_LIT(&out, "]");
+    }
 
-        spectrum_node = cJSON_CreateObject();
-        result = snapshot_serialize_spectrum(spectrum_node, rig, spectrum_line);
+    OUT_LIT(&out, "}");
 
-        if (result != RIG_OK)
-        {
-            cJSON_Delete(spectrum_node);
-            goto error;
-        }
+    if (out.overflow)
+    {
+        buffer[0] = '\0';
 
-        cJSON_AddItemToArray(spectra_array, spectrum_node);
+        // the hashes may be of sections that did not go out
+        if (vfo_state) { vfo_state->valid = 0; }
 
-        cJSON_AddItemToObject(root_node, "spectra", spectra_array);
+        RETURNFUNC2(-RIG_EINVAL);
     }
 
-    bool_result = cJSON_PrintPreallocated(root_node, buffer, (int) buffer_length,
-                                          0);
-
-    cJSON_Delete(root_node);
+    buffer[out.pos] = '\0';
 
-    if (!bool_result)
-    {
-        RETURNFUNC2(-RIG_EINVAL);
-    }
+    if (vfo_state) { vfo_state->valid = 1; }
 
     rs->snapshot_packet_sequence_number++;
 
     return RIG_OK;
-
-error:
-    cJSON_Delete(root_node);
-    RETURNFUNC2(-RIG_EINTERNAL);
 }
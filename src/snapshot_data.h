@@ -1,7 +1,17 @@
 #ifndef _SNAPSHOT_DATA_H
 #define _SNAPSHOT_DATA_H
 
+#include <stdint.h>
+
+/* The VFO sections of the last snapshot, see snapshot_serialize_vfos() */
+struct snapshot_vfo_state
+{
+    int valid;
+    uint64_t hash[HAMLIB_MAX_VFOS];
+};
+
 void snapshot_init();
 int snapshot_serialize(size_t buffer_length, char *buffer, RIG *rig, struct rig_spectrum_line *spectrum_line);
+int snapshot_serialize_vfos(size_t buffer_length, char *buffer, RIG *rig, struct rig_spectrum_line *spectrum_line, struct snapshot_vfo_state *vfo_state);
 
 #endif
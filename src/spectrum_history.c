@@ -0,0 +1,512 @@
+/*
+ *  Hamlib Interface - spectrum line history
+ *  Copyright (c) 2026 The Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+/**
+ * \addtogroup rig
+ * @{
+ */
+
+/**
+ * \file spectrum_history.c
+ * \brief Recent spectrum scope lines, averaged, peak held or decimated
+ *
+ * Waterfall and panadapter clients want more than the newest line: an
+ * average over the last few to calm the noise, a peak hold, or a line
+ * cut down to the width of their window.  Instead of each one keeping
+ * its own copy of the stream, the lines are kept here, once per rig.
+ */
+
+#include "hamlib/config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hamlib/rig.h"
+#include "hamlib/rig_state.h"
+#include "spectrum_history.h"
+#include "spectrum_pool.h"
+
+#define CHECK_RIG_ARG(r) (!(r) || !(r)->caps || !STATE(r)->comm_state)
+
+/*
+ * The kernels work on 16 bins at a time with the compiler's vector
+ * extensions, which become SSE2/NEON instructions where there are such
+ * and plain loops elsewhere.  Other compilers get the scalar loops that
+ * also do the last n % 16 bins.
+ */
+#if defined(__GNUC__) && (defined(__clang__) || __GNUC__ >= 9)
+#define SPECTRUM_VECTOR 16
+typedef unsigned char spectrum_v8 __attribute__((vector_size(16)));
+typedef unsigned short spectrum_v16 __attribute__((vector_size(32)));
+typedef unsigned int spectrum_v32 __attribute__((vector_size(64)));
+
+static inline spectrum_v8 v8_load(const unsigned char *p)
+{
+    spectrum_v8 v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline spectrum_v8 v8_max(spectrum_v8 a, spectrum_v8 b)
+{
+    spectrum_v8 a_greater = (spectrum_v8)(a > b);
+
+    return (a & a_greater) | (b & ~a_greater);
+}
+
+static inline spectrum_v8 v8_min(spectrum_v8 a, spectrum_v8 b)
+{
+    spectrum_v8 a_less = (spectrum_v8)(a < b);
+
+    return (a & a_less) | (b & ~a_less);
+}
+#else
+#define SPECTRUM_VECTOR 0
+#endif
+
+/*
+ * Rounded division by count, as a multiplication: with at most
+ * SPECTRUM_HISTORY_LINES lines of 8 bits the reciprocal 2^24 / count,
+ * rounded up, gives the exact quotient.
+ */
+static unsigned int average_reciprocal(int count)
+{
+    return ((1U << 24) + count - 1) / count;
+}
+
+void spectrum_kernel_average(unsigned char *out,
+                             const unsigned char *const lines[],
+                             int count, size_t n)
+{
+    unsigned int recip = average_reciprocal(count);
+    unsigned int half = count / 2;
+    size_t i = 0;
+    int l;
+
+#if SPECTRUM_VECTOR
+
+    for (; i + SPECTRUM_VECTOR <= n; i += SPECTRUM_VECTOR)
+    {
+        spectrum_v16 sum = { 0 };
+        spectrum_v32 wide;
+        spectrum_v8 avg;
+
+        for (l = 0; l < count; l++)
+        {
+            sum += __builtin_convertvector(v8_load(lines[l] + i), spectrum_v16);
+        }
+
+        wide = (__builtin_convertvector(sum, spectrum_v32) + half) * recip;
+        avg = __builtin_convertvector(wide >> 24, spectrum_v8);
+        memcpy(out + i, &avg, sizeof(avg));
+    }
+
+#endif
+
+    for (; i < n; i++)
+    {
+        unsigned int sum = 0;
+
+        for (l = 0; l < count; l++) { sum += lines[l][i]; }
+
+        out[i] = (unsigned char)(((sum + half) * recip) >> 24);
+    }
+}
+
+void spectrum_kernel_max(unsigned char *out, const unsigned char *const lines[],
+                         int count, size_t n)
+{
+    size_t i = 0;
+    int l;
+
+#if SPECTRUM_VECTOR
+
+    for (; i + SPECTRUM_VECTOR <= n; i += SPECTRUM_VECTOR)
+    {
+        spectrum_v8 peak = v8_load(lines[0] + i);
+
+        for (l = 1; l < count; l++)
+        {
+            peak = v8_max(peak, v8_load(lines[l] + i));
+        }
+
+        memcpy(out + i, &peak, sizeof(peak));
+    }
+
+#endif
+
+    for (; i < n; i++)
+    {
+        unsigned char peak = lines[0][i];
+
+        for (l = 1; l < count; l++)
+        {
+            if (lines[l][i] > peak) { peak = lines[l][i]; }
+        }
+
+        out[i] = peak;
+    }
+}
+
+void spectrum_kernel_min(unsigned char *out, const unsigned char *const lines[],
+                         int count, size_t n)
+{
+    size_t i = 0;
+    int l;
+
+#if SPECTRUM_VECTOR
+
+    for (; i + SPECTRUM_VECTOR <= n; i += SPECTRUM_VECTOR)
+    {
+        spectrum_v8 low = v8_load(lines[0] + i);
+
+        for (l = 1; l < count; l++)
+        {
+            low = v8_min(low, v8_load(lines[l] + i));
+        }
+
+        memcpy(out + i, &low, sizeof(low));
+    }
+
+#endif
+
+    for (; i < n; i++)
+    {
+        unsigned char low = lines[0][i];
+
+        for (l = 1; l < count; l++)
+        {
+            if (lines[l][i] < low) { low = lines[l][i]; }
+        }
+
+        out[i] = low;
+    }
+}
+
+/*
+ * Output bin j covers input bins [j * n / bins, (j + 1) * n / bins).
+ * Averages are averaged; everything else keeps its peaks, so a carrier
+ * narrower than an output bin does not disappear from a narrow window.
+ * This is one pass over a single line, after the lines were combined.
+ */
+void spectrum_kernel_decimate(unsigned char *out, size_t bins,
+                              const unsigned char *in, size_t n,
+                              enum rig_spectrum_history_e op)
+{
+    size_t j;
+
+    for (j = 0; j < bins; j++)
+    {
+        size_t start = j * n / bins;
+        size_t end = (j + 1) * n / bins;
+        unsigned int acc = in[start];
+        size_t i;
+
+        for (i = start + 1; i < end; i++)
+        {
+            switch (op)
+            {
+            case RIG_SPECTRUM_HISTORY_AVERAGE:
+                acc += in[i];
+                break;
+
+            case RIG_SPECTRUM_HISTORY_MIN:
+                if (in[i] < acc) { acc = in[i]; }
+
+                break;
+
+            default:
+                if (in[i] > acc) { acc = in[i]; }
+
+                break;
+            }
+        }
+
+        if (op == RIG_SPECTRUM_HISTORY_AVERAGE)
+        {
+            acc = (acc + (end - start) / 2) / (end - start);
+        }
+
+        out[j] = (unsigned char) acc;
+    }
+}
+
+int spectrum_history_init(RIG *rig)
+{
+    struct spectrum_history *h = calloc(1, sizeof(*h));
+
+    if (!h)
+    {
+        return -RIG_ENOMEM;
+    }
+
+    pthread_mutex_init(&h->lock, NULL);
+    STATE(rig)->spectrum_history = h;
+
+    return RIG_OK;
+}
+
+void spectrum_history_cleanup(RIG *rig)
+{
+    struct spectrum_history *h = STATE(rig)->spectrum_history;
+    int i;
+
+    if (!h)
+    {
+        return;
+    }
+
+    for (i = 0; i < HAMLIB_MAX_SPECTRUM_SCOPES; i++)
+    {
+        struct spectrum_history_scope *s = h->scopes[i];
+        int l;
+
+        if (!s) { continue; }
+
+        for (l = 0; l < SPECTRUM_HISTORY_LINES; l++)
+        {
+            if (s->ring[l]) { spectrum_buffer_unref(s->ring[l]); }
+        }
+
+        free(s);
+    }
+
+    pthread_mutex_destroy(&h->lock);
+    free(h);
+    STATE(rig)->spectrum_history = NULL;
+}
+
+/* Called for every line the rig sends, from rig_fire_spectrum_buffer() */
+void spectrum_history_push(RIG *rig, struct spectrum_buffer *buf)
+{
+    struct spectrum_history *h = STATE(rig)->spectrum_history;
+    const struct rig_spectrum_line *line = &buf->line;
+    struct spectrum_history_scope *s;
+    struct spectrum_buffer **slot;
+
+    if (!h || line->id < 0 || line->id >= HAMLIB_MAX_SPECTRUM_SCOPES)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&h->lock);
+
+    s = h->scopes[line->id];
+
+    // the ring is only allocated for scopes that are in use
+    if (!s)
+    {
+        s = h->scopes[line->id] = calloc(1, sizeof(*s));
+
+        if (!s)
+        {
+            pthread_mutex_unlock(&h->lock);
+            return;
+        }
+    }
+
+    slot = &s->ring[s->seq % SPECTRUM_HISTORY_LINES];
+
+    if (*slot) { spectrum_buffer_unref(*slot); }
+
+    spectrum_buffer_ref(buf);
+    *slot = buf;
+    s->seq++;
+
+    pthread_mutex_unlock(&h->lock);
+}
+
+/* Lines can only be combined bin by bin if they cover the same range */
+static int same_geometry(const struct rig_spectrum_line *a,
+                         const struct rig_spectrum_line *b)
+{
+    if (a->spectrum_data_length != b->spectrum_data_length
+            || a->spectrum_mode != b->spectrum_mode)
+    {
+        return 0;
+    }
+
+    if (a->spectrum_mode == RIG_SPECTRUM_MODE_CENTER
+            || a->spectrum_mode == RIG_SPECTRUM_MODE_CENTER_SCROLL)
+    {
+        return a->center_freq == b->center_freq && a->span_freq == b->span_freq;
+    }
+
+    return a->low_edge_freq == b->low_edge_freq
+           && a->high_edge_freq == b->high_edge_freq;
+}
+
+static void compute(struct spectrum_history_scope *s,
+                    struct spectrum_history_result *r)
+{
+    const struct rig_spectrum_line *newest =
+        &s->ring[(s->seq - 1) % SPECTRUM_HISTORY_LINES]->line;
+    const unsigned char *lines[SPECTRUM_HISTORY_LINES];
+    unsigned char combined[HAMLIB_MAX_SPECTRUM_DATA];
+    size_t n = newest->spectrum_data_length;
+    int used;
+
+    // back from the newest line, up to a change of frequency range
+    for (used = 0; used < r->lines; used++)
+    {
+        const struct rig_spectrum_line *line =
+            &s->ring[(s->seq - 1 - used) % SPECTRUM_HISTORY_LINES]->line;
+
+        if (!same_geometry(line, newest)) { break; }
+
+        lines[used] = line->spectrum_data;
+    }
+
+    switch (r->op)
+    {
+    case RIG_SPECTRUM_HISTORY_AVERAGE:
+        spectrum_kernel_average(combined, lines, used, n);
+        break;
+
+    case RIG_SPECTRUM_HISTORY_MAX:
+        spectrum_kernel_max(combined, lines, used, n);
+        break;
+
+    case RIG_SPECTRUM_HISTORY_MIN:
+        spectrum_kernel_min(combined, lines, used, n);
+        break;
+
+    default:
+        used = 1;
+        memcpy(combined, newest->spectrum_data, n);
+        break;
+    }
+
+    r->line = *newest;
+    r->line.spectrum_data = r->data;
+    r->used = used;
+
+    if (r->bins > 0 && (size_t) r->bins < n)
+    {
+        spectrum_kernel_decimate(r->data, r->bins, combined, n, r->op);
+        r->line.spectrum_data_length = r->bins;
+    }
+    else
+    {
+        memcpy(r->data, combined, n);
+    }
+}
+
+/**
+ * \brief Combine the most recent spectrum lines of a scope
+ * \param rig   The rig handle
+ * \param id    The scope, as in rig_spectrum_line.id
+ * \param op    How to combine them, see enum rig_spectrum_history_e
+ * \param lines How many of the newest lines, at most SPECTRUM_HISTORY_LINES
+ * \param bins  Decimate the result to this many bins, 0 to keep them all
+ * \param line  The combined line, with the range of the newest line
+ * \param data  Receives the data, at least HAMLIB_MAX_SPECTRUM_DATA bytes
+ *
+ * Every line a rig sends is kept in a short history.  Lines are only
+ * combined with newer ones of the same frequency range, so after the
+ * rig was retuned fewer than \a lines are used.
+ *
+ * \return The number of lines combined, -RIG_ENAVAIL if no line of
+ * scope \a id was received yet, or a negative error code.
+ *
+ * \sa rig_set_spectrum_callback()
+ */
+int HAMLIB_API rig_get_spectrum_history(RIG *rig, int id,
+                                        enum rig_spectrum_history_e op,
+                                        int lines, int bins,
+                                        struct rig_spectrum_line *line,
+                                        unsigned char *data)
+{
+    struct spectrum_history *h;
+    struct spectrum_history_scope *s;
+    struct spectrum_history_result *r = NULL;
+    int used;
+    int i;
+
+    if (CHECK_RIG_ARG(rig) || !line || !data)
+    {
+        return -RIG_EINVAL;
+    }
+
+    h = STATE(rig)->spectrum_history;
+
+    if (!h || id < 0 || id >= HAMLIB_MAX_SPECTRUM_SCOPES
+            || op < RIG_SPECTRUM_HISTORY_LAST || op > RIG_SPECTRUM_HISTORY_MIN)
+    {
+        return -RIG_EINVAL;
+    }
+
+    if (op == RIG_SPECTRUM_HISTORY_LAST || lines < 1) { lines = 1; }
+
+    if (lines > SPECTRUM_HISTORY_LINES) { lines = SPECTRUM_HISTORY_LINES; }
+
+    if (bins < 0) { bins = 0; }
+
+    pthread_mutex_lock(&h->lock);
+
+    s = h->scopes[id];
+
+    if (!s || s->seq == 0)
+    {
+        pthread_mutex_unlock(&h->lock);
+        return -RIG_ENAVAIL;
+    }
+
+    if ((unsigned long) lines > s->seq) { lines = (int) s->seq; }
+
+    for (i = 0; i < SPECTRUM_HISTORY_RESULTS; i++)
+    {
+        struct spectrum_history_result *c = &s->results[i];
+
+        if (c->valid && c->seq == s->seq && c->op == op && c->lines == lines
+                && c->bins == bins)
+        {
+            r = c;
+            break;
+        }
+    }
+
+    if (!r)
+    {
+        r = &s->results[s->next_result];
+        s->next_result = (s->next_result + 1) % SPECTRUM_HISTORY_RESULTS;
+        r->valid = 1;
+        r->op = op;
+        r->lines = lines;
+        r->bins = bins;
+        r->seq = s->seq;
+        compute(s, r);
+        h->computed++;
+    }
+
+    *line = r->line;
+    line->spectrum_data = data;
+    memcpy(data, r->data, r->line.spectrum_data_length);
+    used = r->used;
+
+    pthread_mutex_unlock(&h->lock);
+
+    return used;
+}
+
+/** @} */
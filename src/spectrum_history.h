@@ -0,0 +1,91 @@
+/*
+ *  Hamlib Interface - spectrum line history
+ *  Copyright (c) 2026 The Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#ifndef _HL_SPECTRUM_HISTORY_H
+#define _HL_SPECTRUM_HISTORY_H 1
+
+#include <pthread.h>
+
+#include "hamlib/rig.h"
+
+__BEGIN_DECLS
+
+/*
+ * The last SPECTRUM_HISTORY_LINES lines of each scope are held, as they
+ * arrive through rig_fire_spectrum_buffer().  rig_get_spectrum_history()
+ * combines the newest of them, and remembers its last few answers so
+ * several clients asking the same question of the same line cost one
+ * computation.
+ */
+#define SPECTRUM_HISTORY_LINES 64
+#define SPECTRUM_HISTORY_RESULTS 4
+
+struct spectrum_buffer;
+
+struct spectrum_history_result
+{
+    int valid;
+    enum rig_spectrum_history_e op;
+    int lines;              // as asked for, after clamping
+    int bins;               // as asked for, 0 for all
+    unsigned long seq;      // newest line when it was computed
+    int used;               // lines combined
+    struct rig_spectrum_line line;
+    unsigned char data[HAMLIB_MAX_SPECTRUM_DATA];
+};
+
+struct spectrum_history_scope
+{
+    unsigned long seq;      // lines received, the newest is seq - 1
+    struct spectrum_buffer *ring[SPECTRUM_HISTORY_LINES];   // held
+    struct spectrum_history_result results[SPECTRUM_HISTORY_RESULTS];
+    int next_result;
+};
+
+struct spectrum_history
+{
+    pthread_mutex_t lock;
+    unsigned long computed; // queries not answered from results[]
+    struct spectrum_history_scope *scopes[HAMLIB_MAX_SPECTRUM_SCOPES];
+};
+
+extern int spectrum_history_init(RIG *rig);
+extern void spectrum_history_cleanup(RIG *rig);
+extern void spectrum_history_push(RIG *rig, struct spectrum_buffer *buf);
+
+/* Kernels, over n bins of count lines; exported for the tests */
+extern void spectrum_kernel_average(unsigned char *out,
+                                    const unsigned char *const lines[],
+                                    int count, size_t n);
+extern void spectrum_kernel_max(unsigned char *out,
+                                const unsigned char *const lines[],
+                                int count, size_t n);
+extern void spectrum_kernel_min(unsigned char *out,
+                                const unsigned char *const lines[],
+                                int count, size_t n);
+extern void spectrum_kernel_decimate(unsigned char *out, size_t bins,
+                                     const unsigned char *in, size_t n,
+                                     enum rig_spectrum_history_e op);
+
+__END_DECLS
+
+#endif /* _HL_SPECTRUM_HISTORY_H */
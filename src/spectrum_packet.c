@@ -0,0 +1,387 @@
+/*
+ *  Hamlib Interface - binary spectrum line packets
+ *  Copyright (c) 2026 The Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+/*
+ * Binary spectrum line packets, see spectrum_packet.h for the layout.
+ *
+ * A JSON snapshot carries a line as a hex string inside a few hundred
+ * bytes of rig state, built through a cJSON tree.  Here the header is
+ * fixed and the data goes as bytes, run length encoded when that is
+ * shorter.  Scope lines change little from one to the next, so the
+ * difference from the previous line is mostly runs of zeroes and packs
+ * best.
+ */
+
+#include "hamlib/config.h"
+
+#include <string.h>
+
+#include "hamlib/rig.h"
+#include "spectrum_packet.h"
+
+static void put_be16(unsigned char *p, uint16_t v)
+{
+    p[0] = v >> 8;
+    p[1] = v;
+}
+
+static void put_be32(unsigned char *p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
+
+static void put_be64(unsigned char *p, uint64_t v)
+{
+    put_be32(p, v >> 32);
+    put_be32(p + 4, (uint32_t) v);
+}
+
+static uint16_t get_be16(const unsigned char *p)
+{
+    return (uint16_t)(p[0] << 8 | p[1]);
+}
+
+static uint32_t get_be32(const unsigned char *p)
+{
+    return (uint32_t) p[0] << 24 | (uint32_t) p[1] << 16
+           | (uint32_t) p[2] << 8 | p[3];
+}
+
+static uint64_t get_be64(const unsigned char *p)
+{
+    return (uint64_t) get_be32(p) << 32 | get_be32(p + 4);
+}
+
+static uint64_t freq_to_hz(freq_t freq)
+{
+    return freq > 0 ? (uint64_t)(freq + 0.5) : 0;
+}
+
+static int32_t db_to_mdb(double db)
+{
+    return (int32_t)(db * 1000 + (db < 0 ? -0.5 : 0.5));
+}
+
+/*
+ * PackBits: a header byte h < 128 is followed by h + 1 literal bytes,
+ * h > 128 by one byte repeated 257 - h times.  Returns the encoded length
+ * or -1 if it does not fit in out_len.
+ */
+static int rle_encode(const unsigned char *in, size_t n, unsigned char *out,
+                      size_t out_len)
+{
+    size_t i = 0, o = 0;
+
+    while (i < n)
+    {
+        size_t run = 1;
+        size_t start;
+
+        while (i + run < n && run < 128 && in[i + run] == in[i]) { run++; }
+
+        if (run >= 3)
+        {
+            if (o + 2 > out_len) { return -1; }
+
+            out[o++] = (unsigned char)(257 - run);
+            out[o++] = in[i];
+            i += run;
+            continue;
+        }
+
+        // literals up to the next run of three
+        start = i;
+
+        while (i < n && i - start < 128)
+        {
+            if (i + 2 < n && in[i] == in[i + 1] && in[i] == in[i + 2]) { break; }
+
+            i++;
+        }
+
+        if (o + 1 + (i - start) > out_len) { return -1; }
+
+        out[o++] = (unsigned char)(i - start - 1);
+        memcpy(out + o, in + start, i - start);
+        o += i - start;
+    }
+
+    return (int) o;
+}
+
+static int rle_decode(const unsigned char *in, size_t n, unsigned char *out,
+                      size_t out_len)
+{
+    size_t i = 0, o = 0;
+
+    while (i < n)
+    {
+        unsigned int h = in[i++];
+
+        if (h < 128)
+        {
+            size_t lit = h + 1;
+
+            if (i + lit > n || o + lit > out_len) { return -1; }
+
+            memcpy(out + o, in + i, lit);
+            i += lit;
+            o += lit;
+        }
+        else if (h > 128)
+        {
+            size_t run = 257 - h;
+
+            if (i >= n || o + run > out_len) { return -1; }
+
+            memset(out + o, in[i++], run);
+            o += run;
+        }
+    }
+
+    return (int) o;
+}
+
+/**
+ * Returns true if \a buf starts like a binary spectrum packet rather than
+ * a JSON snapshot.
+ */
+int spectrum_packet_is_binary(const unsigned char *buf, size_t len)
+{
+    return len >= SPECTRUM_PACKET_HEADER_SIZE
+           && memcmp(buf, SPECTRUM_PACKET_MAGIC, 4) == 0;
+}
+
+/**
+ * Encodes \a line into \a buf, picking the shortest of the RAW, RLE and
+ * DELTA payloads, and records it in \a state as the base for the next
+ * DELTA line of its scope.
+ *
+ * Returns the packet length, or -RIG_EINVAL if the line is too long for
+ * the format or \a buf.
+ */
+int spectrum_packet_encode(struct spectrum_packet_state *state,
+                           const struct rig_spectrum_line *line,
+                           unsigned char *buf, size_t buf_len)
+{
+    unsigned char packed[HAMLIB_MAX_SPECTRUM_DATA];
+    unsigned char *payload = buf + SPECTRUM_PACKET_HEADER_SIZE;
+    struct spectrum_packet_stream *s = NULL;
+    size_t n = line->spectrum_data_length;
+    int encoding = SPECTRUM_PACKET_RAW;
+    int payload_len = (int) n;
+    uint32_t seq = 0;
+    size_t i;
+
+    if (n > HAMLIB_MAX_SPECTRUM_DATA || buf_len < SPECTRUM_PACKET_HEADER_SIZE + n)
+    {
+        return -RIG_EINVAL;
+    }
+
+    if (line->id >= 0 && line->id < HAMLIB_MAX_SPECTRUM_SCOPES)
+    {
+        s = &state->scopes[line->id];
+        seq = s->seq + 1;
+    }
+
+    if (n > 1)
+    {
+        int len = rle_encode(line->spectrum_data, n, payload, n - 1);
+
+        if (len > 0)
+        {
+            encoding = SPECTRUM_PACKET_RLE;
+            payload_len = len;
+        }
+
+        if (s && s->valid && s->length == n
+                && s->since_key < SPECTRUM_PACKET_KEY_INTERVAL - 1)
+        {
+            unsigned char delta[HAMLIB_MAX_SPECTRUM_DATA];
+
+            for (i = 0; i < n; i++)
+            {
+                delta[i] = line->spectrum_data[i] - s->data[i];
+            }
+
+            len = rle_encode(delta, n, packed, payload_len - 1);
+
+            if (len > 0)
+            {
+                encoding = SPECTRUM_PACKET_DELTA;
+                payload_len = len;
+                memcpy(payload, packed, len);
+            }
+        }
+    }
+
+    if (encoding == SPECTRUM_PACKET_RAW)
+    {
+        memcpy(payload, line->spectrum_data, n);
+    }
+
+    memcpy(buf, SPECTRUM_PACKET_MAGIC, 4);
+    buf[4] = SPECTRUM_PACKET_VERSION;
+    buf[5] = encoding;
+    buf[6] = (unsigned char) line->id;
+    buf[7] = (unsigned char) line->spectrum_mode;
+    put_be32(buf + 8, seq);
+    put_be32(buf + 12, (uint32_t) line->data_level_min);
+    put_be32(buf + 16, (uint32_t) line->data_level_max);
+    put_be32(buf + 20, (uint32_t) db_to_mdb(line->signal_strength_min));
+    put_be32(buf + 24, (uint32_t) db_to_mdb(line->signal_strength_max));
+    put_be64(buf + 28, freq_to_hz(line->center_freq));
+    put_be64(buf + 36, freq_to_hz(line->span_freq));
+    put_be64(buf + 44, freq_to_hz(line->low_edge_freq));
+    put_be64(buf + 52, freq_to_hz(line->high_edge_freq));
+    put_be16(buf + 60, (uint16_t) n);
+    put_be16(buf + 62, (uint16_t) payload_len);
+
+    if (s)
+    {
+        s->seq = seq;
+        s->valid = 1;
+        s->since_key = encoding == SPECTRUM_PACKET_DELTA ? s->since_key + 1 : 0;
+        s->length = n;
+        memcpy(s->data, line->spectrum_data, n);
+    }
+
+    return SPECTRUM_PACKET_HEADER_SIZE + payload_len;
+}
+
+/**
+ * Decodes the packet in \a buf into \a line, with the data bytes in
+ * \a data (HAMLIB_MAX_SPECTRUM_DATA long).  Gaps in a scope's sequence
+ * numbers are added to state->lost.
+ *
+ * Returns RIG_OK, -RIG_EPROTO if the packet is malformed, or
+ * -RIG_ENAVAIL for a DELTA line whose previous line was not received.
+ */
+int spectrum_packet_decode(struct spectrum_packet_state *state,
+                           const unsigned char *buf, size_t len,
+                           struct rig_spectrum_line *line,
+                           unsigned char *data)
+{
+    struct spectrum_packet_stream *s = NULL;
+    const unsigned char *payload = buf + SPECTRUM_PACKET_HEADER_SIZE;
+    size_t n, payload_len;
+    uint32_t seq;
+    int id;
+    size_t i;
+
+    if (!spectrum_packet_is_binary(buf, len) || buf[4] != SPECTRUM_PACKET_VERSION)
+    {
+        return -RIG_EPROTO;
+    }
+
+    id = buf[6];
+    seq = get_be32(buf + 8);
+    n = get_be16(buf + 60);
+    payload_len = get_be16(buf + 62);
+
+    if (n > HAMLIB_MAX_SPECTRUM_DATA
+            || payload_len != len - SPECTRUM_PACKET_HEADER_SIZE)
+    {
+        return -RIG_EPROTO;
+    }
+
+    if (id < HAMLIB_MAX_SPECTRUM_SCOPES)
+    {
+        s = &state->scopes[id];
+
+        // seq 0 means nothing seen yet; a restarted sender goes backwards
+        if (s->seq != 0 && (int32_t)(seq - s->seq) > 1)
+        {
+            state->lost += seq - s->seq - 1;
+        }
+    }
+
+    switch (buf[5])
+    {
+    case SPECTRUM_PACKET_RAW:
+        if (payload_len != n) { return -RIG_EPROTO; }
+
+        memcpy(data, payload, n);
+        break;
+
+    case SPECTRUM_PACKET_RLE:
+        if (rle_decode(payload, payload_len, data, n) != (int) n)
+        {
+            return -RIG_EPROTO;
+        }
+
+        break;
+
+    case SPECTRUM_PACKET_DELTA:
+        if (!s || !s->valid || seq != s->seq + 1 || s->length != n)
+        {
+            if (s)
+            {
+                s->seq = seq;
+                s->valid = 0;
+            }
+
+            return -RIG_ENAVAIL;
+        }
+
+        if (rle_decode(payload, payload_len, data, n) != (int) n)
+        {
+            return -RIG_EPROTO;
+        }
+
+        for (i = 0; i < n; i++)
+        {
+            data[i] += s->data[i];
+        }
+
+        break;
+
+    default:
+        return -RIG_EPROTO;
+    }
+
+    line->id = id;
+    line->spectrum_mode = buf[7];
+    line->data_level_min = (int32_t) get_be32(buf + 12);
+    line->data_level_max = (int32_t) get_be32(buf + 16);
+    line->signal_strength_min = (int32_t) get_be32(buf + 20) / 1000.0;
+    line->signal_strength_max = (int32_t) get_be32(buf + 24) / 1000.0;
+    line->center_freq = (freq_t) get_be64(buf + 28);
+    line->span_freq = (freq_t) get_be64(buf + 36);
+    line->low_edge_freq = (freq_t) get_be64(buf + 44);
+    line->high_edge_freq = (freq_t) get_be64(buf + 52);
+    line->spectrum_data_length = n;
+    line->spectrum_data = data;
+
+    if (s)
+    {
+        s->seq = seq;
+        s->valid = 1;
+        s->length = n;
+        memcpy(s->data, data, n);
+    }
+
+    return RIG_OK;
+}
@@ -0,0 +1,104 @@
+/*
+ *  Hamlib Interface - binary spectrum line packets
+ *  Copyright (c) 2026 The Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#ifndef _HL_SPECTRUM_PACKET_H
+#define _HL_SPECTRUM_PACKET_H 1
+
+#include <stdint.h>
+
+#include "hamlib/rig.h"
+
+__BEGIN_DECLS
+
+/*
+ * With multicast_spectrum_format=binary the multicast publisher sends
+ * each spectrum line as one UDP packet in this format instead of a JSON
+ * snapshot.  Other snapshots stay JSON; a receiver tells them apart by
+ * the magic.  All fields are big endian.
+ *
+ *  offset size
+ *   0  4   magic "HLSP"
+ *   4  1   format version, SPECTRUM_PACKET_VERSION
+ *   5  1   payload encoding, enum spectrum_packet_encoding_e
+ *   6  1   scope id
+ *   7  1   spectrum mode, enum rig_spectrum_mode_e
+ *   8  4   sequence number, counted per scope id
+ *  12  4   data_level_min, signed
+ *  16  4   data_level_max, signed
+ *  20  4   signal_strength_min, signed, 1/1000 dB
+ *  24  4   signal_strength_max, signed, 1/1000 dB
+ *  28  8   center_freq, Hz
+ *  36  8   span_freq, Hz
+ *  44  8   low_edge_freq, Hz
+ *  52  8   high_edge_freq, Hz
+ *  60  2   number of data bytes in the line
+ *  62  2   number of payload bytes following the header
+ *  64      payload
+ *
+ * Payloads are the data bytes as they are (RAW), PackBits run length
+ * encoded (RLE), or the bytewise difference, modulo 256, from the
+ * previous line of the same scope, run length encoded (DELTA).  A DELTA
+ * line can only be decoded if the line with the sequence number before
+ * it was; the sender makes every SPECTRUM_PACKET_KEY_INTERVAL-th line of
+ * a scope a RAW or RLE one so a receiver that lost a packet catches up.
+ */
+#define SPECTRUM_PACKET_MAGIC "HLSP"
+#define SPECTRUM_PACKET_VERSION 1
+#define SPECTRUM_PACKET_HEADER_SIZE 64
+#define SPECTRUM_PACKET_MAX_SIZE (SPECTRUM_PACKET_HEADER_SIZE + HAMLIB_MAX_SPECTRUM_DATA)
+#define SPECTRUM_PACKET_KEY_INTERVAL 16
+
+enum spectrum_packet_encoding_e {
+    SPECTRUM_PACKET_RAW = 0,
+    SPECTRUM_PACKET_RLE = 1,
+    SPECTRUM_PACKET_DELTA = 2,
+};
+
+/* Previous line of one scope, as sent or as received */
+struct spectrum_packet_stream
+{
+    uint32_t seq;           // sequence number of the last line
+    int valid;              // data[] holds the line with sequence number seq
+    int since_key;          // lines sent since the last RAW/RLE one
+    size_t length;
+    unsigned char data[HAMLIB_MAX_SPECTRUM_DATA];
+};
+
+/* Encoder or decoder state, one per publisher or per receiver */
+struct spectrum_packet_state
+{
+    struct spectrum_packet_stream scopes[HAMLIB_MAX_SPECTRUM_SCOPES];
+    unsigned long lost;     // decoder: lines missing from the sequence
+};
+
+extern int spectrum_packet_is_binary(const unsigned char *buf, size_t len);
+extern int spectrum_packet_encode(struct spectrum_packet_state *state,
+                                  const struct rig_spectrum_line *line,
+                                  unsigned char *buf, size_t buf_len);
+extern int spectrum_packet_decode(struct spectrum_packet_state *state,
+                                  const unsigned char *buf, size_t len,
+                                  struct rig_spectrum_line *line,
+                                  unsigned char *data);
+
+__END_DECLS
+
+#endif /* _HL_SPECTRUM_PACKET_H */
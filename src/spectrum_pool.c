@@ -0,0 +1,287 @@
+/*
+ *  Hamlib Interface - pool of spectrum line buffers
+ *  Copyright (c) 2026 The Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+/**
+ * \addtogroup rig
+ * @{
+ */
+
+/**
+ * \file spectrum_pool.c
+ * \brief Reference counted spectrum line buffers
+ *
+ * A scope sends 20-50 lines a second per scope.  Each used to be copied
+ * into the history, twice through the multicast publisher's pipe and
+ * once more on the publisher's stack.  Now a backend assembles the line
+ * into a pooled buffer and every consumer holds the same buffer.
+ */
+
+#include "hamlib/config.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hamlib/rig.h"
+#include "hamlib/rig_state.h"
+#include "spectrum_pool.h"
+
+int spectrum_pool_init(RIG *rig)
+{
+    struct spectrum_pool *pool = calloc(1, sizeof(*pool));
+
+    if (!pool)
+    {
+        return -RIG_ENOMEM;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    STATE(rig)->spectrum_pool = pool;
+
+    return RIG_OK;
+}
+
+/* Called with pool->lock held */
+static void spectrum_buffer_free(struct spectrum_pool *pool,
+                                 struct spectrum_buffer *buf)
+{
+    struct spectrum_buffer **p;
+
+    for (p = &pool->all; *p != buf; p = &(*p)->next) { }
+
+    *p = buf->next;
+    pool->count--;
+    buf->magic = 0;
+    free(buf);
+}
+
+static void spectrum_pool_free(struct spectrum_pool *pool)
+{
+    pthread_mutex_destroy(&pool->lock);
+    free(pool);
+}
+
+/*
+ * After the backend and every consumer inside Hamlib let go of their
+ * lines.  Buffers still held, by an application or a publisher that was
+ * stopped with lines in its pipe, keep the pool alive until they are
+ * released.
+ */
+void spectrum_pool_cleanup(RIG *rig)
+{
+    struct spectrum_pool *pool = STATE(rig)->spectrum_pool;
+    int last;
+
+    if (!pool)
+    {
+        return;
+    }
+
+    STATE(rig)->spectrum_pool = NULL;
+
+    pthread_mutex_lock(&pool->lock);
+
+    pool->closed = 1;
+
+    while (pool->free)
+    {
+        struct spectrum_buffer *buf = pool->free;
+
+        pool->free = buf->next_free;
+        spectrum_buffer_free(pool, buf);
+    }
+
+    last = pool->count == 0;
+    pthread_mutex_unlock(&pool->lock);
+
+    if (last)
+    {
+        spectrum_pool_free(pool);
+    }
+}
+
+/*
+ * A free buffer with one reference, for a backend to assemble a line
+ * into.  NULL when out of memory or when SPECTRUM_POOL_MAX_BUFFERS are
+ * all held, which takes a consumer that stopped releasing its lines.
+ */
+struct spectrum_buffer *spectrum_buffer_get(RIG *rig)
+{
+    struct spectrum_pool *pool = STATE(rig)->spectrum_pool;
+    struct spectrum_buffer *buf;
+
+    if (!pool)
+    {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+
+    buf = pool->free;
+
+    if (buf)
+    {
+        pool->free = buf->next_free;
+    }
+    else if (pool->count < SPECTRUM_POOL_MAX_BUFFERS)
+    {
+        buf = malloc(sizeof(*buf));
+
+        if (buf)
+        {
+            buf->pool = pool;
+            buf->magic = SPECTRUM_BUFFER_MAGIC;
+            buf->next = pool->all;
+            pool->all = buf;
+            pool->count++;
+        }
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    if (!buf)
+    {
+        rig_debug(RIG_DEBUG_WARN, "%s: no free spectrum line buffer\n", __func__);
+        return NULL;
+    }
+
+    buf->next_free = NULL;
+    buf->refs = 1;
+    memset(&buf->line, 0, sizeof(buf->line));
+    buf->line.spectrum_data = buf->data;
+
+    return buf;
+}
+
+void spectrum_buffer_ref(struct spectrum_buffer *buf)
+{
+    __atomic_add_fetch(&buf->refs, 1, __ATOMIC_RELAXED);
+}
+
+void spectrum_buffer_unref(struct spectrum_buffer *buf)
+{
+    struct spectrum_pool *pool = buf->pool;
+    int last = 0;
+
+    if (__atomic_sub_fetch(&buf->refs, 1, __ATOMIC_ACQ_REL) != 0)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+
+    if (pool->closed)
+    {
+        spectrum_buffer_free(pool, buf);
+        last = pool->count == 0;
+    }
+    else
+    {
+        buf->next_free = pool->free;
+        pool->free = buf;
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    if (last)
+    {
+        spectrum_pool_free(pool);
+    }
+}
+
+/*
+ * The buffer a line lives in, or NULL for a line that is not in one.  A
+ * line in a buffer points at the data right behind it and the magic, so
+ * the magic is only read when the memory after the line has that shape.
+ */
+struct spectrum_buffer *spectrum_buffer_of(const struct rig_spectrum_line *line)
+{
+    struct spectrum_buffer *buf = (struct spectrum_buffer *)((char *) line -
+                                  offsetof(struct spectrum_buffer, line));
+
+    if (line->spectrum_data != buf->data || buf->magic != SPECTRUM_BUFFER_MAGIC)
+    {
+        return NULL;
+    }
+
+    return buf;
+}
+
+/**
+ * \brief Keep a spectrum line after the spectrum callback returns
+ * \param rig   The rig handle
+ * \param line  The line as passed to the spectrum callback
+ *
+ * Lines passed to the callback are shared with the rest of Hamlib and
+ * are otherwise only valid during the call.  A consumer that works on
+ * them later, on another thread, holds the line instead of copying it,
+ * and releases it with rig_release_spectrum_line() when done.
+ *
+ * \return RIG_OK, or -RIG_EINVAL if \a line was not passed to the
+ * spectrum callback.
+ *
+ * \sa rig_set_spectrum_callback(), rig_release_spectrum_line()
+ */
+int HAMLIB_API rig_hold_spectrum_line(RIG *rig,
+                                      const struct rig_spectrum_line *line)
+{
+    struct spectrum_buffer *buf;
+
+    if (!rig || !line || !(buf = spectrum_buffer_of(line)))
+    {
+        return -RIG_EINVAL;
+    }
+
+    spectrum_buffer_ref(buf);
+
+    return RIG_OK;
+}
+
+/**
+ * \brief Release a spectrum line kept with rig_hold_spectrum_line()
+ * \param rig   The rig handle
+ * \param line  The line
+ *
+ * Every hold needs one release.  A line held across rig_cleanup() stays
+ * valid and may still be released afterwards.
+ *
+ * \return RIG_OK, or -RIG_EINVAL if \a line was not passed to the
+ * spectrum callback.
+ *
+ * \sa rig_hold_spectrum_line()
+ */
+int HAMLIB_API rig_release_spectrum_line(RIG *rig,
+        const struct rig_spectrum_line *line)
+{
+    struct spectrum_buffer *buf;
+
+    if (!rig || !line || !(buf = spectrum_buffer_of(line)))
+    {
+        return -RIG_EINVAL;
+    }
+
+    spectrum_buffer_unref(buf);
+
+    return RIG_OK;
+}
+
+/** @} */
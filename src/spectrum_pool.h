@@ -0,0 +1,79 @@
+/*
+ *  Hamlib Interface - pool of spectrum line buffers
+ *  Copyright (c) 2026 The Hamlib Group
+ *
+ *
+ *   This library is free software; you can redistribute it and/or
+ *   modify it under the terms of the GNU Lesser General Public
+ *   License as published by the Free Software Foundation; either
+ *   version 2.1 of the License, or (at your option) any later version.
+ *
+ *   This library is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *   Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public
+ *   License along with this library; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#ifndef _HL_SPECTRUM_POOL_H
+#define _HL_SPECTRUM_POOL_H 1
+
+#include <pthread.h>
+
+#include "hamlib/rig.h"
+
+__BEGIN_DECLS
+
+/*
+ * A spectrum line is assembled once, into a buffer from the rig's pool,
+ * and then handed around by pointer: the history, the multicast
+ * publisher and the application callback each take a reference for as
+ * long as they need the line.  The buffer goes back to the pool when
+ * the last one is dropped.
+ */
+#define SPECTRUM_POOL_MAX_BUFFERS 512
+
+/* Marks a buffer of a pool, so a line that merely looks like one is not */
+#define SPECTRUM_BUFFER_MAGIC 0x5370624cU
+
+struct spectrum_pool;
+
+struct spectrum_buffer
+{
+    struct spectrum_pool *pool;
+    struct spectrum_buffer *next;       // all buffers of the pool
+    struct spectrum_buffer *next_free;
+    int refs;
+    struct rig_spectrum_line line;      // spectrum_data points at data
+    unsigned int magic;                 // SPECTRUM_BUFFER_MAGIC while allocated
+    unsigned char data[HAMLIB_MAX_SPECTRUM_DATA];
+};
+
+struct spectrum_pool
+{
+    pthread_mutex_t lock;
+    struct spectrum_buffer *all;
+    struct spectrum_buffer *free;
+    int count;              // buffers allocated
+    int closed;             // the rig is gone, the last release frees the pool
+    unsigned long lines;    // lines fired
+    unsigned long copies;   // of those, lines copied into a buffer
+};
+
+extern int spectrum_pool_init(RIG *rig);
+extern void spectrum_pool_cleanup(RIG *rig);
+
+extern struct spectrum_buffer *spectrum_buffer_get(RIG *rig);
+extern void spectrum_buffer_ref(struct spectrum_buffer *buf);
+extern void spectrum_buffer_unref(struct spectrum_buffer *buf);
+extern struct spectrum_buffer *spectrum_buffer_of(
+    const struct rig_spectrum_line *line);
+
+__END_DECLS
+
+#endif /* _HL_SPECTRUM_POOL_H */
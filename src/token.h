@@ -145,6 +145,10 @@
 #define TOK_FREQ_SKIP  TOKEN_FRONTEND(136)
 /** \brief rig: Client ID of WSJTX or GPREDICT */
 #define TOK_CLIENT  TOKEN_FRONTEND(137)
+/** \brief rig: Multicast spectrum line format, JSON or BINARY */
+#define TOK_MULTICAST_SPECTRUM_FORMAT  TOKEN_FRONTEND(138)
+/** \brief rig: Write only the memory channels that changed, OFF, ON or VERIFY */
+#define TOK_MEM_INCREMENTAL  TOKEN_FRONTEND(139)
 
 /*
  * rotator specific tokens
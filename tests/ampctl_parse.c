@@ -71,6 +71,7 @@ extern int read_history();
 #include "sprintflst.h"
 
 #include "ampctl_parse.h"
+#include "cmd_index.h"
 
 /* Hash table implementation See:  http://uthash.sourceforge.net/ */
 #include "uthash.h"
@@ -207,22 +208,23 @@ struct test_table test_list[] =
     { 0x00, "", NULL },
 };
 
+static struct cmd_index cmd_lookup;
+static pthread_once_t cmd_lookup_once = PTHREAD_ONCE_INIT;
+
+static void cmd_lookup_init(void)
+{
+    CMD_INDEX_INIT(&cmd_lookup, test_list, struct test_table);
+}
+
+
 struct test_table *find_cmd_entry(int cmd)
 {
     int i;
 
-    for (i = 0; test_list[i].cmd != 0; i++)
-        if (test_list[i].cmd == cmd)
-        {
-            break;
-        }
-
-    if (test_list[i].cmd == 0x00)
-    {
-        return NULL;
-    }
+    pthread_once(&cmd_lookup_once, cmd_lookup_init);
+    i = cmd_index_find_cmd(&cmd_lookup, cmd);
 
-    return &test_list[i];
+    return i < 0 ? NULL : &test_list[i];
 }
 
 
@@ -328,19 +330,16 @@ static void rp_getline(const char *s)
 #endif
 
 /*
- * TODO: use Lex?
+ * Long command name to its one character command, 0 if unknown
  */
 char parse_arg(const char *arg)
 {
-    for (int i = 0; test_list[i].cmd != 0; i++)
-    {
-        if (!strncmp(arg, test_list[i].name, MAXNAMSIZ))
-        {
-            return test_list[i].cmd;
-        }
-    }
+    int i;
+
+    pthread_once(&cmd_lookup_once, cmd_lookup_init);
+    i = cmd_index_find_name(&cmd_lookup, arg);
 
-    return 0;
+    return i < 0 ? 0 : test_list[i].cmd;
 }
 
 
@@ -0,0 +1,245 @@
+/*
+ * cmd_index.c - (C) The Hamlib Group 2026
+ *
+ * Command lookup tables for the rigctl/rotctl/ampctl parsers.
+ *
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+/*
+ * The one character commands index a 256 entry table directly.  Long
+ * names ("\get_vfo_info") go through a hash and displace perfect hash
+ * built when the parser starts: names are spread over a few buckets by
+ * one hash, then each bucket gets the displacement (a second hash seed)
+ * that puts all its names into free slots.  A lookup is thus two hashes
+ * and one strcmp(), whatever the size of the table.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hamlib/rig.h"
+#include "cmd_index.h"
+
+#define ENTRY_CMD(ix, i) \
+    (*(const unsigned char *)((ix)->table + (size_t)(i) * (ix)->stride + (ix)->cmd_offset))
+#define ENTRY_NAME(ix, i) \
+    (*(const char *const *)((ix)->table + (size_t)(i) * (ix)->stride + (ix)->name_offset))
+
+static uint32_t name_hash(const char *name, uint32_t seed)
+{
+    uint32_t h = 2166136261u ^ (seed * 0x9e3779b9u);
+
+    while (*name)
+    {
+        h ^= (unsigned char) *name++;
+        h *= 16777619u;
+    }
+
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+
+    return h;
+}
+
+/* Find slots for all names of one bucket, returns 0 on success */
+static int place_bucket(struct cmd_index *ix, unsigned int bucket,
+                        const short *members, int count)
+{
+    unsigned int slot[CMD_INDEX_MAX_SLOTS];
+    unsigned int d;
+    int i, j;
+
+    for (d = 0; d <= 0xffff; d++)
+    {
+        for (i = 0; i < count; i++)
+        {
+            slot[i] = name_hash(ENTRY_NAME(ix, members[i]), d + 1)
+                      & (ix->nslots - 1);
+
+            if (ix->by_name[slot[i]] >= 0) { break; }
+
+            for (j = 0; j < i && slot[j] != slot[i]; j++) {}
+
+            if (j < i) { break; }
+        }
+
+        if (i == count)
+        {
+            for (i = 0; i < count; i++)
+            {
+                ix->by_name[slot[i]] = members[i];
+            }
+
+            ix->disp[bucket] = d;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+void cmd_index_build(struct cmd_index *ix, const void *table, size_t stride,
+                     size_t cmd_offset, size_t name_offset)
+{
+    unsigned int count[CMD_INDEX_MAX_BUCKETS];
+    unsigned int order[CMD_INDEX_MAX_BUCKETS];
+    short *bucket_of;
+    short *members;
+    unsigned int n, i, j, b;
+
+    memset(ix, 0, sizeof(*ix));
+    ix->table = table;
+    ix->stride = stride;
+    ix->cmd_offset = cmd_offset;
+    ix->name_offset = name_offset;
+    memset(ix->by_cmd, 0xff, sizeof(ix->by_cmd));
+    memset(ix->by_name, 0xff, sizeof(ix->by_name));
+
+    // first entry wins, as with the old linear scans
+    for (n = 0; ENTRY_CMD(ix, n) != 0; n++)
+    {
+        if (ix->by_cmd[ENTRY_CMD(ix, n)] < 0)
+        {
+            ix->by_cmd[ENTRY_CMD(ix, n)] = n;
+        }
+    }
+
+    for (ix->nslots = 16; ix->nslots < 2 * n; ix->nslots <<= 1) {}
+
+    ix->nbuckets = n / 4 + 1;
+
+    if (ix->nslots > CMD_INDEX_MAX_SLOTS || ix->nbuckets > CMD_INDEX_MAX_BUCKETS)
+    {
+        rig_debug(RIG_DEBUG_WARN, "%s: %u commands, using linear lookup\n",
+                  __func__, n);
+        return;
+    }
+
+    bucket_of = malloc(n * sizeof(*bucket_of));
+    members = malloc(n * sizeof(*members));
+
+    if (!bucket_of || !members)
+    {
+        free(bucket_of);
+        free(members);
+        return;
+    }
+
+    memset(count, 0, sizeof(count));
+
+    for (i = 0; i < n; i++)
+    {
+        const char *name = ENTRY_NAME(ix, i);
+
+        bucket_of[i] = -1;
+
+        if (!name || !*name) { continue; }
+
+        for (j = 0; j < i && !(ENTRY_NAME(ix, j)
+                               && strcmp(ENTRY_NAME(ix, j), name) == 0); j++) {}
+
+        if (j < i) { continue; }  // duplicate name, the first one wins
+
+        bucket_of[i] = name_hash(name, 0) % ix->nbuckets;
+        count[bucket_of[i]]++;
+    }
+
+    // biggest buckets first, while there is most room
+    for (b = 0; b < ix->nbuckets; b++)
+    {
+        for (j = b; j > 0 && count[order[j - 1]] < count[b]; j--)
+        {
+            order[j] = order[j - 1];
+        }
+
+        order[j] = b;
+    }
+
+    for (b = 0; b < ix->nbuckets && count[order[b]] > 0; b++)
+    {
+        int nmembers = 0;
+
+        for (i = 0; i < n; i++)
+        {
+            if (bucket_of[i] == (short) order[b]) { members[nmembers++] = i; }
+        }
+
+        if (place_bucket(ix, order[b], members, nmembers) != 0)
+        {
+            rig_debug(RIG_DEBUG_WARN, "%s: no perfect hash, using linear lookup\n",
+                      __func__);
+            break;
+        }
+    }
+
+    ix->built = b == ix->nbuckets || count[order[b]] == 0;
+
+    free(bucket_of);
+    free(members);
+}
+
+/* Returns the table index of command cmd, or -1 */
+int cmd_index_find_cmd(const struct cmd_index *ix, int cmd)
+{
+    int i;
+
+    if (cmd <= 0 || cmd > 255)
+    {
+        return -1;
+    }
+
+    if (ix->built)
+    {
+        return ix->by_cmd[cmd];
+    }
+
+    for (i = 0; ENTRY_CMD(ix, i) != 0; i++)
+    {
+        if (ENTRY_CMD(ix, i) == cmd) { return i; }
+    }
+
+    return -1;
+}
+
+/* Returns the table index of the long command name, or -1 */
+int cmd_index_find_name(const struct cmd_index *ix, const char *name)
+{
+    int i;
+
+    if (ix->built)
+    {
+        unsigned int b = name_hash(name, 0) % ix->nbuckets;
+
+        i = ix->by_name[name_hash(name, ix->disp[b] + 1) & (ix->nslots - 1)];
+
+        return i >= 0 && strcmp(ENTRY_NAME(ix, i), name) == 0 ? i : -1;
+    }
+
+    for (i = 0; ENTRY_CMD(ix, i) != 0; i++)
+    {
+        if (ENTRY_NAME(ix, i) && strcmp(ENTRY_NAME(ix, i), name) == 0)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
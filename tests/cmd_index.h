@@ -0,0 +1,59 @@
+/*
+ * cmd_index.h - (C) The Hamlib Group 2026
+ *
+ * Command lookup tables for the rigctl/rotctl/ampctl parsers.
+ *
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef CMD_INDEX_H
+#define CMD_INDEX_H
+
+#include <stddef.h>
+
+#define CMD_INDEX_MAX_BUCKETS 256
+#define CMD_INDEX_MAX_SLOTS 1024
+
+/*
+ * Index of a parser's test_list[]: a direct table for the one character
+ * commands and a perfect hash for the long names.  Entries are indexes
+ * into the table, -1 when empty.  The table must end with a 0 command.
+ */
+struct cmd_index
+{
+    const char *table;
+    size_t stride;          // sizeof(test_list[0])
+    size_t cmd_offset;      // offsetof(struct test_table, cmd)
+    size_t name_offset;     // offsetof(struct test_table, name)
+    int built;              // 0: fall back to scanning the table
+    unsigned int nbuckets;
+    unsigned int nslots;    // power of 2
+    short by_cmd[256];
+    unsigned short disp[CMD_INDEX_MAX_BUCKETS];
+    short by_name[CMD_INDEX_MAX_SLOTS];
+};
+
+#define CMD_INDEX_INIT(ix, list, type) \
+    cmd_index_build((ix), (list), sizeof(type), offsetof(type, cmd), \
+                    offsetof(type, name))
+
+void cmd_index_build(struct cmd_index *ix, const void *table, size_t stride,
+                     size_t cmd_offset, size_t name_offset);
+int cmd_index_find_cmd(const struct cmd_index *ix, int cmd);
+int cmd_index_find_name(const struct cmd_index *ix, const char *name);
+
+#endif /* CMD_INDEX_H */
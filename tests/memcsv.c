@@ -38,6 +38,8 @@ extern int all;
 
 char csv_sep = ','; /* CSV separator */
 
+static int channels_read;   /* by the last csv_save() */
+
 /*
  * Prototypes
  */
@@ -75,6 +77,8 @@ int csv_save(RIG *rig, const char *outfilename)
 {
     int status;
     FILE *f;
+    struct timespec start;
+    double ms;
 
     f = fopen(outfilename, "w");
 
@@ -89,8 +93,19 @@ int csv_save(RIG *rig, const char *outfilename)
                rig->caps->clone_combo_get);
     }
 
+    channels_read = 0;
+    elapsed_ms(&start, HAMLIB_ELAPSED_SET);
+
     status = rig_get_chan_all_cb(rig, RIG_VFO_NONE, dump_csv_chan, f);
 
+    ms = elapsed_ms(&start, HAMLIB_ELAPSED_GET);
+
+    if (status == RIG_OK && ms > 0)
+    {
+        printf("Read %d channels in %.1f s, %.1f channels/s\n", channels_read,
+               ms / 1000, channels_read * 1000 / ms);
+    }
+
     fclose(f);
 
     return status;
@@ -152,6 +167,8 @@ int csv_load(RIG *rig, const char *infilename)
     /* Next, read the file line by line */
     while (fgets(line, sizeof line, f) != NULL)
     {
+        line[strcspn(line, "\r\n")] = '\0';
+
         /* Tokenize the line */
         if (!tokenize_line(line,
                            value_list,
@@ -271,12 +288,9 @@ static char *mystrtok(char *s, char delim)
         pos = 0;
         length = strlen(str);
     }
-    else
-    {
-        return NULL;
-    }
 
-    if (str && str[ pos + 1 ] == '\0')
+    /* past the last token */
+    if (str == NULL || pos > length)
     {
         return NULL;
     }
@@ -297,6 +311,8 @@ static char *mystrtok(char *s, char delim)
         }
     }
 
+    pos = length + 1;
+
     return str + ent_pos;
 }
 
@@ -581,6 +597,8 @@ int dump_csv_chan(RIG *rig,
         return RIG_OK;
     }
 
+    channels_read++;
+
     fprintf(f, "%d%c", chan.channel_num, csv_sep);
 
     if (mem_caps->bank_num)
@@ -746,7 +764,7 @@ int set_channel_data(RIG *rig,
     struct rig_state *rs = STATE(rig);
 
     memset(chan, 0, sizeof(channel_t));
-    chan->vfo = RIG_VFO_CURR;
+    chan->vfo = RIG_VFO_MEM;
 
     i = find_on_list(line_key_list, "num");
 
@@ -792,8 +810,15 @@ int set_channel_data(RIG *rig,
 
         if (i >= 0)
         {
-            strncpy(chan->channel_desc, line_data_list[ i ], rig->caps->chan_desc_sz - 1);
-            chan->channel_desc[ rig->caps->chan_desc_sz ] = '\0';
+            size_t len = sizeof(chan->channel_desc) - 1;
+
+            if (rig->caps->chan_desc_sz > 0 && (size_t)rig->caps->chan_desc_sz < len)
+            {
+                len = rig->caps->chan_desc_sz;
+            }
+
+            strncpy(chan->channel_desc, line_data_list[ i ], len);
+            chan->channel_desc[ len ] = '\0';
         }
     }
 
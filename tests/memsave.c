@@ -20,11 +20,14 @@
  */
 
 #include "hamlib/rig.h"
+#include "misc.h"
 
 #ifdef HAVE_XML2
 #  include <libxml/parser.h>
 #  include <libxml/tree.h>
 
+static int channels_read;   /* by the last xml_save() */
+
 static int dump_xml_chan(RIG *rig,
                          vfo_t vfo,
                          channel_t **chan,
@@ -40,6 +43,8 @@ int xml_save(RIG *rig, const char *outfilename)
     int retval;
     xmlDocPtr Doc;
     xmlNodePtr root;
+    struct timespec start;
+    double ms;
 
     /* create xlm Doc */
     Doc = xmlNewDoc((unsigned char *) "1.0");
@@ -52,6 +57,9 @@ int xml_save(RIG *rig, const char *outfilename)
         printf("About to save data, enter cloning mode: %s\n",
                rig->caps->clone_combo_get);
 
+    channels_read = 0;
+    elapsed_ms(&start, HAMLIB_ELAPSED_SET);
+
     retval = rig_get_chan_all_cb(rig, RIG_VFO_NONE, dump_xml_chan, root);
 
     if (retval != RIG_OK)
@@ -59,6 +67,14 @@ int xml_save(RIG *rig, const char *outfilename)
         return retval;
     }
 
+    ms = elapsed_ms(&start, HAMLIB_ELAPSED_GET);
+
+    if (ms > 0)
+    {
+        printf("Read %d channels in %.1f s, %.1f channels/s\n", channels_read,
+               ms / 1000, channels_read * 1000 / ms);
+    }
+
     /* write xml File */
 
     xmlSaveFormatFileEnc(outfilename, Doc, "UTF-8", 1);
@@ -113,6 +129,8 @@ int dump_xml_chan(RIG *rig,
         return RIG_OK;
     }
 
+    channels_read++;
+
     mtype = rig_strmtype(chan_list->type);
 
     for (i = 0; i < strlen(mtype); i++)
@@ -0,0 +1,173 @@
+/*
+ * Hamlib newcat_bench program
+ *
+ * Runs newcat get/set calls against a simulator and reports wall time
+ * and CPU time per call.  The simulator dominates the wall time; the CPU
+ * time is what the library spends building, validating and parsing
+ * commands.
+ *
+ *   simulators/simftdx101             (prints name=/dev/pts/N)
+ *   tests/newcat_bench /dev/pts/N [model] [loops]
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+
+#define LOOP_COUNT 50
+
+static int bench_get_freq(RIG *rig, int i)
+{
+    freq_t freq;
+
+    return rig_get_freq(rig, RIG_VFO_CURR, &freq);
+}
+
+static int bench_set_freq(RIG *rig, int i)
+{
+    return rig_set_freq(rig, RIG_VFO_CURR, 14074000 + (i % 10) * 100);
+}
+
+static int bench_get_mode(RIG *rig, int i)
+{
+    rmode_t mode;
+    pbwidth_t width;
+
+    return rig_get_mode(rig, RIG_VFO_CURR, &mode, &width);
+}
+
+static int bench_set_mode(RIG *rig, int i)
+{
+    return rig_set_mode(rig, RIG_VFO_CURR, (i & 1) ? RIG_MODE_USB : RIG_MODE_LSB,
+                        RIG_PASSBAND_NOCHANGE);
+}
+
+static int bench_get_ptt(RIG *rig, int i)
+{
+    ptt_t ptt;
+
+    return rig_get_ptt(rig, RIG_VFO_CURR, &ptt);
+}
+
+static int bench_get_level(RIG *rig, int i)
+{
+    value_t val;
+
+    return rig_get_level(rig, RIG_VFO_CURR, RIG_LEVEL_RFPOWER, &val);
+}
+
+static int bench_get_split(RIG *rig, int i)
+{
+    split_t split;
+    vfo_t tx_vfo;
+
+    return rig_get_split_vfo(rig, RIG_VFO_CURR, &split, &tx_vfo);
+}
+
+static const struct
+{
+    const char *name;
+    int (*run)(RIG *rig, int i);
+} bench_ops[] =
+{
+    { "get_freq", bench_get_freq },
+    { "set_freq", bench_set_freq },
+    { "get_mode", bench_get_mode },
+    { "set_mode", bench_set_mode },
+    { "get_ptt", bench_get_ptt },
+    { "get_level", bench_get_level },
+    { "get_split", bench_get_split },
+};
+
+static double now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static double cpu_us(void)
+{
+    struct rusage ru;
+
+    getrusage(RUSAGE_SELF, &ru);
+    return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1e6
+           + ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+}
+
+int main(int argc, char *argv[])
+{
+    RIG *rig;
+    rig_model_t model = RIG_MODEL_FTDX101D;
+    int loops = LOOP_COUNT;
+    int retcode;
+    int i, j;
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s port [model] [loops]\n", argv[0]);
+        return 1;
+    }
+
+    if (argc > 2) { model = atoi(argv[2]); }
+
+    if (argc > 3) { loops = atoi(argv[3]); }
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(model);
+
+    if (!rig)
+    {
+        fprintf(stderr, "Unknown rig num: %u\n", model);
+        return 1;
+    }
+
+    rig_set_conf(rig, rig_token_lookup(rig, "rig_pathname"), argv[1]);
+
+    retcode = rig_open(rig);
+
+    if (retcode != RIG_OK)
+    {
+        fprintf(stderr, "rig_open: error = %s\n", rigerror(retcode));
+        return 1;
+    }
+
+    // every get goes to the rig
+    rig_set_cache_timeout_ms(rig, HAMLIB_CACHE_ALL, 0);
+
+    printf("%s, %d loops\n", rig->caps->model_name, loops);
+
+    for (i = 0; i < (int)(sizeof(bench_ops) / sizeof(bench_ops[0])); i++)
+    {
+        double wall = now_us();
+        double cpu = cpu_us();
+        int errors = 0;
+
+        for (j = 0; j < loops; j++)
+        {
+            if (bench_ops[i].run(rig, j) != RIG_OK) { errors++; }
+        }
+
+        wall = now_us() - wall;
+        cpu = cpu_us() - cpu;
+
+        printf("%-10s %9.0f us/call wall %7.1f us/call cpu", bench_ops[i].name,
+               wall / loops, cpu / loops);
+        printf(errors ? " (%d errors)\n" : "\n", errors);
+    }
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    return 0;
+}
@@ -35,6 +35,7 @@ int main(int argc, const char *argv[])
     if (argc < 2)
     {
         hamlib_port_t myport;
+        memset(&myport, 0, sizeof(myport));
         /* may be overridden by backend probe */
         myport.type.rig = RIG_PORT_SERIAL;
         myport.parm.serial.rate = 19200;
@@ -0,0 +1,102 @@
+/*
+ * Hamlib rig_debug_bench program
+ *
+ * Measures the cost of rig_debug() and of a cache-hit rig_get_freq() on the
+ * dummy rig while debug output is disabled.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+
+#define DEBUG_LOOP_COUNT 1000000
+#define FREQ_LOOP_COUNT 200000
+
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+int main(int argc, char *argv[])
+{
+    RIG *my_rig;
+    freq_t freq;
+    double start, elapsed;
+    int loops;
+    int i;
+    int retcode;
+
+    loops = argc > 1 ? atoi(argv[1]) : 1;
+
+    if (loops < 1) { loops = 1; }
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    start = now_ns();
+
+    for (i = 0; i < DEBUG_LOOP_COUNT * loops; ++i)
+    {
+        rig_debug(RIG_DEBUG_VERBOSE, "%s%d:%s(%d):%s returning(%ld) %s\n",
+                  "***", 3, "rig.c", __LINE__, __func__, (long int)i, "");
+    }
+
+    elapsed = now_ns() - start;
+    printf("rig_debug (disabled):       %8.1f ns/call\n",
+           elapsed / (DEBUG_LOOP_COUNT * (double)loops));
+
+    my_rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!my_rig)
+    {
+        fprintf(stderr, "rig_init failed\n");
+        return 1;
+    }
+
+    retcode = rig_open(my_rig);
+
+    if (retcode != RIG_OK)
+    {
+        fprintf(stderr, "rig_open: error = %s\n", rigerror(retcode));
+        return 1;
+    }
+
+    rig_set_cache_timeout_ms(my_rig, HAMLIB_CACHE_ALL, 60000);
+
+    /* prime the cache */
+    rig_set_freq(my_rig, RIG_VFO_CURR, 14074000);
+    rig_get_freq(my_rig, RIG_VFO_CURR, &freq);
+
+    start = now_ns();
+
+    for (i = 0; i < FREQ_LOOP_COUNT * loops; ++i)
+    {
+        retcode = rig_get_freq(my_rig, RIG_VFO_CURR, &freq);
+
+        if (retcode != RIG_OK)
+        {
+            fprintf(stderr, "rig_get_freq: error = %s\n", rigerror(retcode));
+            return 1;
+        }
+    }
+
+    elapsed = now_ns() - start;
+    printf("rig_get_freq (cache hit):   %8.1f ns/call\n",
+           elapsed / (FREQ_LOOP_COUNT * (double)loops));
+
+    rig_close(my_rig);
+    rig_cleanup(my_rig);
+
+    return 0;
+}
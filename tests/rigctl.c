@@ -80,6 +80,7 @@ extern int read_history();
  */
 static void usage(FILE *fout);
 static void short_usage(FILE *fout);
+static int probe_ports(char *devices);
 
 /*
  * Reminder: when adding long options,
@@ -87,7 +88,7 @@ static void short_usage(FILE *fout);
  * NB: do NOT use -W since it's reserved by POSIX.
  * TODO: add an option to read from a file
  */
-#define SHORT_OPTIONS "+m:r:p:d:P:D:s:c:t:lC:LuonvhVYZ!#"
+#define SHORT_OPTIONS "+m:r:p:d:P:D:s:c:t:lA:C:LuonvhVYZ!#"
 static struct option long_options[] =
 {
     {"model",           1, 0, 'm'},
@@ -100,6 +101,7 @@ static struct option long_options[] =
     {"civaddr",         1, 0, 'c'},
     {"send-cmd-term",   1, 0, 't'},
     {"list",            0, 0, 'l'},
+    {"probe",           1, 0, 'A'},
     {"set-conf",        1, 0, 'C'},
     {"show-conf",       0, 0, 'L'},
     {"dump-caps",       0, 0, 'u'},
@@ -125,6 +127,9 @@ extern powerstat_t rig_powerstat;
 
 static RIG *my_rig;        /* handle to rig (instance) */
 
+#define PROBE_BUDGET_MS (60 * 1000)
+#define PROBE_MAX_PORTS 32
+
 #ifdef HAVE_SIG_ATOMIC_T
 static sig_atomic_t volatile ctrl_c = 0;
 #else
@@ -455,6 +460,9 @@ int main(int argc, char *argv[])
             list_models();
             exit(0);
 
+        case 'A':
+            exit(probe_ports(optarg) > 0 ? 0 : 2);
+
         case 'u':
             dump_caps_opt++;
             break;
@@ -895,6 +903,7 @@ static void usage(FILE *fout)
         "  -C, --set-conf=PARM=VAL[,...] set config parameters\n"
         "  -L, --show-conf               list all config parameters\n"
         "  -l, --list                    list all model numbers and exit\n"
+        "  -A, --probe=DEVICE[,...]      probe serial ports for radios and exit\n"
         "  -u, --dump-caps               dump capabilities and exit\n"
         "  -o, --vfo                     do not default to VFO_CURR, require extra vfo arg\n"
         "  -n, --no-restore-ai           do not restore auto information mode on rig\n"
@@ -917,6 +926,56 @@ static void usage(FILE *fout)
 }
 
 
+static int print_probe(const hamlib_port_t *port, rig_model_t model,
+                       rig_ptr_t data)
+{
+    const struct rig_caps *caps = rig_get_caps(model);
+
+    (void)data;
+
+    if (model == RIG_MODEL_NONE || !caps)
+    {
+        printf("%s: no radio found\n", port->pathname);
+    }
+    else
+    {
+        printf("%s: %u %s %s\n", port->pathname, model, caps->mfg_name,
+               caps->model_name);
+    }
+
+    fflush(stdout);
+
+    return 1;
+}
+
+
+/* Probe a comma separated list of serial devices, all at once */
+static int probe_ports(char *devices)
+{
+    const char *pathnames[PROBE_MAX_PORTS];
+    char *saveptr = NULL;
+    char *dev;
+    int count = 0;
+
+    for (dev = strtok_r(devices, ",", &saveptr);
+            dev && count < PROBE_MAX_PORTS;
+            dev = strtok_r(NULL, ",", &saveptr))
+    {
+        pathnames[count++] = dev;
+    }
+
+    if (count == 0)
+    {
+        fprintf(stderr, "rigctl: no device to probe\n");
+        return -RIG_EINVAL;
+    }
+
+    rig_load_all_backends();
+
+    return rig_probe_ports(pathnames, count, PROBE_BUDGET_MS, print_probe, NULL);
+}
+
+
 static void short_usage(FILE *fout)
 {
     fprintf(fout, "Usage: rigctl [OPTION]... [-m ID] [-r DEVICE] [-s BAUD] [COMMAND...|-]\n");
@@ -76,6 +76,8 @@ extern int read_history();
 #include "sprintflst.h"
 
 #include "rigctl_parse.h"
+#include "cmd_index.h"
+#include "spectrum_stream.h"
 
 /* Hash table implementation See:  http://uthash.sourceforge.net/ */
 #include "uthash.h"
@@ -96,11 +98,13 @@ extern int read_history();
 #define ARG_IN4  0x40
 #define ARG_OUT4 0x80
 #define ARG_OUT5 0x100
+#define ARG_OUT6 0x200
+#define ARG_NOLOCK 0x2000  /* rigctld runs it without its client lock */
 #define ARG_IN_LINE 0x4000
 #define ARG_NOVFO 0x8000
 
 #define ARG_IN  (ARG_IN1|ARG_IN2|ARG_IN3|ARG_IN4)
-#define ARG_OUT (ARG_OUT1|ARG_OUT2|ARG_OUT3|ARG_OUT4|ARG_OUT5)
+#define ARG_OUT (ARG_OUT1|ARG_OUT2|ARG_OUT3|ARG_OUT4|ARG_OUT5|ARG_OUT6)
 
 static int chk_vfo_executed;
 char rigctld_password[65];
@@ -151,6 +155,7 @@ struct test_table
     const char *arg4;
     const char *arg5;
     const char *arg6;
+    const char *arg7;
 };
 
 
@@ -186,6 +191,9 @@ declare_proto_rig(set_vfo);
 declare_proto_rig(get_vfo);
 declare_proto_rig(get_rig_info);
 declare_proto_rig(get_vfo_info);
+declare_proto_rig(get_status);
+declare_proto_rig(get_spectrum_history);
+declare_proto_rig(spectrum_stream);
 declare_proto_rig(get_vfo_list);
 declare_proto_rig(set_ptt);
 declare_proto_rig(get_ptt);
@@ -289,9 +297,9 @@ static struct test_table test_list[] =
 #else
     { 'F',  "set_freq",         ACTION(set_freq),       ARG_IN1, "Frequency" },
 #endif
-    { 'f',  "get_freq",         ACTION(get_freq),       ARG_OUT, "Frequency" },
+    { 'f',  "get_freq",         ACTION(get_freq),       ARG_OUT | ARG_NOLOCK, "Frequency" },
     { 'M',  "set_mode",         ACTION(set_mode),       ARG_IN, "Mode", "Passband" },
-    { 'm',  "get_mode",         ACTION(get_mode),       ARG_OUT, "Mode", "Passband" },
+    { 'm',  "get_mode",         ACTION(get_mode),       ARG_OUT | ARG_NOLOCK, "Mode", "Passband" },
     { 'I',  "set_split_freq",   ACTION(set_split_freq), ARG_IN, "TX Frequency" },
     { 'i',  "get_split_freq",   ACTION(get_split_freq), ARG_OUT, "TX Frequency" },
     { 'X',  "set_split_mode",   ACTION(set_split_mode), ARG_IN, "TX Mode", "TX Passband" },
@@ -303,7 +311,7 @@ static struct test_table test_list[] =
     { 'N',  "set_ts",           ACTION(set_ts),         ARG_IN, "Tuning Step" },
     { 'n',  "get_ts",           ACTION(get_ts),         ARG_OUT, "Tuning Step" },
     { 'L',  "set_level",        ACTION(set_level),      ARG_IN, "Level", "Level Value" },
-    { 'l',  "get_level",        ACTION(get_level),      ARG_IN1 | ARG_OUT2, "Level", "Level Value" },
+    { 'l',  "get_level",        ACTION(get_level),      ARG_IN1 | ARG_OUT2 | ARG_NOLOCK, "Level", "Level Value" },
     { 'U',  "set_func",         ACTION(set_func),       ARG_IN, "Func", "Func Status" },
     { 'u',  "get_func",         ACTION(get_func),       ARG_IN1 | ARG_OUT2, "Func", "Func Status" },
     { 'P',  "set_parm",         ACTION(set_parm),       ARG_IN  | ARG_NOVFO, "Parm", "Parm Value" },
@@ -328,8 +336,8 @@ static struct test_table test_list[] =
     //{ 'V',  "set_vfo",          ACTION(set_vfo),        ARG_IN  | ARG_NOVFO | ARG_OUT, "VFO" },
     { 'V',  "set_vfo",          ACTION(set_vfo),        ARG_IN  | ARG_NOVFO, "VFO" },
     { 'v',  "get_vfo",          ACTION(get_vfo),        ARG_NOVFO | ARG_OUT, "VFO" },
-    { 'T',  "set_ptt",          ACTION(set_ptt),        ARG_IN, "PTT" },
-    { 't',  "get_ptt",          ACTION(get_ptt),        ARG_OUT, "PTT" },
+    { 'T',  "set_ptt",          ACTION(set_ptt),        ARG_IN | ARG_NOLOCK, "PTT" },
+    { 't',  "get_ptt",          ACTION(get_ptt),        ARG_OUT | ARG_NOLOCK, "PTT" },
     { 'E',  "set_mem",          ACTION(set_mem),        ARG_IN, "Memory#" },
     { 'e',  "get_mem",          ACTION(get_mem),        ARG_OUT, "Memory#" },
     { 'H',  "set_channel",      ACTION(set_channel),    ARG_IN  | ARG_NOVFO, "Channel"},
@@ -349,8 +357,8 @@ static struct test_table test_list[] =
     { 'w',  "send_cmd",         ACTION(send_cmd),       ARG_IN1 | ARG_IN_LINE | ARG_OUT2 | ARG_NOVFO, "Command", "Reply" },
     { 'W',  "send_cmd_rx",      ACTION(send_cmd),       ARG_IN | ARG_OUT2 | ARG_NOVFO, "Command", "Reply"},
     { '*',  "reset",            ACTION(reset),          ARG_IN | ARG_NOVFO, "Reset" },
-    { 'b',  "send_morse",       ACTION(send_morse),     ARG_IN | ARG_NOVFO  | ARG_IN_LINE, "Morse" },
-    { 0xbb, "stop_morse",       ACTION(stop_morse),     ARG_NOVFO},
+    { 'b',  "send_morse",       ACTION(send_morse),     ARG_IN | ARG_NOVFO  | ARG_IN_LINE | ARG_NOLOCK, "Morse" },
+    { 0xbb, "stop_morse",       ACTION(stop_morse),     ARG_NOVFO | ARG_NOLOCK},
     { 0xbc, "wait_morse",       ACTION(wait_morse),     ARG_NOVFO},
     { 0x94, "send_voice_mem",   ACTION(send_voice_mem), ARG_NOVFO | ARG_IN, "Voice Mem#" },
     { 0xab, "stop_voice_mem",   ACTION(stop_voice_mem), ARG_NOVFO},
@@ -367,7 +375,10 @@ static struct test_table test_list[] =
     { 0x8f, "dump_state",       ACTION(dump_state),     ARG_OUT | ARG_NOVFO },
     { 0xf0, "chk_vfo",          ACTION(chk_vfo),        ARG_NOVFO, "ChkVFO" },   /* rigctld only--check for VFO mode */
     { 0xf2, "set_vfo_opt",      ACTION(set_vfo_opt),    ARG_NOVFO | ARG_IN, "Status" }, /* turn vfo option on/off */
-    { 0xf3, "get_vfo_info",     ACTION(get_vfo_info),   ARG_IN1 | ARG_NOVFO | ARG_OUT5, "VFO", "Freq", "Mode", "Width", "Split", "SatMode" }, /* get several vfo parameters at once */
+    { 0xf3, "get_vfo_info",     ACTION(get_vfo_info),   ARG_IN1 | ARG_NOVFO | ARG_OUT5, "VFO", "Freq", "Mode", "Width", "Split", "SatMode", NULL }, /* get several vfo parameters at once */
+    { 0xae, "get_status",       ACTION(get_status),     ARG_IN1 | ARG_NOVFO | ARG_OUT6, "VFO", "Freq", "Mode", "Width", "PTT", "Split", "TX VFO" }, /* freq/mode/PTT/split in as few round trips as the rig allows */
+    { 0xaf, "get_spectrum_history", ACTION(get_spectrum_history), ARG_IN1 | ARG_IN2 | ARG_IN3 | ARG_NOVFO | ARG_OUT3, "Scope", "Op", "Lines[:Bins]", "Used", "Low Freq", "High Freq", NULL }, /* average/max/min hold of the last scope lines */
+    { 0xa6, "spectrum_stream", ACTION(spectrum_stream), ARG_IN1 | ARG_IN2 | ARG_IN3 | ARG_NOVFO, "Scope", "Format", "Rate[:Bins]", NULL, NULL, NULL, NULL }, /* rigctld: send the scope lines until the next command */
     { 0xf5, "get_rig_info",     ACTION(get_rig_info),   ARG_NOVFO | ARG_OUT, "RigInfo" }, /* get several vfo parameters at once */
     { 0xf4, "get_vfo_list",    ACTION(get_vfo_list),   ARG_OUT | ARG_NOVFO, "VFOs" },
     { 0xf6, "get_modes",       ACTION(get_modes),   ARG_OUT | ARG_NOVFO, "Modes" },
@@ -397,24 +408,23 @@ static struct test_table test_list[] =
 };
 
 
+static struct cmd_index cmd_lookup;
+static pthread_once_t cmd_lookup_once = PTHREAD_ONCE_INIT;
+
+static void cmd_lookup_init(void)
+{
+    CMD_INDEX_INIT(&cmd_lookup, test_list, struct test_table);
+}
+
+
 static struct test_table *find_cmd_entry(int cmd)
 {
     int i;
 
-    for (i = 0; test_list[i].cmd != 0x00; i++)
-    {
-        if (test_list[i].cmd == cmd)
-        {
-            break;
-        }
-    }
-
-    if (test_list[i].cmd == 0x00)
-    {
-        return NULL;
-    }
+    pthread_once(&cmd_lookup_once, cmd_lookup_init);
+    i = cmd_index_find_cmd(&cmd_lookup, cmd);
 
-    return &test_list[i];
+    return i < 0 ? NULL : &test_list[i];
 }
 
 
@@ -541,19 +551,16 @@ static void rp_getline(const char *s)
 #endif
 
 /*
- * TODO: use Lex?
+ * Long command name to its one character command, 0 if unknown
  */
 static char parse_arg(const char *arg)
 {
-    for (int i = 0; test_list[i].cmd != 0x00; i++)
-    {
-        if (!strncmp(arg, test_list[i].name, MAXNAMSIZ))
-        {
-            return test_list[i].cmd;
-        }
-    }
+    int i;
 
-    return 0;
+    pthread_once(&cmd_lookup_once, cmd_lookup_init);
+    i = cmd_index_find_name(&cmd_lookup, arg);
+
+    return i < 0 ? 0 : test_list[i].cmd;
 }
 
 
@@ -714,6 +721,7 @@ int rigctl_parse(RIG *my_rig, FILE *fin, FILE *fout, char *argv[], int argc,
     struct test_table *cmd_entry = NULL;
     struct rig_state *rs = STATE(my_rig);
     struct handle_data *connection;
+    sync_cb_t lock_cb;
 
     char command[MAXARGSZ + 1] = "";
     char arg1[MAXARGSZ + 1], *p1 = NULL;
@@ -1745,7 +1753,15 @@ readline_repeat:
 
 #endif // HAVE_LIBREADLINE
 
-    if (sync_cb) { sync_cb(1); }    /* lock if necessary */
+    /*
+     * The library serializes these commands itself: concurrent identical
+     * gets share one rig transaction and PTT/CW keying goes ahead of the
+     * other waiters.  Behind the client lock, neither would happen between
+     * rigctld clients.
+     */
+    lock_cb = (cmd_entry->flags & ARG_NOLOCK) ? NULL : sync_cb;
+
+    if (lock_cb) { lock_cb(1); }    /* lock if necessary */
 
     if (!prompt)
     {
@@ -1880,7 +1896,7 @@ readline_repeat:
     {
         rig_debug(RIG_DEBUG_ERR, "%s: RIG_EIO?\n", __func__);
 
-        if (sync_cb) { sync_cb(0); }    /* unlock if necessary */
+        if (lock_cb) { lock_cb(0); }    /* unlock if necessary */
 
         return (retcode);
     }
@@ -1939,7 +1955,7 @@ readline_repeat:
 
 #endif
 
-    if (sync_cb) { sync_cb(0); }    /* unlock if necessary */
+    if (lock_cb) { lock_cb(0); }    /* unlock if necessary */
 
     return (retcode);
 }
@@ -2525,6 +2541,183 @@ declare_proto_rig(get_vfo_info)
     RETURNFUNC2(retval);
 }
 
+/* '\get_status' */
+declare_proto_rig(get_status)
+{
+    struct rig_vfo_status status;
+    int retval;
+
+    ENTERFUNC2;
+    ELAPSED1;
+
+    if (!strcmp(arg1, "?"))
+    {
+        char s[SPRINTF_MAX_SIZE];
+        rig_sprintf_vfo(s, sizeof(s), STATE(rig)->vfo_list);
+        fprintf(fout, "%s\n", s);
+        RETURNFUNC2(RIG_OK);
+    }
+
+    vfo = rig_parse_vfo(arg1);
+    retval = rig_get_status(rig, vfo, &status);
+
+    if (retval != RIG_OK)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: vfo=%s\n", __func__, rig_strvfo(vfo));
+        ELAPSED2;
+        RETURNFUNC2(retval);
+    }
+
+    const char *modestr = rig_strrmode(status.mode);
+
+    if (strlen(modestr) == 0) { modestr = "None"; }
+
+    if ((interactive && prompt) || (interactive && !prompt && ext_resp))
+    {
+        fprintf(fout, "%s: %.0f%c", cmd->arg2, status.freq, resp_sep);
+        fprintf(fout, "%s: %s%c", cmd->arg3, modestr, resp_sep);
+        fprintf(fout, "%s: %d%c", cmd->arg4, (int)status.width, resp_sep);
+        fprintf(fout, "%s: %d%c", cmd->arg5, (int)status.ptt, resp_sep);
+        fprintf(fout, "%s: %d%c", cmd->arg6, (int)status.split, resp_sep);
+        fprintf(fout, "%s: %s%c", cmd->arg7, rig_strvfo(status.tx_vfo), resp_sep);
+    }
+    else
+    {
+        fprintf(fout, "%.0f%c%s%c%d%c%d%c%d%c%s\n", status.freq, resp_sep,
+                modestr, resp_sep, (int)status.width, resp_sep,
+                (int)status.ptt, resp_sep, (int)status.split, resp_sep,
+                rig_strvfo(status.tx_vfo));
+    }
+
+    ELAPSED2;
+    RETURNFUNC2(retval);
+}
+
+
+/* '\get_spectrum_history' */
+declare_proto_rig(get_spectrum_history)
+{
+    static unsigned char data[HAMLIB_MAX_SPECTRUM_DATA];
+    static char hex[2 * HAMLIB_MAX_SPECTRUM_DATA + 1];
+    struct rig_spectrum_line line;
+    freq_t low, high;
+    int id, op, lines, bins = 0;
+    int used, i;
+
+    ENTERFUNC2;
+    ELAPSED1;
+
+    if (!strcmp(arg1, "?") || !strcmp(arg2, "?"))
+    {
+        for (i = RIG_SPECTRUM_HISTORY_LAST; i <= RIG_SPECTRUM_HISTORY_MIN; i++)
+        {
+            fprintf(fout, "%s ", rig_strspectrumhistory(i));
+        }
+
+        fprintf(fout, "\n");
+        RETURNFUNC2(RIG_OK);
+    }
+
+    op = rig_parse_spectrum_history(arg2);
+
+    if (op < 0
+            || sscanf(arg1, "%d", &id) != 1
+            || sscanf(arg3, "%d:%d", &lines, &bins) < 1)
+    {
+        ELAPSED2;
+        RETURNFUNC2(-RIG_EINVAL);
+    }
+
+    used = rig_get_spectrum_history(rig, id, op, lines, bins, &line, data);
+
+    if (used < 0)
+    {
+        ELAPSED2;
+        RETURNFUNC2(used);
+    }
+
+    if (line.spectrum_mode == RIG_SPECTRUM_MODE_CENTER)
+    {
+        low = line.center_freq - line.span_freq / 2;
+        high = line.center_freq + line.span_freq / 2;
+    }
+    else
+    {
+        low = line.low_edge_freq;
+        high = line.high_edge_freq;
+    }
+
+    for (i = 0; i < (int) line.spectrum_data_length; i++)
+    {
+        static const char digits[] = "0123456789ABCDEF";
+
+        hex[2 * i] = digits[data[i] >> 4];
+        hex[2 * i + 1] = digits[data[i] & 0x0f];
+    }
+
+    hex[2 * i] = '\0';
+
+    if ((interactive && prompt) || (interactive && !prompt && ext_resp))
+    {
+        fprintf(fout, "%s: %d%c", cmd->arg4, used, resp_sep);
+        fprintf(fout, "%s: %.0f%c", cmd->arg5, low, resp_sep);
+        fprintf(fout, "%s: %.0f%c", cmd->arg6, high, resp_sep);
+        fprintf(fout, "Length: %d%c", (int) line.spectrum_data_length, resp_sep);
+        fprintf(fout, "Data: %s%c", hex, resp_sep);
+    }
+    else
+    {
+        fprintf(fout, "%d%c%.0f%c%.0f%c%d%c%s\n", used, resp_sep, low, resp_sep,
+                high, resp_sep, (int) line.spectrum_data_length, resp_sep, hex);
+    }
+
+    ELAPSED2;
+    RETURNFUNC2(RIG_OK);
+}
+
+/* '\spectrum_stream' */
+declare_proto_rig(spectrum_stream)
+{
+    struct handle_data *connection = pthread_getspecific(thread_data_key);
+    double rate;
+    int id, format, bins = 0;
+
+    ENTERFUNC2;
+
+    if (!strcmp(arg2, "?"))
+    {
+        fprintf(fout, "%s %s\n", spectrum_stream_strformat(SPECTRUM_STREAM_HEX),
+                spectrum_stream_strformat(SPECTRUM_STREAM_BINARY));
+        RETURNFUNC2(RIG_OK);
+    }
+
+    /* only a network connection can be handed the lines */
+    if (connection == NULL || !connection->can_stream)
+    {
+        RETURNFUNC2(-RIG_ENAVAIL);
+    }
+
+    format = spectrum_stream_parse_format(arg2);
+
+    if (format < 0 || sscanf(arg1, "%d", &id) != 1
+            || sscanf(arg3, "%lf:%d", &rate, &bins) < 1
+            || rate < 0 || bins < 0 || bins > HAMLIB_MAX_SPECTRUM_DATA)
+    {
+        RETURNFUNC2(-RIG_EINVAL);
+    }
+
+    spectrum_stream_close(connection->spectrum_stream);
+    connection->spectrum_stream = spectrum_stream_open(rig, id, format, rate, bins,
+                                  connection->stream_notify);
+
+    if (connection->spectrum_stream == NULL)
+    {
+        RETURNFUNC2(-RIG_ENOMEM);
+    }
+
+    RETURNFUNC2(RIG_OK);
+}
+
 /* '\get_vfo_list' */
 declare_proto_rig(get_vfo_list)
 {
@@ -6174,8 +6367,7 @@ declare_proto_rig(get_conf)
     if (arg1 == NULL || arg1[0] == '?')
     {
         dumpconf_list(rig, fout);
-        debugmsgsave[0] = 0;
-        debugmsgsave2[0] = 0;
+        rig_debug_clear();
         return RIG_OK;
     }
 
@@ -6212,8 +6404,7 @@ declare_proto_rig(set_conf)
     if (arg1[0] == '?')
     {
         dumpconf_list(rig, fout);
-        debugmsgsave[0] = 0;
-        debugmsgsave2[0] = 0;
+        rig_debug_clear();
         return RIG_OK;
     }
 
@@ -52,6 +52,9 @@ struct handle_data
     int vfo_mode;
     int use_password;
     int is_passwordOK;
+    int can_stream;         // the front end serves spectrum streams
+    int stream_notify;      // their wakeup fd, -1 for a pipe per stream
+    struct spectrum_stream *spectrum_stream;    // started by the last command
 };
 
 extern pthread_key_t thread_data_key;
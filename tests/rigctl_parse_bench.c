@@ -0,0 +1,156 @@
+/*
+ * Hamlib rigctl_parse_bench program
+ *
+ * Feeds polling command streams like the ones WSJT-X and a contest
+ * logger send to rigctld through rigctl_parse() on the dummy rig and
+ * reports commands per second.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+
+#include "rigctl_parse.h"
+
+#define STREAM_REPEAT 2000
+
+int lock_mode;
+powerstat_t rig_powerstat = RIG_POWER_ON;
+
+/*
+ * What WSJT-X sends through the NET rigctl backend while idle.  Setters
+ * are left out, the dummy rig sleeps in them like a real rig would.
+ */
+static const char wsjtx_stream[] =
+    "\\chk_vfo\n"
+    "\\get_powerstat\n"
+    "f\n"
+    "m\n"
+    "s\n"
+    "t\n"
+    "\\get_vfo_info VFOA\n"
+    "\\get_split_vfo\n";
+
+/* A contest logger polling frequency, mode and keyer speed */
+static const char logger_stream[] =
+    "f\n"
+    "m\n"
+    "v\n"
+    "l KEYSPD\n"
+    "\\get_freq\n"
+    "\\get_mode\n"
+    "\\get_level KEYSPD\n"
+    "\\get_ptt\n";
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int count_lines(const char *s)
+{
+    int n = 0;
+
+    for (; *s; s++)
+    {
+        if (*s == '\n') { n++; }
+    }
+
+    return n;
+}
+
+static int run_stream(RIG *rig, const char *name, const char *stream)
+{
+    FILE *fin = tmpfile();
+    FILE *fout = tmpfile();
+    int vfo_mode = 0;
+    int ext_resp = 0;
+    char resp_sep = '\n';
+    int commands = count_lines(stream) * STREAM_REPEAT;
+    int errors = 0;
+    double start, elapsed;
+    int i;
+
+    if (!fin || !fout)
+    {
+        fprintf(stderr, "tmpfile failed\n");
+        return 1;
+    }
+
+    for (i = 0; i < STREAM_REPEAT; i++)
+    {
+        fputs(stream, fin);
+    }
+
+    rewind(fin);
+
+    start = now_ns();
+
+    for (i = 0; i < commands; i++)
+    {
+        int retcode = rigctl_parse(rig, fin, fout, NULL, 0, NULL, 1, 0,
+                                   &vfo_mode, '\r', &ext_resp, &resp_sep, 0);
+
+        if (retcode != RIG_OK) { errors++; }
+
+        // keep the output file from growing
+        if ((i & 1023) == 0) { rewind(fout); }
+    }
+
+    elapsed = now_ns() - start;
+
+    printf("%-8s %6d commands %8.0f commands/s %6.2f us/command",
+           name, commands, commands / (elapsed / 1e9), elapsed / commands / 1e3);
+    printf(errors ? " (%d errors)\n" : "\n", errors);
+
+    fclose(fin);
+    fclose(fout);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    RIG *rig;
+    int retcode;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig)
+    {
+        fprintf(stderr, "rig_init failed\n");
+        return 1;
+    }
+
+    retcode = rig_open(rig);
+
+    if (retcode != RIG_OK)
+    {
+        fprintf(stderr, "rig_open: error = %s\n", rigerror(retcode));
+        return 1;
+    }
+
+    // as rigctld sets it up
+    rig_set_cache_timeout_ms(rig, HAMLIB_CACHE_ALL, 500);
+
+    run_stream(rig, "WSJT-X", wsjtx_stream);
+    run_stream(rig, "logger", logger_stream);
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    return 0;
+}
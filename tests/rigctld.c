@@ -66,6 +66,11 @@
 
 #include <pthread.h>
 
+#ifdef HAVE_SYS_EPOLL_H
+#  include <sys/epoll.h>
+#  include <fcntl.h>
+#endif
+
 #include "hamlib/rig.h"
 #include "hamlib/port.h"
 #include "hamlib/rig_state.h"
@@ -73,6 +78,7 @@
 #include "network.h"
 
 #include "rigctl_parse.h"
+#include "spectrum_stream.h"
 #include "riglist.h"
 #include "token.h"
 
@@ -81,7 +87,7 @@
  *      keep up to date SHORT_OPTIONS, usage()'s output and man page. thanks.
  * TODO: add an option to read from a file
  */
-#define SHORT_OPTIONS "m:r:p:d:P:D:s:S:c:T:t:C:W:w:x:lLuovhVZRA:b"
+#define SHORT_OPTIONS "m:r:p:d:P:D:s:S:c:T:t:C:W:w:x:lLuovhVZRA:bEK:"
 static struct option long_options[] =
 {
     {"model",           1, 0, 'm'},
@@ -112,6 +118,8 @@ static struct option long_options[] =
 #endif
     {"rigctld-idle",    0, 0, 'R'},
     {"bind-all",        0, 0, 'b'},
+    {"event-loop",      0, 0, 'E'},
+    {"cache-ttl",       1, 0, 'K'},
     {0, 0, 0, 0}
 };
 
@@ -120,8 +128,12 @@ static struct option long_options[] =
  * Prototypes
  */
 void *handle_socket(void *arg);
+#ifdef HAVE_SYS_EPOLL_H
+static int rigctld_event_loop(int sock_listen, int vfo_mode);
+#endif
 static void usage(FILE *fout);
 static void short_usage(FILE *fout);
+static int set_cache_ttl(RIG *rig, const char *spec);
 
 static unsigned client_count;
 
@@ -145,6 +157,10 @@ static int rigctld_idle =
     0; // if true then rig will close when no clients are connected
 static int skip_open = 0;
 static int bind_all = 0;
+#ifdef HAVE_SYS_EPOLL_H
+static int event_loop = 0;
+#endif
+static const char *cache_ttl = NULL;
 
 #define MAXCONFLEN 2048
 
@@ -311,6 +327,18 @@ int main(int argc, char *argv[])
             bind_all = 1;
             break;
 
+        case 'E':
+#ifdef HAVE_SYS_EPOLL_H
+            event_loop = 1;
+#else
+            fprintf(stderr, "--event-loop is not supported on this platform\n");
+#endif
+            break;
+
+        case 'K':
+            cache_ttl = optarg;
+            break;
+
 #if RIGCTLD_PASSWORDS
         case 'A':
             strncpy(rigctld_password, optarg, sizeof(rigctld_password) - 1);
@@ -597,6 +625,12 @@ int main(int argc, char *argv[])
         rig_set_conf(my_rig, TOK_PATHNAME, rig_file);
     }
 
+    if (cache_ttl && set_cache_ttl(my_rig, cache_ttl) != RIG_OK)
+    {
+        fprintf(stderr, "Invalid --cache-ttl '%s'\n", cache_ttl);
+        exit(1);
+    }
+
     rs->twiddle_timeout = twiddle_timeout;
     rs->twiddle_rit = twiddle_rit;
     rs->uplink = uplink;
@@ -972,6 +1006,14 @@ int main(int argc, char *argv[])
     rig_debug(RIG_DEBUG_TRACE, "%s: rigctld listening on port %s\n", __func__,
               portno);
 
+#ifdef HAVE_SYS_EPOLL_H
+
+    if (event_loop)
+    {
+        rigctld_event_loop(sock_listen, vfo_mode);
+    }
+    else
+#endif
     do
     {
         fd_set set;
@@ -1028,6 +1070,8 @@ int main(int argc, char *argv[])
             arg->rig = my_rig;
             arg->clilen = sizeof(arg->cli_addr);
             arg->vfo_mode = vfo_mode;
+            arg->can_stream = 1;
+            arg->stream_notify = -1;
             arg->sock = accept(sock_listen,
                                (struct sockaddr *)&arg->cli_addr,
                                &arg->clilen);
@@ -1127,83 +1171,176 @@ static FILE *get_fsockin(struct handle_data *handle_data_arg)
 #endif
 }
 
+#ifdef HAVE_SYS_EPOLL_H
 /*
- * This is the function run by the threads
+ * Event driven front end, enabled with --event-loop.
+ *
+ * All clients are multiplexed on a single epoll loop using non-blocking
+ * sockets and per-client buffers.  Complete command lines are handed to
+ * EVLOOP_WORKERS rig worker threads which feed them to rigctl_parse()
+ * through memory streams, so the wire protocol is exactly the same as with
+ * the thread-per-client front end.  A client has one job at a time, so its
+ * commands stay in order; the jobs of different clients are serialized by
+ * the client lock like there, except for the gets rigctl_parse() runs
+ * without it so the library can share them.  The number of threads no
+ * longer grows with the number of clients.
+ *
+ * The rig still does one thing at a time: every backend call goes through
+ * rig_lock(), so more workers add no concurrent rig I/O.  A single worker
+ * would however serialize identical gets from different clients, each one
+ * a trip to the rig once the cache has expired; with a few, a get that
+ * finds the same one in flight waits for it and shares its answer (see
+ * rig_get_freq()).  The pool is fixed, so memory still stays flat as
+ * clients are added.
  */
-void *handle_socket(void *arg)
+
+#define EVLOOP_MAX_EVENTS 64
+#define EVLOOP_WORKERS 4     // jobs in flight at once, not rig I/O, see above
+#define EVLOOP_READ_SIZE 4096
+#define EVLOOP_INBUF_MAX (64 * 1024)
+#define EVLOOP_STREAM_BACKLOG (2 * SPECTRUM_STREAM_FRAME_MAX)
+
+struct evloop_client
 {
-    struct handle_data *handle_data_arg = (struct handle_data *)arg;
-    FILE *fsockin = NULL;
-    FILE *fsockout = NULL;
-    int retcode = RIG_OK;
-    char host[NI_MAXHOST];
-    char serv[NI_MAXSERV];
-    char send_cmd_term = '\r';  /* send_cmd termination char */
-    int ext_resp = 0;
-    char my_resp_sep = resp_sep;  // Separator for this connection, initial default
-    rig_powerstat = RIG_POWER_ON; // defaults to power on
-    struct timespec powerstat_check_time;
+    struct handle_data handle;
+    int ext_resp;
+    char resp_sep;
+    int started;        /* powerstat checked for this connection */
+    int busy;           /* a job is with the rig worker */
+    int closing;        /* close once the output has drained */
+    int gone;           /* closed, freed by evloop_reap() once not busy */
+    int eof;            /* peer shut down its side, serve what it sent */
+    struct evloop_client *reap_next;
+    size_t stalled;     /* input known to hold only an incomplete command */
+    int streaming;      /* on the evloop.streaming list */
+    struct evloop_client *stream_next;
+    char *in;
+    size_t in_len;
+    size_t in_size;
+    char *out;
+    size_t out_len;
+    size_t out_off;
+    size_t out_size;
+};
 
-    fsockin = get_fsockin(handle_data_arg);
+struct evloop_job
+{
+    struct evloop_job *next;
+    struct evloop_client *client;   /* NULL asks the worker to idle the rig */
+    char *in;
+    size_t in_len;
+    size_t consumed;
+    char *out;
+    size_t out_len;
+    int quit;
+};
 
-    if (!fsockin)
+static struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct evloop_job *pending;
+    struct evloop_job **pending_tail;
+    struct evloop_job *done;
+    struct evloop_job **done_tail;
+    int wake[2];
+    int stop;
+    int stream[2];      /* spectrum streams with lines waiting */
+    struct evloop_client *streaming;
+    struct evloop_client *reaped;   /* event loop thread only */
+} evloop =
+{
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+    NULL, &evloop.pending, NULL, &evloop.done, { -1, -1 }, 0, { -1, -1 }, NULL,
+    NULL
+};
+
+/* epoll tags for the non-client descriptors */
+static char evloop_listen_tag;
+static char evloop_wake_tag;
+static char evloop_stream_tag;
+
+
+static int evloop_set_nonblock(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+
+    if (flags < 0)
     {
-        rig_debug(RIG_DEBUG_ERR, "%s: fdopen(0x%d) in: %s\n", __func__,
-                  handle_data_arg->sock,
-                  strerror(errno));
-        goto handle_exit;
+        return -1;
     }
 
-    fsockout = get_fsockout(handle_data_arg);
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
 
-    if (!fsockout)
-    {
-        rig_debug(RIG_DEBUG_ERR, "%s: fdopen out: %s\n", __func__, strerror(errno));
-        fclose(fsockin);
-        fsockin = NULL;
 
-        goto handle_exit;
-    }
+static int evloop_reserve(char **buf, size_t *size, size_t needed)
+{
+    char *p;
+    size_t newsize;
 
-    retcode = pthread_setspecific(thread_data_key, arg);
-    if (0 != retcode)
+    if (needed <= *size)
     {
-        rig_debug(RIG_DEBUG_ERR, "%s: Could not set thread daya\n", __func__);
-        // What do we do here?
+        return 0;
     }
 
-    mutex_rigctld(1);
+    for (newsize = *size ? *size : 256; newsize < needed; newsize *= 2) { }
 
-    ++client_count;
-#if 0
+    p = realloc(*buf, newsize);
 
-    if (!client_count++)
+    if (p == NULL)
     {
-        retcode = rig_open(my_rig);
-
-        if (RIG_OK == retcode && verbose > RIG_DEBUG_ERR)
-        {
-            printf("Opened rig model %d, '%s'\n",
-                   my_rig->caps->rig_model,
-                   my_rig->caps->model_name);
-        }
+        return -1;
     }
 
-#endif
+    *buf = p;
+    *size = newsize;
+    return 0;
+}
 
-    mutex_rigctld(0);
 
-    if (my_rig->caps->get_powerstat)
+/* Runs the command lines of one job through rigctl_parse() */
+static void evloop_run_job(struct evloop_job *job)
+{
+    struct evloop_client *client = job->client;
+    FILE *fin;
+    FILE *fout;
+    int retcode = RIG_OK;
+
+    if (client == NULL)
     {
         mutex_rigctld(1);
-        rig_get_powerstat(my_rig, &rig_powerstat);
+        rig_close(my_rig);
+        rig_opened = 0;
         mutex_rigctld(0);
-        STATE(my_rig)->powerstat = rig_powerstat;
+
+        if (verbose > RIG_DEBUG_ERR) { printf("Closed rig model %s.  Will reopen for new clients\n", my_rig->caps->model_name); }
+
+        return;
     }
 
-    elapsed_ms(&powerstat_check_time, HAMLIB_ELAPSED_SET);
+    fin = fmemopen(job->in, job->in_len, "r");
+    fout = open_memstream(&job->out, &job->out_len);
 
-    do
+    if (fin == NULL || fout == NULL)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: memory stream: %s\n", __func__,
+                  strerror(errno));
+
+        if (fin) { fclose(fin); }
+
+        if (fout) { fclose(fout); }
+
+        job->out = NULL;
+        job->out_len = 0;
+        job->quit = 1;
+        return;
+    }
+
+    pthread_setspecific(thread_data_key, &client->handle);
+
+    /* as in handle_socket(), only wait for the client lock to reopen */
+    if (!rig_opened)
     {
         mutex_rigctld(1);
 
@@ -1216,157 +1353,1101 @@ void *handle_socket(void *arg)
         }
 
         mutex_rigctld(0);
+    }
 
-        if (rig_opened) // only do this if rig is open
+    if (!client->started && rig_opened)
+    {
+        client->started = 1;
+        rig_powerstat = RIG_POWER_ON;
+
+        if (my_rig->caps->get_powerstat)
         {
-            rig_debug(RIG_DEBUG_TRACE, "%s: doing rigctl_parse vfo_mode=%d, secure=%d\n",
-                      __func__,
-                      handle_data_arg->vfo_mode, handle_data_arg->use_password);
-            retcode = rigctl_parse(handle_data_arg->rig, fsockin, fsockout, NULL, 0,
-                                   mutex_rigctld, 1, 0, &handle_data_arg->vfo_mode,
-                                   send_cmd_term, &ext_resp, &my_resp_sep,
-                                   handle_data_arg->use_password);
+            mutex_rigctld(1);
+            rig_get_powerstat(my_rig, &rig_powerstat);
+            mutex_rigctld(0);
+            STATE(my_rig)->powerstat = rig_powerstat;
+        }
+    }
 
-            if (retcode != 0) { rig_debug(RIG_DEBUG_VERBOSE, "%s: rigctl_parse retcode=%d\n", __func__, retcode); }
+    job->consumed = job->in_len;
 
-            // If we get a timeout, the rig might be powered off
-            // Update our power status in case power gets turned off
-            // Check power status if rig is powered off, but not more often than once per second
-            if (my_rig->caps->get_powerstat && (retcode == -RIG_ETIMEOUT ||
-                                                (retcode == -RIG_EPOWER
-                                                 && elapsed_ms(&powerstat_check_time, HAMLIB_ELAPSED_GET) >= 1000)))
-            {
-                powerstat_t powerstat;
-                rig_get_powerstat(my_rig, &powerstat);
-                rig_powerstat = powerstat;
+    while (rig_opened && !ctrl_c)
+    {
+        long start = ftell(fin);
+        int c = fgetc(fin);
 
-                if (powerstat == RIG_POWER_OFF || powerstat == RIG_POWER_STANDBY)
-                {
-                    retcode = -RIG_EPOWER;
-                }
+        if (c == EOF)
+        {
+            break;
+        }
 
-                elapsed_ms(&powerstat_check_time, HAMLIB_ELAPSED_SET);
-            }
+        ungetc(c, fin);
+
+        retcode = rigctl_parse(my_rig, fin, fout, NULL, 0, mutex_rigctld, 1, 0,
+                               &client->handle.vfo_mode, '\r', &client->ext_resp,
+                               &client->resp_sep, client->handle.use_password);
+
+        if (retcode == RIGCTL_PARSE_END)
+        {
+            job->quit = 1;
+            break;
         }
-        else
+
+        if (retcode == RIGCTL_PARSE_ERROR && feof(fin))
         {
-            retcode = -RIG_EIO;
+            /* arguments still to come, keep the command for the next job */
+            job->consumed = start;
+            break;
         }
 
-        // if we get a hard error we try to reopen the rig again
-        // this should cover short dropouts that can occur
         if (retcode < 0 && !RIG_IS_SOFT_ERRCODE(retcode))
         {
-            int retry = 3;
             rig_debug(RIG_DEBUG_ERR, "%s: i/o error\n", __func__);
 
-            do
-            {
-                mutex_rigctld(1);
-                retcode = rig_close(my_rig);
-                rig_opened = 0;
-                mutex_rigctld(0);
-                rig_debug(RIG_DEBUG_ERR, "%s: rig_close retcode=%d\n", __func__, retcode);
-
-                hl_usleep(1000 * 1000);
-
-                mutex_rigctld(1);
-
-                if (!rig_opened)
-                {
-                    retcode = rig_open(my_rig);
-                    rig_opened = retcode == RIG_OK ? 1 : 0;
-                    rig_debug(RIG_DEBUG_ERR, "%s: rig_open retcode=%d, opened=%d\n", __func__,
-                              retcode, rig_opened);
-                }
+            mutex_rigctld(1);
+            rig_close(my_rig);
+            retcode = rig_open(my_rig);
+            rig_opened = retcode == RIG_OK ? 1 : 0;
+            mutex_rigctld(0);
 
-                mutex_rigctld(0);
-            }
-            while (!ctrl_c && !rig_opened && retry-- > 0 && retcode != RIG_OK);
+            rig_debug(RIG_DEBUG_ERR, "%s: rig_open retcode=%d, opened=%d\n", __func__,
+                      retcode, rig_opened);
         }
     }
-    while (!ctrl_c && (retcode == RIG_OK || RIG_IS_SOFT_ERRCODE(retcode)));
 
-    mutex_rigctld(1);
-    if (rigctld_idle && client_count == 1)
+    if (!rig_opened)
     {
-        rig_close(my_rig);
-
-        if (verbose > RIG_DEBUG_ERR) { printf("Closed rig model %s.  Will reopen for new clients\n", my_rig->caps->model_name); }
+        job->quit = 1;
     }
 
-    --client_count;
-    mutex_rigctld(0);
+    pthread_setspecific(thread_data_key, NULL);
 
-    if (rigctld_idle && client_count > 0) { printf("%u client%s still connected so rig remains open\n", client_count, client_count > 1 ? "s" : ""); }
+    fclose(fin);
+    fclose(fout);
+}
 
-#if 0
-    mutex_rigctld(1);
 
-    /* Release rig if there are no clients */
-    if (!--client_count)
+static void *evloop_worker(void *arg)
+{
+    (void)arg;
+
+    for (;;)
     {
-        rig_close(my_rig);
+        struct evloop_job *job;
 
-        if (verbose > RIG_DEBUG_ERR)
+        pthread_mutex_lock(&evloop.lock);
+
+        while (evloop.pending == NULL && !evloop.stop)
         {
-            printf("Closed rig model %d, '%s - no clients, will reopen for new clients'\n",
-                   my_rig->caps->rig_model,
-                   my_rig->caps->model_name);
+            pthread_cond_wait(&evloop.cond, &evloop.lock);
         }
-    }
 
-    mutex_rigctld(0);
-#endif
+        job = evloop.pending;
 
-    if ((retcode = getnameinfo((struct sockaddr const *)&handle_data_arg->cli_addr,
-                               handle_data_arg->clilen,
-                               host,
-                               sizeof(host),
-                               serv,
-                               sizeof(serv),
-                               NI_NUMERICHOST | NI_NUMERICSERV))
-            < 0)
-    {
+        if (job == NULL)
+        {
+            pthread_mutex_unlock(&evloop.lock);
+            break;
+        }
 
-        rig_debug(RIG_DEBUG_WARN, "Peer lookup error: %s", gai_strerror(retcode));
+        evloop.pending = job->next;
+
+        if (evloop.pending == NULL) { evloop.pending_tail = &evloop.pending; }
+
+        pthread_mutex_unlock(&evloop.lock);
+
+        evloop_run_job(job);
+
+        pthread_mutex_lock(&evloop.lock);
+        job->next = NULL;
+        *evloop.done_tail = job;
+        evloop.done_tail = &job->next;
+        pthread_mutex_unlock(&evloop.lock);
+
+        if (write(evloop.wake[1], "", 1) < 0 && errno != EAGAIN)
+        {
+            rig_debug(RIG_DEBUG_ERR, "%s: wake: %s\n", __func__, strerror(errno));
+        }
     }
 
-    rig_debug(RIG_DEBUG_VERBOSE,
-              "Connection closed from %s:%s\n",
-              host,
-              serv);
+    return NULL;
+}
 
-handle_exit:
 
-// for MINGW we close the handle before fclose
-#ifdef __MINGW32__
-    retcode = closesocket(handle_data_arg->sock);
+static void evloop_submit(struct evloop_job *job)
+{
+    pthread_mutex_lock(&evloop.lock);
+    job->next = NULL;
+    *evloop.pending_tail = job;
+    evloop.pending_tail = &job->next;
+    pthread_cond_signal(&evloop.cond);
+    pthread_mutex_unlock(&evloop.lock);
+}
 
-    if (retcode != 0) { rig_debug(RIG_DEBUG_ERR, "%s: fclose(fsockin) %s\n", __func__, strerror(retcode)); }
 
-#endif
+static void evloop_stream_stop(struct evloop_client *client)
+{
+    struct evloop_client **p;
 
-    if (fsockin) { fclose(fsockin); }
+    if (client->handle.spectrum_stream == NULL)
+    {
+        return;
+    }
 
-    if (fsockout) { fclose(fsockout); }
+    for (p = &evloop.streaming; *p; p = &(*p)->stream_next)
+    {
+        if (*p == client)
+        {
+            *p = client->stream_next;
+            break;
+        }
+    }
 
-// for everybody else we close the handle after fclose
-#ifndef __MINGW32__
-    retcode = close(handle_data_arg->sock);
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: stream stopped, %lu lines dropped\n",
+              __func__, spectrum_stream_dropped(client->handle.spectrum_stream));
 
-    if (retcode != 0 && errno != EBADF) { rig_debug(RIG_DEBUG_ERR, "%s: close(handle_data_arg->sock) %s\n", __func__, strerror(errno)); }
+    spectrum_stream_close(client->handle.spectrum_stream);
+    client->handle.spectrum_stream = NULL;
+    client->streaming = 0;
+}
 
-#endif
 
-    pthread_setspecific(thread_data_key, NULL);      // Tell pthreads we're done with the data
-    free(arg);
+/*
+ * Frees the clients closed during the last batch of events; freeing them
+ * right away would leave later events of the batch pointing at them.
+ */
+static void evloop_reap(void)
+{
+    while (evloop.reaped)
+    {
+        struct evloop_client *client = evloop.reaped;
 
-    pthread_exit(NULL);
+        evloop.reaped = client->reap_next;
+        free(client->in);
+        free(client->out);
+        free(client);
+
+        --client_count;
+
+        if (rigctld_idle && client_count == 0)
+        {
+            struct evloop_job *job = calloc(1, sizeof(*job));
+
+            if (job) { evloop_submit(job); }
+        }
+    }
+}
+
+
+/* Closes the connection, the client is freed once the worker is done */
+static void evloop_drop_client(int epfd, struct evloop_client *client)
+{
+    char host[NI_MAXHOST];
+    char serv[NI_MAXSERV];
+
+    if (getnameinfo((struct sockaddr const *)&client->handle.cli_addr,
+                    client->handle.clilen, host, sizeof(host), serv, sizeof(serv),
+                    NI_NUMERICHOST | NI_NUMERICSERV) == 0)
+    {
+        rig_debug(RIG_DEBUG_VERBOSE, "Connection closed from %s:%s\n", host, serv);
+    }
+
+    epoll_ctl(epfd, EPOLL_CTL_DEL, client->handle.sock, NULL);
+    close(client->handle.sock);
+    client->handle.sock = -1;
+    client->gone = 1;
+
+    evloop_stream_stop(client);
+
+    if (!client->busy)
+    {
+        client->reap_next = evloop.reaped;
+        evloop.reaped = client;
+    }
+}
+
+
+/* Hands the complete lines buffered for a client to the rig worker */
+static void evloop_dispatch(struct evloop_client *client)
+{
+    struct evloop_job *job;
+    size_t len;
+
+    if (client->busy || client->closing || client->in_len <= client->stalled)
+    {
+        return;
+    }
+
+    if (client->streaming)
+    {
+        /* a line from the client stops its stream and is dropped */
+        for (len = 0; len < client->in_len; ++len)
+        {
+            if (client->in[len] == '\n' || client->in[len] == '\r')
+            {
+                break;
+            }
+        }
+
+        if (len == client->in_len)
+        {
+            client->stalled = client->in_len;
+            return;
+        }
+
+        evloop_stream_stop(client);
+
+        while (len < client->in_len
+                && (client->in[len] == '\n' || client->in[len] == '\r'))
+        {
+            ++len;
+        }
+
+        memmove(client->in, client->in + len, client->in_len - len);
+        client->in_len -= len;
+        client->stalled = 0;
+
+        if (client->in_len == 0)
+        {
+            return;
+        }
+    }
+
+    for (len = client->in_len; len > client->stalled; --len)
+    {
+        if (client->in[len - 1] == '\n' || client->in[len - 1] == '\r')
+        {
+            break;
+        }
+    }
+
+    if (len == client->stalled)
+    {
+        return;
+    }
+
+    job = calloc(1, sizeof(*job));
+
+    if (job == NULL || (job->in = malloc(len)) == NULL)
+    {
+        free(job);
+        return;
+    }
+
+    memcpy(job->in, client->in, len);
+    job->in_len = len;
+    job->client = client;
+    client->busy = 1;
+
+    evloop_submit(job);
+}
+
+
+/* Writes as much queued output as the socket accepts */
+static int evloop_flush(int epfd, struct evloop_client *client)
+{
+    struct epoll_event ev;
+
+    while (client->out_off < client->out_len)
+    {
+        ssize_t n = send(client->handle.sock, client->out + client->out_off,
+                         client->out_len - client->out_off, MSG_NOSIGNAL);
+
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+
+        if (n <= 0)
+        {
+            return -1;
+        }
+
+        client->out_off += n;
+    }
+
+    if (client->out_off == client->out_len)
+    {
+        client->out_off = client->out_len = 0;
+
+        if (client->closing)
+        {
+            return -1;
+        }
+    }
+
+    ev.events = client->eof ? 0 : EPOLLIN | EPOLLRDHUP;
+
+    if (client->out_len) { ev.events |= EPOLLOUT; }
+
+    ev.data.ptr = client;
+    epoll_ctl(epfd, EPOLL_CTL_MOD, client->handle.sock, &ev);
+
+    return 0;
+}
+
+
+/*
+ * Dispatches the client's complete lines; after its EOF, closes once they
+ * were served and the answers sent.  Returns -1 to drop the client.
+ */
+static int evloop_serve(int epfd, struct evloop_client *client)
+{
+    evloop_dispatch(client);
+
+    if (client->eof && !client->busy && !client->closing)
+    {
+        client->closing = 1;
+        return evloop_flush(epfd, client);
+    }
+
+    return 0;
+}
+
+
+/*
+ * Moves waiting spectrum lines to the output while the client takes
+ * them; lines a slow client leaves waiting are dropped by its stream.
+ */
+static int evloop_stream_pump(int epfd, struct evloop_client *client)
+{
+    if (client->out_off)
+    {
+        memmove(client->out, client->out + client->out_off,
+                client->out_len - client->out_off);
+        client->out_len -= client->out_off;
+        client->out_off = 0;
+    }
+
+    while (client->out_len < EVLOOP_STREAM_BACKLOG
+            && evloop_reserve(&client->out, &client->out_size,
+                              client->out_len + SPECTRUM_STREAM_FRAME_MAX) == 0)
+    {
+        int n = spectrum_stream_next(client->handle.spectrum_stream,
+                                     (unsigned char *) client->out + client->out_len,
+                                     SPECTRUM_STREAM_FRAME_MAX);
+
+        if (n <= 0)
+        {
+            break;
+        }
+
+        client->out_len += n;
+    }
+
+    return evloop_flush(epfd, client);
+}
+
+
+static void evloop_complete(int epfd, struct evloop_job *job)
+{
+    struct evloop_client *client = job->client;
+
+    if (client == NULL)
+    {
+        free(job);
+        return;
+    }
+
+    client->busy = 0;
+
+    if (client->gone)
+    {
+        client->reap_next = evloop.reaped;
+        evloop.reaped = client;
+    }
+    else
+    {
+        memmove(client->in, client->in + job->consumed,
+                client->in_len - job->consumed);
+        client->in_len -= job->consumed;
+        client->stalled = job->consumed < job->in_len ? client->in_len : 0;
+
+        if (job->quit)
+        {
+            client->closing = 1;
+        }
+
+        if (job->out_len
+                && evloop_reserve(&client->out, &client->out_size,
+                                  client->out_len + job->out_len) == 0)
+        {
+            memcpy(client->out + client->out_len, job->out, job->out_len);
+            client->out_len += job->out_len;
+        }
+
+        if (client->handle.spectrum_stream && !client->streaming)
+        {
+            client->streaming = 1;
+            client->stream_next = evloop.streaming;
+            evloop.streaming = client;
+        }
+
+        if ((client->streaming ? evloop_stream_pump(epfd, client)
+                : evloop_flush(epfd, client)) < 0
+                || evloop_serve(epfd, client) < 0)
+        {
+            evloop_drop_client(epfd, client);
+        }
+    }
+
+    free(job->in);
+    free(job->out);
+    free(job);
+}
+
+
+static void evloop_accept(int epfd, int sock_listen, int vfo_mode)
+{
+    for (;;)
+    {
+        struct evloop_client *client;
+        struct epoll_event ev;
+        char host[NI_MAXHOST];
+        char serv[NI_MAXSERV];
+        int retcode;
+
+        client = calloc(1, sizeof(*client));
+
+        if (!client)
+        {
+            rig_debug(RIG_DEBUG_ERR, "calloc: %s\n", strerror(errno));
+            return;
+        }
+
+        client->handle.rig = my_rig;
+        client->handle.clilen = sizeof(client->handle.cli_addr);
+        client->handle.vfo_mode = vfo_mode;
+        client->handle.use_password = rigctld_password[0] != 0;
+        client->handle.can_stream = 1;
+        client->handle.stream_notify = evloop.stream[1];
+        client->resp_sep = resp_sep;
+        client->handle.sock = accept(sock_listen,
+                                     (struct sockaddr *)&client->handle.cli_addr,
+                                     &client->handle.clilen);
+
+        if (client->handle.sock < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                handle_error(RIG_DEBUG_ERR, "accept");
+            }
+
+            free(client);
+            return;
+        }
+
+        if ((retcode = getnameinfo((struct sockaddr const *)&client->handle.cli_addr,
+                                   client->handle.clilen, host, sizeof(host), serv, sizeof(serv),
+                                   NI_NUMERICHOST | NI_NUMERICSERV)) != 0)
+        {
+            rig_debug(RIG_DEBUG_WARN, "Peer lookup error: %s", gai_strerror(retcode));
+        }
+        else
+        {
+            rig_debug(RIG_DEBUG_VERBOSE, "Connection opened from %s:%s\n", host, serv);
+        }
+
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.ptr = client;
+
+        if (evloop_set_nonblock(client->handle.sock) < 0
+                || epoll_ctl(epfd, EPOLL_CTL_ADD, client->handle.sock, &ev) < 0)
+        {
+            handle_error(RIG_DEBUG_ERR, "epoll_ctl");
+            close(client->handle.sock);
+            free(client);
+            continue;
+        }
+
+        ++client_count;
+    }
+}
+
+
+/*
+ * Reads what the client sent; returns 1 once the client shut down its
+ * side and -1 when the connection is gone.
+ */
+static int evloop_read(struct evloop_client *client)
+{
+    for (;;)
+    {
+        ssize_t n;
+
+        if (client->in_len + EVLOOP_READ_SIZE > EVLOOP_INBUF_MAX)
+        {
+            rig_debug(RIG_DEBUG_ERR, "%s: input overflow, dropping client\n",
+                      __func__);
+            return -1;
+        }
+
+        if (evloop_reserve(&client->in, &client->in_size,
+                           client->in_len + EVLOOP_READ_SIZE) < 0)
+        {
+            return -1;
+        }
+
+        n = recv(client->handle.sock, client->in + client->in_len,
+                 EVLOOP_READ_SIZE, 0);
+
+        if (n > 0)
+        {
+            client->in_len += n;
+            continue;
+        }
+
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return 0;
+        }
+
+        return n == 0 ? 1 : -1;
+    }
+}
+
+
+static int rigctld_event_loop(int sock_listen, int vfo_mode)
+{
+    struct epoll_event events[EVLOOP_MAX_EVENTS];
+    struct epoll_event ev;
+    pthread_t workers[EVLOOP_WORKERS];
+    int nworkers;
+    int epfd;
+
+    if (pipe(evloop.wake) < 0
+            || evloop_set_nonblock(evloop.wake[0]) < 0
+            || evloop_set_nonblock(evloop.wake[1]) < 0
+            || pipe(evloop.stream) < 0
+            || evloop_set_nonblock(evloop.stream[0]) < 0
+            || evloop_set_nonblock(evloop.stream[1]) < 0
+            || evloop_set_nonblock(sock_listen) < 0)
+    {
+        handle_error(RIG_DEBUG_ERR, "event loop setup");
+        return -RIG_EIO;
+    }
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+
+    if (epfd < 0)
+    {
+        handle_error(RIG_DEBUG_ERR, "epoll_create1");
+        return -RIG_EIO;
+    }
+
+    ev.events = EPOLLIN;
+    ev.data.ptr = &evloop_listen_tag;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, sock_listen, &ev);
+    ev.data.ptr = &evloop_wake_tag;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, evloop.wake[0], &ev);
+    ev.data.ptr = &evloop_stream_tag;
+    epoll_ctl(epfd, EPOLL_CTL_ADD, evloop.stream[0], &ev);
+
+    for (nworkers = 0; nworkers < EVLOOP_WORKERS; ++nworkers)
+    {
+        if (pthread_create(&workers[nworkers], NULL, evloop_worker, NULL) != 0)
+        {
+            break;
+        }
+    }
+
+    if (nworkers == 0)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: pthread_create failed\n", __func__);
+        close(epfd);
+        return -RIG_EINTERNAL;
+    }
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: serving clients from one event loop\n",
+              __func__);
+
+    while (!ctrl_c)
+    {
+        int n = epoll_wait(epfd, events, EVLOOP_MAX_EVENTS, 1000);
+        int i;
+
+        if (n < 0)
+        {
+            if (errno != EINTR)
+            {
+                handle_error(RIG_DEBUG_ERR, "epoll_wait");
+                break;
+            }
+
+            continue;
+        }
+
+        for (i = 0; i < n; ++i)
+        {
+            struct evloop_client *client;
+
+            if (events[i].data.ptr == &evloop_listen_tag)
+            {
+                evloop_accept(epfd, sock_listen, vfo_mode);
+                continue;
+            }
+
+            if (events[i].data.ptr == &evloop_wake_tag)
+            {
+                char drain[64];
+                struct evloop_job *job;
+
+                while (read(evloop.wake[0], drain, sizeof(drain)) > 0) { }
+
+                pthread_mutex_lock(&evloop.lock);
+                job = evloop.done;
+                evloop.done = NULL;
+                evloop.done_tail = &evloop.done;
+                pthread_mutex_unlock(&evloop.lock);
+
+                while (job)
+                {
+                    struct evloop_job *next = job->next;
+
+                    evloop_complete(epfd, job);
+                    job = next;
+                }
+
+                continue;
+            }
+
+            if (events[i].data.ptr == &evloop_stream_tag)
+            {
+                char drain[64];
+
+                while (read(evloop.stream[0], drain, sizeof(drain)) > 0) { }
+
+                for (client = evloop.streaming; client; )
+                {
+                    struct evloop_client *next = client->stream_next;
+
+                    if (evloop_stream_pump(epfd, client) < 0)
+                    {
+                        evloop_drop_client(epfd, client);
+                    }
+
+                    client = next;
+                }
+
+                continue;
+            }
+
+            client = events[i].data.ptr;
+
+            if (client->gone)
+            {
+                continue;
+            }
+
+            if ((events[i].events & EPOLLOUT)
+                    && (client->streaming ? evloop_stream_pump(epfd, client)
+                        : evloop_flush(epfd, client)) < 0)
+            {
+                evloop_drop_client(epfd, client);
+                continue;
+            }
+
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+            {
+                int retcode = client->eof ? -1 : evloop_read(client);
+
+                if (retcode > 0)
+                {
+                    /* e.g. "echo f | nc -N", answer before closing */
+                    client->eof = 1;
+                    retcode = evloop_flush(epfd, client);
+                }
+
+                if (retcode < 0 || evloop_serve(epfd, client) < 0)
+                {
+                    evloop_drop_client(epfd, client);
+                }
+            }
+        }
+
+        evloop_reap();
+    }
+
+    pthread_mutex_lock(&evloop.lock);
+    evloop.stop = 1;
+    pthread_cond_broadcast(&evloop.cond);
+    pthread_mutex_unlock(&evloop.lock);
+
+    while (nworkers > 0)
+    {
+        pthread_join(workers[--nworkers], NULL);
+    }
+
+    close(epfd);
+    close(evloop.wake[0]);
+    close(evloop.wake[1]);
+    close(evloop.stream[0]);
+    close(evloop.stream[1]);
+
+    return RIG_OK;
+}
+#endif /* HAVE_SYS_EPOLL_H */
+
+
+/*
+ * Sends the lines of the stream the last command started until the
+ * client sends a line, which stops it and is otherwise ignored.
+ */
+static void serve_spectrum_stream(struct handle_data *handle, FILE *fin,
+                                  FILE *fout)
+{
+    char line[1024];
+    int retcode = 1;
+
+    while (!ctrl_c && retcode > 0)
+    {
+        retcode = spectrum_stream_serve(handle->spectrum_stream, fin, fout);
+    }
+
+    rig_debug(RIG_DEBUG_VERBOSE, "%s: stream stopped, %lu lines dropped\n",
+              __func__, spectrum_stream_dropped(handle->spectrum_stream));
+
+    spectrum_stream_close(handle->spectrum_stream);
+    handle->spectrum_stream = NULL;
+
+    if (retcode == 0 && fgets(line, sizeof(line), fin) == NULL)
+    {
+        rig_debug(RIG_DEBUG_VERBOSE, "%s: client gone\n", __func__);
+    }
+}
+
+
+/*
+ * This is the function run by the threads
+ */
+void *handle_socket(void *arg)
+{
+    struct handle_data *handle_data_arg = (struct handle_data *)arg;
+    FILE *fsockin = NULL;
+    FILE *fsockout = NULL;
+    int retcode = RIG_OK;
+    char host[NI_MAXHOST];
+    char serv[NI_MAXSERV];
+    char send_cmd_term = '\r';  /* send_cmd termination char */
+    int ext_resp = 0;
+    char my_resp_sep = resp_sep;  // Separator for this connection, initial default
+    rig_powerstat = RIG_POWER_ON; // defaults to power on
+    struct timespec powerstat_check_time;
+
+    fsockin = get_fsockin(handle_data_arg);
+
+    if (!fsockin)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: fdopen(0x%d) in: %s\n", __func__,
+                  handle_data_arg->sock,
+                  strerror(errno));
+        goto handle_exit;
+    }
+
+    fsockout = get_fsockout(handle_data_arg);
+
+    if (!fsockout)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: fdopen out: %s\n", __func__, strerror(errno));
+        fclose(fsockin);
+        fsockin = NULL;
+
+        goto handle_exit;
+    }
+
+    retcode = pthread_setspecific(thread_data_key, arg);
+    if (0 != retcode)
+    {
+        rig_debug(RIG_DEBUG_ERR, "%s: Could not set thread daya\n", __func__);
+        // What do we do here?
+    }
+
+    mutex_rigctld(1);
+
+    ++client_count;
+#if 0
+
+    if (!client_count++)
+    {
+        retcode = rig_open(my_rig);
+
+        if (RIG_OK == retcode && verbose > RIG_DEBUG_ERR)
+        {
+            printf("Opened rig model %d, '%s'\n",
+                   my_rig->caps->rig_model,
+                   my_rig->caps->model_name);
+        }
+    }
+
+#endif
+
+    mutex_rigctld(0);
+
+    if (my_rig->caps->get_powerstat)
+    {
+        mutex_rigctld(1);
+        rig_get_powerstat(my_rig, &rig_powerstat);
+        mutex_rigctld(0);
+        STATE(my_rig)->powerstat = rig_powerstat;
+    }
+
+    elapsed_ms(&powerstat_check_time, HAMLIB_ELAPSED_SET);
+
+    do
+    {
+        /* only wait for the client lock to reopen, a PTT must not queue */
+        if (!rig_opened)
+        {
+            mutex_rigctld(1);
+
+            if (!rig_opened)
+            {
+                retcode = rig_open(my_rig);
+                rig_opened = retcode == RIG_OK ? 1 : 0;
+                rig_debug(RIG_DEBUG_ERR, "%s: rig_open reopened retcode=%d\n", __func__,
+                          retcode);
+            }
+
+            mutex_rigctld(0);
+        }
+
+        if (rig_opened) // only do this if rig is open
+        {
+            rig_debug(RIG_DEBUG_TRACE, "%s: doing rigctl_parse vfo_mode=%d, secure=%d\n",
+                      __func__,
+                      handle_data_arg->vfo_mode, handle_data_arg->use_password);
+            retcode = rigctl_parse(handle_data_arg->rig, fsockin, fsockout, NULL, 0,
+                                   mutex_rigctld, 1, 0, &handle_data_arg->vfo_mode,
+                                   send_cmd_term, &ext_resp, &my_resp_sep,
+                                   handle_data_arg->use_password);
+
+            if (retcode != 0) { rig_debug(RIG_DEBUG_VERBOSE, "%s: rigctl_parse retcode=%d\n", __func__, retcode); }
+
+            if (handle_data_arg->spectrum_stream)
+            {
+                serve_spectrum_stream(handle_data_arg, fsockin, fsockout);
+            }
+
+            // If we get a timeout, the rig might be powered off
+            // Update our power status in case power gets turned off
+            // Check power status if rig is powered off, but not more often than once per second
+            if (my_rig->caps->get_powerstat && (retcode == -RIG_ETIMEOUT ||
+                                                (retcode == -RIG_EPOWER
+                                                 && elapsed_ms(&powerstat_check_time, HAMLIB_ELAPSED_GET) >= 1000)))
+            {
+                powerstat_t powerstat;
+                rig_get_powerstat(my_rig, &powerstat);
+                rig_powerstat = powerstat;
+
+                if (powerstat == RIG_POWER_OFF || powerstat == RIG_POWER_STANDBY)
+                {
+                    retcode = -RIG_EPOWER;
+                }
+
+                elapsed_ms(&powerstat_check_time, HAMLIB_ELAPSED_SET);
+            }
+        }
+        else
+        {
+            retcode = -RIG_EIO;
+        }
+
+        // if we get a hard error we try to reopen the rig again
+        // this should cover short dropouts that can occur
+        if (retcode < 0 && !RIG_IS_SOFT_ERRCODE(retcode))
+        {
+            int retry = 3;
+            rig_debug(RIG_DEBUG_ERR, "%s: i/o error\n", __func__);
+
+            do
+            {
+                mutex_rigctld(1);
+                retcode = rig_close(my_rig);
+                rig_opened = 0;
+                mutex_rigctld(0);
+                rig_debug(RIG_DEBUG_ERR, "%s: rig_close retcode=%d\n", __func__, retcode);
+
+                hl_usleep(1000 * 1000);
+
+                mutex_rigctld(1);
+
+                if (!rig_opened)
+                {
+                    retcode = rig_open(my_rig);
+                    rig_opened = retcode == RIG_OK ? 1 : 0;
+                    rig_debug(RIG_DEBUG_ERR, "%s: rig_open retcode=%d, opened=%d\n", __func__,
+                              retcode, rig_opened);
+                }
+
+                mutex_rigctld(0);
+            }
+            while (!ctrl_c && !rig_opened && retry-- > 0 && retcode != RIG_OK);
+        }
+    }
+    while (!ctrl_c && (retcode == RIG_OK || RIG_IS_SOFT_ERRCODE(retcode)));
+
+    mutex_rigctld(1);
+    if (rigctld_idle && client_count == 1)
+    {
+        rig_close(my_rig);
+
+        if (verbose > RIG_DEBUG_ERR) { printf("Closed rig model %s.  Will reopen for new clients\n", my_rig->caps->model_name); }
+    }
+
+    --client_count;
+    mutex_rigctld(0);
+
+    if (rigctld_idle && client_count > 0) { printf("%u client%s still connected so rig remains open\n", client_count, client_count > 1 ? "s" : ""); }
+
+#if 0
+    mutex_rigctld(1);
+
+    /* Release rig if there are no clients */
+    if (!--client_count)
+    {
+        rig_close(my_rig);
+
+        if (verbose > RIG_DEBUG_ERR)
+        {
+            printf("Closed rig model %d, '%s - no clients, will reopen for new clients'\n",
+                   my_rig->caps->rig_model,
+                   my_rig->caps->model_name);
+        }
+    }
+
+    mutex_rigctld(0);
+#endif
+
+    if ((retcode = getnameinfo((struct sockaddr const *)&handle_data_arg->cli_addr,
+                               handle_data_arg->clilen,
+                               host,
+                               sizeof(host),
+                               serv,
+                               sizeof(serv),
+                               NI_NUMERICHOST | NI_NUMERICSERV))
+            < 0)
+    {
+
+        rig_debug(RIG_DEBUG_WARN, "Peer lookup error: %s", gai_strerror(retcode));
+    }
+
+    rig_debug(RIG_DEBUG_VERBOSE,
+              "Connection closed from %s:%s\n",
+              host,
+              serv);
+
+handle_exit:
+
+// for MINGW we close the handle before fclose
+#ifdef __MINGW32__
+    retcode = closesocket(handle_data_arg->sock);
+
+    if (retcode != 0) { rig_debug(RIG_DEBUG_ERR, "%s: fclose(fsockin) %s\n", __func__, strerror(retcode)); }
+
+#endif
+
+    if (fsockin) { fclose(fsockin); }
+
+    if (fsockout) { fclose(fsockout); }
+
+// for everybody else we close the handle after fclose
+#ifndef __MINGW32__
+    retcode = close(handle_data_arg->sock);
+
+    if (retcode != 0 && errno != EBADF) { rig_debug(RIG_DEBUG_ERR, "%s: close(handle_data_arg->sock) %s\n", __func__, strerror(errno)); }
+
+#endif
+
+    pthread_setspecific(thread_data_key, NULL);      // Tell pthreads we're done with the data
+    free(arg);
+
+    pthread_exit(NULL);
     return NULL;
 }
 
 
+/*
+ * --cache-ttl: either a bare time in ms, which applies to every item
+ * cache (levels, funcs, parms, RIT, XIT, antenna), or a comma separated
+ * list of item=ms.  "all" sets the shared VFO/freq/mode/PTT/split timeout.
+ */
+static int set_cache_ttl(RIG *rig, const char *spec)
+{
+    static const struct
+    {
+        const char *name;
+        hamlib_cache_t selection;
+    } items[] =
+    {
+        { "all",   HAMLIB_CACHE_ALL },
+        { "level", HAMLIB_CACHE_LEVEL },
+        { "func",  HAMLIB_CACHE_FUNC },
+        { "parm",  HAMLIB_CACHE_PARM },
+        { "rit",   HAMLIB_CACHE_RIT },
+        { "xit",   HAMLIB_CACHE_XIT },
+        { "ant",   HAMLIB_CACHE_ANT },
+    };
+    char buf[256];
+    char *tok;
+    char *end;
+    long ms;
+    int i;
+
+    SNPRINTF(buf, sizeof(buf), "%s", spec);
+
+    for (tok = strtok(buf, ","); tok; tok = strtok(NULL, ","))
+    {
+        char *eq = strchr(tok, '=');
+
+        ms = strtol(eq ? eq + 1 : tok, &end, 10);
+
+        if (*end != '\0' || end == (eq ? eq + 1 : tok) || ms < HAMLIB_CACHE_ALWAYS)
+        {
+            return -RIG_EINVAL;
+        }
+
+        if (!eq)
+        {
+            for (i = HAMLIB_CACHE_LEVEL; i <= HAMLIB_CACHE_ANT; i++)
+            {
+                rig_set_cache_timeout_ms(rig, (hamlib_cache_t) i, (int) ms);
+            }
+
+            continue;
+        }
+
+        *eq = '\0';
+
+        for (i = 0; i < (int)(sizeof(items) / sizeof(items[0])); i++)
+        {
+            if (strcmp(tok, items[i].name) == 0)
+            {
+                break;
+            }
+        }
+
+        if (i == (int)(sizeof(items) / sizeof(items[0])))
+        {
+            return -RIG_EINVAL;
+        }
+
+        rig_set_cache_timeout_ms(rig, items[i].selection, (int) ms);
+    }
+
+    return RIG_OK;
+}
+
+
 static void usage(FILE *fout)
 {
     fprintf(fout, "Usage: rigctld [OPTION]...\n"
@@ -1400,6 +2481,9 @@ static void usage(FILE *fout)
 #endif
         "  -R, --rigctld-idle            make rigctld close the rig when no clients are connected\n"
         "  -b, --bind-all                make rigctld bind to first network device available\n"
+        "  -E, --event-loop              serve all clients from one event loop (Linux only)\n"
+        "  -K, --cache-ttl=[ITEM=]MS[,...] cache levels etc. for MS, ITEM is one of\n"
+        "                                level, func, parm, rit, xit, ant or all (freq,mode...)\n"
         "  -h, --help                    display this help and exit\n"
         "  -V, --version                 output version information and exit\n\n",
         portno);
@@ -68,7 +68,7 @@ static int clear_chans(RIG *rig, const char *infilename);
  *      keep up to date SHORT_OPTIONS, usage()'s output and man page. thanks.
  * NB: do NOT use -W since it's reserved by POSIX.
  */
-#define SHORT_OPTIONS "m:r:s:c:C:p:axvhV"
+#define SHORT_OPTIONS "m:r:s:c:C:p:aixvhV"
 static struct option long_options[] =
 {
     {"model",           1, 0, 'm'},
@@ -78,6 +78,7 @@ static struct option long_options[] =
     {"set-conf",        1, 0, 'C'},
     {"set-separator",   1, 0, 'p'},
     {"all",             0, 0, 'a'},
+    {"incremental",     0, 0, 'i'},
 #ifdef HAVE_XML2
     {"xml",             0, 0, 'x'},
 #endif
@@ -106,6 +107,8 @@ int main(int argc, char *argv[])
     int serial_rate = 0;
     char *civaddr = NULL;   /* NULL means no need to set conf */
     char conf_parms[MAXCONFLEN] = "";
+    int incremental = 0;
+    char hash_file[1024] = "";
     extern char csv_sep;
 
     rig_set_debug(verbose);
@@ -176,6 +179,10 @@ int main(int argc, char *argv[])
         case 'a':
             all++;
             break;
+
+        case 'i':
+            incremental = 1;
+            break;
 #ifdef HAVE_XML2
 
         case 'x':
@@ -220,6 +227,12 @@ int main(int argc, char *argv[])
         exit(2);
     }
 
+    /* -C mem_incremental=VERIFY still applies */
+    if (incremental)
+    {
+        rig_set_conf(rig, rig_token_lookup(rig, "mem_incremental"), "ON");
+    }
+
     retcode = set_conf(rig, conf_parms);
 
     if (retcode != RIG_OK)
@@ -289,6 +302,20 @@ int main(int argc, char *argv[])
     /* on some rigs, this accelerates the backup/restore */
     rig_set_vfo(rig, RIG_VFO_MEM);
 
+    /* what the channels held after the last load or save of this file */
+    if (incremental && (!strcmp(argv[optind], "load")
+                        || !strcmp(argv[optind], "save")))
+    {
+        snprintf(hash_file, sizeof(hash_file), "%s.hashes", argv[optind + 1]);
+
+        if (!strcmp(argv[optind], "load")
+                && rig_load_chan_hashes(rig, hash_file) != RIG_OK)
+        {
+            fprintf(stderr, "No channel hashes in %s, writing all channels\n",
+                    hash_file);
+        }
+    }
+
     if (!strcmp(argv[optind], "save"))
     {
 #ifdef HAVE_XML2
@@ -355,6 +382,12 @@ int main(int argc, char *argv[])
         exit(1);
     }
 
+    if (retcode == RIG_OK && *hash_file
+            && rig_save_chan_hashes(rig, hash_file) != RIG_OK)
+    {
+        fprintf(stderr, "Cannot save channel hashes to %s\n", hash_file);
+    }
+
     rig_close(rig);     /* close port */
     rig_cleanup(rig);   /* if you care about memory */
 
@@ -389,6 +422,7 @@ static void usage(FILE *fout)
         "  -C, --set-conf=PARM=VAL[,...] set config parameters\n"
         "  -p, --set-separator=CHAR      set character separator instead of the CSV comma\n"
         "  -a, --all                     bypass mem_caps, apply to all fields of channel_t\n"
+        "  -i, --incremental             load only the channels changed since FILE.hashes\n"
 #ifdef HAVE_XML2
         "  -x, --xml                     use XML format instead of CSV\n"
 #endif
@@ -16,9 +16,56 @@
 #include <sys/types.h>
 #endif
 
+#include <hamlib/rig.h>
+#include "spectrum_packet.h"
+
 #define MCAST_PORT 4532
 #define MCAST_ADDR "224.0.0.1"
-#define BUFFER_SIZE 4096
+#define BUFFER_SIZE 16384
+
+/*
+ * Prints one decoded binary spectrum packet.  JSON snapshots are printed
+ * as they come.
+ */
+static void print_spectrum_packet(struct spectrum_packet_state *state,
+                                  const unsigned char *buf, int len)
+{
+    static const char *encodings[] = { "raw", "rle", "delta" };
+    unsigned char data[HAMLIB_MAX_SPECTRUM_DATA];
+    struct rig_spectrum_line line;
+    unsigned int min = 255, max = 0;
+    size_t i;
+    int result;
+
+    result = spectrum_packet_decode(state, buf, len, &line, data);
+
+    if (result == -RIG_ENAVAIL)
+    {
+        printf("spectrum: delta line without its base, waiting for a key line, %lu lost\n",
+               state->lost);
+        return;
+    }
+
+    if (result != RIG_OK)
+    {
+        printf("spectrum: bad packet, %d bytes\n", len);
+        return;
+    }
+
+    for (i = 0; i < line.spectrum_data_length; i++)
+    {
+        if (data[i] < min) { min = data[i]; }
+
+        if (data[i] > max) { max = data[i]; }
+    }
+
+    printf("spectrum: id=%d seq=%u %s %d bytes, %d bins %u..%u, center=%.0f span=%.0f, %lu lost\n",
+           line.id, line.id < HAMLIB_MAX_SPECTRUM_SCOPES ?
+           (unsigned int) state->scopes[line.id].seq : 0,
+           buf[5] < 3 ? encodings[buf[5]] : "?", len,
+           (int) line.spectrum_data_length, min, max, line.center_freq,
+           line.span_freq, state->lost);
+}
 
 int main()
 {
@@ -26,6 +73,7 @@ int main()
     struct sockaddr_in mcast_addr;
     char buffer[BUFFER_SIZE];
     int bytes_received;
+    static struct spectrum_packet_state spectrum_state;
 
 #ifdef _WIN32
     WSADATA wsaData;
@@ -82,7 +130,7 @@ int main()
 
     while (1)
     {
-        bytes_received = recvfrom(sock, buffer, BUFFER_SIZE, 0, NULL, 0);
+        bytes_received = recvfrom(sock, buffer, BUFFER_SIZE - 1, 0, NULL, 0);
 
         if (bytes_received < 0)
         {
@@ -90,6 +138,13 @@ int main()
             break;
         }
 
+        if (spectrum_packet_is_binary((unsigned char *) buffer, bytes_received))
+        {
+            print_spectrum_packet(&spectrum_state, (unsigned char *) buffer,
+                                  bytes_received);
+            continue;
+        }
+
         buffer[bytes_received] = '\0';
         printf("%s\n", buffer);
     }
@@ -84,6 +84,7 @@ extern int read_history();
 #endif
 
 #include "rotctl_parse.h"
+#include "cmd_index.h"
 #include "rotlist.h"
 #include "sprintflst.h"
 
@@ -246,22 +247,23 @@ struct test_table test_list[] =
 };
 
 
+static struct cmd_index cmd_lookup;
+static pthread_once_t cmd_lookup_once = PTHREAD_ONCE_INIT;
+
+static void cmd_lookup_init(void)
+{
+    CMD_INDEX_INIT(&cmd_lookup, test_list, struct test_table);
+}
+
+
 static struct test_table *find_cmd_entry(int cmd)
 {
     int i;
 
-    for (i = 0; test_list[i].cmd != 0x00; i++)
-        if (test_list[i].cmd == cmd)
-        {
-            break;
-        }
-
-    if (test_list[i].cmd == 0x00)
-    {
-        return NULL;
-    }
+    pthread_once(&cmd_lookup_once, cmd_lookup_init);
+    i = cmd_index_find_cmd(&cmd_lookup, cmd);
 
-    return &test_list[i];
+    return i < 0 ? NULL : &test_list[i];
 }
 
 
@@ -368,19 +370,16 @@ static void rp_getline(const char *s)
 
 
 /*
- * TODO: use Lex?
+ * Long command name to its one character command, 0 if unknown
  */
 static char parse_arg(const char *arg)
 {
-    for (int i = 0; test_list[i].cmd != 0; i++)
-    {
-        if (!strncmp(arg, test_list[i].name, MAXNAMSIZ))
-        {
-            return test_list[i].cmd;
-        }
-    }
+    int i;
+
+    pthread_once(&cmd_lookup_once, cmd_lookup_init);
+    i = cmd_index_find_name(&cmd_lookup, arg);
 
-    return 0;
+    return i < 0 ? 0 : test_list[i].cmd;
 }
 
 
@@ -1677,8 +1676,7 @@ declare_proto_rot(get_conf)
     if (arg1 == NULL || arg1[0] == '?')
     {
         dumpconf_list(rot, fout);
-        debugmsgsave[0] = 0;
-        debugmsgsave2[0] = 0;
+        rig_debug_clear();
         return RIG_OK;
     }
 
@@ -1716,8 +1714,7 @@ declare_proto_rot(set_conf)
     if (arg1[0] == '?')
     {
         dumpconf_list(rot, fout);
-        debugmsgsave[0] = 0;
-        debugmsgsave2[0] = 0;
+        rig_debug_clear();
         return RIG_OK;
     }
 
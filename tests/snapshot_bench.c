@@ -0,0 +1,179 @@
+/*
+ * Hamlib snapshot_bench program
+ *
+ * Serializes JSON snapshots of the dummy rig, as the multicast publisher
+ * does, and reports snapshots per second, bytes and heap allocations per
+ * snapshot, with and without a spectrum line, and with only the VFO
+ * sections that changed since the previous snapshot.
+ *
+ *   tests/snapshot_bench [snapshots]
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+
+#include "cache.h"
+#include "snapshot_data.h"
+
+#define SNAPSHOT_COUNT 20000
+#define LINE_BINS 689
+
+static unsigned long allocations;
+
+#ifdef __GLIBC__
+/* Count heap allocations by interposing on the C library's */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    allocations++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size)
+{
+    allocations++;
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    allocations++;
+    return __libc_realloc(ptr, size);
+}
+#define COUNTS_ALLOCATIONS 1
+#else
+#define COUNTS_ALLOCATIONS 0
+#endif
+
+static double now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+struct run
+{
+    const char *name;
+    int spectrum;
+    int changed_vfos;
+};
+
+static const struct run runs[] =
+{
+    { "rig and VFOs", 0, 0 },
+    { "with a spectrum line", 1, 0 },
+    { "changed VFOs only", 0, 1 },
+};
+
+int main(int argc, char *argv[])
+{
+    static char json[HAMLIB_MAX_SNAPSHOT_PACKET_SIZE];
+    static struct snapshot_vfo_state vfo_state;
+    unsigned char data[LINE_BINS];
+    struct rig_spectrum_line line;
+    int count = SNAPSHOT_COUNT;
+    RIG *rig;
+    int errors = 0;
+    int i, j;
+
+    if (argc > 1) { count = atoi(argv[1]); }
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig || rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "cannot open dummy rig\n");
+        return 1;
+    }
+
+    snapshot_init();
+
+    for (i = 0; i < LINE_BINS; i++) { data[i] = (unsigned char)(i * 7); }
+
+    memset(&line, 0, sizeof(line));
+    line.data_level_max = 200;
+    line.signal_strength_min = -100;
+    line.spectrum_mode = RIG_SPECTRUM_MODE_CENTER;
+    line.center_freq = 14074000;
+    line.span_freq = 50000;
+    line.low_edge_freq = 14049000;
+    line.high_edge_freq = 14099000;
+    line.spectrum_data_length = LINE_BINS;
+    line.spectrum_data = data;
+
+    printf("%d snapshots\n\n", count);
+    printf("%-22s %10s %8s %8s %12s\n", "", "snapshot/s", "us", "bytes",
+           "allocations");
+
+    for (i = 0; i < (int)(sizeof(runs) / sizeof(runs[0])); i++)
+    {
+        const struct run *r = &runs[i];
+        unsigned long allocated;
+        double bytes = 0;
+        double t;
+
+        memset(&vfo_state, 0, sizeof(vfo_state));
+        allocated = allocations;
+        t = now_us();
+
+        for (j = 0; j < count; j++)
+        {
+            // a tuning knob: VFO A moves every tenth snapshot
+            if (j % 10 == 0)
+            {
+                rig_set_cache_freq(rig, RIG_VFO_A, 14074000 + j);
+            }
+
+            if (snapshot_serialize_vfos(sizeof(json), json, rig,
+                                        r->spectrum ? &line : NULL,
+                                        r->changed_vfos ? &vfo_state : NULL) != RIG_OK)
+            {
+                errors++;
+                continue;
+            }
+
+            bytes += strlen(json);
+        }
+
+        t = now_us() - t;
+        allocated = allocations - allocated;
+
+        if (COUNTS_ALLOCATIONS)
+        {
+            printf("%-22s %10.0f %8.2f %8.0f %12.2f\n", r->name, count / t * 1e6,
+                   t / count, bytes / count, (double) allocated / count);
+        }
+        else
+        {
+            printf("%-22s %10.0f %8.2f %8.0f %12s\n", r->name, count / t * 1e6,
+                   t / count, bytes / count, "n/a");
+        }
+    }
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    if (errors)
+    {
+        fprintf(stderr, "%d snapshots failed\n", errors);
+        return 1;
+    }
+
+    return 0;
+}
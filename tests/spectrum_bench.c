@@ -0,0 +1,182 @@
+/*
+ * Hamlib spectrum_bench program
+ *
+ * Compares the two multicast spectrum formats on synthetic IC-7610 sized
+ * scope lines: the JSON snapshot (snapshot_serialize) against binary
+ * packets (spectrum_packet_encode), in bytes and CPU time per line.
+ * Binary packets are decoded again and checked against the input.
+ *
+ *   tests/spectrum_bench [lines]
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+
+#include "snapshot_data.h"
+#include "spectrum_packet.h"
+
+#define LINE_COUNT 2000
+#define LINE_BINS 689
+#define LINES_PER_SEC 25
+
+/* Synthetic scope: a noise floor, a few carriers and how much it moves */
+struct profile
+{
+    const char *name;
+    int noise;          // noise floor jitter, +/- levels
+    int change_pct;     // bins that change from one line to the next
+};
+
+static const struct profile profiles[] =
+{
+    { "busy band, no averaging", 6, 100 },
+    { "averaged", 1, 25 },
+    { "quiet, floor at zero", 0, 5 },
+};
+
+static unsigned int seed = 1;
+
+static int rnd(int n)
+{
+    seed = seed * 1103515245 + 12345;
+    return (int)((seed >> 16) % n);
+}
+
+static void next_line(const struct profile *p, unsigned char *data, int first)
+{
+    int floor = p->noise ? 30 : 0;
+    int i;
+
+    for (i = 0; i < LINE_BINS; i++)
+    {
+        int v;
+
+        if (!first && rnd(100) >= p->change_pct) { continue; }
+
+        v = floor + (p->noise ? rnd(2 * p->noise + 1) - p->noise : 0);
+
+        // carriers every 97 bins, 3 bins wide
+        if (i % 97 < 3) { v = 120 + rnd(20); }
+
+        data[i] = v < 0 ? 0 : v;
+    }
+}
+
+static double cpu_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+int main(int argc, char *argv[])
+{
+    static char json[HAMLIB_MAX_SNAPSHOT_PACKET_SIZE];
+    static unsigned char packet[SPECTRUM_PACKET_MAX_SIZE];
+    static struct spectrum_packet_state tx, rx;
+    unsigned char data[HAMLIB_MAX_SPECTRUM_DATA];
+    unsigned char decoded[HAMLIB_MAX_SPECTRUM_DATA];
+    struct rig_spectrum_line line, out;
+    int lines = LINE_COUNT;
+    RIG *rig;
+    int errors = 0;
+    int i, j;
+
+    if (argc > 1) { lines = atoi(argv[1]); }
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig || rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "cannot open dummy rig\n");
+        return 1;
+    }
+
+    snapshot_init();
+
+    memset(&line, 0, sizeof(line));
+    line.data_level_max = 200;
+    line.signal_strength_min = -100;
+    line.spectrum_mode = RIG_SPECTRUM_MODE_CENTER;
+    line.center_freq = 14074000;
+    line.span_freq = 50000;
+    line.low_edge_freq = 14049000;
+    line.high_edge_freq = 14099000;
+    line.spectrum_data_length = LINE_BINS;
+    line.spectrum_data = data;
+
+    printf("%d lines of %d bins, bytes/s at %d lines/s\n\n", lines, LINE_BINS,
+           LINES_PER_SEC);
+    printf("%-24s %6s %9s %8s   %6s %9s %8s  %s\n", "", "json", "B/s",
+           "us/line", "binary", "B/s", "us/line", "raw/rle/delta");
+
+    for (i = 0; i < (int)(sizeof(profiles) / sizeof(profiles[0])); i++)
+    {
+        const struct profile *p = &profiles[i];
+        double json_bytes = 0, bin_bytes = 0;
+        double json_cpu = 0, bin_cpu = 0;
+        int encodings[3] = { 0, 0, 0 };
+
+        memset(&tx, 0, sizeof(tx));
+        memset(&rx, 0, sizeof(rx));
+        next_line(p, data, 1);
+
+        for (j = 0; j < lines; j++)
+        {
+            double t;
+            int len;
+
+            next_line(p, data, 0);
+
+            t = cpu_us();
+            snapshot_serialize(sizeof(json), json, rig, &line);
+            json_bytes += strlen(json);
+            json_cpu += cpu_us() - t;
+
+            t = cpu_us();
+            len = spectrum_packet_encode(&tx, &line, packet, sizeof(packet));
+            bin_cpu += cpu_us() - t;
+
+            if (len < 0) { errors++; continue; }
+
+            bin_bytes += len;
+            encodings[packet[5]]++;
+
+            if (spectrum_packet_decode(&rx, packet, len, &out, decoded) != RIG_OK
+                    || out.spectrum_data_length != LINE_BINS
+                    || memcmp(decoded, data, LINE_BINS) != 0)
+            {
+                errors++;
+            }
+        }
+
+        printf("%-24s %6.0f %9.0f %8.1f   %6.0f %9.0f %8.1f  %d/%d/%d\n", p->name,
+               json_bytes / lines, json_bytes / lines * LINES_PER_SEC,
+               json_cpu / lines, bin_bytes / lines,
+               bin_bytes / lines * LINES_PER_SEC, bin_cpu / lines,
+               encodings[0], encodings[1], encodings[2]);
+    }
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    if (errors)
+    {
+        fprintf(stderr, "%d lines did not survive encode/decode\n", errors);
+        return 1;
+    }
+
+    return 0;
+}
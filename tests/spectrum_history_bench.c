@@ -0,0 +1,218 @@
+/*
+ * Hamlib spectrum_history_bench program
+ *
+ * Times the spectrum history kernels against the plain per-bin loops they
+ * replace, on IC-7610 sized lines (689 bins), and shows how many clients
+ * asking for the same average of the same line cost one computation.
+ *
+ *   tests/spectrum_history_bench [iterations]
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+#include <hamlib/rig_state.h>
+
+#include "spectrum_history.h"
+#include "spectrum_pool.h"
+
+#define ITERATIONS 20000
+#define LINE_BINS 689
+#define CLIENTS 8
+
+static unsigned char ring[SPECTRUM_HISTORY_LINES][LINE_BINS];
+
+static double cpu_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* What a client would write without the kernels */
+static void scalar(unsigned char *out, const unsigned char *const lines[],
+                   int count, size_t n, enum rig_spectrum_history_e op)
+{
+    size_t i;
+    int l;
+
+    for (i = 0; i < n; i++)
+    {
+        unsigned int acc = lines[0][i];
+
+        for (l = 1; l < count; l++)
+        {
+            unsigned int v = lines[l][i];
+
+            switch (op)
+            {
+            case RIG_SPECTRUM_HISTORY_AVERAGE: acc += v; break;
+
+            case RIG_SPECTRUM_HISTORY_MAX: if (v > acc) { acc = v; } break;
+
+            default: if (v < acc) { acc = v; } break;
+            }
+        }
+
+        out[i] = op == RIG_SPECTRUM_HISTORY_AVERAGE ? (acc + count / 2) / count
+                 : acc;
+    }
+}
+
+static void kernel(unsigned char *out, const unsigned char *const lines[],
+                   int count, size_t n, enum rig_spectrum_history_e op)
+{
+    switch (op)
+    {
+    case RIG_SPECTRUM_HISTORY_AVERAGE:
+        spectrum_kernel_average(out, lines, count, n);
+        break;
+
+    case RIG_SPECTRUM_HISTORY_MAX:
+        spectrum_kernel_max(out, lines, count, n);
+        break;
+
+    default:
+        spectrum_kernel_min(out, lines, count, n);
+        break;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    static const int counts[] = { 4, 16, SPECTRUM_HISTORY_LINES };
+    static const enum rig_spectrum_history_e ops[] =
+    {
+        RIG_SPECTRUM_HISTORY_AVERAGE, RIG_SPECTRUM_HISTORY_MAX,
+        RIG_SPECTRUM_HISTORY_MIN
+    };
+    const unsigned char *lines[SPECTRUM_HISTORY_LINES];
+    unsigned char out[HAMLIB_MAX_SPECTRUM_DATA], want[LINE_BINS];
+    struct rig_spectrum_line line;
+    struct spectrum_history *h;
+    unsigned long computed;
+    int iterations = ITERATIONS;
+    double t, ts, tk;
+    int errors = 0;
+    int i, c, o;
+    RIG *rig;
+
+    if (argc > 1) { iterations = atoi(argv[1]); }
+
+    srand(1);
+
+    for (c = 0; c < SPECTRUM_HISTORY_LINES; c++)
+    {
+        for (i = 0; i < LINE_BINS; i++) { ring[c][i] = rand(); }
+
+        lines[c] = ring[c];
+    }
+
+    printf("%d bins, us per combined line\n\n", LINE_BINS);
+    printf("%-8s %6s %9s %9s %8s\n", "op", "lines", "scalar", "kernel",
+           "speedup");
+
+    for (o = 0; o < (int)(sizeof(ops) / sizeof(ops[0])); o++)
+    {
+        for (c = 0; c < (int)(sizeof(counts) / sizeof(counts[0])); c++)
+        {
+            t = cpu_us();
+
+            for (i = 0; i < iterations; i++)
+            {
+                scalar(want, lines, counts[c], LINE_BINS, ops[o]);
+            }
+
+            ts = (cpu_us() - t) / iterations;
+            t = cpu_us();
+
+            for (i = 0; i < iterations; i++)
+            {
+                kernel(out, lines, counts[c], LINE_BINS, ops[o]);
+            }
+
+            tk = (cpu_us() - t) / iterations;
+
+            if (memcmp(out, want, LINE_BINS) != 0) { errors++; }
+
+            printf("%-8s %6d %9.2f %9.2f %7.1fx\n", rig_strspectrumhistory(ops[o]),
+                   counts[c], ts, tk, tk > 0 ? ts / tk : 0);
+        }
+    }
+
+    t = cpu_us();
+
+    for (i = 0; i < iterations; i++)
+    {
+        spectrum_kernel_decimate(out, 200, ring[0], LINE_BINS,
+                                 RIG_SPECTRUM_HISTORY_MAX);
+    }
+
+    printf("\ndecimate %d to 200 bins: %.2f us\n", LINE_BINS,
+           (cpu_us() - t) / iterations);
+
+    /* several clients polling the same 16 line average, once per new line */
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig || rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "cannot open dummy rig\n");
+        return 1;
+    }
+
+    h = STATE(rig)->spectrum_history;
+    memset(&line, 0, sizeof(line));
+    line.spectrum_mode = RIG_SPECTRUM_MODE_CENTER;
+    line.center_freq = 14074000;
+    line.span_freq = 50000;
+    line.spectrum_data_length = LINE_BINS;
+
+    computed = h->computed;
+    t = cpu_us();
+
+    for (i = 0; i < iterations / 10; i++)
+    {
+        struct spectrum_buffer *buf = spectrum_buffer_get(rig);
+        struct rig_spectrum_line result;
+
+        buf->line = line;
+        buf->line.spectrum_data = buf->data;
+        memcpy(buf->data, ring[i % SPECTRUM_HISTORY_LINES], LINE_BINS);
+        spectrum_history_push(rig, buf);
+        spectrum_buffer_unref(buf);
+
+        for (c = 0; c < CLIENTS; c++)
+        {
+            rig_get_spectrum_history(rig, 0, RIG_SPECTRUM_HISTORY_AVERAGE, 16, 0,
+                                     &result, out);
+        }
+    }
+
+    printf("%d clients, %d lines: %lu computations, %.2f us per line\n",
+           CLIENTS, iterations / 10, h->computed - computed,
+           (cpu_us() - t) / (iterations / 10));
+
+    if (h->computed - computed != (unsigned long)(iterations / 10)) { errors++; }
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    if (errors)
+    {
+        fprintf(stderr, "%d results differ from the scalar loops\n", errors);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+/*
+ * Hamlib spectrum_pool_bench program
+ *
+ * Fires IC-7610 sized scope lines (689 bins) through the history and
+ * the multicast publisher at 8000 lines/s, well past what a rig sends,
+ * the way the Icom backend does (assembled in a pooled buffer) and the
+ * way a line from elsewhere is (copied into one).  Reports the line
+ * copies and the CPU time of the publisher thread per line.
+ *
+ *   tests/spectrum_pool_bench [lines]
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+#include <hamlib/rig_state.h>
+
+#include "event.h"
+#include "sleep.h"
+#include "spectrum_pool.h"
+
+#define LINE_COUNT 20000
+#define LINE_BINS 689
+#define BURST 16            // lines between 2 ms pauses, 8000 lines/s
+
+static double cpu_us(clockid_t clock)
+{
+    struct timespec ts;
+
+    clock_gettime(clock, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void fill(unsigned char *data, int i)
+{
+    int j;
+
+    for (j = 0; j < LINE_BINS; j++) { data[j] = (unsigned char)(30 + (i + j) % 7); }
+}
+
+static int run(const char *format, int lines)
+{
+    static const char *const modes[] = { "copied", "pooled" };
+    unsigned char data[LINE_BINS];
+    struct rig_spectrum_line line;
+    struct spectrum_pool *pool;
+    int m, i;
+    RIG *rig;
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig)
+    {
+        return 1;
+    }
+
+    rig_set_conf(rig, rig_token_lookup(rig, "multicast_data_addr"), "127.0.0.1");
+    rig_set_conf(rig, rig_token_lookup(rig, "multicast_data_port"), "45998");
+    rig_set_conf(rig, rig_token_lookup(rig, "multicast_spectrum_format"), format);
+
+    if (rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "cannot open dummy rig\n");
+        return 1;
+    }
+
+    pool = STATE(rig)->spectrum_pool;
+
+    memset(&line, 0, sizeof(line));
+    line.spectrum_mode = RIG_SPECTRUM_MODE_CENTER;
+    line.center_freq = 14074000;
+    line.span_freq = 50000;
+    line.spectrum_data_length = LINE_BINS;
+    line.spectrum_data = data;
+
+    for (m = 0; m < 2; m++)
+    {
+        unsigned long copies = pool->copies, fired = pool->lines;
+        double process = cpu_us(CLOCK_PROCESS_CPUTIME_ID);
+        double main_thread = cpu_us(CLOCK_THREAD_CPUTIME_ID);
+
+        for (i = 0; i < lines; i++)
+        {
+            if (m == 0)
+            {
+                fill(data, i);
+                rig_fire_spectrum_event(rig, &line);
+            }
+            else
+            {
+                struct spectrum_buffer *buf = spectrum_buffer_get(rig);
+
+                if (!buf)
+                {
+                    fprintf(stderr, "spectrum pool exhausted\n");
+                    return 1;
+                }
+
+                buf->line = line;
+                buf->line.spectrum_data = buf->data;
+                fill(buf->data, i);
+                rig_fire_spectrum_buffer(rig, buf);
+                spectrum_buffer_unref(buf);
+            }
+
+            if (i % BURST == BURST - 1) { hl_usleep(2 * 1000); }
+        }
+
+        // let the publisher catch up
+        hl_usleep(500 * 1000);
+
+        main_thread = cpu_us(CLOCK_THREAD_CPUTIME_ID) - main_thread;
+        process = cpu_us(CLOCK_PROCESS_CPUTIME_ID) - process;
+
+        printf("%-7s %-7s %12.2f %12.2f %14.2f %8d\n", format, modes[m],
+               (double)(pool->copies - copies) / (pool->lines - fired),
+               main_thread / lines, (process - main_thread) / lines, pool->count);
+    }
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int lines = LINE_COUNT;
+
+    if (argc > 1) { lines = atoi(argv[1]); }
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    printf("%d lines of %d bins\n\n", lines, LINE_BINS);
+    printf("%-7s %-7s %12s %12s %14s %8s\n", "format", "line", "copies/line",
+           "fire us", "publisher us", "buffers");
+
+    return run("JSON", lines) || run("BINARY", lines);
+}
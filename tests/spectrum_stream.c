@@ -0,0 +1,525 @@
+/*
+ * spectrum_stream.c - (C) The Hamlib Group 2026
+ *
+ * Spectrum line subscriptions for the rigctld clients.
+ *
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+/*
+ * A client that asked for a stream gets every spectrum line of a scope,
+ * at most `rate' lines a second, optionally decimated to `bins' points,
+ * without asking for each one.  The rig's spectrum callback runs on the
+ * thread reading the rig, so it only takes a reference to the line and
+ * queues it for each stream; encoding and writing happen on the thread
+ * serving the client.  A stream's queue is short and drops its oldest
+ * line when full, which keeps the latency of a slow client bounded and
+ * never makes the reader wait.
+ *
+ * Frames are either HEX text lines
+ *
+ *   SPECTRUM <id> <seq> <low freq> <high freq> <length> <data in hex>
+ *
+ * where seq counts the lines accepted for the stream, so a gap tells the
+ * lines dropped, or the binary packets of the multicast publisher (see
+ * spectrum_packet.h), which carry their own length.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#ifndef __MINGW32__
+#  include <fcntl.h>
+#  include <poll.h>
+#  include <unistd.h>
+#endif
+
+#include "hamlib/rig.h"
+#include "spectrum_packet.h"
+#include "spectrum_history.h"
+#include "spectrum_stream.h"
+
+struct spectrum_stream_entry
+{
+    const struct rig_spectrum_line *line;   // held until sent or dropped
+    unsigned long seq;
+};
+
+struct spectrum_stream
+{
+    struct spectrum_stream *next;
+    RIG *rig;
+    int id;                     // scope, -1 for all of them
+    int format;
+    double interval;            // seconds between lines, 0 for no limit
+    int bins;                   // 0 for the line as received
+    double last;                // time the last line was accepted
+    struct spectrum_stream_entry queue[SPECTRUM_STREAM_QUEUE];
+    int head;
+    int count;
+    unsigned long seq;
+    unsigned long dropped;
+    int notify;                 // written when the queue stops being empty
+    int wake[2];                // own pipe when no notify fd was given
+    struct spectrum_packet_state packet;
+};
+
+static struct
+{
+    pthread_mutex_t lock;
+    struct spectrum_stream *streams;
+} registry = { PTHREAD_MUTEX_INITIALIZER, NULL };
+
+static const char *const format_names[] = { "HEX", "BINARY", NULL };
+
+
+int spectrum_stream_parse_format(const char *s)
+{
+    int i;
+
+    for (i = 0; format_names[i]; i++)
+    {
+        if (!strcmp(s, format_names[i]))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+
+const char *spectrum_stream_strformat(int format)
+{
+    if (format < 0 || format > SPECTRUM_STREAM_BINARY)
+    {
+        return "";
+    }
+
+    return format_names[format];
+}
+
+
+#ifndef __MINGW32__
+
+static double monotonic_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+
+/* Runs on the thread reading the rig: queue the line, never block */
+static int spectrum_stream_cb(RIG *rig, struct rig_spectrum_line *line,
+                              rig_ptr_t arg)
+{
+    struct spectrum_stream *s;
+    double now = 0;
+
+    (void)arg;
+
+    pthread_mutex_lock(&registry.lock);
+
+    for (s = registry.streams; s; s = s->next)
+    {
+        struct spectrum_stream_entry *e;
+
+        if (s->rig != rig || (s->id >= 0 && s->id != line->id))
+        {
+            continue;
+        }
+
+        if (s->interval > 0)
+        {
+            if (now == 0) { now = monotonic_now(); }
+
+            if (s->last != 0 && now - s->last < s->interval)
+            {
+                continue;
+            }
+
+            s->last = now;
+        }
+
+        if (rig_hold_spectrum_line(rig, line) != RIG_OK)
+        {
+            continue;
+        }
+
+        if (s->count == SPECTRUM_STREAM_QUEUE)
+        {
+            rig_release_spectrum_line(rig, s->queue[s->head].line);
+            s->head = (s->head + 1) % SPECTRUM_STREAM_QUEUE;
+            s->count--;
+            s->dropped++;
+        }
+
+        e = &s->queue[(s->head + s->count) % SPECTRUM_STREAM_QUEUE];
+        e->line = line;
+        e->seq = ++s->seq;
+
+        if (s->count++ == 0 && write(s->notify, "", 1) < 0 && errno != EAGAIN)
+        {
+            rig_debug(RIG_DEBUG_ERR, "%s: notify: %s\n", __func__, strerror(errno));
+        }
+    }
+
+    pthread_mutex_unlock(&registry.lock);
+
+    return RIG_OK;
+}
+
+
+/*
+ * Subscribes to the lines of scope `id' (-1 for all).  The stream writes
+ * a byte to `notify' when lines are waiting, or to a pipe of its own
+ * when `notify' is -1; see spectrum_stream_fd().
+ */
+struct spectrum_stream *spectrum_stream_open(RIG *rig, int id, int format,
+        double rate, int bins, int notify)
+{
+    struct spectrum_stream *s;
+
+    if (format < 0 || format > SPECTRUM_STREAM_BINARY || rate < 0
+            || bins < 0 || bins > HAMLIB_MAX_SPECTRUM_DATA)
+    {
+        return NULL;
+    }
+
+    s = calloc(1, sizeof(*s));
+
+    if (s == NULL)
+    {
+        return NULL;
+    }
+
+    s->rig = rig;
+    s->id = id;
+    s->format = format;
+    s->interval = rate > 0 ? 1 / rate : 0;
+    s->bins = bins;
+    s->wake[0] = s->wake[1] = -1;
+    s->notify = notify;
+
+    if (notify < 0)
+    {
+        if (pipe(s->wake) < 0)
+        {
+            free(s);
+            return NULL;
+        }
+
+        fcntl(s->wake[0], F_SETFL, fcntl(s->wake[0], F_GETFL, 0) | O_NONBLOCK);
+        fcntl(s->wake[1], F_SETFL, fcntl(s->wake[1], F_GETFL, 0) | O_NONBLOCK);
+        s->notify = s->wake[1];
+    }
+
+    pthread_mutex_lock(&registry.lock);
+    rig_set_spectrum_callback(rig, spectrum_stream_cb, NULL);
+    s->next = registry.streams;
+    registry.streams = s;
+    pthread_mutex_unlock(&registry.lock);
+
+    return s;
+}
+
+
+void spectrum_stream_close(struct spectrum_stream *s)
+{
+    struct spectrum_stream **p;
+
+    if (s == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&registry.lock);
+
+    for (p = &registry.streams; *p; p = &(*p)->next)
+    {
+        if (*p == s)
+        {
+            *p = s->next;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&registry.lock);
+
+    while (s->count)
+    {
+        rig_release_spectrum_line(s->rig, s->queue[s->head].line);
+        s->head = (s->head + 1) % SPECTRUM_STREAM_QUEUE;
+        s->count--;
+    }
+
+    if (s->wake[0] >= 0)
+    {
+        close(s->wake[0]);
+        close(s->wake[1]);
+    }
+
+    free(s);
+}
+
+
+int spectrum_stream_fd(const struct spectrum_stream *s)
+{
+    return s->wake[0] >= 0 ? s->wake[0] : s->notify;
+}
+
+
+static int encode_hex(const struct rig_spectrum_line *line, unsigned long seq,
+                      unsigned char *frame, size_t len)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    freq_t low, high;
+    size_t i;
+    int n;
+
+    if (line->spectrum_mode == RIG_SPECTRUM_MODE_CENTER)
+    {
+        low = line->center_freq - line->span_freq / 2;
+        high = line->center_freq + line->span_freq / 2;
+    }
+    else
+    {
+        low = line->low_edge_freq;
+        high = line->high_edge_freq;
+    }
+
+    n = snprintf((char *) frame, len, "SPECTRUM %d %lu %.0f %.0f %d ", line->id,
+                 seq, low, high, (int) line->spectrum_data_length);
+
+    if (n < 0 || n + 2 * line->spectrum_data_length + 1 > len)
+    {
+        return -RIG_ETRUNC;
+    }
+
+    for (i = 0; i < line->spectrum_data_length; i++)
+    {
+        frame[n++] = digits[line->spectrum_data[i] >> 4];
+        frame[n++] = digits[line->spectrum_data[i] & 0x0f];
+    }
+
+    frame[n++] = '\n';
+
+    return n;
+}
+
+
+/*
+ * Encodes the oldest waiting line into `frame' and lets go of it.
+ * Returns the frame length, 0 when no line is waiting.
+ */
+int spectrum_stream_next(struct spectrum_stream *s, unsigned char *frame,
+                         size_t len)
+{
+    unsigned char data[HAMLIB_MAX_SPECTRUM_DATA];
+    struct rig_spectrum_line decimated;
+    const struct rig_spectrum_line *line;
+    unsigned long seq;
+    int n;
+
+    pthread_mutex_lock(&registry.lock);
+
+    if (s->count == 0)
+    {
+        pthread_mutex_unlock(&registry.lock);
+        return 0;
+    }
+
+    line = s->queue[s->head].line;
+    seq = s->queue[s->head].seq;
+    s->head = (s->head + 1) % SPECTRUM_STREAM_QUEUE;
+    s->count--;
+    pthread_mutex_unlock(&registry.lock);
+
+    if (s->bins && (size_t) s->bins < line->spectrum_data_length)
+    {
+        decimated = *line;
+        decimated.spectrum_data = data;
+        decimated.spectrum_data_length = s->bins;
+        spectrum_kernel_decimate(data, s->bins, line->spectrum_data,
+                                 line->spectrum_data_length,
+                                 RIG_SPECTRUM_HISTORY_MAX);
+    }
+    else
+    {
+        decimated = *line;
+    }
+
+    if (s->format == SPECTRUM_STREAM_BINARY)
+    {
+        n = spectrum_packet_encode(&s->packet, &decimated, frame, len);
+    }
+    else
+    {
+        n = encode_hex(&decimated, seq, frame, len);
+    }
+
+    rig_release_spectrum_line(s->rig, line);
+
+    return n;
+}
+
+
+unsigned long spectrum_stream_dropped(const struct spectrum_stream *s)
+{
+    unsigned long dropped;
+
+    pthread_mutex_lock(&registry.lock);
+    dropped = s->dropped;
+    pthread_mutex_unlock(&registry.lock);
+
+    return dropped;
+}
+
+
+/*
+ * Whether the client sent something poll() cannot see: a line that came
+ * with the command that started the stream sits in the stdio buffer.
+ * With the descriptor non-blocking for the moment, getc() returns what
+ * is buffered or already arrived and never waits.
+ */
+static int input_pending(FILE *fin)
+{
+    int flags = fcntl(fileno(fin), F_GETFL);
+    int c;
+
+    if (flags < 0 || fcntl(fileno(fin), F_SETFL, flags | O_NONBLOCK) < 0)
+    {
+        return 0;
+    }
+
+    c = getc(fin);
+
+    if (c == EOF)
+    {
+        clearerr(fin);
+    }
+    else
+    {
+        ungetc(c, fin);
+    }
+
+    fcntl(fileno(fin), F_SETFL, flags);
+
+    return c != EOF;
+}
+
+/*
+ * Writes the lines of a stream with its own pipe to a blocking client
+ * connection until the client sends something.  Returns 0 then, 1 after
+ * a second without lines so the caller can check for shutdown, and -1
+ * when the connection failed.  The input is left unread.
+ */
+int spectrum_stream_serve(struct spectrum_stream *s, FILE *fin, FILE *fout)
+{
+    unsigned char frame[SPECTRUM_STREAM_FRAME_MAX];
+    struct pollfd fds[2];
+    char drain[64];
+    int n;
+
+    if (fflush(fout) != 0)
+    {
+        return -1;
+    }
+
+    if (input_pending(fin))
+    {
+        return 0;
+    }
+
+    for (;;)
+    {
+        fds[0].fd = spectrum_stream_fd(s);
+        fds[0].events = POLLIN;
+        fds[1].fd = fileno(fin);
+        fds[1].events = POLLIN;
+
+        n = poll(fds, 2, 1000);
+
+        if (n < 0)
+        {
+            if (errno == EINTR) { continue; }
+
+            return -1;
+        }
+
+        if (n == 0)
+        {
+            return 1;
+        }
+
+        if (fds[1].revents)
+        {
+            return 0;
+        }
+
+        while (read(fds[0].fd, drain, sizeof(drain)) > 0) { }
+
+        while ((n = spectrum_stream_next(s, frame, sizeof(frame))) > 0)
+        {
+            if (fwrite(frame, 1, n, fout) != (size_t) n)
+            {
+                return -1;
+            }
+        }
+
+        if (fflush(fout) != 0)
+        {
+            return -1;
+        }
+    }
+}
+
+#else /* __MINGW32__ */
+
+struct spectrum_stream *spectrum_stream_open(RIG *rig, int id, int format,
+        double rate, int bins, int notify)
+{
+    return NULL;
+}
+
+void spectrum_stream_close(struct spectrum_stream *s) { }
+
+int spectrum_stream_fd(const struct spectrum_stream *s) { return -1; }
+
+int spectrum_stream_next(struct spectrum_stream *s, unsigned char *frame,
+                         size_t len)
+{
+    return 0;
+}
+
+unsigned long spectrum_stream_dropped(const struct spectrum_stream *s)
+{
+    return 0;
+}
+
+int spectrum_stream_serve(struct spectrum_stream *s, FILE *fin, FILE *fout)
+{
+    return -1;
+}
+
+#endif /* __MINGW32__ */
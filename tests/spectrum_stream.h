@@ -0,0 +1,59 @@
+/*
+ * spectrum_stream.h - (C) The Hamlib Group 2026
+ *
+ * Spectrum line subscriptions for the rigctld clients.
+ *
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License along
+ *   with this program; if not, write to the Free Software Foundation, Inc.,
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef SPECTRUM_STREAM_H
+#define SPECTRUM_STREAM_H
+
+#include <stdio.h>
+#include "hamlib/rig.h"
+
+/*
+ * Lines waiting for one client.  When the client does not keep up the
+ * oldest waiting line is dropped for the new one, so a slow connection
+ * costs neither the other clients nor the rig's reader any time.
+ */
+#define SPECTRUM_STREAM_QUEUE 4
+
+/* Largest frame: a HEX line, which is longer than a binary packet */
+#define SPECTRUM_STREAM_FRAME_MAX (2 * HAMLIB_MAX_SPECTRUM_DATA + 128)
+
+enum spectrum_stream_format_e
+{
+    SPECTRUM_STREAM_HEX,
+    SPECTRUM_STREAM_BINARY,
+};
+
+struct spectrum_stream;
+
+int spectrum_stream_parse_format(const char *s);
+const char *spectrum_stream_strformat(int format);
+
+struct spectrum_stream *spectrum_stream_open(RIG *rig, int id, int format,
+        double rate, int bins, int notify);
+void spectrum_stream_close(struct spectrum_stream *s);
+int spectrum_stream_fd(const struct spectrum_stream *s);
+int spectrum_stream_next(struct spectrum_stream *s, unsigned char *frame,
+                         size_t len);
+unsigned long spectrum_stream_dropped(const struct spectrum_stream *s);
+int spectrum_stream_serve(struct spectrum_stream *s, FILE *fin, FILE *fout);
+
+#endif /* SPECTRUM_STREAM_H */
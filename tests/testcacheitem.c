@@ -0,0 +1,127 @@
+/*
+ * Test the level/func/RIT item cache: hits within the timeout, misses
+ * when disabled, expired or for another VFO, and invalidation by setters.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+
+#include "sleep.h"
+#include "testcheck.h"
+
+/* Change the rig behind the frontend's back */
+static void backend_set_level(RIG *rig, setting_t level, int i)
+{
+    value_t val;
+
+    val.i = i;
+    rig->caps->set_level(rig, RIG_VFO_CURR, level, val);
+}
+
+int main(void)
+{
+    RIG *rig;
+    value_t val;
+    shortfreq_t rit;
+    int status;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig || rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "cannot open dummy rig\n");
+        return 1;
+    }
+
+    rig_set_vfo(rig, RIG_VFO_A);
+
+    CHECK(rig_get_cache_timeout_ms(rig, HAMLIB_CACHE_LEVEL) == 0,
+          "item cache is off by default");
+
+    /* off: every get reaches the backend */
+    backend_set_level(rig, RIG_LEVEL_AGC, 1);
+    rig_get_level(rig, RIG_VFO_CURR, RIG_LEVEL_AGC, &val);
+    backend_set_level(rig, RIG_LEVEL_AGC, 2);
+    rig_get_level(rig, RIG_VFO_CURR, RIG_LEVEL_AGC, &val);
+    CHECK(val.i == 2, "uncached level read");
+
+    /* on: the second get is served from the cache */
+    rig_set_cache_timeout_ms(rig, HAMLIB_CACHE_LEVEL, 200);
+    CHECK(rig_get_cache_timeout_ms(rig, HAMLIB_CACHE_LEVEL) == 200,
+          "level timeout readback");
+    CHECK(rig_get_cache_timeout_ms(rig, HAMLIB_CACHE_FUNC) == 0,
+          "func timeout is separate");
+    rig_get_level(rig, RIG_VFO_CURR, RIG_LEVEL_AGC, &val);
+    backend_set_level(rig, RIG_LEVEL_AGC, 3);
+    rig_get_level(rig, RIG_VFO_CURR, RIG_LEVEL_AGC, &val);
+    CHECK(val.i == 2, "cached level hit");
+
+    /* another VFO is a different entry */
+    rig_set_vfo(rig, RIG_VFO_B);
+    backend_set_level(rig, RIG_LEVEL_AGC, 7);
+    rig_get_level(rig, RIG_VFO_CURR, RIG_LEVEL_AGC, &val);
+    CHECK(val.i == 7, "cached level miss after VFO change");
+    rig_set_vfo(rig, RIG_VFO_A);
+
+    /* expiry */
+    rig_get_level(rig, RIG_VFO_CURR, RIG_LEVEL_AGC, &val);
+    backend_set_level(rig, RIG_LEVEL_AGC, 4);
+    hl_usleep(250 * 1000);
+    rig_get_level(rig, RIG_VFO_CURR, RIG_LEVEL_AGC, &val);
+    CHECK(val.i == 4, "cached level expires");
+
+    /* the frontend setter invalidates */
+    val.i = 5;
+    rig_set_level(rig, RIG_VFO_CURR, RIG_LEVEL_AGC, val);
+    rig_get_level(rig, RIG_VFO_CURR, RIG_LEVEL_AGC, &val);
+    CHECK(val.i == 5, "set_level invalidates");
+
+    /* funcs; rig_set_func() may run an external tuner script, so go
+     * through the backend */
+    rig_set_cache_timeout_ms(rig, HAMLIB_CACHE_FUNC, HAMLIB_CACHE_ALWAYS);
+    rig->caps->set_func(rig, RIG_VFO_CURR, RIG_FUNC_NB, 1);
+    rig_get_func(rig, RIG_VFO_CURR, RIG_FUNC_NB, &status);
+    rig->caps->set_func(rig, RIG_VFO_CURR, RIG_FUNC_NB, 0);
+    rig_get_func(rig, RIG_VFO_CURR, RIG_FUNC_NB, &status);
+    CHECK(status == 1, "cached func hit");
+    rig_set_cache_timeout_ms(rig, HAMLIB_CACHE_FUNC, 0);
+    rig_get_func(rig, RIG_VFO_CURR, RIG_FUNC_NB, &status);
+    CHECK(status == 0, "func cache disabled");
+
+    /* RIT */
+    rig_set_cache_timeout_ms(rig, HAMLIB_CACHE_RIT, 1000);
+    rig_set_rit(rig, RIG_VFO_CURR, 100);
+    rig_get_rit(rig, RIG_VFO_CURR, &rit);
+    rig->caps->set_rit(rig, RIG_VFO_CURR, 200);
+    rig_get_rit(rig, RIG_VFO_CURR, &rit);
+    CHECK(rit == 100, "cached RIT hit");
+    rig_set_rit(rig, RIG_VFO_CURR, 300);
+    rig_get_rit(rig, RIG_VFO_CURR, &rit);
+    CHECK(rit == 300, "set_rit invalidates");
+
+    /* HAMLIB_CACHE_ALL leaves the item timeouts alone */
+    rig_set_cache_timeout_ms(rig, HAMLIB_CACHE_ALL, 0);
+    CHECK(rig_get_cache_timeout_ms(rig, HAMLIB_CACHE_RIT) == 1000,
+          "HAMLIB_CACHE_ALL does not touch item timeouts");
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    if (failures)
+    {
+        fprintf(stderr, "%d item cache checks failed\n", failures);
+        return 1;
+    }
+
+    printf("item cache OK\n");
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*
+ * Test cache change notification: rig_cache_wait() sleeps until the
+ * cache is written to, or times out, and wakes up promptly.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+
+#include "cache.h"
+#include "sleep.h"
+#include "testcheck.h"
+
+#define WRITE_COUNT 200
+#define IDLE_MS 100
+#define BASE_FREQ 14074000
+
+struct waiter
+{
+    RIG *rig;
+    unsigned int gen;       // read before the first write
+    int64_t written;        // when the main thread wrote
+    int seen;               // last write the waiter has seen
+    int64_t latency_max;
+    int64_t latency_total;
+    int wakeups;
+    int timeouts;
+};
+
+/* Wakes up for each write, the main thread waits for it to be seen */
+static void *wait_for_writes(void *arg)
+{
+    struct waiter *w = arg;
+    struct rig_cache snap;
+
+    while (__atomic_load_n(&w->seen, __ATOMIC_ACQUIRE) < WRITE_COUNT)
+    {
+        int64_t latency;
+
+        if (!rig_cache_wait(w->rig, &w->gen, 5000))
+        {
+            w->timeouts++;
+            break;
+        }
+
+        latency = rig_cache_now_ns() - __atomic_load_n(&w->written,
+                  __ATOMIC_ACQUIRE);
+        w->wakeups++;
+
+        rig_cache_snapshot(w->rig, &snap);
+
+        if ((int)(snap.slot[CACHE_SLOT_MAIN_A].freq - BASE_FREQ) == w->seen + 1)
+        {
+            w->latency_total += latency;
+
+            if (latency > w->latency_max) { w->latency_max = latency; }
+
+            __atomic_store_n(&w->seen, w->seen + 1, __ATOMIC_RELEASE);
+        }
+    }
+
+    return NULL;
+}
+
+static void *wait_forever(void *arg)
+{
+    RIG *rig = arg;
+    unsigned int gen = rig_cache_generation(rig);
+
+    return (void *)(intptr_t) rig_cache_wait(rig, &gen, -1);
+}
+
+int main(void)
+{
+    struct waiter w = { 0 };
+    pthread_t thread;
+    unsigned int gen;
+    int64_t t;
+    void *result;
+    int i;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    w.rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!w.rig)
+    {
+        fprintf(stderr, "cannot init dummy rig\n");
+        return 1;
+    }
+
+    /* idle: sleeps for the whole timeout */
+    gen = rig_cache_generation(w.rig);
+    t = rig_cache_now_ns();
+    CHECK(rig_cache_wait(w.rig, &gen, IDLE_MS) == 0, "idle wait times out");
+    t = (rig_cache_now_ns() - t) / 1000000;
+    CHECK(t >= IDLE_MS - 1, "idle wait sleeps");
+
+    /* a write since the generation was read returns at once */
+    rig_set_cache_freq(w.rig, RIG_VFO_A, BASE_FREQ);
+    t = rig_cache_now_ns();
+    CHECK(rig_cache_wait(w.rig, &gen, 1000) == 1, "missed write seen");
+    CHECK(rig_cache_now_ns() - t < 1000000, "without sleeping");
+
+    /* every write wakes a waiter */
+    w.gen = rig_cache_generation(w.rig);
+    pthread_create(&thread, NULL, wait_for_writes, &w);
+
+    for (i = 1; i <= WRITE_COUNT && !w.timeouts; i++)
+    {
+        // let the waiter go back to sleep
+        hl_usleep(200);
+        __atomic_store_n(&w.written, rig_cache_now_ns(), __ATOMIC_RELEASE);
+        rig_set_cache_freq(w.rig, RIG_VFO_A, BASE_FREQ + i);
+
+        while (__atomic_load_n(&w.seen, __ATOMIC_ACQUIRE) < i && !w.timeouts)
+        {
+            hl_usleep(50);
+        }
+    }
+
+    pthread_join(thread, NULL);
+
+    printf("%d writes, %d wakeups, latency avg %.0f us max %.0f us\n",
+           w.seen, w.wakeups,
+           w.seen ? w.latency_total / 1e3 / w.seen : 0.0,
+           w.latency_max / 1e3);
+
+    CHECK(w.seen == WRITE_COUNT && !w.timeouts, "every write wakes the waiter");
+    CHECK(w.latency_max < 100 * 1000000LL, "woken promptly");
+
+    /* rig_cache_wake() ends a wait without a limit */
+    pthread_create(&thread, NULL, wait_forever, w.rig);
+    hl_usleep(10 * 1000);
+    rig_cache_wake(w.rig);
+    pthread_join(thread, &result);
+    CHECK(result == (void *) 1, "rig_cache_wake wakes");
+
+    rig_cleanup(w.rig);
+
+    if (failures)
+    {
+        fprintf(stderr, "%d cache notify checks failed\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * Test that rig cache readers never see a half-published update.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+
+#include "cache.h"
+
+#define READER_COUNT 3
+#define WRITE_COUNT 200000
+
+static volatile int writer_done;
+
+struct reader_context
+{
+    RIG *rig;
+    long snapshots;
+    long torn;
+};
+
+/*
+ * split ON always goes with VFO B and OFF with VFO A; USB always has a
+ * 2400 Hz width and LSB 1800 Hz, and VFO A is current so the CURR slot
+ * must track MAIN_A.
+ */
+static void *writer(void *arg)
+{
+    RIG *rig = arg;
+    int i;
+
+    for (i = 0; i < WRITE_COUNT; ++i)
+    {
+        if (i & 1)
+        {
+            rig_set_cache_split(rig, RIG_SPLIT_ON, RIG_VFO_B);
+            rig_set_cache_mode(rig, RIG_VFO_A, RIG_MODE_USB, 2400);
+        }
+        else
+        {
+            rig_set_cache_split(rig, RIG_SPLIT_OFF, RIG_VFO_A);
+            rig_set_cache_mode(rig, RIG_VFO_A, RIG_MODE_LSB, 1800);
+        }
+
+        rig_set_cache_freq(rig, RIG_VFO_A, 14000000 + (i & 0xffff));
+    }
+
+    __atomic_store_n(&writer_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void *reader(void *arg)
+{
+    struct reader_context *ctx = arg;
+    struct rig_cache snap;
+    const struct rig_cache_vfo *curr = &snap.slot[CACHE_SLOT_CURR];
+    const struct rig_cache_vfo *main_a = &snap.slot[CACHE_SLOT_MAIN_A];
+
+    while (!__atomic_load_n(&writer_done, __ATOMIC_ACQUIRE))
+    {
+        rig_cache_snapshot(ctx->rig, &snap);
+
+        if ((snap.split == RIG_SPLIT_ON) != (snap.split_vfo == RIG_VFO_B))
+        {
+            ctx->torn++;
+        }
+
+        if (curr->mode != main_a->mode
+                || main_a->width != (main_a->mode == RIG_MODE_USB ? 2400 : 1800))
+        {
+            ctx->torn++;
+        }
+
+        ctx->snapshots++;
+    }
+
+    return NULL;
+}
+
+int main(void)
+{
+    RIG *rig;
+    pthread_t writer_thread;
+    pthread_t reader_threads[READER_COUNT];
+    struct reader_context ctx[READER_COUNT];
+    long snapshots = 0;
+    long torn = 0;
+    unsigned int seq;
+    int i;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig || rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "cannot open dummy rig\n");
+        return 1;
+    }
+
+    rig_set_vfo(rig, RIG_VFO_A);
+    rig_set_cache_split(rig, RIG_SPLIT_OFF, RIG_VFO_A);
+    rig_set_cache_mode(rig, RIG_VFO_A, RIG_MODE_LSB, 1800);
+
+    for (i = 0; i < READER_COUNT; ++i)
+    {
+        ctx[i].rig = rig;
+        ctx[i].snapshots = 0;
+        ctx[i].torn = 0;
+        pthread_create(&reader_threads[i], NULL, reader, &ctx[i]);
+    }
+
+    pthread_create(&writer_thread, NULL, writer, rig);
+    pthread_join(writer_thread, NULL);
+
+    for (i = 0; i < READER_COUNT; ++i)
+    {
+        pthread_join(reader_threads[i], NULL);
+        snapshots += ctx[i].snapshots;
+        torn += ctx[i].torn;
+    }
+
+    seq = CACHE(rig)->seq;
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    printf("%ld snapshots, %ld torn\n", snapshots, torn);
+
+    if (torn != 0)
+    {
+        fprintf(stderr, "readers saw fields from different updates\n");
+        return 1;
+    }
+
+    if (seq & 1)
+    {
+        fprintf(stderr, "cache sequence left odd (%u) after the writer finished\n",
+                seq);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+/*
+ * Hamlib test helper: count failed checks and carry on, so one run
+ * reports every broken case.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef _TESTCHECK_H
+#define _TESTCHECK_H 1
+
+#include <stdio.h>
+
+static int failures;
+
+#define CHECK(cond, what) \
+    do { \
+        if (!(cond)) \
+        { \
+            fprintf(stderr, "FAIL line %d: %s\n", __LINE__, what); \
+            failures++; \
+        } \
+    } while (0)
+
+#endif /* _TESTCHECK_H */
@@ -88,6 +88,7 @@ static int test_concurrent_history(void)
     struct worker_context contexts[THREAD_COUNT];
     pthread_t threads[THREAD_COUNT];
     size_t expected_length = 0;
+    const char *history;
     unsigned int thread;
 
     rig_debug_clear();
@@ -122,6 +123,8 @@ static int test_concurrent_history(void)
     pthread_cond_destroy(&gate.condition);
     pthread_mutex_destroy(&gate.mutex);
 
+    history = rig_get_debug_history();
+
     for (thread = 0; thread < THREAD_COUNT; ++thread)
     {
         char expected[MESSAGE_SIZE];
@@ -131,7 +134,7 @@ static int test_concurrent_history(void)
             return 0;
         }
         expected_length += strlen(expected);
-        if (strstr(debugmsgsave, expected) == NULL)
+        if (strstr(history, expected) == NULL)
         {
             fprintf(stderr,
                     "history does not contain an intact message "
@@ -141,10 +144,10 @@ static int test_concurrent_history(void)
         }
     }
 
-    if (strlen(debugmsgsave) != expected_length)
+    if (strlen(history) != expected_length)
     {
         fprintf(stderr, "history retained %zu bytes; expected %zu\n",
-                strlen(debugmsgsave), expected_length);
+                strlen(history), expected_length);
         return 0;
     }
 
@@ -168,7 +171,7 @@ static int test_rolling_history(void)
     rig_set_debug_callback(NULL, NULL);
     rig_set_debug(RIG_DEBUG_NONE);
 
-    history = debugmsgsave;
+    history = rig_get_debug_history();
     for (line = HISTORY_LINE_COUNT - RETAINED_LINE_COUNT;
             line < HISTORY_LINE_COUNT; ++line)
     {
@@ -195,9 +198,102 @@ static int test_rolling_history(void)
     return 1;
 }
 
+static int test_deferred_formatting(void)
+{
+    char buffer[32];
+    char expected[256];
+    const char *history;
+
+    rig_debug_clear();
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    /* the history must not depend on the argument storage after the call */
+    snprintf(buffer, sizeof(buffer), "%s", "transient");
+    rig_debug(RIG_DEBUG_TRACE, "[%-10s|%*d|%.*s|%lu|%.3f|%c|%zu|100%%]\n",
+              buffer, 5, 42, 3, "abcdef", 1234567UL, 3.14159, 'x',
+              (size_t)7);
+    memset(buffer, 'X', sizeof(buffer) - 1);
+
+    snprintf(expected, sizeof(expected), "[%-10s|%*d|%.*s|%lu|%.3f|%c|%zu|100%%]\n",
+             "transient", 5, 42, 3, "abcdef", 1234567UL, 3.14159, 'x',
+             (size_t)7);
+
+    history = rig_get_debug_history();
+
+    if (strcmp(history, expected) != 0)
+    {
+        fprintf(stderr, "deferred history '%s' does not match '%s'\n",
+                history, expected);
+        return 0;
+    }
+
+    return 1;
+}
+
+static int test_format_copy(void)
+{
+    char *fmt = strdup("[%s %d]\n");
+    const char *history;
+
+    if (fmt == NULL)
+    {
+        return 0;
+    }
+
+    rig_debug_clear();
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    /* a format built at run time, e.g. by a language binding */
+    rig_debug(RIG_DEBUG_TRACE, fmt, "heap", 7);
+    memset(fmt, 'X', strlen(fmt));
+    free(fmt);
+
+    history = rig_get_debug_history();
+
+    if (strcmp(history, "[heap 7]\n") != 0)
+    {
+        fprintf(stderr, "history '%s' depends on the format storage\n", history);
+        return 0;
+    }
+
+    /* nothing is recorded above the history level */
+    rig_debug_clear();
+    rig_set_debug_history_level(RIG_DEBUG_WARN);
+    rig_debug(RIG_DEBUG_TRACE, "trace %s\n", "dropped");
+    rig_debug(RIG_DEBUG_ERR, "err %s\n", "kept");
+    rig_set_debug_history_level(RIG_DEBUG_NONE);
+    rig_debug(RIG_DEBUG_BUG, "bug %s\n", "dropped");
+    rig_set_debug_history_level(RIG_DEBUG_CACHE);
+
+    history = rig_get_debug_history();
+
+    if (strcmp(history, "err kept\n") != 0)
+    {
+        fprintf(stderr, "history level not applied: '%s'\n", history);
+        return 0;
+    }
+
+    /* history off: nothing formatted, rigerror() still names the error */
+    rig_set_debug_history_level(RIG_DEBUG_NONE);
+    history = rig_get_debug_history();
+
+    if (*history != '\0' || strcmp(rigerror(-RIG_EIO), "IO error\n") != 0)
+    {
+        fprintf(stderr, "history off: '%s', rigerror '%s'\n", history,
+                rigerror(-RIG_EIO));
+        rig_set_debug_history_level(RIG_DEBUG_CACHE);
+        return 0;
+    }
+
+    rig_set_debug_history_level(RIG_DEBUG_CACHE);
+
+    return 1;
+}
+
 int main(void)
 {
-    if (!test_concurrent_history() || !test_rolling_history())
+    if (!test_concurrent_history() || !test_rolling_history()
+            || !test_deferred_formatting() || !test_format_copy())
     {
         return EXIT_FAILURE;
     }
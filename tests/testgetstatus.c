@@ -0,0 +1,113 @@
+/*
+ * Test rig_get_status() against the dummy rig: without a get_status hook
+ * every field comes from the generic getters, with one the hook's fields
+ * are used and cached and only the missing ones are read, and a failing
+ * hook falls back to the getters.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+
+#include "testcheck.h"
+
+#define ALL_VALID (RIG_VFO_STATUS_FREQ | RIG_VFO_STATUS_MODE \
+                   | RIG_VFO_STATUS_WIDTH | RIG_VFO_STATUS_PTT \
+                   | RIG_VFO_STATUS_SPLIT)
+
+static int hook_calls;
+static int hook_retval;
+
+/* An IF-style reply: freq and mode, no width, PTT or split */
+static int status_hook(RIG *rig, vfo_t vfo, struct rig_vfo_status *status)
+{
+    (void)rig;
+    (void)vfo;
+
+    hook_calls++;
+
+    if (hook_retval != RIG_OK) { return hook_retval; }
+
+    status->freq = 7074000;
+    status->mode = RIG_MODE_PKTUSB;
+    status->valid = RIG_VFO_STATUS_FREQ | RIG_VFO_STATUS_MODE;
+    return RIG_OK;
+}
+
+int main(void)
+{
+    static struct rig_caps caps;
+    struct rig_vfo_status status;
+    freq_t freq;
+    RIG *rig;
+    int ms;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig || rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "cannot open the dummy rig\n");
+        return 1;
+    }
+
+    CHECK(rig_set_vfo(rig, RIG_VFO_A) == RIG_OK
+          && rig_set_freq(rig, RIG_VFO_A, 14074000) == RIG_OK
+          && rig_set_mode(rig, RIG_VFO_A, RIG_MODE_USB, 2400) == RIG_OK
+          && rig_set_split_vfo(rig, RIG_VFO_A, RIG_SPLIT_ON, RIG_VFO_B) == RIG_OK
+          && rig_set_ptt(rig, RIG_VFO_A, RIG_PTT_ON) == RIG_OK,
+          "dummy set up");
+
+    /* the dummy has no hook: the generic getters answer */
+    CHECK(rig_get_status(rig, RIG_VFO_CURR, &status) == RIG_OK, "fallback");
+    CHECK(status.vfo == RIG_VFO_A, "current VFO resolved");
+    CHECK(status.valid == ALL_VALID, "fallback fills every field");
+    CHECK(status.freq == 14074000 && status.mode == RIG_MODE_USB
+          && status.width == 2400, "fallback freq and mode");
+    CHECK(status.ptt == RIG_PTT_ON, "fallback PTT");
+    CHECK(status.split == RIG_SPLIT_ON && status.tx_vfo == RIG_VFO_B,
+          "fallback split");
+
+    CHECK(rig_get_status(rig, RIG_VFO_A, NULL) == -RIG_EINVAL, "NULL status");
+
+    /* a backend that reads freq and mode in one reply */
+    caps = *rig->caps;
+    caps.get_status = status_hook;
+    rig->caps = &caps;
+
+    CHECK(rig_get_status(rig, RIG_VFO_A, &status) == RIG_OK, "hook");
+    CHECK(hook_calls == 1, "hook called");
+    CHECK(status.valid == (ALL_VALID & ~RIG_VFO_STATUS_WIDTH),
+          "hook and getters fill every field but the width");
+    CHECK(status.freq == 7074000 && status.mode == RIG_MODE_PKTUSB, "hook fields");
+    CHECK(status.width == rig_passband_normal(rig, RIG_MODE_PKTUSB),
+          "width of a new mode is the normal passband");
+    CHECK(status.ptt == RIG_PTT_ON && status.split == RIG_SPLIT_ON,
+          "missing fields from the getters");
+    CHECK(rig_get_cache_freq(rig, RIG_VFO_A, &freq, &ms) == RIG_OK
+          && freq == 7074000, "hook reply cached");
+
+    /* a failed status read is not fatal */
+    hook_retval = -RIG_EIO;
+    CHECK(rig_get_status(rig, RIG_VFO_A, &status) == RIG_OK, "failing hook");
+    CHECK(hook_calls == 2 && status.valid == ALL_VALID, "getters after a failure");
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    if (failures)
+    {
+        fprintf(stderr, "%d get_status checks failed\n", failures);
+        return 1;
+    }
+
+    printf("get_status OK\n");
+    return 0;
+}
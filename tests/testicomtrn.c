@@ -0,0 +1,212 @@
+/*
+ * Test the Icom transceive-authoritative cache: after a CI-V transceive
+ * frame for the VFO we selected, icom_get_freq() answers from the cache
+ * until transceive_reconcile_ms has passed, other VFOs still go to the
+ * rig, and the civ_stats counters add up.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+#include <hamlib/port.h>
+#include <hamlib/rig_state.h>
+
+#include "icom.h"
+#include "icom_defs.h"
+#include "testcheck.h"
+
+#define RIGADDR 0x94    // IC-7300
+
+struct peer
+{
+    int fd;
+    int gets;           // frequency reads that reached the rig
+};
+
+/* Answers a read of the frequency with 7.1 MHz, anything else with OK */
+static void *run_peer(void *arg)
+{
+    static const unsigned char ack[] =
+    {
+        0xfe, 0xfe, CTRLID, RIGADDR, ACK, 0xfd
+    };
+    struct peer *p = arg;
+    unsigned char in[64];
+    ssize_t n;
+
+    while ((n = read(p->fd, in, sizeof(in))) > 0)
+    {
+        ssize_t i;
+
+        for (i = 0; i + 5 < n; i++)
+        {
+            unsigned char freq[12] = { 0xfe, 0xfe, CTRLID, RIGADDR };
+            int len = 4;
+
+            if (in[i] != 0xfe || in[i + 1] != 0xfe) { continue; }
+
+            /* 03 reads the current VFO, 25 00/01 the selected/unselected */
+            if (in[i + 4] == C_RD_FREQ || in[i + 4] == C_SEND_SEL_FREQ)
+            {
+                freq[len++] = in[i + 4];
+
+                if (in[i + 4] == C_SEND_SEL_FREQ) { freq[len++] = in[i + 5]; }
+
+                memcpy(freq + len, "\x00\x00\x10\x07\x00\xfd", 6);
+                len += 6;
+                p->gets++;
+
+                if (write(p->fd, freq, len) < 0) { return NULL; }
+            }
+            else if (write(p->fd, ack, sizeof(ack)) < 0) { return NULL; }
+
+            i += 4;
+        }
+    }
+
+    return NULL;
+}
+
+/* The rig tuned to freq Hz and told everybody */
+static void transceive_freq(RIG *rig, unsigned long freq)
+{
+    unsigned char frame[] =
+    {
+        0xfe, 0xfe, BCASTID, RIGADDR, C_SND_FREQ, 0, 0, 0, 0, 0, 0xfd
+    };
+    int i;
+
+    for (i = 0; i < 5; i++, freq /= 100)
+    {
+        frame[5 + i] = (freq % 10) | ((freq / 10 % 10) << 4);
+    }
+
+    icom_process_async_frame(rig, sizeof(frame), frame);
+}
+
+static unsigned long civ_stat(RIG *rig, const char *name)
+{
+    char buf[256];
+    unsigned long val = 0;
+    const char *p;
+
+    if (rig_get_conf2(rig, rig_token_lookup(rig, "civ_stats"), buf,
+                      sizeof(buf)) != RIG_OK)
+    {
+        return (unsigned long) -1;
+    }
+
+    p = strstr(buf, name);
+
+    if (p) { sscanf(p + strlen(name), "=%lu", &val); }
+
+    return val;
+}
+
+int main(void)
+{
+    static struct peer peer;
+    struct icom_priv_data *priv;
+    int sockets[2];
+    pthread_t thread;
+    freq_t freq;
+    RIG *rig;
+    int gets;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+    {
+        perror("socketpair");
+        return 1;
+    }
+
+    peer.fd = sockets[1];
+
+    if (pthread_create(&thread, NULL, run_peer, &peer) != 0)
+    {
+        return 1;
+    }
+
+    rig = rig_init(RIG_MODEL_IC7300);
+
+    if (!rig)
+    {
+        fprintf(stderr, "cannot init IC-7300\n");
+        return 1;
+    }
+
+    RIGPORT(rig)->fd = sockets[0];
+    RIGPORT(rig)->timeout = 500;
+    RIGPORT(rig)->retry = 0;
+    RIGPORT(rig)->post_write_delay = 0;
+    STATE(rig)->comm_state = 1;
+    STATE(rig)->async_data_enabled = 1;
+    STATE(rig)->current_vfo = RIG_VFO_A;
+
+    /* what icom_set_vfo() leaves behind when it selects VFO A */
+    priv = STATE(rig)->priv;
+    priv->serial_USB_echo_off = 1;
+    priv->transceive_vfo = RIG_VFO_A;
+    priv->transceive_reconcile_ms = 60000;
+
+    /* nothing pushed yet, the rig is asked */
+    CHECK(icom_get_freq(rig, RIG_VFO_A, &freq) == RIG_OK && freq == 7100000,
+          "first get polled");
+    CHECK(peer.gets == 1, "poll reached the rig");
+
+    /* pushed: the first get reconciles, the next ones use the cache */
+    transceive_freq(rig, 14074000);
+    CHECK(civ_stat(rig, "async") == 1, "transceive frame counted");
+    CHECK(icom_get_freq(rig, RIG_VFO_A, &freq) == RIG_OK, "reconciling get");
+    CHECK(peer.gets == 2, "reconcile poll reached the rig");
+    CHECK(civ_stat(rig, "polls") == 1, "reconcile poll counted");
+
+    transceive_freq(rig, 14075000);
+    gets = peer.gets;
+    CHECK(icom_get_freq(rig, RIG_VFO_A, &freq) == RIG_OK && freq == 14075000,
+          "transceive freq answers");
+    CHECK(icom_get_freq(rig, RIG_VFO_CURR, &freq) == RIG_OK && freq == 14075000,
+          "current VFO answers too");
+    CHECK(peer.gets == gets, "cache hits stay off the bus");
+    CHECK(civ_stat(rig, "hits") == 2, "hits counted");
+
+    /* frames follow the selected VFO, they say nothing about B */
+    CHECK(icom_get_freq(rig, RIG_VFO_B, &freq) == RIG_OK && peer.gets == gets + 1,
+          "other VFO polled");
+
+    /* 0 turns it off */
+    priv->transceive_reconcile_ms = 0;
+    CHECK(icom_get_freq(rig, RIG_VFO_A, &freq) == RIG_OK && peer.gets == gets + 2,
+          "always polled when off");
+
+    CHECK(civ_stat(rig, "hits") == 2 && civ_stat(rig, "misses") == 4,
+          "hits and misses");
+    CHECK(civ_stat(rig, "tx") == (unsigned long) peer.gets, "frames sent");
+
+    STATE(rig)->comm_state = 0;
+    RIGPORT(rig)->fd = -1;
+    rig_cleanup(rig);
+
+    close(sockets[0]);
+    pthread_join(thread, NULL);
+    close(sockets[1]);
+
+    if (failures)
+    {
+        fprintf(stderr, "%d transceive cache checks failed\n", failures);
+        return 1;
+    }
+
+    printf("transceive cache OK\n");
+    return 0;
+}
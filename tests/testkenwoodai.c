@@ -0,0 +1,172 @@
+/*
+ * Test the Kenwood AI mode demultiplexer: frames the rig pushes are told
+ * apart from the reply a transaction waits for, the reply is left for the
+ * transaction and the pushed FA/FB/IF/MD/TX/RX frames update the cache,
+ * and only a rig going to AI talks to the port itself on open and close.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+#include <hamlib/port.h>
+#include <hamlib/rig_state.h>
+
+#include "cache.h"
+#include "kenwood.h"
+#include "testcheck.h"
+
+/* IF: freq at 2, PTT at 28, mode at 29, VFO at 30 */
+#define IF_FRAME(freq, ptt, mode, vfo) \
+    "IF" freq "000000000000000" ptt mode vfo "000000;"
+
+#define WAIT_FOR(a, b) (((a) << 8) | (b))
+
+static char routed[256];
+
+/* Splits what the rig sent like the async reader does */
+static void feed(RIG *rig, const char *stream)
+{
+    const char *frame = stream;
+    const char *end;
+
+    routed[0] = '\0';
+
+    while ((end = strchr(frame, ';')) != NULL)
+    {
+        size_t len = end - frame + 1;
+
+        if (rig->caps->is_async_frame(rig, len, (const unsigned char *) frame))
+        {
+            rig->caps->process_async_frame(rig, len, (const unsigned char *) frame);
+        }
+        else
+        {
+            strncat(routed, frame, len);
+        }
+
+        frame = end + 1;
+    }
+}
+
+static freq_t cached_freq(RIG *rig, vfo_t vfo)
+{
+    freq_t freq = 0;
+    int ms;
+
+    rig_get_cache_freq(rig, vfo, &freq, &ms);
+    return freq;
+}
+
+static rmode_t cached_mode(RIG *rig, vfo_t vfo)
+{
+    freq_t freq;
+    rmode_t mode = RIG_MODE_NONE;
+    pbwidth_t width;
+    int ms_freq, ms_mode, ms_width;
+
+    rig_get_cache(rig, vfo, &freq, &ms_freq, &mode, &ms_mode, &width, &ms_width);
+    return mode;
+}
+
+int main(void)
+{
+    struct kenwood_priv_data *priv;
+    RIG *rig;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_TS890S);
+
+    if (!rig)
+    {
+        fprintf(stderr, "cannot init TS-890S\n");
+        return 1;
+    }
+
+    priv = STATE(rig)->priv;
+    STATE(rig)->current_vfo = RIG_VFO_A;
+    STATE(rig)->comm_state = 1;     // the cache getters want an open rig
+
+    /* before AI is on, every frame is a reply */
+    feed(rig, "FA00014074000;");
+    CHECK(strcmp(routed, "FA00014074000;") == 0, "no AI, replies only");
+    CHECK(cached_freq(rig, RIG_VFO_A) != 14074000, "no AI, cache untouched");
+
+    priv->ai_active = 1;
+
+    /* nobody waiting: everything is pushed, even a stale error */
+    feed(rig, "FA00014074000;MD2;?;");
+    CHECK(routed[0] == '\0', "nothing routed while idle");
+    CHECK(cached_freq(rig, RIG_VFO_A) == 14074000, "FA cached");
+    CHECK(cached_mode(rig, RIG_VFO_A) == RIG_MODE_USB, "MD cached");
+
+    /* a get_freq waiting for FA among pushed frames */
+    priv->ai_reply = WAIT_FOR('F', 'A');
+    feed(rig, "FB00007074000;FA00014100000;TX;");
+    CHECK(strcmp(routed, "FA00014100000;") == 0, "FA reply routed");
+    CHECK(cached_freq(rig, RIG_VFO_A) == 14074000, "reply not cached as a push");
+    CHECK(cached_freq(rig, RIG_VFO_B) == 7074000, "FB cached");
+    CHECK(CACHE(rig)->ptt == RIG_PTT_ON, "TX cached");
+    CHECK(STATE(rig)->use_cached_ptt, "pushed PTT answers gets");
+
+    /* error replies belong to the transaction */
+    feed(rig, "RX;?;");
+    CHECK(strcmp(routed, "?;") == 0, "error reply routed");
+    CHECK(CACHE(rig)->ptt == RIG_PTT_OFF, "RX cached");
+
+    /* a status read waiting for IF while the rig pushes another IF */
+    priv->ai_reply = WAIT_FOR('I', 'F');
+    feed(rig, "MD3;" IF_FRAME("00021074000", "0", "2", "0") ";");
+    CHECK(strncmp(routed, "IF00021074000", 13) == 0, "IF reply routed");
+    CHECK(cached_mode(rig, RIG_VFO_A) == RIG_MODE_CW, "MD cached with a waiter");
+
+    /* a pushed IF carries freq, mode, PTT and the VFO */
+    priv->ai_reply = 0;
+    feed(rig, IF_FRAME("00021074000", "1", "2", "1"));
+    CHECK(routed[0] == '\0', "IF pushed");
+    CHECK(cached_freq(rig, RIG_VFO_B) == 21074000, "IF freq cached on B");
+    CHECK(cached_mode(rig, RIG_VFO_B) == RIG_MODE_USB, "IF mode cached on B");
+    CHECK(CACHE(rig)->ptt == RIG_PTT_ON, "IF PTT cached");
+
+    CHECK(kenwood_process_async_frame(rig, 9, (const unsigned char *) "IF000210;")
+          == -RIG_EPROTO, "short IF rejected");
+
+    /* only a rig going to AI opens and closes talking to the port itself */
+    STATE(rig)->async_data_enabled = 1;
+    RIGPORT(rig)->asyncio = 1;
+    kenwood_ai_open(rig);
+    CHECK(priv->ai_pending && !RIGPORT(rig)->asyncio, "AI open direct");
+    RIGPORT(rig)->asyncio = 1;
+    kenwood_ai_close(rig);
+    CHECK(!RIGPORT(rig)->asyncio, "AI close direct");
+
+    STATE(rig)->comm_state = 0;
+    rig_cleanup(rig);
+
+    rig = rig_init(RIG_MODEL_TS2000);
+
+    if (rig)
+    {
+        STATE(rig)->async_data_enabled = 1;
+        RIGPORT(rig)->asyncio = 1;
+        kenwood_ai_open(rig);
+        kenwood_ai_close(rig);
+        CHECK(RIGPORT(rig)->asyncio, "no AI, asyncio left alone");
+        rig_cleanup(rig);
+    }
+
+    if (failures)
+    {
+        fprintf(stderr, "%d Kenwood AI checks failed\n", failures);
+        return 1;
+    }
+
+    printf("Kenwood AI OK\n");
+    return 0;
+}
@@ -0,0 +1,272 @@
+/*
+ * Test the pipelined memory dump: rig_get_chan_all_cb() on a fake TS-850
+ * reads the same channels as kenwood_get_channel() one by one, keeps no
+ * more than the window of commands in flight, skips the empty channels,
+ * and leaves the port clean after an error reply.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <pthread.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+#include <hamlib/port.h>
+#include <hamlib/rig_state.h>
+
+#include "misc.h"
+#include "sleep.h"
+#include "testcheck.h"
+
+#define CHANNELS 100    // 0-89 memories, 90-99 band edges
+#define LATENCY_US 2000
+
+struct peer
+{
+    int fd;
+    int bad_channel;    // answered with an error, -1 for none
+    int max_pending;
+    int commands;
+};
+
+static int empty(int ch)
+{
+    return ch % 4 == 3;
+}
+
+/* MRsbccfffffffffffMLTtt ; */
+static void reply(struct peer *p, const char *cmd)
+{
+    char buf[32];
+    int side = cmd[2] - '0';
+    int ch = atoi(&cmd[4]);
+    long freq = empty(ch) ? 0 : 14000000L + ch * 1000L;
+
+    if (side == 1 && ch % 2) { freq += 5000; }
+
+    if (ch == p->bad_channel)
+    {
+        snprintf(buf, sizeof(buf), "?;");
+    }
+    else
+    {
+        snprintf(buf, sizeof(buf), "MR%d %02d%011ld%c%c000 ;", side, ch, freq,
+                 ch % 3 ? '2' : '1', ch % 5 ? '0' : '1');
+    }
+
+    if (write(p->fd, buf, strlen(buf)) < 0) { perror("write"); }
+}
+
+/*
+ * Answers after the rig's turnaround whatever commands arrived until
+ * then, so the number answered at once is the number in flight.
+ */
+static void *run_peer(void *arg)
+{
+    struct peer *p = arg;
+    char in[512];
+    size_t used = 0;
+
+    for (;;)
+    {
+        struct pollfd pfd = { p->fd, POLLIN, 0 };
+        char *cmd, *end;
+        int pending = 0;
+        ssize_t n;
+
+        if (poll(&pfd, 1, -1) != 1) { break; }
+
+        hl_usleep(LATENCY_US);
+        n = read(p->fd, in + used, sizeof(in) - 1 - used);
+
+        if (n <= 0) { break; }
+
+        used += n;
+        in[used] = '\0';
+
+        for (cmd = in; (end = strchr(cmd, ';')) != NULL; cmd = end + 1)
+        {
+            pending++;
+        }
+
+        if (pending > p->max_pending) { p->max_pending = pending; }
+
+        for (cmd = in; (end = strchr(cmd, ';')) != NULL; cmd = end + 1)
+        {
+            p->commands++;
+            reply(p, cmd);
+        }
+
+        used = strlen(cmd);
+        memmove(in, cmd, used + 1);
+    }
+
+    return NULL;
+}
+
+static channel_t slot;
+static channel_t got[CHANNELS];
+static int got_count;
+
+static int collect(RIG *rig, vfo_t vfo, channel_t **chan, int channel_num,
+                   const chan_t *chan_list, rig_ptr_t arg)
+{
+    (void)rig;
+    (void)vfo;
+    (void)channel_num;
+    (void)chan_list;
+    (void)arg;
+
+    if (*chan == NULL)
+    {
+        *chan = &slot;
+        return RIG_OK;
+    }
+
+    if ((*chan)->channel_num >= 0 && (*chan)->channel_num < CHANNELS)
+    {
+        got[(*chan)->channel_num] = **chan;
+    }
+
+    got_count++;
+
+    return RIG_OK;
+}
+
+int main(void)
+{
+    static channel_t want[CHANNELS], chans[CHANNELS];
+    struct peer peer = { -1, -1, 0, 0 };
+    struct timespec start;
+    double one_by_one, batched;
+    int sockets[2];
+    pthread_t thread;
+    int i, mismatch, filled, used, retval;
+    RIG *rig;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+    {
+        perror("socketpair");
+        return 1;
+    }
+
+    peer.fd = sockets[1];
+
+    if (pthread_create(&thread, NULL, run_peer, &peer) != 0)
+    {
+        return 1;
+    }
+
+    rig = rig_init(RIG_MODEL_TS850);
+
+    if (!rig || !rig->caps->mem_batch)
+    {
+        fprintf(stderr, "no TS-850 batch\n");
+        return 1;
+    }
+
+    RIGPORT(rig)->fd = sockets[0];
+    RIGPORT(rig)->timeout = 500;
+    RIGPORT(rig)->retry = 0;
+    RIGPORT(rig)->post_write_delay = 0;
+    STATE(rig)->comm_state = 1;
+
+    /* the reference: one channel at a time */
+    elapsed_ms(&start, HAMLIB_ELAPSED_SET);
+
+    for (i = 0, used = 0; i < CHANNELS; i++)
+    {
+        want[i].channel_num = i;
+        retval = rig->caps->get_channel(rig, RIG_VFO_MEM, &want[i], 1);
+        CHECK(retval == (empty(i) ? -RIG_ENAVAIL : RIG_OK), "get_channel");
+
+        if (retval == RIG_OK) { used++; }
+    }
+
+    one_by_one = elapsed_ms(&start, HAMLIB_ELAPSED_GET);
+    CHECK(peer.max_pending == 1, "one command at a time");
+
+    peer.max_pending = 0;
+    peer.commands = 0;
+    elapsed_ms(&start, HAMLIB_ELAPSED_SET);
+    CHECK(rig_get_chan_all_cb(rig, RIG_VFO_NONE, collect, NULL) == RIG_OK,
+          "get_chan_all_cb");
+    batched = elapsed_ms(&start, HAMLIB_ELAPSED_GET);
+
+    CHECK(peer.commands == 2 * CHANNELS, "two commands a channel");
+    CHECK(peer.max_pending > 1
+          && peer.max_pending <= rig->caps->mem_batch->window, "window");
+    CHECK(got_count == used, "empty channels skipped");
+    CHECK(batched < one_by_one, "faster than one by one");
+
+    for (i = 0, mismatch = 0; i < CHANNELS; i++)
+    {
+        if (empty(i)) { continue; }
+
+        if (got[i].channel_num != i || got[i].freq != want[i].freq
+                || got[i].mode != want[i].mode || got[i].split != want[i].split
+                || got[i].tx_freq != want[i].tx_freq
+                || got[i].tx_mode != want[i].tx_mode
+                || got[i].flags != want[i].flags)
+        {
+            mismatch++;
+        }
+    }
+
+    CHECK(mismatch == 0, "same channels as get_channel");
+    CHECK(got[1].split == RIG_SPLIT_ON && got[1].tx_freq == 14006000
+          && got[5].flags == RIG_CHFLAG_SKIP, "channel contents");
+
+    /* an empty channel's slot is not handed to the next channel */
+    CHECK(rig_get_chan_all(rig, RIG_VFO_NONE, chans) == RIG_OK, "get_chan_all");
+
+    for (i = 0, filled = 0; i < CHANNELS; i++)
+    {
+        if (chans[i].freq != RIG_FREQ_NONE) { filled++; }
+
+        if (!empty(i) && chans[i].freq != want[i].freq) { mismatch++; }
+    }
+
+    CHECK(filled == used && mismatch == 0, "get_chan_all slots");
+
+    /* an error stops the dump, the replies in flight do not linger */
+    peer.bad_channel = 20;
+    CHECK(rig_get_chan_all_cb(rig, RIG_VFO_NONE, collect, NULL) == -RIG_EPROTO,
+          "error reply");
+    peer.bad_channel = -1;
+
+    memset(&slot, 0, sizeof(slot));
+    slot.channel_num = 42;
+    CHECK(rig->caps->get_channel(rig, RIG_VFO_MEM, &slot, 1) == RIG_OK
+          && slot.freq == want[42].freq, "port clean after the error");
+
+    printf("%d channels: %.0f ms one by one, %.0f ms pipelined\n", CHANNELS,
+           one_by_one, batched);
+
+    STATE(rig)->comm_state = 0;
+    RIGPORT(rig)->fd = -1;
+    rig_cleanup(rig);
+
+    close(sockets[0]);
+    pthread_join(thread, NULL);
+    close(sockets[1]);
+
+    if (failures)
+    {
+        fprintf(stderr, "%d memory batch checks failed\n", failures);
+        return 1;
+    }
+
+    printf("memory batch OK\n");
+    return 0;
+}
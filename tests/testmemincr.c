@@ -0,0 +1,251 @@
+/*
+ * Test the incremental memory upload: with mem_incremental set,
+ * rig_set_chan_all() on a fake TS-850 writes only the channels that
+ * differ from what was last read or written, the hashes survive a save
+ * and load, and VERIFY catches a channel the rig did not take but not
+ * one it cleared.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <pthread.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+#include <hamlib/port.h>
+#include <hamlib/rig_state.h>
+
+#include "testcheck.h"
+
+#define CHANNELS 100    // 0-89 memories, 90-99 band edges
+
+struct peer
+{
+    int fd;
+    long freq[CHANNELS][2];     // receive and transmit, 0 when empty
+    char mode[CHANNELS][2];
+    int writes;                 // MW commands
+    int ignore_writes;          // accepted, not stored
+};
+
+static void reply(struct peer *p, const char *cmd)
+{
+    char buf[32];
+    int side = cmd[2] - '0';
+    int ch = (cmd[4] - '0') * 10 + cmd[5] - '0';
+
+    if (strncmp(cmd, "ID", 2) == 0)
+    {
+        snprintf(buf, sizeof(buf), "ID009;");
+    }
+    else if (strncmp(cmd, "MW", 2) == 0)
+    {
+        /* MWsbccfffffffffffMLTtt, MW1 of a channel without split is empty */
+        long freq = 0;
+        int i;
+
+        for (i = 6; i < 17; i++) { freq = freq * 10 + cmd[i] - '0'; }
+
+        p->writes++;
+
+        if (p->ignore_writes) { return; }
+
+        p->freq[ch][side] = side == 1 && freq == 0 ? p->freq[ch][0] : freq;
+        p->mode[ch][side] = side == 1 && freq == 0 ? p->mode[ch][0]
+                            : cmd[17] == ';' ? '\0' : cmd[17];
+        return;
+    }
+    else
+    {
+        /* MRsbccfffffffffffMLTtt ; */
+        snprintf(buf, sizeof(buf), "MR%d %02d%011ld%c0000 ;", side, ch,
+                 p->freq[ch][side], p->mode[ch][side] ? p->mode[ch][side] : '0');
+    }
+
+    if (write(p->fd, buf, strlen(buf)) < 0) { perror("write"); }
+}
+
+static void *run_peer(void *arg)
+{
+    struct peer *p = arg;
+    char in[512];
+    size_t used = 0;
+
+    for (;;)
+    {
+        char *cmd, *end;
+        ssize_t n = read(p->fd, in + used, sizeof(in) - 1 - used);
+
+        if (n <= 0) { break; }
+
+        used += n;
+        in[used] = '\0';
+
+        for (cmd = in; (end = strchr(cmd, ';')) != NULL; cmd = end + 1)
+        {
+            reply(p, cmd);
+        }
+
+        used = strlen(cmd);
+        memmove(in, cmd, used + 1);
+    }
+
+    return NULL;
+}
+
+static int upload(RIG *rig, struct peer *peer, const channel_t *chans)
+{
+    int writes = peer->writes;
+    int retval = rig_set_chan_all(rig, RIG_VFO_NONE, chans);
+
+    CHECK(retval == RIG_OK, "set_chan_all");
+
+    return (peer->writes - writes) / 2;     // MW0 and MW1 a channel
+}
+
+int main(void)
+{
+    static channel_t chans[CHANNELS];
+    static struct peer peer;
+    const char *path = "testmemincr.hashes";
+    channel_t a, b;
+    int sockets[2];
+    pthread_t thread;
+    FILE *f;
+    RIG *rig;
+    int i;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    for (i = 0; i < CHANNELS; i++)
+    {
+        if (i % 4 == 3) { continue; }
+
+        peer.freq[i][0] = peer.freq[i][1] = 7000000L + i * 1000L;
+        peer.mode[i][0] = peer.mode[i][1] = i % 3 ? '2' : '1';
+    }
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+    {
+        perror("socketpair");
+        return 1;
+    }
+
+    peer.fd = sockets[1];
+
+    if (pthread_create(&thread, NULL, run_peer, &peer) != 0)
+    {
+        return 1;
+    }
+
+    rig = rig_init(RIG_MODEL_TS850);
+
+    if (!rig)
+    {
+        fprintf(stderr, "cannot init TS-850\n");
+        return 1;
+    }
+
+    RIGPORT(rig)->fd = sockets[0];
+    RIGPORT(rig)->timeout = 500;
+    RIGPORT(rig)->retry = 0;
+    RIGPORT(rig)->post_write_delay = 0;
+    STATE(rig)->comm_state = 1;
+
+    /* the hash covers what the rig stores, a TS-850 has no names */
+    memset(&a, 0, sizeof(a));
+    a.channel_num = 10;
+    a.freq = 14074000;
+    a.mode = RIG_MODE_USB;
+    b = a;
+    SNPRINTF(b.channel_desc, sizeof(b.channel_desc), "FT8");
+    CHECK(rig_channel_hash(rig, &a) == rig_channel_hash(rig, &b), "names ignored");
+    b.freq = 14074010;
+    CHECK(rig_channel_hash(rig, &a) != rig_channel_hash(rig, &b), "freq hashed");
+
+    /* off: every channel is written */
+    CHECK(rig_get_chan_all(rig, RIG_VFO_NONE, chans) == RIG_OK, "get_chan_all");
+    CHECK(upload(rig, &peer, chans) == CHANNELS, "all written when off");
+
+    CHECK(rig_set_conf(rig, rig_token_lookup(rig, "mem_incremental"), "ON")
+          == RIG_OK, "mem_incremental=ON");
+
+    /* what was read is known, nothing to write */
+    CHECK(rig_get_chan_all(rig, RIG_VFO_NONE, chans) == RIG_OK, "get_chan_all");
+    CHECK(upload(rig, &peer, chans) == 0, "unchanged bank not written");
+
+    /* two retuned, one mode changed, one empty channel filled */
+    chans[5].freq = 7100000;
+    chans[40].freq = 7200000;
+    chans[41].mode = RIG_MODE_CW;
+    chans[43].freq = 7300000;
+    chans[43].mode = RIG_MODE_LSB;
+    CHECK(upload(rig, &peer, chans) == 4, "changed channels written");
+    CHECK(peer.freq[5][0] == 7100000 && peer.freq[43][0] == 7300000,
+          "rig reprogrammed");
+    CHECK(upload(rig, &peer, chans) == 0, "written channels known");
+
+    /* the hashes of a later session */
+    CHECK(rig_save_chan_hashes(rig, path) == RIG_OK, "save hashes");
+    chans[60].freq = 7400000;
+    CHECK(upload(rig, &peer, chans) == 1, "one more change");
+    CHECK(rig_load_chan_hashes(rig, path) == RIG_OK, "load hashes");
+    CHECK(upload(rig, &peer, chans) == 1, "loaded hashes replace the known ones");
+
+    f = fopen(path, "w");
+
+    if (f)
+    {
+        fprintf(f, "# Hamlib channel hashes\nmodel 1\n0 5 12345678\n");
+        fclose(f);
+    }
+
+    CHECK(rig_load_chan_hashes(rig, path) == -RIG_EINVAL, "other model");
+    CHECK(upload(rig, &peer, chans) == CHANNELS, "nothing known after a bad file");
+    remove(path);
+
+    /* verify: a write the rig dropped is an error, and written again */
+    CHECK(rig_set_conf(rig, rig_token_lookup(rig, "mem_incremental"), "VERIFY")
+          == RIG_OK, "mem_incremental=VERIFY");
+    chans[70].freq = 7500000;
+    peer.ignore_writes = 1;
+    CHECK(rig_set_chan_all(rig, RIG_VFO_NONE, chans) == -RIG_EPROTO,
+          "verify catches it");
+    peer.ignore_writes = 0;
+    CHECK(upload(rig, &peer, chans) == 1 && peer.freq[70][0] == 7500000,
+          "written again");
+    CHECK(upload(rig, &peer, chans) == 0, "verified channel known");
+
+    /* a cleared channel reads back as not there, which matches */
+    memset(&chans[20], 0, sizeof(chans[20]));
+    chans[20].vfo = RIG_VFO_MEM;
+    chans[20].channel_num = 20;
+    CHECK(upload(rig, &peer, chans) == 1 && peer.freq[20][0] == 0,
+          "cleared channel verified");
+    CHECK(upload(rig, &peer, chans) == 0, "cleared channel known");
+
+    STATE(rig)->comm_state = 0;
+    RIGPORT(rig)->fd = -1;
+    rig_cleanup(rig);
+
+    close(sockets[0]);
+    pthread_join(thread, NULL);
+    close(sockets[1]);
+
+    if (failures)
+    {
+        fprintf(stderr, "%d incremental upload checks failed\n", failures);
+        return 1;
+    }
+
+    printf("incremental upload OK\n");
+    return 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Test the Yaesu newcat AI mode decoder: pushed FA/FB/MD/TX frames and
+ * the IF frames of every length update the cache of the VFO or memory
+ * they report, a reply a command waits for is left to it.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+#include <hamlib/rig_state.h>
+
+#include "cache.h"
+#include "newcat.h"
+#include "testcheck.h"
+
+/*
+ * IF: channel, freq, clarifier, RX/TX clarifier, mode at 12 + freq width,
+ * VFO or memory right after it, then tone and shift; some rigs add a tail
+ */
+#define IF_FRAME(freq, mode, mem, tail) "IF001" freq "+000000" mode mem "0000" tail ";"
+
+#define WAIT_FOR(a, b) (((a) << 8) | (b))
+
+static int push(RIG *rig, const char *frame)
+{
+    size_t len = strlen(frame);
+
+    if (!rig->caps->is_async_frame(rig, len, (const unsigned char *) frame))
+    {
+        return 1;       // routed to the command being read
+    }
+
+    return rig->caps->process_async_frame(rig, len, (const unsigned char *) frame);
+}
+
+static freq_t cached_freq(RIG *rig, vfo_t vfo)
+{
+    freq_t freq = 0;
+    int ms;
+
+    rig_get_cache_freq(rig, vfo, &freq, &ms);
+    return freq;
+}
+
+static rmode_t cached_mode(RIG *rig, vfo_t vfo)
+{
+    freq_t freq;
+    rmode_t mode = RIG_MODE_NONE;
+    pbwidth_t width;
+    int ms_freq, ms_mode, ms_width;
+
+    rig_get_cache(rig, vfo, &freq, &ms_freq, &mode, &ms_mode, &width, &ms_width);
+    return mode;
+}
+
+int main(void)
+{
+    struct newcat_priv_data *priv;
+    RIG *rig;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_FT991);
+
+    if (!rig)
+    {
+        fprintf(stderr, "cannot init FT-991\n");
+        return 1;
+    }
+
+    priv = STATE(rig)->priv;
+    priv->ai_active = 1;
+    STATE(rig)->current_vfo = RIG_VFO_A;
+    STATE(rig)->comm_state = 1;     // the cache getters want an open rig
+
+    CHECK(push(rig, "FA014074000;") == RIG_OK, "FA");
+    CHECK(cached_freq(rig, RIG_VFO_A) == 14074000, "FA cached");
+    CHECK(push(rig, "FB007074000;") == RIG_OK, "FB");
+    CHECK(cached_freq(rig, RIG_VFO_B) == 7074000, "FB cached");
+
+    CHECK(push(rig, "MD02;") == RIG_OK && push(rig, "MD13;") == RIG_OK, "MD");
+    CHECK(cached_mode(rig, RIG_VFO_A) == RIG_MODE_USB, "MD0 cached on A");
+    CHECK(cached_mode(rig, RIG_VFO_B) == RIG_MODE_CW, "MD1 cached on B");
+
+    CHECK(!STATE(rig)->use_cached_ptt, "PTT read from the rig before a push");
+    CHECK(push(rig, "TX1;") == RIG_OK && CACHE(rig)->ptt == RIG_PTT_ON, "TX1");
+    CHECK(STATE(rig)->use_cached_ptt, "pushed PTT answers gets");
+    CHECK(push(rig, "TX0;") == RIG_OK && CACHE(rig)->ptt == RIG_PTT_OFF, "TX0");
+
+    /* FT-991 style IF, 9 digit frequency */
+    CHECK(push(rig, IF_FRAME("021074000", "C", "0", "")) == RIG_OK, "IF 28 bytes");
+    CHECK(cached_freq(rig, RIG_VFO_A) == 21074000, "IF freq cached");
+    CHECK(cached_mode(rig, RIG_VFO_A) == RIG_MODE_PKTUSB, "IF mode cached");
+
+    /* FT-450 style IF, 8 digit frequency */
+    CHECK(push(rig, IF_FRAME("07030000", "3", "0", "")) == RIG_OK, "IF 27 bytes");
+    CHECK(cached_freq(rig, RIG_VFO_A) == 7030000, "short IF freq cached");
+    CHECK(cached_mode(rig, RIG_VFO_A) == RIG_MODE_CW, "short IF mode cached");
+
+    /* 9 digit frequency and two more bytes */
+    CHECK(push(rig, IF_FRAME("014074000", "2", "0", "00")) == RIG_OK, "IF 30 bytes");
+    CHECK(cached_freq(rig, RIG_VFO_A) == 14074000, "long IF freq cached");
+    CHECK(cached_mode(rig, RIG_VFO_A) == RIG_MODE_USB, "long IF mode cached");
+
+    /* on a memory channel the IF says nothing about VFO A */
+    CHECK(push(rig, IF_FRAME("145500000", "4", "1", "")) == RIG_OK, "IF memory");
+    CHECK(cached_freq(rig, RIG_VFO_MEM) == 145500000, "memory freq cached");
+    CHECK(cached_mode(rig, RIG_VFO_MEM) == RIG_MODE_FM, "memory mode cached");
+    CHECK(cached_freq(rig, RIG_VFO_A) == 14074000, "VFO A left alone");
+
+    CHECK(push(rig, "IF00107030000;") == -RIG_EPROTO, "truncated IF rejected");
+    CHECK(cached_freq(rig, RIG_VFO_A) == 14074000, "truncated IF ignored");
+
+    /* the reply to a get_freq is not a push, an error reply neither */
+    priv->ai_reply = WAIT_FOR('F', 'A');
+    CHECK(push(rig, "FA014100000;") == 1, "FA reply routed");
+    CHECK(push(rig, "?;") == 1, "error reply routed");
+    CHECK(push(rig, "FB007100000;") == RIG_OK, "FB pushed meanwhile");
+    CHECK(cached_freq(rig, RIG_VFO_A) == 14074000, "reply not cached as a push");
+    CHECK(cached_freq(rig, RIG_VFO_B) == 7100000, "FB cached meanwhile");
+
+    STATE(rig)->comm_state = 0;
+    rig_cleanup(rig);
+
+    if (failures)
+    {
+        fprintf(stderr, "%d newcat AI checks failed\n", failures);
+        return 1;
+    }
+
+    printf("newcat AI OK\n");
+    return 0;
+}
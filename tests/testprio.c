@@ -0,0 +1,164 @@
+/*
+ * Test that PTT gets the rig ahead of queued gets and polls, and that
+ * polls are not starved.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+
+#include "sleep.h"
+
+#define GETTER_COUNT 4
+#define PTT_COUNT 20
+#define BACKEND_MS 20
+
+static int (*dummy_get_level)(RIG *rig, vfo_t vfo, setting_t level,
+                              value_t *val);
+static int (*dummy_get_freq)(RIG *rig, vfo_t vfo, freq_t *freq);
+static int done;
+
+/* Every read keeps the rig busy for a while, like a real CAT round trip */
+static int slow_get_level(RIG *rig, vfo_t vfo, setting_t level, value_t *val)
+{
+    hl_usleep(BACKEND_MS * 1000);
+    return dummy_get_level(rig, vfo, level, val);
+}
+
+static int slow_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
+{
+    hl_usleep(BACKEND_MS * 1000);
+    return dummy_get_freq(rig, vfo, freq);
+}
+
+struct getter_context
+{
+    RIG *rig;
+    setting_t level;    // distinct per thread so the gets are not shared
+};
+
+static void *getter(void *arg)
+{
+    const struct getter_context *ctx = arg;
+    value_t val;
+
+    while (!__atomic_load_n(&done, __ATOMIC_RELAXED))
+    {
+        rig_get_level(ctx->rig, RIG_VFO_CURR, ctx->level, &val);
+    }
+
+    return NULL;
+}
+
+static void *poller(void *arg)
+{
+    RIG *rig = arg;
+    freq_t freq;
+
+    rig_set_thread_prio(RIG_PRIO_POLL);
+
+    while (!__atomic_load_n(&done, __ATOMIC_RELAXED))
+    {
+        rig_get_freq(rig, RIG_VFO_CURR, &freq);
+    }
+
+    return NULL;
+}
+
+int main(void)
+{
+    static const setting_t levels[GETTER_COUNT] =
+    {
+        RIG_LEVEL_AF, RIG_LEVEL_RF, RIG_LEVEL_SQL, RIG_LEVEL_MICGAIN
+    };
+    RIG *rig;
+    pthread_t threads[GETTER_COUNT + 1];
+    struct getter_context ctx[GETTER_COUNT];
+    struct rig_prio_stats ptt, get, poll;
+    int failures = 0;
+    int i;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig || rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "cannot open dummy rig\n");
+        return 1;
+    }
+
+    rig_set_cache_timeout_ms(rig, HAMLIB_CACHE_ALL, 0);
+
+    dummy_get_level = rig->caps->get_level;
+    rig->caps->get_level = slow_get_level;
+    dummy_get_freq = rig->caps->get_freq;
+    rig->caps->get_freq = slow_get_freq;
+
+    for (i = 0; i < GETTER_COUNT; ++i)
+    {
+        ctx[i].rig = rig;
+        ctx[i].level = levels[i];
+        pthread_create(&threads[i], NULL, getter, &ctx[i]);
+    }
+
+    pthread_create(&threads[GETTER_COUNT], NULL, poller, rig);
+
+    // let the queue fill up
+    hl_usleep(100 * 1000);
+
+    for (i = 0; i < PTT_COUNT; ++i)
+    {
+        rig_set_ptt(rig, RIG_VFO_CURR, (i & 1) ? RIG_PTT_OFF : RIG_PTT_ON);
+        hl_usleep(30 * 1000);
+    }
+
+    __atomic_store_n(&done, 1, __ATOMIC_RELAXED);
+
+    for (i = 0; i <= GETTER_COUNT; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    rig->caps->get_level = dummy_get_level;
+    rig->caps->get_freq = dummy_get_freq;
+
+    rig_get_prio_stats(rig, RIG_PRIO_PTT, &ptt);
+    rig_get_prio_stats(rig, RIG_PRIO_GET, &get);
+    rig_get_prio_stats(rig, RIG_PRIO_POLL, &poll);
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    printf("PTT  waits=%lu max=%luus\n", ptt.count, ptt.max_us);
+    printf("GET  waits=%lu max=%luus\n", get.count, get.max_us);
+    printf("POLL waits=%lu max=%luus\n", poll.count, poll.max_us);
+
+    if (ptt.count < PTT_COUNT)
+    {
+        fprintf(stderr, "PTT waits were not counted\n");
+        failures++;
+    }
+
+    // a PTT should only ever wait for the read in progress
+    if (ptt.max_us > 3 * BACKEND_MS * 1000)
+    {
+        fprintf(stderr, "PTT waited too long\n");
+        failures++;
+    }
+
+    if (poll.count < 2)
+    {
+        fprintf(stderr, "poll thread was starved\n");
+        failures++;
+    }
+
+    return failures ? 1 : 0;
+}
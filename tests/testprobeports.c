@@ -0,0 +1,202 @@
+/*
+ * Test rig_probe_ports(): several ports probed at once, a radio found on
+ * one and a silent port given up on when the budget runs out, with
+ * nothing left probing it afterwards.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+#include <hamlib/port.h>
+
+#define BUDGET_MS 1500
+
+struct result
+{
+    char pathname[HAMLIB_FILPATHLEN];
+    rig_model_t model;
+    double ms;
+};
+
+static struct result results[2];
+static int result_count;
+static double start_ms;
+
+static double now_ms(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static int open_pty(char *name, size_t len)
+{
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (fd < 0 || grantpt(fd) < 0 || unlockpt(fd) < 0)
+    {
+        return -1;
+    }
+
+    snprintf(name, len, "%s", ptsname(fd));
+    return fd;
+}
+
+/* Answers "ID;" the way a TS-2000 does */
+static void *kenwood_responder(void *arg)
+{
+    int fd = *(int *)arg;
+    char cmd[64];
+    size_t n = 0;
+    char c;
+
+    while (read(fd, &c, 1) == 1)
+    {
+        if (n < sizeof(cmd) - 1) { cmd[n++] = c; }
+
+        if (c != ';') { continue; }
+
+        cmd[n] = '\0';
+        n = 0;
+
+        if (strcmp(cmd, "ID;") == 0 && write(fd, "ID019;", 6) != 6)
+        {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static int record(const hamlib_port_t *port, rig_model_t model, rig_ptr_t data)
+{
+    if (result_count < 2)
+    {
+        struct result *r = &results[result_count++];
+
+        snprintf(r->pathname, sizeof(r->pathname), "%s", port->pathname);
+        r->model = model;
+        r->ms = now_ms() - start_ms;
+    }
+
+    return 1;
+}
+
+static const struct result *lookup(const char *pathname)
+{
+    int i;
+
+    for (i = 0; i < result_count; i++)
+    {
+        if (strcmp(results[i].pathname, pathname) == 0) { return &results[i]; }
+    }
+
+    return NULL;
+}
+
+/* Bytes the probes wrote to a port that were not read yet */
+static int drain(int fd)
+{
+    char buf[256];
+    int total = 0;
+    ssize_t n;
+
+    while ((n = read(fd, buf, sizeof(buf))) > 0) { total += n; }
+
+    return total;
+}
+
+int main(void)
+{
+    char kenwood[64], silent[64];
+    const char *pathnames[2] = { kenwood, silent };
+    const struct result *r;
+    pthread_t thread;
+    int kenwood_fd, silent_fd;
+    int found;
+    double elapsed;
+    int failures = 0;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    kenwood_fd = open_pty(kenwood, sizeof(kenwood));
+    silent_fd = open_pty(silent, sizeof(silent));
+
+    if (kenwood_fd < 0 || silent_fd < 0)
+    {
+        printf("no pseudo terminals, skipped\n");
+        return 77;
+    }
+
+    pthread_create(&thread, NULL, kenwood_responder, &kenwood_fd);
+
+    rig_load_all_backends();
+
+    start_ms = now_ms();
+    found = rig_probe_ports(pathnames, 2, BUDGET_MS, record, NULL);
+    elapsed = now_ms() - start_ms;
+
+    printf("found %d of 2 in %.0f ms\n", found, elapsed);
+
+    if (found != 1 || result_count != 2)
+    {
+        fprintf(stderr, "expected one radio and two reports\n");
+        failures++;
+    }
+
+    r = lookup(kenwood);
+
+    if (!r || r->model != RIG_MODEL_TS2000)
+    {
+        fprintf(stderr, "%s: expected TS-2000, got %u\n", kenwood,
+                r ? r->model : 0);
+        failures++;
+    }
+    else if (r->ms > BUDGET_MS / 2)
+    {
+        // the silent port must not hold up the one that answers
+        fprintf(stderr, "%s: reported after %.0f ms\n", kenwood, r->ms);
+        failures++;
+    }
+
+    r = lookup(silent);
+
+    if (!r || r->model != RIG_MODEL_NONE)
+    {
+        fprintf(stderr, "%s: expected no radio\n", silent);
+        failures++;
+    }
+
+    if (elapsed > BUDGET_MS + 500)
+    {
+        fprintf(stderr, "probe overran its %d ms budget\n", BUDGET_MS);
+        failures++;
+    }
+
+    // the probes of the silent port ended with the call
+    fcntl(silent_fd, F_SETFL, fcntl(silent_fd, F_GETFL) | O_NONBLOCK);
+    drain(silent_fd);
+    nanosleep(&(struct timespec) { 0, 500000000L }, NULL);
+
+    if (drain(silent_fd) != 0)
+    {
+        fprintf(stderr, "%s: still probed after the call returned\n", silent);
+        failures++;
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,168 @@
+/*
+ * Test the read-ahead buffer of read_string() over a pty: several frames
+ * the rig sent back to back are fetched with one read() and handed out a
+ * frame per call, read_block() takes what is left from the buffer, and a
+ * probe reopening the port at another rate starts with nothing buffered.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/port.h>
+
+#include "iofunc.h"
+#include "serial.h"
+#include "testcheck.h"
+
+#ifdef __linux__
+#include <sys/syscall.h>
+
+static int counted_fd = -1;
+static int reads;
+
+/* Counts the library's reads of the pty, the executable's read() wins */
+ssize_t read(int fd, void *buf, size_t count)
+{
+    if (fd == counted_fd) { ++reads; }
+
+    return syscall(SYS_read, fd, buf, count);
+}
+
+static int open_pty(int *slave)
+{
+    struct termios tio;
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0)
+    {
+        return -1;
+    }
+
+    *slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+
+    if (*slave < 0 || tcgetattr(*slave, &tio) < 0)
+    {
+        return -1;
+    }
+
+    cfmakeraw(&tio);
+    tcsetattr(*slave, TCSANOW, &tio);
+
+    return master;
+}
+
+static int send_frames(int master, const char *s)
+{
+    int ok = write(master, s, strlen(s)) == (ssize_t)strlen(s);
+
+    /* let the line discipline pass everything to the slave */
+    usleep(50000);
+
+    return ok;
+}
+#endif
+
+int main(void)
+{
+#ifdef __linux__
+    static hamlib_port_t port;
+    unsigned char buf[64];
+    int master, slave;
+    int n;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    master = open_pty(&slave);
+
+    if (master < 0)
+    {
+        perror("pty");
+        return 77;
+    }
+
+    port.type.rig = RIG_PORT_SERIAL;
+    port.parm.serial.data_bits = 8;
+    port.fd = slave;
+    port.timeout = 1000;
+    counted_fd = slave;
+
+    /* three replies arrive together, as after a burst of commands */
+    CHECK(send_frames(master, "FA00014074000;FB00007000000;MD2;"), "write");
+
+    reads = 0;
+    n = read_string(&port, buf, sizeof(buf), ";", 1, 0, 1);
+    CHECK(n == 14 && memcmp(buf, "FA00014074000;", 14) == 0, "first frame");
+    CHECK(port.rxbuf[0].len == 18, "the rest read ahead");
+    n = read_string(&port, buf, sizeof(buf), ";", 1, 0, 1);
+    CHECK(n == 14 && memcmp(buf, "FB00007000000;", 14) == 0, "second frame");
+    n = read_string(&port, buf, sizeof(buf), ";", 1, 0, 1);
+    CHECK(n == 4 && memcmp(buf, "MD2;", 4) == 0, "third frame");
+    CHECK(reads == 1, "one read for three frames");
+
+    /* a binary tail after a text reply goes to read_block() */
+    CHECK(send_frames(master, "ID019;\x01\x02\x03"), "write");
+
+    reads = 0;
+    n = read_string(&port, buf, sizeof(buf), ";", 1, 0, 1);
+    CHECK(n == 6 && memcmp(buf, "ID019;", 6) == 0, "text reply");
+    n = read_block(&port, buf, 3);
+    CHECK(n == 3 && memcmp(buf, "\x01\x02\x03", 3) == 0, "block from the buffer");
+    CHECK(reads == 1 && port.rxbuf[0].len == 0, "block read no more");
+
+    /* a flush drops what was read ahead */
+    CHECK(send_frames(master, "FA00014074000;FB00007000000;"), "write");
+    n = read_string(&port, buf, sizeof(buf), ";", 1, 0, 1);
+    CHECK(n == 14 && port.rxbuf[0].len == 14, "second frame buffered");
+    CHECK(port_rxbuf_discard(&port, 1) == 14 && port.rxbuf[0].len == 0,
+          "discarded");
+
+    /* a probe trying the next rate reopens the port with serial_open() */
+    CHECK(send_frames(master, "FA00014074000;FB00007000000;"), "write");
+    n = read_string(&port, buf, sizeof(buf), ";", 1, 0, 1);
+    CHECK(n == 14 && port.rxbuf[0].len == 14, "buffered before reopening");
+    strncpy(port.pathname, ptsname(master), HAMLIB_FILPATHLEN - 1);
+    port.parm.serial.rate = 9600;
+    port.parm.serial.stop_bits = 1;
+    port.rxbuf[1].head = 12345;     // as on a port the caller never zeroed
+    port.rxbuf[1].len = -7;
+
+    if (serial_open(&port) == RIG_OK)
+    {
+        CHECK(port.rxbuf[0].len == 0, "nothing carried over to the next rate");
+        CHECK(port.rxbuf[1].head == 0 && port.rxbuf[1].len == 0,
+              "pipe buffer reset");
+        ser_close(&port);
+    }
+    else
+    {
+        CHECK(0, "serial_open");
+    }
+
+    counted_fd = -1;
+    close(slave);
+    close(master);
+
+    if (failures)
+    {
+        fprintf(stderr, "%d read-ahead checks failed\n", failures);
+        return 1;
+    }
+
+    printf("read-ahead OK\n");
+    return 0;
+#else
+    /* the reads are counted by overriding read() */
+    return 77;
+#endif
+}
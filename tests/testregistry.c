@@ -0,0 +1,164 @@
+/*
+ * Test the rig registry: lazy backend loading, lookups of unknown models,
+ * lookups while backends load, walk order and unregistering from a walk.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+
+#include "testcheck.h"
+
+/* dummy backend model numbers nothing uses */
+#define CHURN_BASE 500
+#define CHURN_MODELS 200
+#define CHURN_ROUNDS 200
+
+struct walk
+{
+    int count;
+    int sorted;
+    rig_model_t last;
+    rig_model_t drop;
+    rig_model_t ahead;          // unregistered before its turn
+    int saw_ahead;
+};
+
+struct lookups
+{
+    volatile int stop;
+    int misses;
+};
+
+static int walk_models(const struct rig_caps *caps, rig_ptr_t data)
+{
+    struct walk *w = data;
+
+    if (caps->rig_model <= w->last) { w->sorted = 0; }
+
+    w->last = caps->rig_model;
+    w->count++;
+
+    if (caps->rig_model == w->drop) { rig_unregister(w->drop); }
+
+    if (caps->rig_model == w->ahead) { w->saw_ahead = 1; }
+
+    if (w->ahead && w->count == 1) { rig_unregister(w->ahead); }
+
+    return 1;
+}
+
+/* A loaded model must stay visible while other backends register */
+static void *look_up(void *arg)
+{
+    struct lookups *l = arg;
+
+    while (!l->stop)
+    {
+        if (rig_get_caps(RIG_MODEL_TS2000) == NULL) { l->misses++; }
+    }
+
+    return NULL;
+}
+
+static int count_models(void)
+{
+    struct walk w = { 0, 1, 0, 0, 0, 0 };
+
+    rig_list_foreach(walk_models, &w);
+    return w.count;
+}
+
+int main(void)
+{
+    struct walk w = { 0, 1, 0, RIG_MODEL_TS2000, 0, 0 };
+    struct walk ahead = { 0, 1, 0, 0, RIG_MODEL_IC7300, 0 };
+    static struct rig_caps churn[CHURN_MODELS];
+    struct lookups lookups = { 0, 0 };
+    pthread_t thread;
+    RIG *rig;
+    int round;
+    int all;
+    int i;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    CHECK(rig_get_caps(RIG_MODEL_TS2000) == NULL, "nothing registered yet");
+
+    /* rig_init loads just the backend it needs */
+    rig = rig_init(RIG_MODEL_TS2000);
+    CHECK(rig != NULL, "rig_init loads the kenwood backend");
+    rig_cleanup(rig);
+    CHECK(rig_get_caps(RIG_MODEL_TS2000) != NULL, "kenwood caps registered");
+    CHECK(rig_get_caps(RIG_MODEL_IC7300) == NULL, "icom backend not loaded");
+
+    /* an unknown model of a loaded backend is an error, not a reload */
+    CHECK(rig_check_backend(RIG_MAKE_MODEL(RIG_KENWOOD, 999)) != RIG_OK,
+          "unknown kenwood model");
+    CHECK(rig_init(RIG_MAKE_MODEL(RIG_KENWOOD, 999)) == NULL,
+          "rig_init of unknown kenwood model");
+
+    /* the registry grows and moves under the lookups */
+    pthread_create(&thread, NULL, look_up, &lookups);
+    rig_load_all_backends();
+    lookups.stop = 1;
+    pthread_join(thread, NULL);
+    CHECK(lookups.misses == 0, "lookups during backend loading");
+
+    /* registering below a model moves it, over and over */
+    lookups.stop = 0;
+    pthread_create(&thread, NULL, look_up, &lookups);
+
+    for (round = 0; round < CHURN_ROUNDS; round++)
+    {
+        for (i = 0; i < CHURN_MODELS; i++)
+        {
+            churn[i] = *rig_get_caps(RIG_MODEL_DUMMY);
+            churn[i].rig_model = CHURN_BASE + i;
+            rig_register(&churn[i]);
+        }
+
+        for (i = 0; i < CHURN_MODELS; i++) { rig_unregister(CHURN_BASE + i); }
+    }
+
+    lookups.stop = 1;
+    pthread_join(thread, NULL);
+    CHECK(lookups.misses == 0, "lookups while models come and go");
+
+    all = count_models();
+    CHECK(rig_get_caps(RIG_MODEL_IC7300) != NULL, "all backends loaded");
+
+    rig_load_all_backends();
+    CHECK(count_models() == all, "loading twice registers nothing new");
+
+    CHECK(rig_register(rig_get_caps(RIG_MODEL_DUMMY)) != RIG_OK,
+          "duplicate registration refused");
+
+    /* model order, and the walk survives unregistering the current caps */
+    rig_list_foreach(walk_models, &w);
+    CHECK(w.sorted, "walk is in model order");
+    CHECK(w.count == all, "walk visits every model once");
+    CHECK(rig_get_caps(RIG_MODEL_TS2000) == NULL, "unregistered");
+    CHECK(count_models() == all - 1, "one model fewer");
+
+    /* a model unregistered before its turn is not visited */
+    rig_list_foreach(walk_models, &ahead);
+    CHECK(!ahead.saw_ahead && ahead.count == all - 2, "unregistered model skipped");
+    CHECK(count_models() == all - 2, "two models fewer");
+
+    if (failures)
+    {
+        fprintf(stderr, "%d registry checks failed\n", failures);
+        return 1;
+    }
+
+    printf("registry OK, %d models\n", all);
+    return 0;
+}
@@ -43,6 +43,7 @@ int main(int argc, const char *argv[])
 
     if (argc < 2)
     {
+        memset(&myport, 0, sizeof(myport));
         /* may be overridden by backend probe */
         myport.type.rig = RIG_PORT_SERIAL;
         myport.parm.serial.rate = 9600;
@@ -0,0 +1,333 @@
+/*
+ * Test rigctld over real connections: with the event loop, a client that
+ * shuts down its side still gets the answers to what it sent and clients
+ * closing together do not disturb the others; with both front ends,
+ * concurrent clients share the gets that reach the rig and PTT does not
+ * wait for another client's command.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "testcheck.h"
+
+#define CLIENTS 16
+#define GETTERS 8
+#define GETS 10
+#define TRACE "testrigctld.trace"
+
+static struct sockaddr_in addr;
+
+/* A port nobody listens on right now */
+static int free_port(void)
+{
+    socklen_t len = sizeof(addr);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int port = -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (fd >= 0 && bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0
+            && getsockname(fd, (struct sockaddr *)&addr, &len) == 0)
+    {
+        port = ntohs(addr.sin_port);
+    }
+
+    if (fd >= 0) { close(fd); }
+
+    return port;
+}
+
+/* The debug output goes to TRACE */
+static pid_t start_rigctld(int port, int event_loop)
+{
+    char portstr[16];
+    char *argv[] = { "rigctld", "-m", "1", "-T", "127.0.0.1", "-t", portstr,
+                     "-vvvv", NULL, NULL
+                   };
+    pid_t pid;
+
+    snprintf(portstr, sizeof(portstr), "%d", port);
+
+    if (event_loop) { argv[8] = "--event-loop"; }
+
+    pid = fork();
+
+    if (pid == 0)
+    {
+        int null = open("/dev/null", O_WRONLY);
+        int trace = open(TRACE, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        dup2(null, STDOUT_FILENO);
+        dup2(trace, STDERR_FILENO);
+        execv("./rigctld", argv);
+        _exit(127);
+    }
+
+    return pid;
+}
+
+static void stop_rigctld(pid_t pid)
+{
+    int status;
+
+    kill(pid, SIGTERM);
+    waitpid(pid, &status, 0);
+}
+
+static int connect_rigctld(void)
+{
+    int tries;
+
+    for (tries = 0; tries < 100; ++tries)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+        if (fd < 0) { return -1; }
+
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0)
+        {
+            return fd;
+        }
+
+        close(fd);
+        usleep(50000);
+    }
+
+    return -1;
+}
+
+static int send_all(int fd, const char *s)
+{
+    return send(fd, s, strlen(s), MSG_NOSIGNAL) == (ssize_t)strlen(s) ? 0 : -1;
+}
+
+/*
+ * Reads until want lines arrived, or to EOF when want is 0; returns the
+ * number of lines, *eof tells whether the server closed the connection.
+ */
+static int read_lines(int fd, int want, int *eof)
+{
+    char buf[1024];
+    int lines = 0;
+
+    *eof = 0;
+
+    while (want == 0 || lines < want)
+    {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        ssize_t n;
+        ssize_t i;
+
+        if (poll(&pfd, 1, 5000) <= 0) { break; }
+
+        n = recv(fd, buf, sizeof(buf), 0);
+
+        if (n <= 0)
+        {
+            *eof = n == 0;
+            break;
+        }
+
+        for (i = 0; i < n; ++i)
+        {
+            if (buf[i] == '\n') { ++lines; }
+        }
+    }
+
+    return lines;
+}
+
+/* Times the dummy rig was asked for its frequency */
+static int backend_gets(void)
+{
+    char line[512];
+    FILE *f = fopen(TRACE, "r");
+    int n = 0;
+
+    if (f == NULL) { return -1; }
+
+    while (fgets(line, sizeof(line), f))
+    {
+        if (strstr(line, "dummy_get_freq called")) { ++n; }
+    }
+
+    fclose(f);
+    return n;
+}
+
+static void *getter(void *arg)
+{
+    int fd = connect_rigctld();
+    int *answered = arg;
+    int eof;
+    int i;
+
+    for (i = 0; fd >= 0 && i < GETS; ++i)
+    {
+        if (send_all(fd, "f\n") < 0 || read_lines(fd, 1, &eof) != 1) { break; }
+
+        ++*answered;
+    }
+
+    if (fd >= 0) { close(fd); }
+
+    return NULL;
+}
+
+/* Several clients polling the frequency with the cache off */
+static void test_shared_gets(int port, int event_loop)
+{
+    pthread_t threads[GETTERS];
+    int answered[GETTERS] = { 0 };
+    int before, total = 0;
+    pid_t pid = start_rigctld(port, event_loop);
+    int fd = connect_rigctld();
+    int eof;
+    int i;
+
+    CHECK(fd >= 0 && send_all(fd, "\\set_cache 0\n") == 0
+          && read_lines(fd, 1, &eof) == 1, "cache off");
+    before = backend_gets();
+
+    for (i = 0; i < GETTERS; ++i)
+    {
+        pthread_create(&threads[i], NULL, getter, &answered[i]);
+    }
+
+    for (i = 0; i < GETTERS; ++i)
+    {
+        pthread_join(threads[i], NULL);
+        total += answered[i];
+    }
+
+    if (fd >= 0) { close(fd); }
+
+    stop_rigctld(pid);
+
+    CHECK(total == GETTERS * GETS, "every get answered");
+    CHECK(backend_gets() - before < total, "concurrent gets shared");
+    remove(TRACE);
+}
+
+/* PTT while another client's command holds the client lock */
+static void test_ptt_first(int port, int event_loop)
+{
+    struct timespec start, end;
+    pid_t pid = start_rigctld(port, event_loop);
+    int slow = connect_rigctld();
+    int fd = connect_rigctld();
+    int eof;
+
+    /* the first command of a connection checks the power with the lock */
+    CHECK(fd >= 0 && send_all(fd, "t\n") == 0 && read_lines(fd, 1, &eof) == 1,
+          "connected");
+    CHECK(slow >= 0 && send_all(slow, "\\pause 3\n") == 0, "slow command");
+    usleep(200000);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    CHECK(fd >= 0 && send_all(fd, "T 1\n") == 0
+          && read_lines(fd, 1, &eof) == 1, "PTT answered");
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    /* the pause ends 2.8 s later */
+    CHECK(end.tv_sec - start.tv_sec < 2, "PTT did not wait for the pause");
+
+    if (fd >= 0) { close(fd); }
+
+    if (slow >= 0) { close(slow); }
+
+    stop_rigctld(pid);
+}
+
+int main(void)
+{
+#ifdef __linux__
+    int fds[CLIENTS];
+    int port = free_port();
+    int eof;
+    int fd;
+    int i;
+    pid_t pid;
+
+    signal(SIGPIPE, SIG_IGN);
+
+    if (port < 0 || (pid = start_rigctld(port, 1)) < 0)
+    {
+        perror("start rigctld");
+        return 1;
+    }
+
+    fd = connect_rigctld();
+    CHECK(fd >= 0, "connect");
+
+    if (fd < 0)
+    {
+        stop_rigctld(pid);
+        return 1;
+    }
+
+    /* echo "f m" | nc -N: the commands arrive with the EOF */
+    CHECK(send_all(fd, "f\nm\n") == 0, "send");
+    shutdown(fd, SHUT_WR);
+    CHECK(read_lines(fd, 0, &eof) == 3, "answers after the client's EOF");
+    CHECK(eof, "closed once answered");
+    close(fd);
+
+    /* clients closing in the same batch of events */
+    for (i = 0; i < CLIENTS; ++i)
+    {
+        fds[i] = connect_rigctld();
+        CHECK(fds[i] >= 0 && send_all(fds[i], "f\n") == 0, "batch client");
+    }
+
+    for (i = 0; i < CLIENTS; ++i)
+    {
+        if (fds[i] >= 0) { close(fds[i]); }
+    }
+
+    fd = connect_rigctld();
+    CHECK(fd >= 0 && send_all(fd, "f\n") == 0, "client after the batch");
+    CHECK(fd >= 0 && read_lines(fd, 1, &eof) == 1, "still serving");
+
+    if (fd >= 0) { close(fd); }
+
+    stop_rigctld(pid);
+
+    test_shared_gets(port, 0);
+    test_shared_gets(port, 1);
+    test_ptt_first(port, 0);
+    test_ptt_first(port, 1);
+    remove(TRACE);
+
+    if (failures)
+    {
+        fprintf(stderr, "%d rigctld checks failed\n", failures);
+        return 1;
+    }
+
+    printf("rigctld OK\n");
+    return 0;
+#else
+    /* the event loop is Linux only, and so is this test */
+    return 77;
+#endif
+}
@@ -0,0 +1,122 @@
+/*
+ * Test that concurrent identical gets share one backend call.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+
+#include "cache.h"
+#include "sleep.h"
+
+#define THREAD_COUNT 5
+#define GET_COUNT 20
+#define TEST_FREQ 14074000
+
+static int (*dummy_get_freq)(RIG *rig, vfo_t vfo, freq_t *freq);
+static int backend_calls;
+
+/* A rig that takes a while to answer, like a real CAT round trip */
+static int slow_get_freq(RIG *rig, vfo_t vfo, freq_t *freq)
+{
+    __atomic_add_fetch(&backend_calls, 1, __ATOMIC_RELAXED);
+    hl_usleep(20 * 1000);
+    return dummy_get_freq(rig, vfo, freq);
+}
+
+struct getter_context
+{
+    RIG *rig;
+    int errors;
+};
+
+static void *getter(void *arg)
+{
+    struct getter_context *ctx = arg;
+    freq_t freq;
+    int i;
+
+    for (i = 0; i < GET_COUNT; ++i)
+    {
+        if (rig_get_freq(ctx->rig, RIG_VFO_CURR, &freq) != RIG_OK
+                || freq != TEST_FREQ)
+        {
+            ctx->errors++;
+        }
+    }
+
+    return NULL;
+}
+
+int main(void)
+{
+    RIG *rig;
+    pthread_t threads[THREAD_COUNT];
+    struct getter_context ctx[THREAD_COUNT];
+    int total = THREAD_COUNT * GET_COUNT;
+    int errors = 0;
+    unsigned long shared;
+    int i;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig || rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "cannot open dummy rig\n");
+        return 1;
+    }
+
+    rig_set_freq(rig, RIG_VFO_CURR, TEST_FREQ);
+
+    // every get must reach the backend unless it is shared
+    rig_set_cache_timeout_ms(rig, HAMLIB_CACHE_ALL, 0);
+
+    dummy_get_freq = rig->caps->get_freq;
+    rig->caps->get_freq = slow_get_freq;
+
+    for (i = 0; i < THREAD_COUNT; ++i)
+    {
+        ctx[i].rig = rig;
+        ctx[i].errors = 0;
+        pthread_create(&threads[i], NULL, getter, &ctx[i]);
+    }
+
+    for (i = 0; i < THREAD_COUNT; ++i)
+    {
+        pthread_join(threads[i], NULL);
+        errors += ctx[i].errors;
+    }
+
+    rig->caps->get_freq = dummy_get_freq;
+    shared = CACHE(rig)->flights.shared;
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    printf("%d gets, %d backend calls, %lu shared\n", total, backend_calls,
+           shared);
+
+    if (errors)
+    {
+        fprintf(stderr, "%d gets failed or returned the wrong frequency\n",
+                errors);
+        return 1;
+    }
+
+    if (backend_calls + (int) shared != total || backend_calls > total / 2)
+    {
+        fprintf(stderr, "concurrent gets were not coalesced\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,173 @@
+/*
+ * Test JSON snapshots: the streaming writer gives the bytes cJSON would
+ * print for the same document, and with a VFO state only the VFOs that
+ * changed are sent.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hamlib/config.h>
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+#include <hamlib/rig_state.h>
+
+#include "cache.h"
+#include "snapshot_data.h"
+#include "cJSON.h"
+#include "testcheck.h"
+
+static char json[HAMLIB_MAX_SNAPSHOT_PACKET_SIZE];
+
+/* cJSON reads the snapshot and prints it back unchanged */
+static int same_as_cjson(const char *s)
+{
+    cJSON *root = cJSON_Parse(s);
+    char *printed;
+    int same;
+
+    if (!root) { return 0; }
+
+    printed = cJSON_PrintUnformatted(root);
+    same = printed && strcmp(printed, s) == 0;
+
+    if (!same) { fprintf(stderr, "ours:  %s\ncJSON: %s\n", s, printed); }
+
+    cJSON_free(printed);
+    cJSON_Delete(root);
+    return same;
+}
+
+static int vfo_count(const char *s, const char **name)
+{
+    cJSON *root = cJSON_Parse(s);
+    cJSON *vfos = cJSON_GetObjectItem(root, "vfos");
+    int n = cJSON_GetArraySize(vfos);
+    static char first[32];
+
+    first[0] = '\0';
+
+    if (n > 0)
+    {
+        const char *v = cJSON_GetStringValue(cJSON_GetObjectItem(
+                cJSON_GetArrayItem(vfos, 0), "name"));
+        snprintf(first, sizeof(first), "%s", v ? v : "");
+    }
+
+    *name = first;
+    cJSON_Delete(root);
+    return n;
+}
+
+int main(void)
+{
+    static const char prefix[] = "{\"app\":\"" PACKAGE_NAME "\",\"version\":";
+    static struct snapshot_vfo_state vfo_state;
+    unsigned char data[3] = { 0x00, 0x01, 0xff };
+    struct rig_spectrum_line line;
+    unsigned int seq;
+    const char *name;
+    int all;
+    RIG *rig;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig || rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "cannot open dummy rig\n");
+        return 1;
+    }
+
+    snapshot_init();
+
+    /* strings that need escaping, numbers in each of cJSON's formats */
+    strcpy(STATE(rig)->device_id, "a\"b\\c\t\001");
+    rig_set_cache_freq(rig, RIG_VFO_A, 14074000.5);
+    rig_set_cache_freq(rig, RIG_VFO_B, 10e9);
+
+    memset(&line, 0, sizeof(line));
+    line.id = 0;
+    line.data_level_max = 160;
+    line.signal_strength_min = -80.25;
+    line.signal_strength_max = 0.1;
+    line.spectrum_mode = RIG_SPECTRUM_MODE_FIXED;
+    line.low_edge_freq = 7000000;
+    line.high_edge_freq = 7200000;
+    line.spectrum_data_length = sizeof(data);
+    line.spectrum_data = data;
+
+    seq = STATE(rig)->snapshot_packet_sequence_number;
+    CHECK(snapshot_serialize(sizeof(json), json, rig, &line) == RIG_OK,
+          "serialize");
+    CHECK(same_as_cjson(json), "snapshot with a spectrum line as cJSON prints it");
+    CHECK(strncmp(json, prefix, sizeof(prefix) - 1) == 0, "static prefix");
+    CHECK(strstr(json, "\"deviceId\":\"a\\\"b\\\\c\\t\\u0001\"") != NULL,
+          "string escapes");
+    CHECK(strstr(json, "\"freq\":14074000.5,") != NULL, "fractional number");
+    CHECK(strstr(json, "\"freq\":10000000000,") != NULL, "number past INT_MAX");
+    CHECK(strstr(json, "\"minStrength\":-80.25,\"maxStrength\":0.1,") != NULL,
+          "doubles");
+    CHECK(strstr(json, "\"type\":\"FIXED\"") != NULL, "spectrum type");
+    CHECK(strstr(json, "\"length\":3,\"data\":\"0001FF\"}]}") != NULL,
+          "spectrum data");
+    CHECK(STATE(rig)->snapshot_packet_sequence_number == seq + 1, "seq counted");
+
+    CHECK(snapshot_serialize(sizeof(json), json, rig, NULL) == RIG_OK,
+          "serialize without spectrum");
+    CHECK(same_as_cjson(json), "snapshot as cJSON prints it");
+    CHECK(strstr(json, "\"spectra\"") == NULL, "no spectra");
+    all = vfo_count(json, &name);
+    CHECK(all >= 2, "all VFOs sent");
+
+    /* too small: fails and the sequence number is not used up */
+    seq = STATE(rig)->snapshot_packet_sequence_number;
+    CHECK(snapshot_serialize(100, json, rig, NULL) == -RIG_EINVAL,
+          "short buffer fails");
+    CHECK(STATE(rig)->snapshot_packet_sequence_number == seq, "seq not counted");
+
+    /* changed VFOs only */
+    CHECK(snapshot_serialize_vfos(sizeof(json), json, rig, NULL,
+                                  &vfo_state) == RIG_OK, "first changes");
+    CHECK(vfo_count(json, &name) == all, "first snapshot has every VFO");
+
+    CHECK(snapshot_serialize_vfos(sizeof(json), json, rig, NULL,
+                                  &vfo_state) == RIG_OK, "no changes");
+    CHECK(vfo_count(json, &name) == 0, "nothing changed, no VFOs");
+    CHECK(strstr(json, "\"vfos\":[]") != NULL && same_as_cjson(json),
+          "empty vfos array as cJSON prints it");
+
+    // MainB and Sub share the cache of VFOB and change with it
+    rig_set_cache_freq(rig, RIG_VFO_B, 7074000);
+    CHECK(snapshot_serialize_vfos(sizeof(json), json, rig, NULL,
+                                  &vfo_state) == RIG_OK, "one change");
+    CHECK(vfo_count(json, &name) < all && strcmp(name, "VFOB") == 0,
+          "only VFOB sent");
+    CHECK(same_as_cjson(json), "changes as cJSON prints them");
+
+    /* a failed snapshot does not lose a change */
+    rig_set_cache_freq(rig, RIG_VFO_A, 7000000);
+    CHECK(snapshot_serialize_vfos(100, json, rig, NULL, &vfo_state) != RIG_OK,
+          "short buffer fails");
+    CHECK(snapshot_serialize_vfos(sizeof(json), json, rig, NULL,
+                                  &vfo_state) == RIG_OK, "after failure");
+    CHECK(vfo_count(json, &name) == all, "every VFO sent again");
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    if (failures)
+    {
+        fprintf(stderr, "%d snapshot checks failed\n", failures);
+        return 1;
+    }
+
+    printf("snapshot JSON OK\n");
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * Test the spectrum line history: the kernels against plain loops, and
+ * rig_get_spectrum_history() combining, decimating and reusing results.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+#include <hamlib/rig_state.h>
+
+#include "spectrum_history.h"
+#include "spectrum_pool.h"
+#include "testcheck.h"
+
+#define BINS 689    // not a multiple of the vector width
+
+static unsigned char ring[SPECTRUM_HISTORY_LINES][BINS];
+
+static void reference(unsigned char *out, const unsigned char *const lines[],
+                      int count, enum rig_spectrum_history_e op)
+{
+    int i, l;
+
+    for (i = 0; i < BINS; i++)
+    {
+        unsigned int acc = lines[0][i];
+
+        for (l = 1; l < count; l++)
+        {
+            unsigned int v = lines[l][i];
+
+            if (op == RIG_SPECTRUM_HISTORY_AVERAGE) { acc += v; }
+            else if (op == RIG_SPECTRUM_HISTORY_MAX && v > acc) { acc = v; }
+            else if (op == RIG_SPECTRUM_HISTORY_MIN && v < acc) { acc = v; }
+        }
+
+        if (op == RIG_SPECTRUM_HISTORY_AVERAGE)
+        {
+            acc = (acc + count / 2) / count;
+        }
+
+        out[i] = acc;
+    }
+}
+
+static void check_kernels(void)
+{
+    const unsigned char *lines[SPECTRUM_HISTORY_LINES];
+    unsigned char out[BINS], want[BINS];
+    static const int counts[] = { 1, 2, 3, 7, 16, SPECTRUM_HISTORY_LINES };
+    int c, l, i;
+
+    for (l = 0; l < SPECTRUM_HISTORY_LINES; l++)
+    {
+        for (i = 0; i < BINS; i++) { ring[l][i] = rand(); }
+
+        lines[l] = ring[l];
+    }
+
+    // the extremes, where a rounding or overflow error would show
+    memset(ring[0], 255, 40);
+    memset(ring[1], 255, 40);
+
+    for (c = 0; c < (int)(sizeof(counts) / sizeof(counts[0])); c++)
+    {
+        spectrum_kernel_average(out, lines, counts[c], BINS);
+        reference(want, lines, counts[c], RIG_SPECTRUM_HISTORY_AVERAGE);
+        CHECK(memcmp(out, want, BINS) == 0, "average");
+
+        spectrum_kernel_max(out, lines, counts[c], BINS);
+        reference(want, lines, counts[c], RIG_SPECTRUM_HISTORY_MAX);
+        CHECK(memcmp(out, want, BINS) == 0, "max hold");
+
+        spectrum_kernel_min(out, lines, counts[c], BINS);
+        reference(want, lines, counts[c], RIG_SPECTRUM_HISTORY_MIN);
+        CHECK(memcmp(out, want, BINS) == 0, "min hold");
+    }
+
+    /* 689 bins into 100: bins of 6 or 7, covering all of them once */
+    for (i = 0; i < BINS; i++) { ring[0][i] = i == 300 ? 200 : 10; }
+
+    spectrum_kernel_decimate(out, 100, ring[0], BINS, RIG_SPECTRUM_HISTORY_MAX);
+    CHECK(out[300 * 100 / BINS] == 200 && out[0] == 10, "decimation keeps a peak");
+    spectrum_kernel_decimate(out, 100, ring[0], BINS, RIG_SPECTRUM_HISTORY_MIN);
+    CHECK(out[300 * 100 / BINS] == 10, "decimated minimum");
+    spectrum_kernel_decimate(out, 100, ring[0], BINS,
+                             RIG_SPECTRUM_HISTORY_AVERAGE);
+    CHECK(out[300 * 100 / BINS] > 10 && out[300 * 100 / BINS] < 50,
+          "decimated average");
+}
+
+static void push(RIG *rig, unsigned char value, freq_t center)
+{
+    struct spectrum_buffer *buf = spectrum_buffer_get(rig);
+
+    memset(buf->data, value, BINS);
+    buf->line.id = 0;
+    buf->line.spectrum_mode = RIG_SPECTRUM_MODE_CENTER;
+    buf->line.center_freq = center;
+    buf->line.span_freq = 50000;
+    buf->line.spectrum_data_length = BINS;
+    spectrum_history_push(rig, buf);
+    spectrum_buffer_unref(buf);
+}
+
+int main(void)
+{
+    unsigned char data[HAMLIB_MAX_SPECTRUM_DATA];
+    struct rig_spectrum_line line;
+    struct spectrum_history *h;
+    unsigned long computed;
+    RIG *rig;
+    int i;
+
+    check_kernels();
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig || rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "cannot open dummy rig\n");
+        return 1;
+    }
+
+    h = STATE(rig)->spectrum_history;
+
+    CHECK(rig_get_spectrum_history(rig, 0, RIG_SPECTRUM_HISTORY_LAST, 1, 0,
+                                   &line, data) == -RIG_ENAVAIL, "no line yet");
+
+    for (i = 1; i <= 5; i++) { push(rig, i * 10, 14074000); }
+
+    CHECK(rig_get_spectrum_history(rig, 0, RIG_SPECTRUM_HISTORY_LAST, 1, 0,
+                                   &line, data) == 1
+          && line.spectrum_data_length == BINS && data[0] == 50
+          && line.center_freq == 14074000, "newest line");
+    CHECK(rig_get_spectrum_history(rig, 0, RIG_SPECTRUM_HISTORY_AVERAGE, 4, 0,
+                                   &line, data) == 4 && data[BINS - 1] == 35,
+          "average of four");
+    CHECK(rig_get_spectrum_history(rig, 0, RIG_SPECTRUM_HISTORY_MIN, 100, 0,
+                                   &line, data) == 5 && data[7] == 10,
+          "no more lines than received");
+
+    /* the same question of the same line is answered from the result */
+    computed = h->computed;
+    CHECK(rig_get_spectrum_history(rig, 0, RIG_SPECTRUM_HISTORY_MAX, 3, 120,
+                                   &line, data) == 3
+          && line.spectrum_data_length == 120 && data[119] == 50,
+          "max hold decimated");
+    CHECK(h->computed == computed + 1, "computed once");
+
+    for (i = 0; i < 8; i++)
+    {
+        rig_get_spectrum_history(rig, 0, RIG_SPECTRUM_HISTORY_MAX, 3, 120, &line,
+                                 data);
+    }
+
+    CHECK(h->computed == computed + 1, "shared by later callers");
+    push(rig, 60, 14074000);
+    rig_get_spectrum_history(rig, 0, RIG_SPECTRUM_HISTORY_MAX, 3, 120, &line,
+                             data);
+    CHECK(h->computed == computed + 2 && data[0] == 60, "new line, new result");
+
+    /* retuned: older lines are not mixed in */
+    push(rig, 100, 7074000);
+    CHECK(rig_get_spectrum_history(rig, 0, RIG_SPECTRUM_HISTORY_AVERAGE, 8, 0,
+                                   &line, data) == 1 && data[0] == 100
+          && line.center_freq == 7074000, "lines of one range only");
+
+    /* a full ring wraps around */
+    for (i = 0; i < SPECTRUM_HISTORY_LINES + 5; i++) { push(rig, i, 7074000); }
+
+    CHECK(rig_get_spectrum_history(rig, 0, RIG_SPECTRUM_HISTORY_MIN,
+                                   SPECTRUM_HISTORY_LINES, 0, &line, data)
+          == SPECTRUM_HISTORY_LINES && data[0] == 5, "ring wraps");
+
+    CHECK(rig_get_spectrum_history(rig, 1, RIG_SPECTRUM_HISTORY_LAST, 1, 0,
+                                   &line, data) == -RIG_ENAVAIL, "other scope");
+    CHECK(rig_get_spectrum_history(rig, 0, (enum rig_spectrum_history_e) 9, 1,
+                                   0, &line, data) == -RIG_EINVAL, "bad op");
+    CHECK(rig_parse_spectrum_history("AVG") == RIG_SPECTRUM_HISTORY_AVERAGE
+          && strcmp(rig_strspectrumhistory(RIG_SPECTRUM_HISTORY_MAX), "MAX") == 0
+          && rig_parse_spectrum_history("X") == -1, "names");
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    if (failures)
+    {
+        fprintf(stderr, "%d spectrum history checks failed\n", failures);
+        return 1;
+    }
+
+    printf("spectrum history OK\n");
+    return 0;
+}
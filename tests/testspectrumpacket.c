@@ -0,0 +1,144 @@
+/*
+ * Test binary spectrum packets: encodings, header round trip, key lines
+ * and recovery from a lost packet.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hamlib/rig.h>
+
+#include "spectrum_packet.h"
+#include "testcheck.h"
+
+#define BINS 475
+
+static struct spectrum_packet_state tx, rx;
+static unsigned char data[BINS];
+static unsigned char packet[SPECTRUM_PACKET_MAX_SIZE];
+static struct rig_spectrum_line line;
+
+static int send_line(void)
+{
+    return spectrum_packet_encode(&tx, &line, packet, sizeof(packet));
+}
+
+static int receive_line(int len)
+{
+    unsigned char decoded[HAMLIB_MAX_SPECTRUM_DATA];
+    struct rig_spectrum_line out;
+    int result = spectrum_packet_decode(&rx, packet, len, &out, decoded);
+
+    if (result == RIG_OK
+            && (out.spectrum_data_length != BINS
+                || memcmp(decoded, data, BINS) != 0))
+    {
+        return -RIG_EINTERNAL;
+    }
+
+    return result;
+}
+
+int main(void)
+{
+    unsigned char decoded[HAMLIB_MAX_SPECTRUM_DATA];
+    struct rig_spectrum_line out;
+    int len;
+    int i;
+
+    line.id = 1;
+    line.data_level_min = 0;
+    line.data_level_max = 160;
+    line.signal_strength_min = -80.5;
+    line.signal_strength_max = 0;
+    line.spectrum_mode = RIG_SPECTRUM_MODE_FIXED;
+    line.low_edge_freq = 7000000;
+    line.high_edge_freq = 7200000;
+    line.spectrum_data_length = BINS;
+    line.spectrum_data = data;
+
+    /* a flat line packs as runs */
+    memset(data, 12, sizeof(data));
+    len = send_line();
+    CHECK(len > 0 && len < SPECTRUM_PACKET_HEADER_SIZE + 16, "flat line is short");
+    CHECK(packet[5] == SPECTRUM_PACKET_RLE, "flat line is RLE");
+    CHECK(spectrum_packet_is_binary(packet, len), "binary magic");
+    CHECK(spectrum_packet_decode(&rx, packet, len, &out, decoded) == RIG_OK,
+          "decode flat line");
+    CHECK(out.id == 1 && out.data_level_max == 160
+          && out.signal_strength_min == -80.5
+          && out.spectrum_mode == RIG_SPECTRUM_MODE_FIXED
+          && out.low_edge_freq == 7000000 && out.high_edge_freq == 7200000,
+          "header round trip");
+
+    /* noise does not pack, and is not a delta of the flat line either */
+    for (i = 0; i < BINS; i++) { data[i] = rand(); }
+
+    len = send_line();
+    CHECK(packet[5] == SPECTRUM_PACKET_RAW
+          && len == SPECTRUM_PACKET_HEADER_SIZE + BINS, "noise is RAW");
+    CHECK(receive_line(len) == RIG_OK, "decode noise");
+
+    /* a few bins changed: delta */
+    data[10]++;
+    data[200] -= 3;
+    len = send_line();
+    CHECK(packet[5] == SPECTRUM_PACKET_DELTA && len < SPECTRUM_PACKET_HEADER_SIZE + 32,
+          "small change is DELTA");
+    CHECK(receive_line(len) == RIG_OK, "decode delta");
+
+    /* deltas give way to a key line within the key interval */
+    for (i = 0; i < SPECTRUM_PACKET_KEY_INTERVAL; i++)
+    {
+        data[i]++;
+        len = send_line();
+        CHECK(receive_line(len) == RIG_OK, "decode delta run");
+
+        if (packet[5] != SPECTRUM_PACKET_DELTA) { break; }
+    }
+
+    CHECK(i < SPECTRUM_PACKET_KEY_INTERVAL, "key line sent");
+
+    /* lose a packet: the next delta cannot be decoded, the next key can */
+    data[0]++;
+    send_line();
+    data[0]++;
+    len = send_line();
+    CHECK(packet[5] == SPECTRUM_PACKET_DELTA, "delta after loss");
+    CHECK(receive_line(len) == -RIG_ENAVAIL, "delta without its base");
+    CHECK(rx.lost == 1, "one line lost");
+
+    for (i = 0; i < SPECTRUM_PACKET_KEY_INTERVAL; i++)
+    {
+        data[0]++;
+        len = send_line();
+
+        if (packet[5] != SPECTRUM_PACKET_DELTA) { break; }
+
+        CHECK(receive_line(len) == -RIG_ENAVAIL, "still waiting for a key line");
+    }
+
+    CHECK(receive_line(len) == RIG_OK, "key line decodes");
+    CHECK(rx.lost == 1, "no further loss counted");
+
+    /* malformed packets */
+    CHECK(receive_line(len - 1) == -RIG_EPROTO, "truncated packet");
+    memset(data, 0, sizeof(data));
+    len = send_line();
+    packet[SPECTRUM_PACKET_HEADER_SIZE] = 0x7f;    // literal run past the end
+    CHECK(receive_line(len) == -RIG_EPROTO, "corrupt run length data");
+
+    if (failures)
+    {
+        fprintf(stderr, "%d spectrum packet checks failed\n", failures);
+        return 1;
+    }
+
+    printf("spectrum packets OK\n");
+    return 0;
+}
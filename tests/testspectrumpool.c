@@ -0,0 +1,180 @@
+/*
+ * Test the spectrum line buffer pool: lines are handed to the history,
+ * the multicast publisher and the callback without being copied, a line
+ * held by a slow consumer stays intact while the next ones are assembled
+ * elsewhere, every buffer comes back once it is released, and a line
+ * held across rig_cleanup() outlives the rig.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+#include <hamlib/rig_state.h>
+
+#include "event.h"
+#include "sleep.h"
+#include "spectrum_pool.h"
+#include "testcheck.h"
+
+#define BINS 689
+#define LINES 50
+
+/* Laid out like a pool buffer, but not one */
+struct foreign_line
+{
+    struct rig_spectrum_line line;
+    unsigned char data[HAMLIB_MAX_SPECTRUM_DATA];
+};
+
+static const struct rig_spectrum_line *held;
+static int callbacks;
+
+/* A consumer that keeps the first line for later */
+static int spectrum_cb(RIG *rig, struct rig_spectrum_line *line, rig_ptr_t arg)
+{
+    if (!held && rig_hold_spectrum_line(rig, line) == RIG_OK) { held = line; }
+
+    callbacks++;
+    return RIG_OK;
+}
+
+/* Buffers not back in the pool */
+static int in_use(struct spectrum_pool *pool)
+{
+    struct spectrum_buffer *buf;
+    int n;
+
+    pthread_mutex_lock(&pool->lock);
+    n = pool->count;
+
+    for (buf = pool->free; buf; buf = buf->next_free) { n--; }
+
+    pthread_mutex_unlock(&pool->lock);
+    return n;
+}
+
+int main(void)
+{
+    static struct foreign_line foreign;
+    unsigned char data[BINS];
+    struct spectrum_buffer *buf, *previous = NULL;
+    struct rig_spectrum_line line;
+    struct spectrum_pool *pool;
+    int reused = 1;
+    int i, wait;
+    RIG *rig;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig)
+    {
+        fprintf(stderr, "cannot init dummy rig\n");
+        return 1;
+    }
+
+    // lines also go through the multicast publisher
+    rig_set_conf(rig, rig_token_lookup(rig, "multicast_data_addr"), "127.0.0.1");
+    rig_set_conf(rig, rig_token_lookup(rig, "multicast_data_port"), "45999");
+
+    if (rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "cannot open dummy rig\n");
+        return 1;
+    }
+
+    CHECK(STATE(rig)->multicast_publisher_priv_data != NULL, "publisher running");
+    pool = STATE(rig)->spectrum_pool;
+    rig_set_spectrum_callback(rig, spectrum_cb, NULL);
+
+    /* what a backend does: assemble, fire, let go, take the next buffer */
+    for (i = 0; i < LINES; i++)
+    {
+        buf = spectrum_buffer_get(rig);
+
+        if (!buf) { CHECK(0, "buffer"); break; }
+
+        if (buf == previous) { reused = 0; }
+
+        memset(buf->data, i, BINS);
+        buf->line.spectrum_mode = RIG_SPECTRUM_MODE_CENTER;
+        buf->line.center_freq = 14074000;
+        buf->line.span_freq = 50000;
+        buf->line.spectrum_data_length = BINS;
+        rig_fire_spectrum_buffer(rig, buf);
+        spectrum_buffer_unref(buf);
+        previous = buf;
+    }
+
+    CHECK(reused, "next line assembled in another buffer");
+    CHECK(callbacks == LINES, "every line to the callback");
+    CHECK(pool->lines == LINES && pool->copies == 0, "no line copied");
+    CHECK(held && held->spectrum_data[0] == 0
+          && held->spectrum_data[BINS - 1] == 0
+          && held->spectrum_data_length == BINS, "held line intact");
+    CHECK(rig_release_spectrum_line(rig, held) == RIG_OK, "release");
+
+    /* a line from elsewhere is copied once */
+    memset(data, 7, sizeof(data));
+    memset(&line, 0, sizeof(line));
+    line.spectrum_data_length = BINS;
+    line.spectrum_data = data;
+    CHECK(rig_fire_spectrum_event(rig, &line) == RIG_OK, "fire a plain line");
+    CHECK(pool->lines == LINES + 1 && pool->copies == 1, "copied once");
+    CHECK(rig_hold_spectrum_line(rig, &line) == -RIG_EINVAL,
+          "only pooled lines can be held");
+    foreign.line.spectrum_data = foreign.data;
+    CHECK(rig_hold_spectrum_line(rig, &foreign.line) == -RIG_EINVAL,
+          "a line shaped like a pooled one is not held");
+
+    /* once the publisher is done, only the history holds lines */
+    for (wait = 0; wait < 200 && in_use(pool) != LINES + 1; wait++)
+    {
+        hl_usleep(10 * 1000);
+    }
+
+    CHECK(in_use(pool) == LINES + 1, "publisher released its lines");
+    CHECK(pool->count <= LINES + 8, "buffers reused");
+
+    /* the last reference frees a line held across rig_cleanup() */
+    held = NULL;
+    buf = spectrum_buffer_get(rig);
+
+    if (buf)
+    {
+        memset(buf->data, 9, BINS);
+        buf->line.spectrum_data_length = BINS;
+        rig_fire_spectrum_buffer(rig, buf);
+        spectrum_buffer_unref(buf);
+    }
+
+    CHECK(held != NULL, "line held");
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    if (held)
+    {
+        CHECK(held->spectrum_data[0] == 9 && held->spectrum_data[BINS - 1] == 9,
+              "held line intact after cleanup");
+        CHECK(rig_release_spectrum_line(rig, held) == RIG_OK,
+              "release after cleanup");
+    }
+
+    if (failures)
+    {
+        fprintf(stderr, "%d spectrum pool checks failed\n", failures);
+        return 1;
+    }
+
+    printf("spectrum pool OK\n");
+    return 0;
+}
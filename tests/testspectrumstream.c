@@ -0,0 +1,217 @@
+/*
+ * Test the rigctld spectrum streams: lines are queued per stream, a
+ * stream that is not read drops its oldest lines, the rate limit and the
+ * decimation apply, both frame formats carry the line, and serving stops
+ * at the client's next line, also one read ahead with the command.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/riglist.h>
+#include <hamlib/rig_state.h>
+
+#include "event.h"
+#include "sleep.h"
+#include "spectrum_packet.h"
+#include "spectrum_pool.h"
+#include "spectrum_stream.h"
+#include "testcheck.h"
+
+#define BINS 475
+
+static void fire(RIG *rig, int id, unsigned char value)
+{
+    unsigned char data[BINS];
+    struct rig_spectrum_line line;
+
+    memset(&line, 0, sizeof(line));
+    memset(data, value, sizeof(data));
+    data[BINS / 2] = 250;
+    line.id = id;
+    line.spectrum_mode = RIG_SPECTRUM_MODE_CENTER;
+    line.center_freq = 14074000;
+    line.span_freq = 50000;
+    line.spectrum_data = data;
+    line.spectrum_data_length = BINS;
+    rig_fire_spectrum_event(rig, &line);
+}
+
+static int readable(int fd)
+{
+    struct pollfd p = { fd, POLLIN, 0 };
+
+    return poll(&p, 1, 0) == 1;
+}
+
+/* References held on the lines of the pool, by the history and the streams */
+static int references(struct spectrum_pool *pool)
+{
+    struct spectrum_buffer *buf;
+    int n = 0;
+
+    pthread_mutex_lock(&pool->lock);
+
+    for (buf = pool->all; buf; buf = buf->next) { n += buf->refs; }
+
+    pthread_mutex_unlock(&pool->lock);
+    return n;
+}
+
+int main(void)
+{
+    static unsigned char frame[SPECTRUM_STREAM_FRAME_MAX];
+    static struct spectrum_packet_state decoder;
+    unsigned char data[HAMLIB_MAX_SPECTRUM_DATA];
+    struct rig_spectrum_line line;
+    struct spectrum_stream *hex, *bin, *other, *idle;
+    unsigned long seq;
+    unsigned int first;
+    int low, high, length;
+    int n, i, count, refs;
+    char drain[16];
+    int input[2];
+    FILE *fin, *fout;
+    RIG *rig;
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    rig = rig_init(RIG_MODEL_DUMMY);
+
+    if (!rig || rig_open(rig) != RIG_OK)
+    {
+        fprintf(stderr, "cannot open dummy rig\n");
+        return 1;
+    }
+
+    CHECK(spectrum_stream_parse_format("BINARY") == SPECTRUM_STREAM_BINARY
+          && spectrum_stream_parse_format("JSON") < 0, "format names");
+
+    hex = spectrum_stream_open(rig, 0, SPECTRUM_STREAM_HEX, 0, 0, -1);
+    bin = spectrum_stream_open(rig, 0, SPECTRUM_STREAM_BINARY, 0, 100, -1);
+    other = spectrum_stream_open(rig, 1, SPECTRUM_STREAM_HEX, 0, 0, -1);
+    CHECK(hex && bin && other, "open");
+
+    CHECK(!readable(spectrum_stream_fd(hex)), "nothing yet");
+    fire(rig, 0, 7);
+    CHECK(readable(spectrum_stream_fd(hex)), "woken by a line");
+    CHECK(!readable(spectrum_stream_fd(other)), "other scope not woken");
+
+    n = spectrum_stream_next(hex, frame, sizeof(frame));
+    CHECK(n == 36 + 2 * BINS && frame[n - 1] == '\n', "hex frame length");
+    frame[n - 1] = '\0';
+    CHECK(sscanf((char *) frame, "SPECTRUM 0 %lu %d %d %d %2x", &seq, &low, &high,
+                 &length, &first) == 5
+          && seq == 1 && low == 14049000 && high == 14099000 && length == BINS
+          && first == 7, "hex frame fields");
+    CHECK(spectrum_stream_next(hex, frame, sizeof(frame)) == 0, "hex drained");
+
+    n = spectrum_stream_next(bin, frame, sizeof(frame));
+    CHECK(n > 0 && spectrum_packet_is_binary(frame, n), "binary frame");
+    CHECK(spectrum_packet_decode(&decoder, frame, n, &line, data) == RIG_OK
+          && line.spectrum_data_length == 100 && data[0] == 7
+          && memchr(data, 250, 100) != NULL, "decimated, peak kept");
+
+    /* not read: only the newest lines wait, the others are let go */
+    idle = spectrum_stream_open(rig, 0, SPECTRUM_STREAM_HEX, 0, 0, -1);
+
+    for (i = 1; i <= 10; i++) { fire(rig, 0, i); }
+
+    refs = references(STATE(rig)->spectrum_pool);
+    spectrum_stream_close(idle);
+    CHECK(references(STATE(rig)->spectrum_pool) == refs - SPECTRUM_STREAM_QUEUE,
+          "lines released on close");
+
+    CHECK(spectrum_stream_dropped(hex) == 10 - SPECTRUM_STREAM_QUEUE,
+          "dropped count");
+    n = spectrum_stream_next(hex, frame, sizeof(frame));
+    CHECK(n > 0 && sscanf((char *) frame, "SPECTRUM 0 %lu %d %d %d %2x", &seq,
+                          &low, &high, &length, &first) == 5
+          && seq == 2 + 10 - SPECTRUM_STREAM_QUEUE
+          && first == 11 - SPECTRUM_STREAM_QUEUE, "oldest lines dropped");
+
+    for (count = 1; spectrum_stream_next(hex, frame, sizeof(frame)) > 0; count++) { }
+
+    CHECK(count == SPECTRUM_STREAM_QUEUE, "queue depth");
+
+    /* the binary decoder follows the lines actually sent */
+    while ((n = spectrum_stream_next(bin, frame, sizeof(frame))) > 0)
+    {
+        CHECK(spectrum_packet_decode(&decoder, frame, n, &line, data) == RIG_OK,
+              "binary after drops");
+    }
+
+    CHECK(decoder.lost == 0, "no gap in the binary sequence");
+
+    spectrum_stream_close(bin);
+    spectrum_stream_close(other);
+    spectrum_stream_close(hex);
+
+    /* at most 10 lines a second */
+    hex = spectrum_stream_open(rig, -1, SPECTRUM_STREAM_HEX, 10, 0, -1);
+
+    for (i = 0; i < 5; i++) { fire(rig, i & 1, i); }
+
+    hl_usleep(120 * 1000);
+    fire(rig, 0, 0);
+
+    for (count = 0; spectrum_stream_next(hex, frame, sizeof(frame)) > 0; count++) { }
+
+    CHECK(count == 2, "rate limit");
+
+    /* serving stops at the first input from the client */
+    while (read(spectrum_stream_fd(hex), drain, sizeof(drain)) > 0) { }
+
+    fire(rig, 0, 0);
+
+    if (pipe(input) == 0)
+    {
+        fin = fdopen(input[0], "r");
+        fout = fopen("/dev/null", "w");
+        CHECK(write(input[1], "\n", 1) == 1
+              && spectrum_stream_serve(hex, fin, fout) == 0, "stopped by input");
+        fclose(fin);
+        fclose(fout);
+        close(input[1]);
+    }
+
+    /* a stop line that came with the command is already read ahead */
+    if (pipe(input) == 0)
+    {
+        static const char cmd_stop[] = "\\spectrum_stream 0 HEX 10\n\n";
+        char cmd[64];
+
+        fin = fdopen(input[0], "r");
+        fout = fopen("/dev/null", "w");
+        CHECK(write(input[1], cmd_stop, sizeof(cmd_stop) - 1) == sizeof(cmd_stop) - 1
+              && fgets(cmd, sizeof(cmd), fin) != NULL, "command read");
+        CHECK(spectrum_stream_serve(hex, fin, fout) == 0, "stopped by buffered input");
+        CHECK(fgets(cmd, sizeof(cmd), fin) != NULL && strcmp(cmd, "\n") == 0,
+              "stop line left unread");
+        fclose(fin);
+        fclose(fout);
+        close(input[1]);
+    }
+
+    spectrum_stream_close(hex);
+
+    rig_close(rig);
+    rig_cleanup(rig);
+
+    if (failures)
+    {
+        fprintf(stderr, "%d spectrum stream checks failed\n", failures);
+        return 1;
+    }
+
+    printf("spectrum stream OK\n");
+    return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * Test write_block() pacing: write_delay between bytes and
+ * post_write_delay between blocks, with time spent elsewhere counted.
+ *
+ * Copyright (C) 2026 The Hamlib Group
+ *
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <hamlib/rig.h>
+#include <hamlib/port.h>
+
+#include "iofunc.h"
+#include "sleep.h"
+
+static int failures;
+
+static double now_ms(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e3 + now.tv_nsec / 1e6;
+}
+
+/* Time one write_block() in ms */
+static double timed_write(hamlib_port_t *p, const char *s)
+{
+    double start = now_ms();
+
+    if (write_block(p, (const unsigned char *) s, strlen(s)) != RIG_OK)
+    {
+        fprintf(stderr, "write_block failed\n");
+        failures++;
+    }
+
+    return now_ms() - start;
+}
+
+static void check_range(const char *what, double ms, double min, double max)
+{
+    printf("%-40s %6.1f ms\n", what, ms);
+
+    if (ms < min || ms > max)
+    {
+        fprintf(stderr, "FAIL: %s took %.1f ms, expected %.0f..%.0f\n", what,
+                ms, min, max);
+        failures++;
+    }
+}
+
+int main(void)
+{
+    hamlib_port_t port;
+    double start;
+    int fds[2];
+
+    rig_set_debug(RIG_DEBUG_NONE);
+
+    if (pipe(fds) != 0)
+    {
+        perror("pipe");
+        return 1;
+    }
+
+    memset(&port, 0, sizeof(port));
+    port.fd = fds[1];
+
+    /*
+     * A loaded machine may take longer for anything, so the waits are
+     * checked from the start of the first write, where being slow only
+     * adds to them, and the upper bounds are loose.  A block that must
+     * not wait gets a bound well below the delay it would wait out.
+     */
+    port.post_write_delay = 200;
+    start = now_ms();
+    check_range("first block", timed_write(&port, "FA;"), 0, 150);
+    timed_write(&port, "FA;");
+    check_range("back to back blocks wait out the gap", now_ms() - start,
+                199, 2000);
+
+    // e.g. reading the reply, the gap has passed meanwhile
+    hl_usleep(250 * 1000);
+    check_range("block after the gap passed", timed_write(&port, "FA;"), 0, 150);
+
+    hl_usleep(250 * 1000);
+    port.post_write_delay = 0;
+    port.write_delay = 10;
+    start = now_ms();
+    check_range("6 bytes with write_delay 10",
+                timed_write(&port, "ABCDEF"), 49, 2000);
+    timed_write(&port, "A");
+    check_range("next block waits for the last byte gap", now_ms() - start,
+                59, 2000);
+
+    close(fds[0]);
+    close(fds[1]);
+
+    return failures ? 1 : 0;
+}